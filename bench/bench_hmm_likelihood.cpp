@@ -0,0 +1,55 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Numeric/Hmm/AutoCorrelationTransitionMatrix.h>
+#include <Bpp/Numeric/Hmm/RescaledHmmLikelihood.h>
+#include <Bpp/Utils/ThreadPool.h>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "../test/SimpleHmm.h"
+
+using namespace bpp;
+using namespace std;
+
+// Time the forward, backward and derivative recursions of RescaledHmmLikelihood
+// on data made of many independent segments, with an increasing number of threads.
+
+template<class F>
+double timeIt(F f)
+{
+  auto start = chrono::steady_clock::now();
+  f();
+  chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+int main()
+{
+  size_t nbStates = 20, nbSites = 1000000, nbSegments = 2000;
+  auto alphabet = make_shared<SimpleHmmStateAlphabet>(nbStates);
+  auto trans = make_shared<AutoCorrelationTransitionMatrix>(alphabet);
+  auto emissions = make_shared<SimpleHmmEmissionProbabilities>(alphabet, simulateSimpleHmmData(nbSites));
+  vector<size_t> breakPoints;
+  for (size_t i = 1; i < nbSegments; ++i)
+  {
+    breakPoints.push_back(i * (nbSites / nbSegments));
+  }
+
+  cout << setw(8) << "threads" << setw(14) << "forward(s)" << setw(14) << "backward(s)" << setw(14) << "dforward(s)" << endl;
+  for (size_t nbThreads = 1; nbThreads <= ThreadPool::getDefaultNumberOfThreads(); nbThreads *= 2)
+  {
+    RescaledHmmLikelihood lik(alphabet, trans, emissions, "");
+    lik.setThreadPool(make_shared<ThreadPool>(nbThreads));
+    lik.setBreakPoints(breakPoints);
+    double tForward = timeIt([&]() { lik.setParameterValue("p1", 0.3); });
+    vector< vector<double> > post;
+    double tBackward = timeIt([&]() { lik.getHiddenStatesPosteriorProbabilities(post); });
+    double tDForward = timeIt([&]() { lik.getFirstOrderDerivative("p1"); });
+    cout << setw(8) << nbThreads << setprecision(3) << setw(14) << tForward << setw(14) << tBackward << setw(14) << tDForward << endl;
+  }
+  return 0;
+}
@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Numeric/Matrix/Matrix.h>
+#include <Bpp/Numeric/Matrix/MatrixTools.h>
+#include <Bpp/Numeric/Random/RandomTools.h>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+// Time the reconstruction of A . diag(D[t]) . B for many diagonals D[t]:
+// generic implementation (ColMatrix operands), one dense product per
+// diagonal, and all diagonals in one batched call.
+
+template<class MatrixType>
+void fillRandom(MatrixType& m)
+{
+  for (size_t i = 0; i < m.getNumberOfRows(); ++i)
+  {
+    for (size_t j = 0; j < m.getNumberOfColumns(); ++j)
+    {
+      m(i, j) = RandomTools::giveRandomNumberBetweenZeroAndEntry(1.);
+    }
+  }
+}
+
+template<class F>
+double timeIt(F f)
+{
+  auto start = chrono::steady_clock::now();
+  f();
+  chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+int main()
+{
+  vector<size_t> sizes = { 4, 20, 61, 100, 200 };
+  size_t nbT = 200;
+
+  cout << setw(6) << "n" << setw(8) << "nbT" << setw(14) << "generic(s)" << setw(14) << "dense(s)" << setw(14) << "batch(s)" << endl;
+  for (size_t n : sizes)
+  {
+    ColMatrix<double> ca(n, n), cb(n, n);
+    fillRandom(ca);
+    fillRandom(cb);
+    vector<vector<double>> vD(nbT, vector<double>(n));
+    for (auto& D : vD)
+    {
+      for (auto& d : D) { d = RandomTools::giveRandomNumberBetweenZeroAndEntry(1.); }
+    }
+
+    ColMatrix<double> co;
+    double tGeneric = timeIt([&]() {
+      for (const auto& D : vD) { MatrixTools::mult(ca, D, cb, co); }
+    });
+
+    // Warm-up: allocate outputs and packing buffers before timing.
+    DenseMatrix<double> da(ca), db(cb), dO;
+    MatrixTools::mult(da, vD[0], db, dO);
+    double tDense = timeIt([&]() {
+      for (const auto& D : vD) { MatrixTools::mult(da, D, db, dO); }
+    });
+
+    vector<DenseMatrix<double>> vO;
+    MatrixTools::mult(da, vD, db, vO);
+    double tBatch = timeIt([&]() { MatrixTools::mult(da, vD, db, vO); });
+
+    cout << setw(6) << n << setw(8) << nbT << setprecision(3)
+         << setw(14) << tGeneric << setw(14) << tDense << setw(14) << tBatch << endl;
+  }
+  return 0;
+}
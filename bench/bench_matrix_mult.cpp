@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Numeric/Matrix/Matrix.h>
+#include <Bpp/Numeric/Matrix/MatrixKernels.h>
+#include <Bpp/Numeric/Matrix/MatrixTools.h>
+#include <Bpp/Numeric/Random/RandomTools.h>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+// Compare the generic product (through the virtual Matrix interface, here
+// with ColMatrix operands) to the dense kernels with all available
+// instruction sets, on square LinearMatrix<double>.
+
+template<class MatrixType>
+void fillRandom(MatrixType& m)
+{
+  for (size_t i = 0; i < m.getNumberOfRows(); ++i)
+  {
+    for (size_t j = 0; j < m.getNumberOfColumns(); ++j)
+    {
+      m(i, j) = RandomTools::giveRandomNumberBetweenZeroAndEntry(1.);
+    }
+  }
+}
+
+template<class MatrixType>
+double timeMult(const MatrixType& a, const MatrixType& b, MatrixType& o, size_t reps)
+{
+  auto start = chrono::steady_clock::now();
+  for (size_t r = 0; r < reps; ++r)
+  {
+    MatrixTools::mult(a, b, o);
+  }
+  chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+  return elapsed.count() / static_cast<double>(reps);
+}
+
+int main()
+{
+  vector<size_t> sizes = { 20, 32, 61, 100, 200, 400 };
+  vector<MatrixKernels::SimdLevel> levels = { MatrixKernels::SimdLevel::SCALAR };
+  if (MatrixKernels::getSupportedSimdLevel() >= MatrixKernels::SimdLevel::AVX2)
+    levels.push_back(MatrixKernels::SimdLevel::AVX2);
+  if (MatrixKernels::getSupportedSimdLevel() >= MatrixKernels::SimdLevel::AVX512)
+    levels.push_back(MatrixKernels::SimdLevel::AVX512);
+  vector<string> levelNames = { "scalar", "avx2", "avx512" };
+
+  cout << setw(6) << "n" << setw(14) << "generic(GF/s)";
+  for (auto level : levels)
+  {
+    cout << setw(14) << levelNames[static_cast<size_t>(level)] + "(GF/s)";
+  }
+  cout << endl;
+
+  for (size_t n : sizes)
+  {
+    double flops = 2. * static_cast<double>(n * n * n);
+    size_t reps = max<size_t>(1, static_cast<size_t>(2e8 / flops));
+
+    ColMatrix<double> ca(n, n), cb(n, n), co;
+    fillRandom(ca);
+    fillRandom(cb);
+    cout << setw(6) << n << setw(14) << setprecision(3) << flops / timeMult(ca, cb, co, reps) * 1e-9;
+
+    LinearMatrix<double> la(ca), lb(cb), lo;
+    for (auto level : levels)
+    {
+      MatrixKernels::setSimdLevel(level);
+      cout << setw(14) << setprecision(3) << flops / timeMult(la, lb, lo, reps) * 1e-9;
+    }
+    MatrixKernels::setSimdLevel(MatrixKernels::getSupportedSimdLevel());
+    cout << endl;
+  }
+  return 0;
+}
@@ -360,6 +360,9 @@ public:
 template<class N, class E>
 using AssociationDAGlobalGraphObserver =  AssociationDAGraphImplObserver<N, E, DAGlobalGraph>;
 
+template<class N, class E>
+using AssociationDACompactGraphObserver =  AssociationDAGraphImplObserver<N, E, DACompactGraph>;
+
 /********************/
 }
 #endif // BPP_GRAPH_ASSOCIATIONDAGRAPHIMPLOBSERVER_H
@@ -12,12 +12,15 @@
 #include <memory>
 #include <ostream>
 #include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "../Clonable.h"
 #include "../Exceptions.h"
 #include "../Text/TextTools.h"
 #include "AssociationGraphObserver.h"
+#include "CompactGraph.h"
 #include "GlobalGraph.h"
 
 namespace bpp
@@ -63,14 +66,15 @@ private:
   std::vector<Eref> graphidToE_;
 
   /**
-   * Can find a Node with the corresponding object.
+   * Can find a Node with the corresponding object. Objects are
+   * hashed on their address, so that lookups are in constant time.
    */
-  std::map<Nref, NodeGraphid> NToGraphid_;
+  std::unordered_map<Nref, NodeGraphid> NToGraphid_;
 
   /**
    * Can find an Edge with the corresponding object.
    */
-  std::map<Eref, EdgeGraphid> EToGraphid_;
+  std::unordered_map<Eref, EdgeGraphid> EToGraphid_;
 
   /*
    * @}
@@ -95,12 +99,12 @@ private:
   /**
    * Can find a Node index with the corresponding object.
    */
-  std::map<Nref, NodeIndex> NToIndex_;
+  std::unordered_map<Nref, NodeIndex> NToIndex_;
 
   /**
    * Can find an Edge index with the corresponding object.
    */
-  std::map<Eref, EdgeIndex> EToIndex_;
+  std::unordered_map<Eref, EdgeIndex> EToIndex_;
 
   /*
    * @}
@@ -166,6 +170,8 @@ public:
     NToIndex_(),
     EToIndex_()
   {
+    NToGraphid_.reserve(graphObserver.NToGraphid_.size());
+    EToGraphid_.reserve(graphObserver.EToGraphid_.size());
     for (const auto& itN:graphObserver.NToGraphid_)
     {
       Nref node(AssociationGraphObserver<N, E>::template copy<N2, N>(*itN.first));
@@ -212,6 +218,8 @@ public:
     NToIndex_(),
     EToIndex_()
   {
+    NToGraphid_.reserve(graphObserver.NToGraphid_.size());
+    EToGraphid_.reserve(graphObserver.EToGraphid_.size());
     for (const auto& itN:graphObserver.NToGraphid_)
     {
       Nref node(AssociationGraphObserver<N, E>::template copy<N, N>(*itN.first));
@@ -458,6 +466,51 @@ public:
     link(objectOriginNode, newNodeObject, newEdgeObject);
   }
 
+  /**
+   * Creates nodes and the links between them in a single operation,
+   * see Graph::createNodesAndEdges().
+   * @param nodeObjects the distinct N objects associated to the new nodes.
+   * @param links pairs (A, B) of positions in nodeObjects to link
+   * together. In a directed graph: A -> B.
+   * @param edgeObjects the optional E objects associated to the links,
+   * in the same order (default: no objects). Null objects are skipped.
+   * @throw Exception if a node object is null, or if an object is
+   * repeated or already in the graph. Nothing is created in this case.
+   */
+  void createNodesAndEdges(const std::vector<Nref>& nodeObjects, const std::vector<std::pair<size_t, size_t>>& links, const std::vector<Eref>& edgeObjects = std::vector<Eref>())
+  {
+    if (!edgeObjects.empty() && edgeObjects.size() != links.size())
+      throw Exception("AssociationGraphImplObserver::createNodesAndEdges : " + TextTools::toString(edgeObjects.size()) + " edge objects for " + TextTools::toString(links.size()) + " links.");
+    std::unordered_set<Nref> newNodes(nodeObjects.size());
+    for (const auto& nodeObject : nodeObjects)
+    {
+      if (!nodeObject)
+        throw Exception("AssociationGraphImplObserver::createNodesAndEdges : null node object.");
+      if (hasNode(nodeObject) || !newNodes.insert(nodeObject).second)
+        throw Exception("AssociationGraphImplObserver::createNodesAndEdges : node repeated or already exists: " + nodeToString(nodeObject));
+    }
+    std::unordered_set<Eref> newEdges(edgeObjects.size());
+    for (const auto& edgeObject : edgeObjects)
+    {
+      if (edgeObject && (hasEdge(edgeObject) || !newEdges.insert(edgeObject).second))
+        throw Exception("AssociationGraphImplObserver::createNodesAndEdges : edge repeated or already exists: " + edgeToString(edgeObject));
+    }
+
+    std::pair<NodeGraphid, EdgeGraphid> first = getGraph()->createNodesAndEdges(nodeObjects.size(), links);
+
+    NToGraphid_.reserve(NToGraphid_.size() + nodeObjects.size());
+    for (size_t i = 0; i < nodeObjects.size(); ++i)
+    {
+      associateNode(nodeObjects[i], first.first + static_cast<NodeGraphid>(i));
+    }
+    EToGraphid_.reserve(EToGraphid_.size() + edgeObjects.size());
+    for (size_t i = 0; i < edgeObjects.size(); ++i)
+    {
+      if (edgeObjects[i])
+        associateEdge(edgeObjects[i], first.second + static_cast<EdgeGraphid>(i));
+    }
+  }
+
 public:
   /**
    * Creates a link between two existing nodes.
@@ -512,10 +565,11 @@ public:
    */
   void deleteNode(Nref nodeObject)
   {
-    // first deleting the node in the graph
+    // first deleting the node in the graph, which tells its observers
     getGraph()->deleteNode(getNodeGraphid(nodeObject));
-    // then forgetting
-    dissociateNode(nodeObject);
+    // then forgetting, if not already done
+    if (hasNode(nodeObject))
+      dissociateNode(nodeObject);
   }
 
 
@@ -572,7 +626,7 @@ public:
    */
   void dissociateNode(Nref nodeObject)
   {
-    typename std::map<Nref, NodeGraphid>::iterator nodeToForget = NToGraphid_.find(nodeObject);
+    auto nodeToForget = NToGraphid_.find(nodeObject);
     graphidToN_.at(nodeToForget->second) = 00;
     NToGraphid_.erase(nodeToForget);
   }
@@ -580,7 +634,7 @@ public:
 
   void dissociateEdge(Eref edgeObject)
   {
-    typename std::map<Eref, EdgeGraphid>::iterator edgeToForget = EToGraphid_.find(edgeObject);
+    auto edgeToForget = EToGraphid_.find(edgeObject);
     graphidToE_.at(edgeToForget->second) = 00;
     EToGraphid_.erase(edgeToForget);
   }
@@ -593,7 +647,7 @@ public:
    */
   NodeGraphid getNodeGraphid(const Nref nodeObject) const
   {
-    typename std::map<Nref, NodeGraphid>::const_iterator found = NToGraphid_.find(nodeObject);
+    const auto found = NToGraphid_.find(nodeObject);
     if (found == NToGraphid_.end())
       throw Exception("Unexisting node object: " + TextTools::toString(nodeObject));
     return found->second;
@@ -607,7 +661,7 @@ public:
    */
   EdgeGraphid getEdgeGraphid(const Eref edgeObject) const
   {
-    typename std::map<Eref, EdgeGraphid>::const_iterator found = EToGraphid_.find(edgeObject);
+    const auto found = EToGraphid_.find(edgeObject);
     if (found == EToGraphid_.end())
       throw Exception("Unexisting edge object: " + TextTools::toString(edgeObject));
     return found->second;
@@ -677,6 +731,86 @@ public:
     return edgeObjects;
   }
 
+  /**
+   * @brief The dense tables of the objects, indexed by graph id.
+   *
+   * Ids without associated object hold a null pointer. The tables
+   * are as long as the highest associated id plus one.
+   */
+  const std::vector<Nref>& getNodesByGraphid() const
+  {
+    return graphidToN_;
+  }
+
+  const std::vector<Eref>& getEdgesByGraphid() const
+  {
+    return graphidToE_;
+  }
+
+  /**
+   * @brief Gather an attribute of all the nodes in an array indexed by graph id.
+   *
+   * The returned array is laid out as the table of getNodesByGraphid(),
+   * so that bulk computations can run over contiguous values.
+   *
+   * @param attribute a function returning the attribute of a node object.
+   * @param missing the value given to the ids without associated node.
+   */
+  template<typename T, class Getter>
+  std::vector<T> gatherNodeAttribute(Getter attribute, T missing = T()) const
+  {
+    std::vector<T> values(graphidToN_.size(), missing);
+    for (size_t id = 0; id < graphidToN_.size(); ++id)
+    {
+      if (graphidToN_[id])
+        values[id] = attribute(*graphidToN_[id]);
+    }
+    return values;
+  }
+
+  template<typename T, class Getter>
+  std::vector<T> gatherEdgeAttribute(Getter attribute, T missing = T()) const
+  {
+    std::vector<T> values(graphidToE_.size(), missing);
+    for (size_t id = 0; id < graphidToE_.size(); ++id)
+    {
+      if (graphidToE_[id])
+        values[id] = attribute(*graphidToE_[id]);
+    }
+    return values;
+  }
+
+  /**
+   * @brief Write back an array indexed by graph id to the node objects.
+   *
+   * @param values an array laid out as the table of getNodesByGraphid().
+   * @param setter a function setting the attribute of a node object from a value.
+   * @throw Exception if the array is shorter than the table.
+   */
+  template<typename T, class Setter>
+  void scatterNodeAttribute(const std::vector<T>& values, Setter setter)
+  {
+    if (values.size() < graphidToN_.size())
+      throw Exception("AssociationGraphImplObserver::scatterNodeAttribute : " + TextTools::toString(values.size()) + " values for " + TextTools::toString(graphidToN_.size()) + " node ids.");
+    for (size_t id = 0; id < graphidToN_.size(); ++id)
+    {
+      if (graphidToN_[id])
+        setter(*graphidToN_[id], values[id]);
+    }
+  }
+
+  template<typename T, class Setter>
+  void scatterEdgeAttribute(const std::vector<T>& values, Setter setter)
+  {
+    if (values.size() < graphidToE_.size())
+      throw Exception("AssociationGraphImplObserver::scatterEdgeAttribute : " + TextTools::toString(values.size()) + " values for " + TextTools::toString(graphidToE_.size()) + " edge ids.");
+    for (size_t id = 0; id < graphidToE_.size(); ++id)
+    {
+      if (graphidToE_[id])
+        setter(*graphidToE_[id], values[id]);
+    }
+  }
+
 
   /**
    * @brief set the root (but no checking, to be used at first construction)
@@ -994,7 +1128,7 @@ public:
     virtual public AssociationGraphObserver<N, E>::NodeIterator
   {
 private:
-    NodesIteratorClass<GraphIterator, is_const> it_;
+    typename GraphImpl::template NodesIterator<GraphIterator, is_const> it_;
     const AssociationGraphImplObserver<N, E, GraphImpl>& agio_;
 
 public:
@@ -1332,7 +1466,7 @@ public:
     public AssociationGraphObserver<N, E>::EdgeIterator
   {
 private:
-    EdgesIteratorClass<GraphIterator, is_const> it_;
+    typename GraphImpl::template EdgesIterator<GraphIterator, is_const> it_;
     const AssociationGraphImplObserver<N, E, GraphImpl>& agio_;
 
 public:
@@ -1570,5 +1704,8 @@ public:
 
 template<class N, class E>
 using AssociationGlobalGraphObserver = AssociationGraphImplObserver<N, E, GlobalGraph>;
+
+template<class N, class E>
+using AssociationCompactGraphObserver = AssociationGraphImplObserver<N, E, CompactGraph>;
 }
 #endif // BPP_GRAPH_ASSOCIATIONGRAPHIMPLOBSERVER_H
@@ -394,5 +394,8 @@ public:
 
 template<class N, class E>
 using AssociationTreeGlobalGraphObserver =  AssociationTreeGraphImplObserver<N, E, TreeGlobalGraph>;
+
+template<class N, class E>
+using AssociationTreeCompactGraphObserver =  AssociationTreeGraphImplObserver<N, E, TreeCompactGraph>;
 }
 #endif // BPP_GRAPH_ASSOCIATIONTREEGRAPHIMPLOBSERVER_H
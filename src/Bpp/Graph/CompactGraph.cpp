@@ -0,0 +1,933 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "../Exceptions.h"
+#include "../Text/TextTools.h"
+#include "CompactGraph.h"
+#include "GraphObserver.h"
+
+using namespace bpp;
+using namespace std;
+
+CompactGraph::CompactGraph(bool directed_p) :
+  directed_(directed_p),
+  observers_(),
+  nodeUsed_(),
+  outgoing_(),
+  incoming_(),
+  edgeUsed_(),
+  edges_(),
+  nbNodes_(0),
+  nbEdges_(0),
+  freeNodes_(),
+  freeEdges_(),
+  root_(0)
+{}
+
+
+CompactGraph::CompactGraph(const CompactGraph& gg) :
+  directed_(gg.directed_),
+  observers_(gg.observers_),
+  nodeUsed_(gg.nodeUsed_),
+  outgoing_(gg.outgoing_),
+  incoming_(gg.incoming_),
+  edgeUsed_(gg.edgeUsed_),
+  edges_(gg.edges_),
+  nbNodes_(gg.nbNodes_),
+  nbEdges_(gg.nbEdges_),
+  freeNodes_(gg.freeNodes_),
+  freeEdges_(gg.freeEdges_),
+  root_(gg.root_)
+{}
+
+CompactGraph& CompactGraph::operator=(const CompactGraph& gg)
+{
+  directed_ = gg.directed_;
+  observers_ = gg.observers_;
+  nodeUsed_ = gg.nodeUsed_;
+  outgoing_ = gg.outgoing_;
+  incoming_ = gg.incoming_;
+  edgeUsed_ = gg.edgeUsed_;
+  edges_ = gg.edges_;
+  nbNodes_ = gg.nbNodes_;
+  nbEdges_ = gg.nbEdges_;
+  freeNodes_ = gg.freeNodes_;
+  freeEdges_ = gg.freeEdges_;
+  root_ = gg.root_;
+
+  return *this;
+}
+
+
+void CompactGraph::nodeMustExist_(const CompactGraph::Node& node, string name) const
+{
+  if (!hasNode_(node))
+    throw Exception("This node must exist: " + TextTools::toString(node) + " as " + name + ".");
+}
+
+void CompactGraph::edgeMustExist_(const CompactGraph::Edge& edge, string name) const
+{
+  if (!hasEdge_(edge))
+    throw Exception("This edge must exist: " + TextTools::toString(edge) + " as " + name + ".");
+}
+
+/**********************************************/
+
+size_t CompactGraph::find_(const adjacencyType& relations, Node node)
+{
+  auto it = lower_bound(relations.begin(), relations.end(), node,
+      [](const pair<Node, Edge>& relation, Node n) { return relation.first < n; });
+  if (it == relations.end() || it->first != node)
+    return relations.size();
+  return static_cast<size_t>(it - relations.begin());
+}
+
+bool CompactGraph::insert_(adjacencyType& relations, Node node, Edge edge)
+{
+  auto it = lower_bound(relations.begin(), relations.end(), node,
+      [](const pair<Node, Edge>& relation, Node n) { return relation.first < n; });
+  if (it != relations.end() && it->first == node)
+    return false;
+  relations.insert(it, make_pair(node, edge));
+  return true;
+}
+
+bool CompactGraph::erase_(adjacencyType& relations, Node node)
+{
+  size_t pos = find_(relations, node);
+  if (pos == relations.size())
+    return false;
+  relations.erase(relations.begin() + static_cast<ptrdiff_t>(pos));
+  return true;
+}
+
+void CompactGraph::addEdge_(Edge edge, Node nodeA, Node nodeB)
+{
+  if (edge >= edgeUsed_.size())
+  {
+    // The skipped ids remain available:
+    for (Edge e = static_cast<Edge>(edgeUsed_.size()); e < edge; ++e)
+    {
+      freeEdges_.push_back(e);
+    }
+    edgeUsed_.resize(edge + 1, false);
+    edges_.resize(edge + 1);
+  }
+  edgeUsed_[edge] = true;
+  edges_[edge] = make_pair(nodeA, nodeB);
+  nbEdges_++;
+}
+
+void CompactGraph::removeEdge_(Edge edge)
+{
+  edgeUsed_[edge] = false;
+  freeEdges_.push_back(edge);
+  nbEdges_--;
+}
+
+/**********************************************/
+
+Graph::EdgeId CompactGraph::link(Graph::NodeId nodeA, Graph::NodeId nodeB)
+{
+  // which ID is available? Ids given explicitly may still be in the free list.
+  while (!freeEdges_.empty() && hasEdge_(freeEdges_.back()))
+  {
+    freeEdges_.pop_back();
+  }
+  Edge edgeID = freeEdges_.empty() ? static_cast<Edge>(edgeUsed_.size()) : freeEdges_.back();
+
+  link(nodeA, nodeB, edgeID);
+  return edgeID;
+}
+
+void CompactGraph::link(Graph::NodeId nodeA, Graph::NodeId nodeB, Graph::EdgeId edgeID)
+{
+  if (hasEdge_(edgeID))
+    throw Exception("CompactGraph::link : already existing edgeId " + TextTools::toString(edgeID));
+  nodeMustExist_(nodeA, "first node");
+  nodeMustExist_(nodeB, "second node");
+
+  if (!insert_(outgoing_[nodeA], nodeB, edgeID))
+    throw Exception("CompactGraph::link : already existing relation " + TextTools::toString(nodeA) + "->" + TextTools::toString(nodeB));
+  insert_(incoming_[nodeB], nodeA, edgeID);
+  if (!directed_)
+  {
+    insert_(outgoing_[nodeB], nodeA, edgeID);
+    insert_(incoming_[nodeA], nodeB, edgeID);
+  }
+
+  if (!freeEdges_.empty() && freeEdges_.back() == edgeID)
+    freeEdges_.pop_back();
+  addEdge_(edgeID, nodeA, nodeB);
+  this->topologyHasChanged_();
+}
+
+vector<Graph::EdgeId> CompactGraph::unlink(Graph::NodeId nodeA, Graph::NodeId nodeB)
+{
+  nodeMustExist_(nodeA, "first node");
+  nodeMustExist_(nodeB, "second node");
+
+  size_t pos = find_(outgoing_[nodeA], nodeB);
+  if (pos == outgoing_[nodeA].size())
+    throw Exception("CompactGraph::unlink : no edge to erase " + TextTools::toString(nodeA) + "->" + TextTools::toString(nodeB));
+  Edge edge = outgoing_[nodeA][pos].second;
+
+  erase_(outgoing_[nodeA], nodeB);
+  erase_(incoming_[nodeB], nodeA);
+  if (!directed_)
+  {
+    erase_(outgoing_[nodeB], nodeA);
+    erase_(incoming_[nodeA], nodeB);
+  }
+  removeEdge_(edge);
+  this->topologyHasChanged_();
+
+  // telling the observers
+  vector<Graph::EdgeId> deletedEdges(1, edge);
+  notifyDeletedEdges(deletedEdges);
+
+  return deletedEdges;
+}
+
+void CompactGraph::switchNodes(Graph::NodeId nodeA, Graph::NodeId nodeB)
+{
+  nodeMustExist_(nodeA, "first node");
+  nodeMustExist_(nodeB, "second node");
+
+  Graph::NodeId father = nodeA, son = nodeB;
+  size_t pos = find_(outgoing_[nodeA], nodeB);
+  if (pos == outgoing_[nodeA].size())
+  {
+    father = nodeB;
+    son = nodeA;
+    pos = find_(outgoing_[nodeB], nodeA);
+    if (pos == outgoing_[nodeB].size())
+      throw Exception("CompactGraph::switchNodes : no edge between nodes " + TextTools::toString(nodeA) + " and " + TextTools::toString(nodeB));
+  }
+  Edge edge = outgoing_[father][pos].second;
+
+  erase_(outgoing_[father], son);
+  erase_(incoming_[son], father);
+  insert_(outgoing_[son], father, edge);
+  insert_(incoming_[father], son, edge);
+
+  edges_[edge] = pair<Node, Node>(son, father);
+
+  this->topologyHasChanged_();
+}
+
+Graph::NodeId CompactGraph::createNode()
+{
+  while (!freeNodes_.empty() && hasNode_(freeNodes_.back()))
+  {
+    freeNodes_.pop_back();
+  }
+
+  Node newNode;
+  if (freeNodes_.empty())
+  {
+    newNode = static_cast<Node>(nodeUsed_.size());
+    nodeUsed_.push_back(true);
+    outgoing_.push_back(adjacencyType());
+    incoming_.push_back(adjacencyType());
+  }
+  else
+  {
+    newNode = freeNodes_.back();
+    freeNodes_.pop_back();
+    nodeUsed_[newNode] = true;
+  }
+  nbNodes_++;
+  this->topologyHasChanged_();
+
+  return newNode;
+}
+
+Graph::NodeId CompactGraph::createNodeFromNode(Graph::NodeId origin)
+{
+  Graph::NodeId newNode = createNode();
+  link(origin, newNode);
+  this->topologyHasChanged_();
+  return newNode;
+}
+
+Graph::NodeId CompactGraph::createNodeOnEdge(Graph::EdgeId edge)
+{
+  // origin must be an existing edge
+  edgeMustExist_(edge, "");
+
+  Graph::NodeId newNode = createNode();
+
+  // determining the nodes on the border of the edge
+  Node nodeA = edges_[edge].first;
+  Node nodeB = edges_[edge].second;
+
+  unlink(nodeA, nodeB);
+  link(nodeA, newNode);
+  link(newNode, nodeB);
+  this->topologyHasChanged_();
+  return newNode;
+}
+
+Graph::NodeId CompactGraph::createNodeFromEdge(Graph::NodeId origin)
+{
+  // origin must be an existing edge
+  edgeMustExist_(origin, "origin edge");
+
+  // splitting the edge
+  Graph::NodeId anchor = createNodeOnEdge(origin);
+
+  Graph::NodeId newNode = createNodeFromNode(anchor);
+  this->topologyHasChanged_();
+  return newNode;
+}
+
+std::pair<Graph::NodeId, Graph::EdgeId> CompactGraph::createNodesAndEdges(size_t nbNodes, const vector<pair<size_t, size_t>>& links)
+{
+  // the new ids are taken at the end, leaving the released ones available
+  Node firstNode = static_cast<Node>(nodeUsed_.size());
+  Edge firstEdge = static_cast<Edge>(edgeUsed_.size());
+
+  // relations of the new nodes, built and checked before touching the graph
+  vector<adjacencyType> outgoing(nbNodes);
+  vector<adjacencyType> incoming(nbNodes);
+  Edge edge = firstEdge;
+  for (const auto& currLink : links)
+  {
+    if (currLink.first >= nbNodes || currLink.second >= nbNodes)
+      throw Exception("CompactGraph::createNodesAndEdges : node rank out of range " + TextTools::toString(max(currLink.first, currLink.second)));
+    Node nodeA = firstNode + static_cast<Node>(currLink.first);
+    Node nodeB = firstNode + static_cast<Node>(currLink.second);
+    outgoing[currLink.first].push_back(make_pair(nodeB, edge));
+    incoming[currLink.second].push_back(make_pair(nodeA, edge));
+    if (!directed_)
+    {
+      outgoing[currLink.second].push_back(make_pair(nodeA, edge));
+      incoming[currLink.first].push_back(make_pair(nodeB, edge));
+    }
+    edge++;
+  }
+  for (size_t i = 0; i < nbNodes; ++i)
+  {
+    sort(outgoing[i].begin(), outgoing[i].end());
+    sort(incoming[i].begin(), incoming[i].end());
+    for (size_t j = 1; j < outgoing[i].size(); ++j)
+    {
+      if (outgoing[i][j].first == outgoing[i][j - 1].first)
+        throw Exception("CompactGraph::createNodesAndEdges : already existing relation " + TextTools::toString(i) + "->" + TextTools::toString(outgoing[i][j].first - firstNode));
+    }
+  }
+
+  nodeUsed_.resize(firstNode + nbNodes, true);
+  outgoing_.reserve(firstNode + nbNodes);
+  incoming_.reserve(firstNode + nbNodes);
+  std::move(outgoing.begin(), outgoing.end(), back_inserter(outgoing_));
+  std::move(incoming.begin(), incoming.end(), back_inserter(incoming_));
+  nbNodes_ += nbNodes;
+
+  edgeUsed_.resize(firstEdge + links.size(), true);
+  edges_.reserve(firstEdge + links.size());
+  for (const auto& currLink : links)
+  {
+    edges_.push_back(make_pair(firstNode + static_cast<Node>(currLink.first), firstNode + static_cast<Node>(currLink.second)));
+  }
+  nbEdges_ += links.size();
+  this->topologyHasChanged_();
+
+  return make_pair(firstNode, firstEdge);
+}
+
+void CompactGraph::isolate_(CompactGraph::Node node)
+{
+  while (!outgoing_[node].empty())
+  {
+    unlink(node, outgoing_[node].back().first);
+  }
+  while (!incoming_[node].empty())
+  {
+    unlink(incoming_[node].back().first, node);
+  }
+}
+
+void CompactGraph::deleteNode(Graph::NodeId node)
+{
+  // checking the node
+  nodeMustExist_(node, "node to delete");
+  isolate_(node);
+
+  nodeUsed_[node] = false;
+  outgoing_[node] = adjacencyType();
+  incoming_[node] = adjacencyType();
+  freeNodes_.push_back(node);
+  nbNodes_--;
+
+  this->topologyHasChanged_();
+
+  // telling the observers, before the id is given to a new node
+  notifyDeletedNodes(vector<Graph::NodeId>(1, node));
+}
+
+/*********************************************/
+
+void CompactGraph::registerObserver(GraphObserver* observer)
+{
+  if (!observers_.insert(observer).second)
+    throw (Exception("This GraphObserver was already an observer of this Graph"));
+}
+
+void CompactGraph::unregisterObserver(GraphObserver* observer)
+{
+  if (!observers_.erase(observer))
+    throw (Exception("This GraphObserver was not an observer of this Graph"));
+}
+
+/**********************************************/
+
+vector<CompactGraph::Node> CompactGraph::getNeighbors_(const CompactGraph::Node& node, bool outgoing) const
+{
+  if (!hasNode_(node))
+    throw (Exception("The requested node is not in the structure."));
+  const adjacencyType& relations = outgoing ? outgoing_[node] : incoming_[node];
+  vector<Node> result(relations.size());
+  for (size_t i = 0; i < relations.size(); ++i)
+  {
+    result[i] = relations[i].first;
+  }
+  return result;
+}
+
+vector<CompactGraph::Edge> CompactGraph::getEdges_(const CompactGraph::Node& node, bool outgoing) const
+{
+  if (!hasNode_(node))
+    throw (Exception("The requested node is not in the structure."));
+  const adjacencyType& relations = outgoing ? outgoing_[node] : incoming_[node];
+  vector<Edge> result(relations.size());
+  for (size_t i = 0; i < relations.size(); ++i)
+  {
+    result[i] = relations[i].second;
+  }
+  return result;
+}
+
+vector<Graph::NodeId> CompactGraph::getIncomingNeighbors(Graph::NodeId node) const
+{
+  return getNeighbors_(node, false);
+}
+
+vector<Graph::EdgeId> CompactGraph::getIncomingEdges(Graph::NodeId node) const
+{
+  return getEdges_(node, false);
+}
+
+vector<Graph::NodeId> CompactGraph::getOutgoingNeighbors(Graph::NodeId node) const
+{
+  return getNeighbors_(node, true);
+}
+
+vector<Graph::EdgeId> CompactGraph::getOutgoingEdges(Graph::NodeId node) const
+{
+  return getEdges_(node, true);
+}
+
+vector<Graph::NodeId> CompactGraph::getNeighbors(Graph::NodeId node) const
+{
+  if (!directed_)
+    return getNeighbors_(node, true);
+  vector<Graph::NodeId> result = getNeighbors_(node, false);
+  for (const auto& relation : outgoing_[node])
+  {
+    result.push_back(relation.first);
+  }
+  return result;
+}
+
+vector<Graph::EdgeId> CompactGraph::getEdges(Graph::NodeId node) const
+{
+  if (!directed_)
+    return getEdges_(node, true);
+  vector<Graph::EdgeId> result = getEdges_(node, false);
+  for (const auto& relation : outgoing_[node])
+  {
+    result.push_back(relation.second);
+  }
+  return result;
+}
+
+std::unique_ptr<Graph::NodeIterator> CompactGraph::allNodesIterator()
+{
+  return std::unique_ptr<Graph::NodeIterator>(new CompactNodesIteratorClass<Graph::ALLGRAPHITER, false>(*this));
+}
+
+std::unique_ptr<Graph::NodeIterator> CompactGraph::allNodesIterator() const
+{
+  return std::unique_ptr<Graph::NodeIterator>(new CompactNodesIteratorClass<Graph::ALLGRAPHITER, true>(*this));
+}
+
+std::unique_ptr<Graph::NodeIterator> CompactGraph::outgoingNeighborNodesIterator(Graph::NodeId node)
+{
+  return std::unique_ptr<Graph::NodeIterator>(new CompactNodesIteratorClass<Graph::OUTGOINGNEIGHBORITER, false>(*this, node));
+}
+
+std::unique_ptr<Graph::NodeIterator> CompactGraph::outgoingNeighborNodesIterator(Graph::NodeId node) const
+{
+  return std::unique_ptr<Graph::NodeIterator>(new CompactNodesIteratorClass<Graph::OUTGOINGNEIGHBORITER, true>(*this, node));
+}
+
+std::unique_ptr<Graph::NodeIterator> CompactGraph::incomingNeighborNodesIterator(Graph::NodeId node)
+{
+  return std::unique_ptr<Graph::NodeIterator>(new CompactNodesIteratorClass<Graph::INCOMINGNEIGHBORITER, false>(*this, node));
+}
+
+std::unique_ptr<Graph::NodeIterator> CompactGraph::incomingNeighborNodesIterator(Graph::NodeId node) const
+{
+  return std::unique_ptr<Graph::NodeIterator>(new CompactNodesIteratorClass<Graph::INCOMINGNEIGHBORITER, true>(*this, node));
+}
+
+std::unique_ptr<Graph::EdgeIterator> CompactGraph::allEdgesIterator()
+{
+  return std::unique_ptr<Graph::EdgeIterator>(new CompactEdgesIteratorClass<Graph::ALLGRAPHITER, false>(*this));
+}
+
+std::unique_ptr<Graph::EdgeIterator> CompactGraph::allEdgesIterator() const
+{
+  return std::unique_ptr<Graph::EdgeIterator>(new CompactEdgesIteratorClass<Graph::ALLGRAPHITER, true>(*this));
+}
+
+std::unique_ptr<Graph::EdgeIterator> CompactGraph::outgoingEdgesIterator(Graph::NodeId node)
+{
+  return std::unique_ptr<Graph::EdgeIterator>(new CompactEdgesIteratorClass<Graph::OUTGOINGNEIGHBORITER, false>(*this, node));
+}
+
+std::unique_ptr<Graph::EdgeIterator> CompactGraph::outgoingEdgesIterator(Graph::NodeId node) const
+{
+  return std::unique_ptr<Graph::EdgeIterator>(new CompactEdgesIteratorClass<Graph::OUTGOINGNEIGHBORITER, true>(*this, node));
+}
+
+std::unique_ptr<Graph::EdgeIterator> CompactGraph::incomingEdgesIterator(Graph::NodeId node)
+{
+  return std::unique_ptr<Graph::EdgeIterator>(new CompactEdgesIteratorClass<Graph::INCOMINGNEIGHBORITER, false>(*this, node));
+}
+
+std::unique_ptr<Graph::EdgeIterator> CompactGraph::incomingEdgesIterator(Graph::NodeId node) const
+{
+  return std::unique_ptr<Graph::EdgeIterator>(new CompactEdgesIteratorClass<Graph::INCOMINGNEIGHBORITER, true>(*this, node));
+}
+
+size_t CompactGraph::getNumberOfNodes() const
+{
+  return nbNodes_;
+}
+
+size_t CompactGraph::getNumberOfEdges() const
+{
+  return nbEdges_;
+}
+
+size_t CompactGraph::getDegree(Graph::NodeId node) const
+{
+  if (!hasNode_(node))
+    throw Exception("CompactGraph::getDegree : Node " + TextTools::toString(node) + " does not exist.");
+
+  return directed_ ? outgoing_[node].size() + incoming_[node].size() : outgoing_[node].size();
+}
+
+bool CompactGraph::isLeaf(Graph::NodeId node) const
+{
+  if (!hasNode_(node))
+    throw Exception("CompactGraph::isLeaf : Node " + TextTools::toString(node) + " does not exist.");
+
+  const adjacencyType& out = outgoing_[node];
+  const adjacencyType& in = incoming_[node];
+  return (!directed_ && (out.size() <= 1))
+         || (directed_ && (
+           (out.size() + in.size() <= 1)
+           || (out.size() == 1 && in.size() == 1 && out.front().first == in.front().first)));
+}
+
+size_t CompactGraph::getNumberOfNeighbors(Graph::NodeId node) const
+{
+  if (!hasNode_(node))
+    throw (Exception("The requested node is not in the structure."));
+  return directed_ ? outgoing_[node].size() + incoming_[node].size() : outgoing_[node].size();
+}
+
+size_t CompactGraph::getNumberOfOutgoingNeighbors(Graph::NodeId node) const
+{
+  if (!hasNode_(node))
+    throw (Exception("The requested node is not in the structure."));
+  return outgoing_[node].size();
+}
+
+size_t CompactGraph::getNumberOfIncomingNeighbors(Graph::NodeId node) const
+{
+  if (!hasNode_(node))
+    throw (Exception("The requested node is not in the structure."));
+  return incoming_[node].size();
+}
+
+std::pair<Graph::NodeId, Graph::NodeId> CompactGraph::getNodes(Graph::EdgeId edge) const
+{
+  edgeMustExist_(edge);
+  return edges_[edge];
+}
+
+Graph::NodeId CompactGraph::getTop(Graph::EdgeId edge) const
+{
+  return getNodes(edge).first;
+}
+
+Graph::NodeId CompactGraph::getBottom(Graph::EdgeId edge) const
+{
+  return getNodes(edge).second;
+}
+
+vector<Graph::EdgeId> CompactGraph::getAllEdges() const
+{
+  vector<Graph::EdgeId> listOfEdges;
+  listOfEdges.reserve(nbEdges_);
+  for (Edge edge = 0; edge < edgeUsed_.size(); ++edge)
+  {
+    if (edgeUsed_[edge])
+      listOfEdges.push_back(edge);
+  }
+  return listOfEdges;
+}
+
+Graph::EdgeId CompactGraph::getEdge(Graph::NodeId nodeA, Graph::NodeId nodeB) const
+{
+  if (!hasNode_(nodeA))
+    throw (Exception("The fist node was not the origin of an edge."));
+  size_t pos = find_(outgoing_[nodeA], nodeB);
+  if (pos == outgoing_[nodeA].size())
+    throw (Exception("The second node was not in a relation with the first one."));
+  return outgoing_[nodeA][pos].second;
+}
+
+Graph::EdgeId CompactGraph::getAnyEdge(Graph::NodeId nodeA, Graph::NodeId nodeB) const
+{
+  if (hasNode_(nodeA))
+  {
+    size_t pos = find_(outgoing_[nodeA], nodeB);
+    if (pos < outgoing_[nodeA].size())
+      return outgoing_[nodeA][pos].second;
+  }
+  return getEdge(nodeB, nodeA);
+}
+
+vector<Graph::NodeId> CompactGraph::getAllLeaves() const
+{
+  vector<Graph::NodeId> listOfLeaves;
+  for (Node node = 0; node < nodeUsed_.size(); ++node)
+  {
+    if (nodeUsed_[node] && isLeaf(node))
+      listOfLeaves.push_back(node);
+  }
+  return listOfLeaves;
+}
+
+set<Graph::NodeId> CompactGraph::getSetOfAllLeaves() const
+{
+  vector<Graph::NodeId> listOfLeaves = getAllLeaves();
+  return set<Graph::NodeId>(listOfLeaves.begin(), listOfLeaves.end());
+}
+
+vector<Graph::NodeId> CompactGraph::getAllNodes() const
+{
+  vector<Graph::NodeId> listOfNodes;
+  listOfNodes.reserve(nbNodes_);
+  for (Node node = 0; node < nodeUsed_.size(); ++node)
+  {
+    if (nodeUsed_[node])
+      listOfNodes.push_back(node);
+  }
+  return listOfNodes;
+}
+
+vector<Graph::NodeId> CompactGraph::getAllInnerNodes() const
+{
+  vector<Graph::NodeId> listOfInNodes;
+  for (Node node = 0; node < nodeUsed_.size(); ++node)
+  {
+    if (nodeUsed_[node] && !outgoing_[node].empty())
+      listOfInNodes.push_back(node);
+  }
+  return listOfInNodes;
+}
+
+void CompactGraph::fillListOfLeaves_(const CompactGraph::Node& startingNode, vector<CompactGraph::Node>& foundLeaves, const CompactGraph::Node& originNode, unsigned int maxRecursions) const
+{
+  const vector<Graph::NodeId> neighbors = getNeighbors(startingNode);
+  if (neighbors.size() > 1)
+  {
+    if (maxRecursions > 0)
+      for (const auto& currNeighbor : neighbors)
+      {
+        if (currNeighbor != originNode)
+          fillListOfLeaves_(currNeighbor, foundLeaves, startingNode, maxRecursions - 1);
+      }
+  }
+  else
+    foundLeaves.push_back(startingNode);
+}
+
+vector<Graph::NodeId> CompactGraph::getLeavesFromNode(Graph::NodeId node, unsigned int maxDepth) const
+{
+  vector<Graph::NodeId> listOfLeaves;
+  fillListOfLeaves_(node, listOfLeaves, node, maxDepth);
+  return listOfLeaves;
+}
+
+/**********************************************/
+
+bool CompactGraph::isTree() const
+{
+  if (!hasNode_(root_))
+    return false;
+
+  // Depth-first search from the root, with (node, origin) pairs:
+  vector<bool> met(nodeUsed_.size(), false);
+  vector<pair<Node, Node>> toVisit(1, make_pair(root_, root_));
+  size_t nbMet = 0;
+  while (!toVisit.empty())
+  {
+    Node node = toVisit.back().first;
+    Node origin = toVisit.back().second;
+    toVisit.pop_back();
+    if (met[node])
+      return false;
+    met[node] = true;
+    nbMet++;
+    for (const auto& relation : outgoing_[node])
+    {
+      if (relation.first != origin)
+        toVisit.push_back(make_pair(relation.first, node));
+    }
+  }
+
+  // now they have only been met at most once, they have to be met at least once
+  return nbMet == nbNodes_;
+}
+
+bool CompactGraph::isDA() const
+{
+  // Algo: remove recursively all nodes with no sons from graph
+  vector<size_t> nbSons(outgoing_.size(), 0);
+  vector<Node> toRemove;
+  for (Node node = 0; node < nodeUsed_.size(); ++node)
+  {
+    if (!nodeUsed_[node])
+      continue;
+    nbSons[node] = outgoing_[node].size();
+    if (nbSons[node] == 0)
+      toRemove.push_back(node);
+  }
+
+  size_t nbRemoved = 0;
+  while (!toRemove.empty())
+  {
+    Node node = toRemove.back();
+    toRemove.pop_back();
+    nbRemoved++;
+    for (const auto& relation : incoming_[node])
+    {
+      if (--nbSons[relation.first] == 0)
+        toRemove.push_back(relation.first);
+    }
+  }
+
+  return nbRemoved == nbNodes_;
+}
+
+void CompactGraph::orientate()
+{
+  if (!isDirected())
+    makeDirected();
+
+  CompactGraph gg(*this);
+  gg.observers_.clear();
+
+  // Algo: remove recursively all nodes from graph, starting with
+  // root_
+
+  std::set<Graph::NodeId> nextNodes;
+  nextNodes.insert(root_);
+
+  while (gg.getNumberOfNodes() != 0 && !nextNodes.empty())
+  {
+    // first node with one neighbor (ie no choice on orientation)
+    std::set<Graph::NodeId>::iterator it = nextNodes.begin();
+    for ( ; it != nextNodes.end(); it++)
+    {
+      if (gg.getNumberOfNeighbors(*it) <= 1)
+        break;
+    }
+
+    // if none, look for node wih minimum number of fathers
+    Graph::NodeId nbgg;
+    if (it == nextNodes.end())
+    {
+      nbgg = *nextNodes.begin();
+      for (auto node : nextNodes)
+      {
+        if (gg.getNumberOfIncomingNeighbors(node) < gg.getNumberOfIncomingNeighbors(nbgg))
+          nbgg = node;
+      }
+    }
+    else
+      nbgg = *it;
+
+    // next orient edges from this node and catch neighbors
+    std::vector<Graph::NodeId> vL = gg.getIncomingNeighbors(nbgg);
+    for (auto& it2 : vL)
+    {
+      switchNodes(nbgg, it2);
+      nextNodes.insert(it2);
+    }
+
+    vL = gg.getOutgoingNeighbors(nbgg);
+    for (auto& it2 : vL)
+    {
+      nextNodes.insert(it2);
+    }
+
+    gg.deleteNode(nbgg);
+    nextNodes.erase(nbgg);
+  }
+}
+
+void CompactGraph::setRoot(Graph::NodeId newRoot)
+{
+  nodeMustExist_(newRoot, "new root");
+  root_ = newRoot;
+}
+
+Graph::NodeId CompactGraph::getRoot() const
+{
+  return root_;
+}
+
+bool CompactGraph::isDirected() const
+{
+  return directed_;
+}
+
+void CompactGraph::makeDirected()
+{
+  if (directed_)
+    return;
+
+  // Each relation A - B is stored as A->B and B->A. The one leaving
+  // the node with the smallest id is kept, as in GlobalGraph. As
+  // nodes are met in increasing order, the lists remain sorted.
+  vector<adjacencyType> undirectedStructure;
+  undirectedStructure.swap(outgoing_);
+  outgoing_.resize(undirectedStructure.size());
+  incoming_.assign(undirectedStructure.size(), adjacencyType());
+  for (Node nodeA = 0; nodeA < undirectedStructure.size(); ++nodeA)
+  {
+    for (const auto& relation : undirectedStructure[nodeA])
+    {
+      Node nodeB = relation.first;
+      if (nodeB < nodeA)
+        continue;
+      outgoing_[nodeA].push_back(relation);
+      incoming_[nodeB].push_back(make_pair(nodeA, relation.second));
+      edges_[relation.second] = make_pair(nodeA, nodeB);
+    }
+  }
+  directed_ = true;
+  this->topologyHasChanged_();
+}
+
+void CompactGraph::makeUndirected()
+{
+  if (!directed_)
+    return;
+  if (containsReciprocalRelations())
+    throw Exception("Cannot make an undirected graph from a directed one containing reciprocal relations.");
+
+  // copy each relation twice, making the reciprocal link
+  for (Node nodeA = 0; nodeA < outgoing_.size(); ++nodeA)
+  {
+    for (const auto& relation : incoming_[nodeA])
+    {
+      insert_(outgoing_[nodeA], relation.first, relation.second);
+    }
+  }
+  incoming_ = outgoing_;
+  directed_ = false;
+  this->topologyHasChanged_();
+}
+
+bool CompactGraph::containsReciprocalRelations() const
+{
+  if (!directed_)
+    throw Exception("Cannot state reciprocal link in an undirected graph.");
+  for (Node nodeA = 0; nodeA < outgoing_.size(); ++nodeA)
+  {
+    for (const auto& relation : outgoing_[nodeA])
+    {
+      Node nodeB = relation.first;
+      if (nodeB != nodeA && find_(outgoing_[nodeB], nodeA) < outgoing_[nodeB].size())
+        return true;
+    }
+  }
+  return false;
+}
+
+/**********************************************/
+
+void CompactGraph::nodeToDot_(const CompactGraph::Node& node, ostream& out, std::set<std::pair<Node, Node>>& alreadyFigured) const
+{
+  out << node;
+  bool flag(false);
+  for (const auto& currChild : outgoing_[node])
+  {
+    if (alreadyFigured.find(pair<Node, Node>(node, currChild.first)) != alreadyFigured.end() || (!directed_ && alreadyFigured.find(pair<Node, Node>(currChild.first, node)) != alreadyFigured.end()))
+      continue;
+    alreadyFigured.insert(pair<Node, Node>(node, currChild.first));
+    if (flag)
+      out << node;
+    out << (directed_ ? " -> " : " -- ");
+    nodeToDot_(currChild.first, out, alreadyFigured);
+    flag = true;
+  }
+  if (!flag)
+    out << ";\n   ";
+}
+
+void CompactGraph::outputToDot(ostream& out, const std::string& name) const
+{
+  out << (directed_ ? "digraph" : "graph") << " " << name << " {\n   ";
+  set<pair<Node, Node>> alreadyFigured;
+  if (hasNode_(root_))
+    nodeToDot_(root_, out, alreadyFigured);
+  for (Node node = 0; node < nodeUsed_.size(); ++node)
+  {
+    if (nodeUsed_[node] && node != root_)
+      nodeToDot_(node, out, alreadyFigured);
+  }
+  out << "\r}" << endl;
+}
+
+void CompactGraph::notifyDeletedEdges(const vector<Graph::EdgeId>& edgesToDelete) const
+{
+  for (auto& currObserver : observers_)
+  {
+    currObserver->deletedEdgesUpdate(edgesToDelete);
+  }
+}
+
+void CompactGraph::notifyDeletedNodes(const vector<Graph::NodeId>& nodesToDelete) const
+{
+  for (auto& currObserver : observers_)
+  {
+    currObserver->deletedNodesUpdate(nodesToDelete);
+  }
+}
@@ -0,0 +1,650 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_GRAPH_COMPACTGRAPH_H
+#define BPP_GRAPH_COMPACTGRAPH_H
+
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../Clonable.h"
+#include "Graph.h"
+
+namespace bpp
+{
+template<class T, bool is_const>
+class CompactNodesIteratorClass;
+
+template<class T, bool is_const>
+class CompactEdgesIteratorClass;
+
+template<bool outgoing>
+class CompactNeighborIteratorClass;
+
+/**
+ * @brief A Graph implementation with dense, id-indexed storage.
+ *
+ * This class offers the same interface as GlobalGraph, and can be
+ * used in its place as the GraphImpl template argument of
+ * TreeGraphImpl, DAGraphImpl and AssociationGraphImplObserver.
+ *
+ * Nodes and edges are stored in arrays indexed by their ids, and the
+ * ids of deleted nodes and edges are recycled through free lists:
+ * contrary to GlobalGraph, a new node or edge may get the id of a
+ * deleted one. Observers are told about deletions before ids are
+ * reused, so that they do not associate objects to recycled ids.
+ * The incoming and outgoing relations of each node are stored in
+ * contiguous arrays sorted by neighbor id, so that neighbors are
+ * visited in the same order as in GlobalGraph, without any tree walk.
+ *
+ * Contrary to GlobalGraph, in an undirected graph the relations are
+ * only reported once by getNeighbors() and getEdges(), and unlink()
+ * removes the relation in both directions.
+ */
+class CompactGraph :
+  public virtual Graph,
+  public virtual Clonable
+{
+public:
+  typedef Graph::NodeId Node;
+  typedef Graph::EdgeId Edge;
+
+  /**
+   * The relations of a node: (neighbor, edge), sorted by neighbor.
+   */
+  typedef std::vector<std::pair<Node, Edge>> adjacencyType;
+
+  /**
+   * @brief Iterators on the nodes and edges of the graph, as used by
+   * AssociationGraphImplObserver.
+   */
+  template<class T, bool is_const>
+  using NodesIterator = CompactNodesIteratorClass<T, is_const>;
+
+  template<class T, bool is_const>
+  using EdgesIterator = CompactEdgesIteratorClass<T, is_const>;
+
+private:
+  /**
+   * is the graph directed
+   */
+  bool directed_;
+
+  /**
+   * List of all the subscribers.
+   */
+  std::set<GraphObserver*> observers_;
+
+  /**
+   * Which node ids are in use.
+   */
+  std::vector<bool> nodeUsed_;
+
+  /**
+   * Outgoing and incoming relations, indexed by node id.
+   * In an undirected graph, both contain all the relations of a node.
+   */
+  std::vector<adjacencyType> outgoing_;
+  std::vector<adjacencyType> incoming_;
+
+  /**
+   * Which edge ids are in use.
+   */
+  std::vector<bool> edgeUsed_;
+
+  /**
+   * Extremities of the edges, indexed by edge id.
+   */
+  std::vector<std::pair<Node, Node>> edges_;
+
+  /**
+   * Number of nodes and edges in use.
+   */
+  size_t nbNodes_;
+  size_t nbEdges_;
+
+  /**
+   * Released ids, available for new nodes and edges.
+   */
+  std::vector<Node> freeNodes_;
+  std::vector<Edge> freeEdges_;
+
+  /**
+   * Usualy the first node of a graph. Used for algorithmic purposes.
+   */
+  Node root_;
+
+  /**
+   * Some types of Graphs need to know if they have been modified
+   * But for a Graph, it does nothing.
+   */
+  virtual void topologyHasChanged_() const
+  {
+    // do nothing: a Graph does not care to be modified
+  }
+
+  bool hasNode_(Node node) const
+  {
+    return node < nodeUsed_.size() && nodeUsed_[node];
+  }
+
+  bool hasEdge_(Edge edge) const
+  {
+    return edge < edgeUsed_.size() && edgeUsed_[edge];
+  }
+
+  /**
+   * Find a neighbor in a list of relations.
+   * @return the position of the relation, or the size of the list if not found.
+   */
+  static size_t find_(const adjacencyType& relations, Node node);
+
+  /**
+   * Insert a relation, keeping the list sorted.
+   * @return false if the neighbor was already in the list.
+   */
+  static bool insert_(adjacencyType& relations, Node node, Edge edge);
+
+  /**
+   * Remove a relation.
+   * @return false if the neighbor was not in the list.
+   */
+  static bool erase_(adjacencyType& relations, Node node);
+
+  /**
+   * Record an edge with a given id, growing the storage if needed.
+   */
+  void addEdge_(Edge edge, Node nodeA, Node nodeB);
+
+  /**
+   * Release an edge id.
+   */
+  void removeEdge_(Edge edge);
+
+protected:
+  /**
+   * Check that a node exists. If not, throw an exception.
+   * @param node node that has to be checked
+   * @param name common name to give to the user in case of failure (eg: "first node")
+   */
+  void nodeMustExist_(const Node& node, std::string name = "") const;
+
+  /**
+   * Check that a edge exists. If not, throw an exception.
+   * @param edge edge that has to be checked
+   * @param name common name to give to the user in case of failure (eg: "first node")
+   */
+  void edgeMustExist_(const Edge& edge, std::string name = "") const;
+
+private:
+  /**
+   * Private version of getIncomingNeighbors or getOutgoingNeighbors.
+   * @param node node to  in or outgoing neighbors
+   * @param outgoing boolean: if true, outgoing; else incoming
+   */
+  std::vector<Node> getNeighbors_(const Node& node, bool outgoing = true) const;
+
+  /**
+   * Private version of getIncomingEdges or getOutgoingEdges.
+   * @param node node to  in or outgoing edges
+   * @param outgoing boolean: if true, outgoing; else incoming
+   */
+  std::vector<Edge> getEdges_(const Node& node, bool outgoing = true) const;
+
+  /**
+   * Separate a node from all its neighbors.
+   * @param node node to isolate
+   */
+  void isolate_(Node node);
+
+  /**
+   * Get leaves from a starting node, filling a vector (private version).
+   * @param startingNode root node
+   * @param foundLeaves a vector containing all the found leaves
+   * @param originNode the node where we come from, not to explore
+   * @param maxRecursions  maximum number of recursion steps
+   */
+  void fillListOfLeaves_(const Node& startingNode, std::vector<Node>& foundLeaves, const Node& originNode, unsigned int maxRecursions) const;
+
+  /**
+   * output a node to DOT format (recursive)
+   */
+  void nodeToDot_(const Node& node, std::ostream& out, std::set<std::pair<Node, Node>>& alreadyFigured) const;
+
+public:
+  /** @name General Management
+   *  Misc & constructors
+   */
+  // /@{
+
+  /**
+   * Constructor
+   * @param directed true if the graph is directed.
+   */
+  CompactGraph(bool directed = false);
+
+  CompactGraph(const CompactGraph& gg);
+
+  CompactGraph& operator=(const CompactGraph& gg);
+
+  CompactGraph* clone() const { return new CompactGraph(*this); }
+
+  ~CompactGraph() {}
+
+protected:
+  /**
+   * set the root node to an existing node. Will not affect the topology.
+   * @param newRoot the new root
+   */
+  void setRoot(Graph::NodeId newRoot);
+
+public:
+  /**
+   * get the root node
+   */
+  Graph::NodeId getRoot() const;
+
+  /**
+   * Make the graph directed. Each relation is kept from the node with
+   * the smallest id, as in GlobalGraph.
+   */
+  void makeDirected();
+
+  /**
+   * Make the graph undirected.
+   * If the directed graph already contains reciprocal relations,
+   * such as A->B and B->A, the method will throw an exception.
+   */
+  void makeUndirected();
+
+  // /@}
+
+  /** @name Relations management
+   *  Modificating the structure of the graph.
+   */
+  // /@{
+
+  /**
+   * Creates an orphaned node, recycling the id of a deleted node if any.
+   * @return the new node
+   */
+  Graph::NodeId createNode();
+
+  /**
+   * Creates a node linked to an existing node.
+   * @param origin existing node. In a directed graph: origin -> newNode.
+   * @return the new node
+   */
+  Graph::NodeId createNodeFromNode(Graph::NodeId origin);
+
+  /**
+   * Creates new node on an existing Edge. A -> B will be A -> N -> B
+   * @param edge existing edge.
+   * @return the new node
+   */
+  Graph::NodeId createNodeOnEdge(Graph::EdgeId edge);
+
+  /**
+   * Creates a node linked to new node, splitting an edge.
+   * @param origin existing edge. In a directed graph: origin -> newNode.
+   * @return the new node
+   */
+  Graph::NodeId createNodeFromEdge(Graph::NodeId origin);
+
+  /**
+   * Creates nodes and the links between them in a single operation.
+   * @param nbNodes the number of nodes to create.
+   * @param links pairs of ranks of the new nodes to link together.
+   * @return the ids of the first new node and of the first new edge.
+   */
+  std::pair<Graph::NodeId, Graph::EdgeId> createNodesAndEdges(size_t nbNodes, const std::vector<std::pair<size_t, size_t>>& links);
+
+protected:
+  /**
+   * Creates a link between two existing nodes. If directed graph: nodeA -> nodeB.
+   * @param nodeA source node (or first node if undirected)
+   * @param nodeB target node (or second node if undirected)
+   * @return the new edge
+   */
+  Graph::EdgeId link(Graph::NodeId nodeA, Graph::NodeId nodeB);
+
+  /**
+   * Sets a link between two existing nodes, using existing edge. If
+   * directed graph: nodeA -> nodeB.
+   * @param nodeA source node (or first node if undirected)
+   * @param nodeB target node (or second node if undirected)
+   * @param edgeID the used edge
+   */
+  void link(Graph::NodeId nodeA, Graph::NodeId nodeB, Graph::EdgeId edgeID);
+
+  /**
+   * Switch the edge  between two existing nodes.
+   *
+   * @param nodeA source node (or first node if undirected)
+   * @param nodeB target node (or second node if undirected)
+   */
+  void switchNodes(Graph::NodeId nodeA, Graph::NodeId nodeB);
+
+  /**
+   * Remove all links between two existing nodes. If directed graph: nodeA -> nodeB.
+   * @param nodeA source node (or first node if undirected)
+   * @param nodeB target node (or second node if undirected)
+   * @return vector of deleted edges
+   */
+  std::vector<Graph::EdgeId> unlink(Graph::NodeId nodeA, Graph::NodeId nodeB);
+
+public:
+  /**
+   * Delete one node. Its id may be reused by a later node.
+   * @param node node to be deleted
+   */
+  void deleteNode(Graph::NodeId node);
+
+  // /@}
+
+  /** @name Observers Management
+   *  Managing communication with the observers: subscribe, unsubscribe.
+   */
+  // /@{
+
+  void registerObserver(GraphObserver* observer);
+
+  void unregisterObserver(GraphObserver* observer);
+
+  // /@}
+
+  /** @name Nodes Functions
+   *  These methodes of the graph concern the node management.
+   */
+  // /@{
+
+  template<typename T, bool is_const>
+  friend class CompactNodesIteratorClass;
+
+  template<typename T, bool is_const>
+  friend class CompactEdgesIteratorClass;
+
+  template<bool outgoing>
+  friend class CompactNeighborIteratorClass;
+
+  std::unique_ptr<Graph::NodeIterator> allNodesIterator();
+  std::unique_ptr<Graph::NodeIterator> allNodesIterator() const;
+
+  std::unique_ptr<Graph::NodeIterator> outgoingNeighborNodesIterator(NodeId node);
+  std::unique_ptr<Graph::NodeIterator> outgoingNeighborNodesIterator(NodeId node) const;
+
+  std::unique_ptr<Graph::NodeIterator> incomingNeighborNodesIterator(NodeId node);
+  std::unique_ptr<Graph::NodeIterator> incomingNeighborNodesIterator(NodeId node) const;
+
+  size_t getNumberOfNodes() const;
+
+  size_t getNumberOfEdges() const;
+
+  size_t getDegree(Graph::NodeId node) const;
+
+  bool isLeaf(Graph::NodeId node) const;
+
+  size_t getNumberOfNeighbors(Graph::NodeId node) const;
+
+  size_t getNumberOfOutgoingNeighbors(Graph::NodeId node) const;
+
+  size_t getNumberOfIncomingNeighbors(Graph::NodeId node) const;
+
+  std::vector<Graph::NodeId> getNeighbors(Graph::NodeId node) const;
+
+  std::vector<Graph::NodeId> getOutgoingNeighbors(Graph::NodeId node) const;
+
+  std::vector<Graph::NodeId> getIncomingNeighbors(Graph::NodeId node) const;
+
+  std::vector<Graph::NodeId> getLeavesFromNode(Graph::NodeId node, unsigned int maxDepth) const;
+
+  std::vector<Graph::NodeId> getAllLeaves() const;
+  std::set<NodeId> getSetOfAllLeaves() const;
+
+  std::vector<Graph::NodeId> getAllNodes() const;
+
+  std::vector<Graph::NodeId> getAllInnerNodes() const;
+
+  std::pair<Graph::NodeId, Graph::NodeId> getNodes(Graph::EdgeId edge) const;
+
+  Graph::NodeId getTop(Graph::EdgeId edge) const;
+
+  Graph::NodeId getBottom(Graph::EdgeId edge) const;
+
+  // /@}
+
+  /** @name Topological Properties
+   *  These methodes check some topological properties.
+   */
+  // /@{
+
+  /**
+   * Is the graph a tree? The graph is browsed iteratively from the
+   * root, so that deep trees do not exhaust the stack.
+   * @return false if a node is met more than one time browsing the graph
+   */
+  bool isTree() const;
+
+  /**
+   * Is the graph directed acyclic?
+   * Nodes without sons are removed in topological order.
+   */
+  bool isDA() const;
+
+  /**
+   * Orientates the graph hanging from the root
+   */
+  void orientate();
+
+  bool isDirected() const;
+
+  bool containsReciprocalRelations() const;
+
+  // /@}
+
+  std::unique_ptr<EdgeIterator> allEdgesIterator();
+  std::unique_ptr<EdgeIterator> allEdgesIterator() const;
+
+  std::unique_ptr<EdgeIterator> outgoingEdgesIterator(NodeId node);
+  std::unique_ptr<EdgeIterator> outgoingEdgesIterator(NodeId node) const;
+
+  std::unique_ptr<EdgeIterator> incomingEdgesIterator(NodeId node);
+  std::unique_ptr<EdgeIterator> incomingEdgesIterator(NodeId node) const;
+
+  std::vector<Graph::EdgeId> getEdges(Graph::NodeId node) const;
+
+  std::vector<Graph::EdgeId> getOutgoingEdges(Graph::NodeId node) const;
+
+  std::vector<Graph::EdgeId> getIncomingEdges(Graph::NodeId node) const;
+
+  Graph::EdgeId getEdge(Graph::NodeId nodeA, Graph::NodeId nodeB) const;
+
+  Graph::EdgeId getAnyEdge(Graph::NodeId nodeA, Graph::NodeId nodeB) const;
+
+  std::vector<Graph::EdgeId> getAllEdges() const;
+
+  /** @name Updating the changes on the observers
+   *  These methodes aim to trigger some changes to the observers
+   */
+  // /@{
+
+  void notifyDeletedEdges(const std::vector<Graph::EdgeId>& edgesToDelete) const;
+
+  void notifyDeletedNodes(const std::vector<Graph::NodeId>& nodesToDelete) const;
+
+  // /@}
+
+  void outputToDot(std::ostream& out, const std::string& name) const;
+
+  template<class N, class E, class GraphImpl>
+  friend class AssociationGraphImplObserver;
+};
+
+
+/************************************************/
+/* ITERATORS */
+/************************************************/
+
+template<class T, bool is_const>
+class CompactNodesIteratorClass :
+  virtual public Graph::NodeIterator
+{};
+
+template<bool is_const>
+class CompactNodesIteratorClass<Graph::ALLGRAPHITER, is_const> :
+  virtual public Graph::NodeIterator
+{
+private:
+  const CompactGraph& gg_;
+  CompactGraph::Node pos_;
+
+public:
+  CompactNodesIteratorClass(const CompactGraph& gg) : gg_(gg), pos_(0) { start(); }
+
+  void next()
+  {
+    pos_++;
+    while (pos_ < gg_.nodeUsed_.size() && !gg_.nodeUsed_[pos_])
+      pos_++;
+  }
+  bool end() const { return pos_ >= gg_.nodeUsed_.size(); }
+  void start()
+  {
+    pos_ = 0;
+    while (pos_ < gg_.nodeUsed_.size() && !gg_.nodeUsed_[pos_])
+      pos_++;
+  }
+
+  Graph::NodeId operator*() { return pos_; }
+};
+
+/**
+ * @brief Iterator on the relations of a node.
+ *
+ * The relations are looked up at each step, so that the iterator is
+ * not invalidated when nodes are added to the graph.
+ */
+template<bool outgoing>
+class CompactNeighborIteratorClass
+{
+protected:
+  const CompactGraph::adjacencyType& relations_() const
+  {
+    return outgoing ? gg_.outgoing_[node_] : gg_.incoming_[node_];
+  }
+
+  const CompactGraph& gg_;
+  CompactGraph::Node node_;
+  size_t pos_;
+
+public:
+  CompactNeighborIteratorClass(const CompactGraph& gg, CompactGraph::Node node) :
+    gg_(gg), node_(node), pos_(0)
+  {
+    gg.nodeMustExist_(node, "iterated node");
+  }
+
+  virtual ~CompactNeighborIteratorClass() {}
+
+  void next() { pos_++; }
+  bool end() const { return pos_ >= relations_().size(); }
+  void start() { pos_ = 0; }
+};
+
+template<bool is_const>
+class CompactNodesIteratorClass<Graph::OUTGOINGNEIGHBORITER, is_const> :
+  public CompactNeighborIteratorClass<true>,
+  virtual public Graph::NodeIterator
+{
+public:
+  CompactNodesIteratorClass(const CompactGraph& gg, CompactGraph::Node node) : CompactNeighborIteratorClass<true>(gg, node) {}
+
+  void next() { CompactNeighborIteratorClass<true>::next(); }
+  bool end() const { return CompactNeighborIteratorClass<true>::end(); }
+  void start() { CompactNeighborIteratorClass<true>::start(); }
+
+  Graph::NodeId operator*() { return relations_()[pos_].first; }
+};
+
+template<bool is_const>
+class CompactNodesIteratorClass<Graph::INCOMINGNEIGHBORITER, is_const> :
+  public CompactNeighborIteratorClass<false>,
+  virtual public Graph::NodeIterator
+{
+public:
+  CompactNodesIteratorClass(const CompactGraph& gg, CompactGraph::Node node) : CompactNeighborIteratorClass<false>(gg, node) {}
+
+  void next() { CompactNeighborIteratorClass<false>::next(); }
+  bool end() const { return CompactNeighborIteratorClass<false>::end(); }
+  void start() { CompactNeighborIteratorClass<false>::start(); }
+
+  Graph::NodeId operator*() { return relations_()[pos_].first; }
+};
+
+template<class T, bool is_const>
+class CompactEdgesIteratorClass :
+  virtual public Graph::EdgeIterator
+{};
+
+template<bool is_const>
+class CompactEdgesIteratorClass<Graph::ALLGRAPHITER, is_const> :
+  virtual public Graph::EdgeIterator
+{
+private:
+  const CompactGraph& gg_;
+  CompactGraph::Edge pos_;
+
+public:
+  CompactEdgesIteratorClass(const CompactGraph& gg) : gg_(gg), pos_(0) { start(); }
+
+  void next()
+  {
+    pos_++;
+    while (pos_ < gg_.edgeUsed_.size() && !gg_.edgeUsed_[pos_])
+      pos_++;
+  }
+  bool end() const { return pos_ >= gg_.edgeUsed_.size(); }
+  void start()
+  {
+    pos_ = 0;
+    while (pos_ < gg_.edgeUsed_.size() && !gg_.edgeUsed_[pos_])
+      pos_++;
+  }
+
+  Graph::EdgeId operator*() { return pos_; }
+};
+
+template<bool is_const>
+class CompactEdgesIteratorClass<Graph::OUTGOINGNEIGHBORITER, is_const> :
+  public CompactNeighborIteratorClass<true>,
+  public Graph::EdgeIterator
+{
+public:
+  CompactEdgesIteratorClass(const CompactGraph& gg, CompactGraph::Node node) : CompactNeighborIteratorClass<true>(gg, node) {}
+
+  void next() { CompactNeighborIteratorClass<true>::next(); }
+  bool end() const { return CompactNeighborIteratorClass<true>::end(); }
+  void start() { CompactNeighborIteratorClass<true>::start(); }
+
+  Graph::EdgeId operator*() { return relations_()[pos_].second; }
+};
+
+template<bool is_const>
+class CompactEdgesIteratorClass<Graph::INCOMINGNEIGHBORITER, is_const> :
+  public CompactNeighborIteratorClass<false>,
+  public Graph::EdgeIterator
+{
+public:
+  CompactEdgesIteratorClass(const CompactGraph& gg, CompactGraph::Node node) : CompactNeighborIteratorClass<false>(gg, node) {}
+
+  void next() { CompactNeighborIteratorClass<false>::next(); }
+  bool end() const { return CompactNeighborIteratorClass<false>::end(); }
+  void start() { CompactNeighborIteratorClass<false>::start(); }
+
+  Graph::EdgeId operator*() { return relations_()[pos_].second; }
+};
+}
+#endif // BPP_GRAPH_COMPACTGRAPH_H
@@ -13,6 +13,7 @@
 #include "../Exceptions.h"
 #include "../Numeric/VectorTools.h"
 #include "DAGraph.h"
+#include "CompactGraph.h"
 #include "GlobalGraph.h"
 
 namespace bpp
@@ -207,6 +208,8 @@ public:
 
 typedef DAGraphImpl<GlobalGraph> DAGlobalGraph;
 
+typedef DAGraphImpl<CompactGraph> DACompactGraph;
+
 /*****************/
 
 
@@ -266,6 +266,52 @@ Graph::NodeId GlobalGraph::createNodeFromEdge(Graph::NodeId origin)
   return newNode;
 }
 
+std::pair<Graph::NodeId, Graph::EdgeId> GlobalGraph::createNodesAndEdges(size_t nbNodes, const vector<pair<size_t, size_t>>& links)
+{
+  // ids after all the existing ones, so that the new entries go at the end of the maps
+  GlobalGraph::Node firstNode = highestNodeID_;
+  if (!nodeStructure_.empty() && nodeStructure_.rbegin()->first >= firstNode)
+    firstNode = nodeStructure_.rbegin()->first + 1;
+  GlobalGraph::Edge firstEdge = highestEdgeID_;
+  if (!edgeStructure_.empty() && edgeStructure_.rbegin()->first >= firstEdge)
+    firstEdge = edgeStructure_.rbegin()->first + 1;
+
+  // relations of the new nodes, built and checked before touching the graph
+  vector<pair<map<GlobalGraph::Node, GlobalGraph::Edge>, map<GlobalGraph::Node, GlobalGraph::Edge>>> relations(nbNodes);
+  GlobalGraph::Edge edge = firstEdge;
+  for (const auto& currLink : links)
+  {
+    if (currLink.first >= nbNodes || currLink.second >= nbNodes)
+      throw Exception("GlobalGraph::createNodesAndEdges : node rank out of range " + TextTools::toString(max(currLink.first, currLink.second)));
+    GlobalGraph::Node nodeA = firstNode + static_cast<GlobalGraph::Node>(currLink.first);
+    GlobalGraph::Node nodeB = firstNode + static_cast<GlobalGraph::Node>(currLink.second);
+    if (!relations[currLink.first].first.emplace(nodeB, edge).second)
+      throw Exception("GlobalGraph::createNodesAndEdges : already existing relation " + TextTools::toString(currLink.first) + "->" + TextTools::toString(currLink.second));
+    relations[currLink.second].second.emplace(nodeA, edge);
+    if (!directed_)
+    {
+      relations[currLink.second].first.emplace(nodeA, edge);
+      relations[currLink.first].second.emplace(nodeB, edge);
+    }
+    edge++;
+  }
+
+  for (size_t i = 0; i < nbNodes; ++i)
+  {
+    nodeStructure_.emplace_hint(nodeStructure_.end(), firstNode + static_cast<GlobalGraph::Node>(i), std::move(relations[i]));
+  }
+  edge = firstEdge;
+  for (const auto& currLink : links)
+  {
+    edgeStructure_.emplace_hint(edgeStructure_.end(), edge++, make_pair(firstNode + static_cast<GlobalGraph::Node>(currLink.first), firstNode + static_cast<GlobalGraph::Node>(currLink.second)));
+  }
+  highestNodeID_ = firstNode + static_cast<GlobalGraph::Node>(nbNodes);
+  highestEdgeID_ = edge;
+  this->topologyHasChanged_();
+
+  return make_pair(firstNode, firstEdge);
+}
+
 /*********************************************/
 
 void GlobalGraph::registerObserver(GraphObserver* observer)
@@ -475,6 +521,9 @@ void GlobalGraph::deleteNode(Graph::NodeId node)
   nodeStructure_.erase(found);
 
   this->topologyHasChanged_();
+
+  // telling the observers
+  notifyDeletedNodes(vector<Graph::NodeId>(1, node));
 }
 
 void GlobalGraph::isolate_(GlobalGraph::Node& node)
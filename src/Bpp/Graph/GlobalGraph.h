@@ -15,6 +15,12 @@
 
 namespace bpp
 {
+template<class T, bool is_const>
+class NodesIteratorClass;
+
+template<class T, bool is_const>
+class EdgesIteratorClass;
+
 class GlobalGraph :
   public virtual Graph,
   public virtual Clonable
@@ -44,6 +50,16 @@ public:
    */
   typedef std::map<Edge, std::pair<Node, Node>> edgeStructureType;
 
+  /**
+   * @brief Iterators on the nodes and edges of the graph, as used by
+   * AssociationGraphImplObserver.
+   */
+  template<class T, bool is_const>
+  using NodesIterator = NodesIteratorClass<T, is_const>;
+
+  template<class T, bool is_const>
+  using EdgesIterator = EdgesIteratorClass<T, is_const>;
+
 private:
   /**
    * is the graph directed
@@ -298,6 +314,15 @@ public:
 
   Graph::NodeId createNodeFromEdge(Graph::NodeId origin);
 
+  /**
+   * Creates nodes and the links between them in a single operation.
+   * @param nbNodes the number of nodes to create.
+   * @param links pairs of ranks of the new nodes to link together.
+   * @return the ids of the first new node and of the first new edge.
+   */
+
+  std::pair<Graph::NodeId, Graph::EdgeId> createNodesAndEdges(size_t nbNodes, const std::vector<std::pair<size_t, size_t>>& links);
+
 protected:
   /**
    * Creates a link between two existing nodes. If directed graph: nodeA -> nodeB.
@@ -14,6 +14,8 @@
 #include <utility>
 #include <vector>
 
+#include "../Exceptions.h"
+#include "../Text/TextTools.h"
 
 // forward declaration to avoid circular dependancies.
 // since we do not need its size in this header file (only using pointers to it)
@@ -113,6 +115,49 @@ public:
 
   virtual NodeId createNodeFromEdge(NodeId origin) = 0;
 
+  /**
+   * @brief Creates nodes and the links between them in a single operation.
+   *
+   * The new nodes get consecutive ids, as do the new edges, in the
+   * order of the links. The links are checked before anything is
+   * created, and the change of topology is signalled only once.
+   *
+   * The default implementation only checks the ranks beforehand, then
+   * calls createNode() and link() for each node and link: it must be
+   * overridden by graphs which do not hand out consecutive ids.
+   *
+   * @param nbNodes the number of nodes to create.
+   * @param links pairs (A, B) of ranks of the new nodes, in [0, nbNodes),
+   *   to link together. In a directed graph: A -> B.
+   * @return the ids of the first new node and of the first new edge.
+   */
+  virtual std::pair<NodeId, EdgeId> createNodesAndEdges(size_t nbNodes, const std::vector<std::pair<size_t, size_t>>& links)
+  {
+    for (const auto& currLink : links)
+    {
+      if (currLink.first >= nbNodes || currLink.second >= nbNodes)
+        throw Exception("Graph::createNodesAndEdges : node rank out of range " + TextTools::toString(std::max(currLink.first, currLink.second)));
+    }
+    std::pair<NodeId, EdgeId> first(0, 0);
+    for (size_t i = 0; i < nbNodes; ++i)
+    {
+      NodeId node = createNode();
+      if (i == 0)
+        first.first = node;
+      else if (node != first.first + static_cast<NodeId>(i))
+        throw Exception("Graph::createNodesAndEdges : node ids are not consecutive, this method must be overridden.");
+    }
+    for (size_t i = 0; i < links.size(); ++i)
+    {
+      EdgeId edge = link(first.first + static_cast<NodeId>(links[i].first), first.first + static_cast<NodeId>(links[i].second));
+      if (i == 0)
+        first.second = edge;
+      else if (edge != first.second + static_cast<EdgeId>(i))
+        throw Exception("Graph::createNodesAndEdges : edge ids are not consecutive, this method must be overridden.");
+    }
+    return first;
+  }
+
 protected:
   /**
    * Creates a link between two existing nodes. If directed graph: nodeA -> nodeB.
@@ -144,7 +189,8 @@ protected:
 
 public:
   /**
-   * Delete one node
+   * Delete one node, after unlinking it. The observers are told about
+   * the deleted edges and node.
    * @param node node to be deleted
    */
 
@@ -5,13 +5,18 @@
 #ifndef BPP_GRAPH_TREEGRAPHIMPL_H
 #define BPP_GRAPH_TREEGRAPHIMPL_H
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <limits>
+#include <mutex>
 #include <ostream>
 #include <string>
 #include <vector>
 
 #include "../Exceptions.h"
 #include "../Numeric/VectorTools.h"
+#include "CompactGraph.h"
 #include "GlobalGraph.h"
 #include "TreeGraph.h"
 
@@ -28,9 +33,53 @@ private:
    */
   mutable bool isValid_;
 
+  /**
+   * Traversals of the rooted tree, computed once by computeTraversals_()
+   * and discarded when the topology or the root changes. They are computed
+   * under cacheMutex_, so that const queries can be made concurrently.
+   *
+   * traversalRoot_ is the root they were computed from, or noRoot_ if
+   * they must be computed again. It is set once they are complete.
+   */
+  static constexpr Graph::NodeId noRoot_ = std::numeric_limits<Graph::NodeId>::max();
+  mutable std::mutex cacheMutex_;
+  mutable std::atomic<Graph::NodeId> traversalRoot_;
+  mutable std::vector<Graph::NodeId> preOrder_;
+  mutable std::vector<Graph::NodeId> postOrder_;
+  mutable std::vector<Graph::NodeId> levelOrder_;
+
+  /**
+   * Indexed by node id: position in preOrder_, size of the subtree,
+   * depth, father and branch leading to the father.
+   */
+  mutable std::vector<size_t> preOrderRank_;
+  mutable std::vector<size_t> subtreeSize_;
+  mutable std::vector<size_t> depth_;
+  mutable std::vector<Graph::NodeId> father_;
+  mutable std::vector<Graph::EdgeId> fatherEdge_;
+
+  /**
+   * Index for lowest common ancestor queries: sparse table of the
+   * shallowest node in ranges of preOrder_. lcaTable_[k][i] is the
+   * shallowest node among preOrder_[i], ..., preOrder_[i + 2^(k+1) - 1].
+   * Like the traversals, it is built under cacheMutex_.
+   */
+  bool useLCAIndex_;
+  mutable std::atomic<bool> lcaIndexIsValid_;
+  mutable std::vector<std::vector<Graph::NodeId>> lcaTable_;
+
   // unvalidate the tree
   void topologyHasChanged_() const;
 
+  // compute the traversals if needed
+  void computeTraversals_() const;
+
+  // compute the LCA index if needed
+  void computeLCAIndex_() const;
+
+  // shallowest node among preOrder_[begin], ..., preOrder_[end]
+  Graph::NodeId getShallowestNode_(size_t begin, size_t end) const;
+
   // will throw an exception if the tree is not valid
   void mustBeValid_() const;
 
@@ -46,20 +95,15 @@ private:
    */
   void propagateDirection_(Graph::NodeId node);
 
-  // recursive function for getSubtreeNodes
-  void fillSubtreeMetNodes_(std::vector<Graph::NodeId>& metNodes, Graph::NodeId localRoot) const;
-
-  // recursive function for getSubtreeEdges
-  void fillSubtreeMetEdges_(std::vector<Graph::EdgeId>& metEdges, Graph::NodeId localRoot) const;
-
-  // recursive function for getLeavesUnderNode
-  void fillListOfLeaves_(Graph::NodeId startingNode, std::vector<Graph::NodeId>& foundLeaves) const;
-
 public:
   TreeGraphImpl();
 
   TreeGraphImpl(bool rooted = true);
 
+  TreeGraphImpl(const TreeGraphImpl& tree);
+
+  TreeGraphImpl& operator=(const TreeGraphImpl& tree);
+
   /**
    * Is the graph a tree? A tree must be acyclic and with no isolated node.
    * @return true if valid tree
@@ -157,6 +201,17 @@ public:
 
   void addSon(Graph::NodeId node, Graph::NodeId sonNode, Graph::EdgeId edgeId);
 
+  /**
+   * @brief Build a rooted tree in a single operation from an array of fathers.
+   *
+   * The tree must be empty. Node i is a son of node fathers[i], and
+   * the root is the only node which is its own father. The array is
+   * checked in linear time, so that the tree needs no further validation.
+   *
+   * @return the ids of the new nodes, in the order of the array.
+   */
+  std::vector<Graph::NodeId> createTreeFromFathers(const std::vector<size_t>& fathers);
+
   /**
    * Remove all the sons
    */
@@ -202,6 +257,36 @@ public:
 
   std::vector<Graph::EdgeId> getSubtreeEdges(Graph::NodeId localRoot) const;
 
+  /**
+   * @name Traversals of a rooted tree.
+   *
+   * The orders are computed once for a given topology and root, and
+   * the returned references remain valid until the tree is modified.
+   * Sons are visited in the same order as in getSons().
+   *
+   * They can be queried from several threads at once, but not while
+   * the tree is modified.
+   *
+   * @{
+   */
+
+  /**
+   * @brief Nodes in pre-order: fathers before their sons.
+   */
+  const std::vector<Graph::NodeId>& getPreOrder() const;
+
+  /**
+   * @brief Nodes in post-order: sons before their fathers.
+   */
+  const std::vector<Graph::NodeId>& getPostOrder() const;
+
+  /**
+   * @brief Nodes in level-order: by increasing depth from the root.
+   */
+  const std::vector<Graph::NodeId>& getLevelOrder() const;
+
+  /** @} */
+
   // ///FROM TREETOOLS & TREETOOLS COMPAT
 
 
@@ -215,6 +300,25 @@ public:
    */
 
   Graph::NodeId MRCA(const std::vector<Graph::NodeId>& nodes) const;
+
+  /**
+   * @brief Use an index for MRCA and path queries.
+   *
+   * The index is a sparse table over the pre-order traversal, built
+   * lazily in O(n log n) after each change of the tree. It answers
+   * pairwise LCA queries in constant time, MRCA queries on k nodes in
+   * O(k), and path queries in time proportional to the path length.
+   * The tree must be valid and rooted.
+   */
+  void useLCAIndex(bool yn) { useLCAIndex_ = yn; }
+
+  bool usesLCAIndex() const { return useLCAIndex_; }
+
+  /**
+   * @brief Get the lowest common ancestor of two nodes, using the LCA
+   * index even if it is not used by the other queries.
+   */
+  Graph::NodeId getLCA(Graph::NodeId nodeA, Graph::NodeId nodeB) const;
 };
 
 
@@ -222,15 +326,61 @@ public:
 
 typedef TreeGraphImpl<GlobalGraph> TreeGlobalGraph;
 
+typedef TreeGraphImpl<CompactGraph> TreeCompactGraph;
+
 /*****************/
 
 
 template<class GraphImpl>
 TreeGraphImpl<GraphImpl>::TreeGraphImpl(bool rooted) :
   GraphImpl(rooted),
-  isValid_(false)
+  isValid_(false),
+  cacheMutex_(),
+  traversalRoot_(noRoot_),
+  preOrder_(),
+  postOrder_(),
+  levelOrder_(),
+  preOrderRank_(),
+  subtreeSize_(),
+  depth_(),
+  father_(),
+  fatherEdge_(),
+  useLCAIndex_(false),
+  lcaIndexIsValid_(false),
+  lcaTable_()
+{}
+
+template<class GraphImpl>
+TreeGraphImpl<GraphImpl>::TreeGraphImpl(const TreeGraphImpl& tree) :
+  GraphImpl(tree),
+  isValid_(tree.isValid_),
+  cacheMutex_(),
+  traversalRoot_(noRoot_),
+  preOrder_(),
+  postOrder_(),
+  levelOrder_(),
+  preOrderRank_(),
+  subtreeSize_(),
+  depth_(),
+  father_(),
+  fatherEdge_(),
+  useLCAIndex_(tree.useLCAIndex_),
+  lcaIndexIsValid_(false),
+  lcaTable_()
 {}
 
+template<class GraphImpl>
+TreeGraphImpl<GraphImpl>& TreeGraphImpl<GraphImpl>::operator=(const TreeGraphImpl& tree)
+{
+  GraphImpl::operator=(tree);
+  isValid_ = tree.isValid_;
+  useLCAIndex_ = tree.useLCAIndex_;
+  // The traversals are computed again when needed:
+  traversalRoot_ = noRoot_;
+  lcaIndexIsValid_ = false;
+  return *this;
+}
+
 
 template<class GraphImpl>
 bool TreeGraphImpl<GraphImpl>::isValid() const
@@ -270,28 +420,23 @@ bool TreeGraphImpl<GraphImpl>::isLeaf(Graph::NodeId node) const
 }
 
 template<class GraphImpl>
-void TreeGraphImpl<GraphImpl>::fillListOfLeaves_(Graph::NodeId startingNode, std::vector<Graph::NodeId>& foundLeaves) const
+std::vector<Graph::NodeId> TreeGraphImpl<GraphImpl>::getLeavesUnderNode(Graph::NodeId node) const
 {
-  const std::vector<Graph::NodeId> sons = getSons(startingNode);
-  if (sons.size() > 1)
+  std::vector<Graph::NodeId> foundLeaves;
+  std::vector<Graph::NodeId> toVisit(1, node);
+  while (!toVisit.empty())
   {
-    for (std::vector<Graph::NodeId>::const_iterator currNeighbor = sons.begin(); currNeighbor != sons.end(); currNeighbor++)
+    Graph::NodeId current = toVisit.back();
+    toVisit.pop_back();
+    if (getNumberOfSons(current) > 1)
     {
-      fillListOfLeaves_(*currNeighbor, foundLeaves);
+      // the first son is visited first
+      const std::vector<Graph::NodeId> sons = getSons(current);
+      toVisit.insert(toVisit.end(), sons.rbegin(), sons.rend());
     }
+    else
+      foundLeaves.push_back(current);
   }
-  else
-  {
-    foundLeaves.push_back(startingNode);
-  }
-}
-
-template<class GraphImpl>
-std::vector<Graph::NodeId> TreeGraphImpl<GraphImpl>::getLeavesUnderNode(Graph::NodeId node) const
-{
-  std::vector<Graph::NodeId> foundLeaves;
-  fillListOfLeaves_(node, foundLeaves);
-
   return foundLeaves;
 }
 
@@ -326,6 +471,173 @@ template<class GraphImpl>
 void TreeGraphImpl<GraphImpl>::topologyHasChanged_() const
 {
   isValid_ = false;
+  traversalRoot_ = noRoot_;
+}
+
+template<class GraphImpl>
+void TreeGraphImpl<GraphImpl>::computeTraversals_() const
+{
+  Graph::NodeId root = GraphImpl::getRoot();
+  if (traversalRoot_.load(std::memory_order_acquire) == root)
+    return;
+  std::lock_guard<std::mutex> lock(cacheMutex_);
+  // They may have been computed by another thread in the meantime:
+  if (traversalRoot_.load(std::memory_order_relaxed) == root)
+    return;
+  mustBeRooted_();
+  mustBeValid_();
+
+  traversalRoot_.store(noRoot_, std::memory_order_relaxed);
+  lcaIndexIsValid_.store(false, std::memory_order_relaxed);
+  size_t nbNodes = GraphImpl::getNumberOfNodes();
+  preOrder_.clear();
+  preOrder_.reserve(nbNodes);
+  auto reserve = [this](Graph::NodeId node) {
+      if (node >= preOrderRank_.size())
+      {
+        preOrderRank_.resize(node + 1);
+        subtreeSize_.resize(node + 1);
+        depth_.resize(node + 1);
+        father_.resize(node + 1);
+        fatherEdge_.resize(node + 1);
+      }
+    };
+
+  // Pre-order, with an explicit stack:
+  std::vector<Graph::NodeId> toVisit(1, root);
+  reserve(root);
+  depth_[root] = 0;
+  father_[root] = root;
+  while (!toVisit.empty())
+  {
+    Graph::NodeId node = toVisit.back();
+    toVisit.pop_back();
+    preOrderRank_[node] = preOrder_.size();
+    subtreeSize_[node] = 1;
+    preOrder_.push_back(node);
+    const std::vector<Graph::EdgeId> branches = GraphImpl::getOutgoingEdges(node);
+    for (auto branch = branches.rbegin(); branch != branches.rend(); ++branch)
+    {
+      Graph::NodeId son = GraphImpl::getBottom(*branch);
+      reserve(son);
+      father_[son] = node;
+      fatherEdge_[son] = *branch;
+      depth_[son] = depth_[node] + 1;
+      toVisit.push_back(son);
+    }
+  }
+
+  // Sizes of the subtrees, from the leaves up:
+  for (size_t i = preOrder_.size(); i > 1; --i)
+  {
+    Graph::NodeId node = preOrder_[i - 1];
+    subtreeSize_[father_[node]] += subtreeSize_[node];
+  }
+
+  // In post-order, a node comes after its subtree, minus its ancestors:
+  postOrder_.resize(preOrder_.size());
+  for (Graph::NodeId node : preOrder_)
+  {
+    postOrder_[preOrderRank_[node] + subtreeSize_[node] - 1 - depth_[node]] = node;
+  }
+
+  // Level-order, the sons of a node being contiguous subtrees in pre-order:
+  levelOrder_.clear();
+  levelOrder_.reserve(preOrder_.size());
+  levelOrder_.push_back(root);
+  for (size_t i = 0; i < levelOrder_.size(); ++i)
+  {
+    Graph::NodeId node = levelOrder_[i];
+    size_t end = preOrderRank_[node] + subtreeSize_[node];
+    for (size_t son = preOrderRank_[node] + 1; son < end; son += subtreeSize_[preOrder_[son]])
+    {
+      levelOrder_.push_back(preOrder_[son]);
+    }
+  }
+
+  traversalRoot_.store(root, std::memory_order_release);
+}
+
+template<class GraphImpl>
+void TreeGraphImpl<GraphImpl>::computeLCAIndex_() const
+{
+  computeTraversals_();
+  if (lcaIndexIsValid_.load(std::memory_order_acquire))
+    return;
+  std::lock_guard<std::mutex> lock(cacheMutex_);
+  if (lcaIndexIsValid_.load(std::memory_order_relaxed))
+    return;
+
+  lcaTable_.clear();
+  for (size_t width = 1; 2 * width <= preOrder_.size(); width *= 2)
+  {
+    const std::vector<Graph::NodeId>& previous = lcaTable_.empty() ? preOrder_ : lcaTable_.back();
+    std::vector<Graph::NodeId> level(previous.size() - width);
+    for (size_t i = 0; i < level.size(); ++i)
+    {
+      Graph::NodeId nodeA = previous[i];
+      Graph::NodeId nodeB = previous[i + width];
+      level[i] = depth_[nodeA] <= depth_[nodeB] ? nodeA : nodeB;
+    }
+    lcaTable_.push_back(std::move(level));
+  }
+  lcaIndexIsValid_.store(true, std::memory_order_release);
+}
+
+template<class GraphImpl>
+Graph::NodeId TreeGraphImpl<GraphImpl>::getShallowestNode_(size_t begin, size_t end) const
+{
+  size_t length = end - begin + 1;
+  if (length == 1)
+    return preOrder_[begin];
+  size_t k = 0;
+  while ((static_cast<size_t>(2) << k) <= length)
+  {
+    k++;
+  }
+  const std::vector<Graph::NodeId>& level = lcaTable_[k - 1];
+  Graph::NodeId nodeA = level[begin];
+  Graph::NodeId nodeB = level[end + 1 - (static_cast<size_t>(1) << k)];
+  return depth_[nodeA] <= depth_[nodeB] ? nodeA : nodeB;
+}
+
+template<class GraphImpl>
+Graph::NodeId TreeGraphImpl<GraphImpl>::getLCA(Graph::NodeId nodeA, Graph::NodeId nodeB) const
+{
+  computeLCAIndex_();
+  GraphImpl::nodeMustExist_(nodeA, "first node");
+  GraphImpl::nodeMustExist_(nodeB, "second node");
+  if (nodeA == nodeB)
+    return nodeA;
+
+  // Between two nodes in pre-order, the shallowest node is a son of
+  // their LCA.
+  size_t rankA = preOrderRank_[nodeA];
+  size_t rankB = preOrderRank_[nodeB];
+  if (rankA > rankB)
+    std::swap(rankA, rankB);
+  return father_[getShallowestNode_(rankA + 1, rankB)];
+}
+
+template<class GraphImpl>
+const std::vector<Graph::NodeId>& TreeGraphImpl<GraphImpl>::getPreOrder() const
+{
+  computeTraversals_();
+  return preOrder_;
+}
+
+template<class GraphImpl>
+const std::vector<Graph::NodeId>& TreeGraphImpl<GraphImpl>::getPostOrder() const
+{
+  computeTraversals_();
+  return postOrder_;
+}
+
+template<class GraphImpl>
+const std::vector<Graph::NodeId>& TreeGraphImpl<GraphImpl>::getLevelOrder() const
+{
+  computeTraversals_();
+  return levelOrder_;
 }
 
 template<class GraphImpl>
@@ -344,11 +656,16 @@ void TreeGraphImpl<GraphImpl>::rootAt(Graph::NodeId newRoot)
 template<class GraphImpl>
 void TreeGraphImpl<GraphImpl>::propagateDirection_(Graph::NodeId node)
 {
-  if (hasFather(node))
+  // path from the node up to the former root
+  std::vector<Graph::NodeId> path(1, node);
+  while (hasFather(path.back()))
   {
-    NodeId father = getFatherOfNode(node);
-    propagateDirection_(father);
-    GraphImpl::switchNodes(father, node);
+    path.push_back(getFatherOfNode(path.back()));
+  }
+  // switch the edges from the former root down to the node
+  for (size_t i = path.size() - 1; i > 0; --i)
+  {
+    GraphImpl::switchNodes(path[i], path[i - 1]);
   }
 }
 
@@ -385,6 +702,65 @@ void TreeGraphImpl<GraphImpl>::addSon(Graph::NodeId node, Graph::NodeId sonNode,
   topologyHasChanged_();
 }
 
+template<class GraphImpl>
+std::vector<Graph::NodeId> TreeGraphImpl<GraphImpl>::createTreeFromFathers(const std::vector<size_t>& fathers)
+{
+  mustBeRooted_();
+  if (GraphImpl::getNumberOfNodes() != 0)
+    throw Exception("TreeGraphImpl::createTreeFromFathers: The tree must be empty.");
+
+  size_t nbNodes = fathers.size();
+  size_t root = nbNodes;
+  std::vector<std::pair<size_t, size_t>> links;
+  links.reserve(nbNodes);
+  for (size_t i = 0; i < nbNodes; ++i)
+  {
+    if (fathers[i] >= nbNodes)
+      throw Exception("TreeGraphImpl::createTreeFromFathers: Unknown father " + TextTools::toString(fathers[i]) + " of node " + TextTools::toString(i) + ".");
+    if (fathers[i] == i)
+    {
+      if (root != nbNodes)
+        throw Exception("TreeGraphImpl::createTreeFromFathers: Several roots " + TextTools::toString(root) + " and " + TextTools::toString(i) + ".");
+      root = i;
+    }
+    else
+      links.push_back(std::make_pair(fathers[i], i));
+  }
+  if (root == nbNodes)
+    throw Exception("TreeGraphImpl::createTreeFromFathers: No root.");
+
+  // every node must lead to the root: climb from each node until a
+  // node already known to do so, and fail on coming back to the path
+  std::vector<unsigned char> state(nbNodes, 0); // 0: unknown, 1: on current path, 2: leads to the root
+  state[root] = 2;
+  for (size_t i = 0; i < nbNodes; ++i)
+  {
+    size_t node = i;
+    while (state[node] == 0)
+    {
+      state[node] = 1;
+      node = fathers[node];
+    }
+    if (state[node] == 1)
+      throw Exception("TreeGraphImpl::createTreeFromFathers: Cycle through node " + TextTools::toString(node) + ".");
+    for (node = i; state[node] == 1; node = fathers[node])
+    {
+      state[node] = 2;
+    }
+  }
+
+  Graph::NodeId firstNode = GraphImpl::createNodesAndEdges(nbNodes, links).first;
+  GraphImpl::setRoot(firstNode + static_cast<Graph::NodeId>(root));
+  isValid_ = true;
+
+  std::vector<Graph::NodeId> nodes(nbNodes);
+  for (size_t i = 0; i < nbNodes; ++i)
+  {
+    nodes[i] = firstNode + static_cast<Graph::NodeId>(i);
+  }
+  return nodes;
+}
+
 template<class GraphImpl>
 void TreeGraphImpl<GraphImpl>::unRoot(bool joinRootSons)
 {
@@ -478,6 +854,24 @@ std::vector<Graph::NodeId> TreeGraphImpl<GraphImpl>::getNodePathBetweenTwoNodes(
   GraphImpl::nodeMustExist_(nodeA);
   GraphImpl::nodeMustExist_(nodeB);
   std::vector<Graph::NodeId> path;
+  if (useLCAIndex_)
+  {
+    Graph::NodeId ancestor = getLCA(nodeA, nodeB);
+    for (Graph::NodeId node = nodeA; node != ancestor; node = father_[node])
+    {
+      path.push_back(node);
+    }
+    if (includeAncestor)
+      path.push_back(ancestor);
+    size_t middle = path.size();
+    for (Graph::NodeId node = nodeB; node != ancestor; node = father_[node])
+    {
+      path.push_back(node);
+    }
+    std::reverse(path.begin() + static_cast<std::ptrdiff_t>(middle), path.end());
+    return path;
+  }
+
   std::vector<Graph::NodeId> pathMatrix1;
   std::vector<Graph::NodeId> pathMatrix2;
 
@@ -526,6 +920,22 @@ template<class GraphImpl>
 std::vector<Graph::EdgeId> TreeGraphImpl<GraphImpl>::getEdgePathBetweenTwoNodes(Graph::NodeId nodeA, Graph::NodeId nodeB) const
 {
   std::vector<Graph::EdgeId> path;
+  if (useLCAIndex_)
+  {
+    Graph::NodeId ancestor = getLCA(nodeA, nodeB);
+    for (Graph::NodeId node = nodeA; node != ancestor; node = father_[node])
+    {
+      path.push_back(fatherEdge_[node]);
+    }
+    size_t middle = path.size();
+    for (Graph::NodeId node = nodeB; node != ancestor; node = father_[node])
+    {
+      path.push_back(fatherEdge_[node]);
+    }
+    std::reverse(path.begin() + static_cast<std::ptrdiff_t>(middle), path.end());
+    return path;
+  }
+
   std::vector<Graph::NodeId> pathNodes = getNodePathBetweenTwoNodes(nodeA, nodeB, true);
   for (size_t currNodeNr = 0; currNodeNr + 1 < pathNodes.size(); currNodeNr++)
   {
@@ -537,42 +947,26 @@ std::vector<Graph::EdgeId> TreeGraphImpl<GraphImpl>::getEdgePathBetweenTwoNodes(
 template<class GraphImpl>
 std::vector<Graph::NodeId> TreeGraphImpl<GraphImpl>::getSubtreeNodes(Graph::NodeId localRoot) const
 {
-  mustBeValid_();
-  std::vector<Graph::EdgeId> metNodes;
-  fillSubtreeMetNodes_(metNodes, localRoot);
-  return metNodes;
+  computeTraversals_();
+  GraphImpl::nodeMustExist_(localRoot, "local root");
+  // the subtree is contiguous in pre-order
+  auto begin = preOrder_.begin() + static_cast<std::ptrdiff_t>(preOrderRank_[localRoot]);
+  return std::vector<Graph::NodeId>(begin, begin + static_cast<std::ptrdiff_t>(subtreeSize_[localRoot]));
 }
 
 template<class GraphImpl>
 std::vector<Graph::EdgeId> TreeGraphImpl<GraphImpl>::getSubtreeEdges(Graph::NodeId localRoot) const
 {
-  mustBeValid_();
+  computeTraversals_();
+  GraphImpl::nodeMustExist_(localRoot, "local root");
+  size_t begin = preOrderRank_[localRoot];
   std::vector<Graph::EdgeId> metEdges;
-  fillSubtreeMetEdges_(metEdges, localRoot);
-  return metEdges;
-}
-
-
-template<class GraphImpl>
-void TreeGraphImpl<GraphImpl>::fillSubtreeMetNodes_(std::vector<Graph::NodeId>& metNodes, Graph::NodeId localRoot) const
-{
-  metNodes.push_back(localRoot);
-  std::vector<Graph::NodeId> sons = GraphImpl::getOutgoingNeighbors(localRoot);
-  for (std::vector<Graph::NodeId>::iterator currSon = sons.begin(); currSon != sons.end(); currSon++)
-  {
-    fillSubtreeMetNodes_(metNodes, *currSon);
-  }
-}
-
-template<class GraphImpl>
-void TreeGraphImpl<GraphImpl>::fillSubtreeMetEdges_(std::vector<Graph::EdgeId>& metEdges, Graph::NodeId localRoot) const
-{
-  std::vector<Graph::EdgeId> edgesToSons = GraphImpl::getOutgoingEdges(localRoot);
-  for (std::vector<Graph::EdgeId>::iterator currEdgeToSon = edgesToSons.begin(); currEdgeToSon != edgesToSons.end(); currEdgeToSon++)
+  metEdges.reserve(subtreeSize_[localRoot] - 1);
+  for (size_t i = begin + 1; i < begin + subtreeSize_[localRoot]; ++i)
   {
-    metEdges.push_back(*currEdgeToSon);
-    fillSubtreeMetEdges_(metEdges, GraphImpl::getBottom(*currEdgeToSon));
+    metEdges.push_back(fatherEdge_[preOrder_[i]]);
   }
+  return metEdges;
 }
 
 template<class GraphImpl>
@@ -588,38 +982,42 @@ Graph::NodeId TreeGraphImpl<GraphImpl>::MRCA(const std::vector<Graph::NodeId>& n
   if (nbnodes == 1)
     return nodes[0];
 
-  // Forward counts
-  auto fathers = std::make_shared<std::map<Graph::NodeId, unsigned int>>();
-  auto sons = std::make_shared<std::map<Graph::NodeId, unsigned int>>();
+  if (useLCAIndex_)
+  {
+    Graph::NodeId ancestor = nodes[0];
+    for (size_t i = 1; i < nbnodes; ++i)
+    {
+      ancestor = getLCA(ancestor, nodes[i]);
+    }
+    return ancestor;
+  }
 
-  for (auto nodeid:nodes)
+  // Ancestors of the first node, by distance to it
+  std::vector<Graph::NodeId> path(1, nodes[0]);
+  std::map<Graph::NodeId, size_t> ancestors;
+  ancestors[nodes[0]] = 0;
+  while (hasFather(path.back()))
   {
-    (*sons)[nodeid] = 1;
+    path.push_back(getFatherOfNode(path.back()));
+    ancestors[path.back()] = path.size() - 1;
   }
 
-  while (sons->size() > 1)
+  // The MRCA is the furthest of the first ancestors met by the other nodes
+  size_t mrca = 0;
+  for (size_t i = 1; i < nbnodes; ++i)
   {
-    // From sons to fathers
-    for (auto son:(*sons))
+    Graph::NodeId node = nodes[i];
+    auto found = ancestors.find(node);
+    while (found == ancestors.end() && hasFather(node))
     {
-      Graph::NodeId here = (!hasFather(son.first)) ? son.first : getFatherOfNode(son.first);
-
-      if (fathers->find(here) == fathers->end())
-        (*fathers)[here] = son.second;
-      else
-        (*fathers)[here] += son.second;
-
-      if ((*fathers)[here] == nbnodes)
-        return here;
+      node = getFatherOfNode(node);
+      found = ancestors.find(node);
     }
-
-    auto temp = sons;
-    sons = fathers;
-    fathers = temp;
-    fathers->clear();
+    if (found == ancestors.end())
+      throw Exception("TreeGraphImpl::MRCA not found");
+    mrca = std::max(mrca, found->second);
   }
-
-  throw Exception("TreeGraphImpl::MRCA not found");
+  return path[mrca];
 }
 }
 #endif // BPP_GRAPH_TREEGRAPHIMPL_H
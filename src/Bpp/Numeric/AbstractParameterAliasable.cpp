@@ -199,6 +199,9 @@ void AbstractParameterAliasable::setNamespace(const std::string& prefix)
 
   // Finally we notify the mother class:
   AbstractParametrizable::setNamespace(prefix);
+
+  // The independent parameters are shared, and have been renamed too:
+  independentParameters_.reindex();
 }
 
 vector<string> AbstractParameterAliasable::getAlias(const string& name) const
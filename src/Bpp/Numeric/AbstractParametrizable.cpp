@@ -20,6 +20,7 @@ void AbstractParametrizable::setNamespace(const std::string& prefix)
     else
       parameters_[i].setName(prefix + currentName);
   }
+  parameters_.reindex();
 
   // Then we store the new namespace:
   prefix_ = prefix;
@@ -32,3 +33,36 @@ std::string AbstractParametrizable::getParameterNameWithoutNamespace(const std::
   else
     return name;
 }
+
+bool AbstractParametrizable::matchBoundParametersValues(const std::vector<size_t>& slots, const double* values, const std::vector<bool>* changed)
+{
+  // First we check if all values are correct:
+  vector<size_t> updated;
+  for (size_t k = 0; k < slots.size(); ++k)
+  {
+    if (changed && !(*changed)[k])
+      continue;
+    if (slots[k] >= parameters_.size())
+      throw IndexOutOfBoundsException("AbstractParametrizable::matchBoundParametersValues.", slots[k], 0, parameters_.size() - 1);
+    const Parameter& p = parameters_[slots[k]];
+    if (p.getValue() != values[k])
+    {
+      if (p.hasConstraint() && !p.getConstraint()->isCorrect(values[k]))
+        throw ConstraintException("AbstractParametrizable::matchBoundParametersValues()", &p, values[k]);
+      updated.push_back(k);
+    }
+  }
+  if (updated.empty())
+    return false;
+
+  // If all values are ok, we set them:
+  vector<size_t> positions(updated.size());
+  for (size_t u = 0; u < updated.size(); ++u)
+  {
+    size_t k = updated[u];
+    parameters_[slots[k]].setValue(values[k]);
+    positions[u] = slots[k];
+  }
+  fireParameterChanged(parameters_.shareSubList(positions));
+  return true;
+}
@@ -84,6 +84,15 @@ public:
     return test;
   }
 
+  /**
+   * @brief Update parameters given by their positions.
+   *
+   * Values are checked and set directly in the list of parameters, and fireParameterChanged()
+   * is called with the parameters whose value changed. Derived classes redefining
+   * matchParametersValues should redefine this method accordingly.
+   */
+  bool matchBoundParametersValues(const std::vector<size_t>& slots, const double* values, const std::vector<bool>* changed = nullptr) override;
+
   void removeConstraint(const std::string& name) override
   {
     getParameter_(name).removeConstraint();
@@ -214,11 +223,6 @@ protected:
   {
     return parameters_.getParameter(i);
   }
-
-  std::shared_ptr<Parameter>& getParameter(size_t i)
-  {
-    return parameters_.getParameter(i);
-  }
 };
 } // end of namespace bpp.
 #endif // BPP_NUMERIC_ABSTRACTPARAMETRIZABLE_H
@@ -26,6 +26,7 @@ AbstractOptimizer::AbstractOptimizer(std::shared_ptr<FunctionInterface> function
   verbose_(true), isInitialized_(false), startTime_(), listeners_(),
   updateParameters_(false), stepChar_("*"),
   nbEvalMax_(1000000), nbEval_(0),
+  nbGradientEval_(0), lineSearchTime_(0),
   currentValue_(0), tolIsReached_(false)
 {}
 
@@ -46,6 +47,8 @@ AbstractOptimizer::AbstractOptimizer(const AbstractOptimizer& opt) :
   stepChar_(opt.stepChar_),
   nbEvalMax_(opt.nbEvalMax_),
   nbEval_(opt.nbEval_),
+  nbGradientEval_(opt.nbGradientEval_),
+  lineSearchTime_(opt.lineSearchTime_),
   currentValue_(opt.currentValue_),
   tolIsReached_(opt.tolIsReached_)
 {
@@ -103,6 +106,8 @@ AbstractOptimizer& AbstractOptimizer::operator=(const AbstractOptimizer& opt)
 
   nbEvalMax_              = opt.nbEvalMax_;
   nbEval_                 = opt.nbEval_;
+  nbGradientEval_         = opt.nbGradientEval_;
+  lineSearchTime_         = opt.lineSearchTime_;
   verbose_                = opt.verbose_;
   isInitialized_          = opt.isInitialized_;
   // In case of AutoParameter instances, we must actualize the pointers toward messageHandler_:
@@ -135,6 +140,8 @@ void AbstractOptimizer::init(const ParameterList& params)
     autoParameter();
   else if (constraintPolicy_ == AutoParameter::CONSTRAINTS_IGNORE)
     ignoreConstraints();
+  nbGradientEval_ = 0;
+  lineSearchTime_ = 0;
   doInit(params);
   nbEval_ = 0;
   tolIsReached_ = false;
@@ -8,6 +8,9 @@
 
 #include "Optimizer.h"
 
+// From the STL:
+#include <chrono>
+
 namespace bpp
 {
 /**
@@ -96,6 +99,20 @@ protected:
    */
   unsigned int nbEval_;
 
+  /**
+   * @brief The number of gradient computations since the last initialization.
+   *
+   * Maintained by optimizers using derivatives.
+   */
+  unsigned int nbGradientEval_;
+
+  /**
+   * @brief The wall time spent in line searches since the last initialization, in seconds.
+   *
+   * Maintained by optimizers performing line searches.
+   */
+  double lineSearchTime_;
+
   /**
    * @brief The current value of the function.
    */
@@ -205,6 +222,16 @@ public:
 
   unsigned int getNumberOfEvaluations() const override { return nbEval_; }
 
+  /**
+   * @return The number of gradient computations since the last initialization.
+   */
+  unsigned int getNumberOfGradientEvaluations() const { return nbGradientEval_; }
+
+  /**
+   * @return The wall time spent in line searches since the last initialization, in seconds.
+   */
+  double getLineSearchTime() const { return lineSearchTime_; }
+
   void setStopCondition(std::shared_ptr<OptimizationStopCondition> stopCondition) override
   {
     stopCondition_ = stopCondition;
@@ -392,6 +419,16 @@ protected:
   {
     defaultStopCondition_ = osc;
   }
+
+  /**
+   * @brief Add the time elapsed since a given time point to the line search time.
+   *
+   * @param start The time point when the line search started.
+   */
+  void addLineSearchTime_(const std::chrono::steady_clock::time_point& start)
+  {
+    lineSearchTime_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
 };
 } // end of namespace bpp.
 #endif // BPP_NUMERIC_FUNCTION_ABSTRACTOPTIMIZER_H
@@ -66,6 +66,7 @@ void BfgsMultiDimensions::doInit(const ParameterList& params)
   function().setParameters(params);
 
   getGradient(gradient_);
+  nbGradientEval_++;
 
   for (size_t i = 0; i < nbParams; ++i)
   {
@@ -105,12 +106,14 @@ double BfgsMultiDimensions::doStep()
   setDirection();
 
   firstOrderDerivableFunction().enableFirstOrderDerivatives(false);
+  auto lineSearchStart = std::chrono::steady_clock::now();
   nbEval_ += OneDimensionOptimizationTools::lineSearch(f1dim_,
         getParameters_(), xi_,
         gradient_,
         // getStopCondition()->getTolerance(),
         0, 0,
         getVerbose() > 0 ? getVerbose() - 1 : 0);
+  addLineSearchTime_(lineSearchStart);
   firstOrderDerivableFunction().enableFirstOrderDerivatives(true);
 
   for (i = 0; i < n; ++i)
@@ -154,6 +157,7 @@ double BfgsMultiDimensions::doStep()
   }
 
   getGradient(gradient_);
+  nbGradientEval_++;
   // test = 0.0;
 
   // for (i = 0; i < n; i++)
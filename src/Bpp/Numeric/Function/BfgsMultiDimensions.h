@@ -49,6 +49,12 @@ public:
    *
    * @{
    */
+  void setFunction(std::shared_ptr<FunctionInterface> function) override
+  {
+    AbstractOptimizer::setFunction(function);
+    f1dim_ = std::make_shared<DirectionFunction>(function);
+  }
+
   void doInit(const ParameterList& params) override;
 
   double doStep() override;
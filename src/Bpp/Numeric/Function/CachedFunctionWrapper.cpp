@@ -0,0 +1,186 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "CachedFunctionWrapper.h"
+
+// From the STL:
+#include <cstdint>
+#include <cstring>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+size_t CachedFunctionWrapper::PointHash::operator()(const std::vector<double>& point) const
+{
+  // FNV-1a on the bits of each value:
+  uint64_t h = 14695981039346656037ULL;
+  for (double x : point)
+  {
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    h ^= bits;
+    h *= 1099511628211ULL;
+  }
+  return static_cast<size_t>(h ^ (h >> 32));
+}
+
+/******************************************************************************/
+
+bool CachedFunctionWrapper::PointEqual::operator()(const std::vector<double>& p1, const std::vector<double>& p2) const
+{
+  return p1.size() == p2.size() && (p1.empty() || memcmp(&p1[0], &p2[0], p1.size() * sizeof(double)) == 0);
+}
+
+/******************************************************************************/
+
+CachedFunctionWrapper::CachedFunctionWrapper(std::shared_ptr<FunctionInterface> function, size_t capacity) :
+  FunctionWrapper(function),
+  entries_(),
+  index_(),
+  capacity_(capacity),
+  parameters_(),
+  value_(0),
+  point_(),
+  nbHits_(0),
+  nbMisses_(0)
+{
+  if (capacity_ == 0)
+    throw Exception("CachedFunctionWrapper. Capacity must be at least 1.");
+  synchronize();
+}
+
+/******************************************************************************/
+
+CachedFunctionWrapper::CachedFunctionWrapper(const CachedFunctionWrapper& cfw) :
+  FunctionWrapper(cfw),
+  entries_(cfw.entries_),
+  index_(),
+  capacity_(cfw.capacity_),
+  parameters_(cfw.parameters_),
+  value_(cfw.value_),
+  point_(cfw.point_),
+  nbHits_(cfw.nbHits_),
+  nbMisses_(cfw.nbMisses_)
+{
+  for (Entries::iterator it = entries_.begin(); it != entries_.end(); ++it)
+  {
+    index_[it->first] = it;
+  }
+}
+
+/******************************************************************************/
+
+CachedFunctionWrapper& CachedFunctionWrapper::operator=(const CachedFunctionWrapper& cfw)
+{
+  FunctionWrapper::operator=(cfw);
+  entries_ = cfw.entries_;
+  index_.clear();
+  for (Entries::iterator it = entries_.begin(); it != entries_.end(); ++it)
+  {
+    index_[it->first] = it;
+  }
+  capacity_ = cfw.capacity_;
+  parameters_ = cfw.parameters_;
+  value_ = cfw.value_;
+  point_ = cfw.point_;
+  nbHits_ = cfw.nbHits_;
+  nbMisses_ = cfw.nbMisses_;
+  return *this;
+}
+
+/******************************************************************************/
+
+void CachedFunctionWrapper::setCapacity(size_t capacity)
+{
+  if (capacity == 0)
+    throw Exception("CachedFunctionWrapper::setCapacity. Capacity must be at least 1.");
+  capacity_ = capacity;
+  while (entries_.size() > capacity_)
+  {
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+}
+
+/******************************************************************************/
+
+void CachedFunctionWrapper::synchronize()
+{
+  entries_.clear();
+  index_.clear();
+  parameters_ = function_->getParameters();
+  value_ = function_->getValue();
+  point_.resize(parameters_.size());
+  for (size_t i = 0; i < parameters_.size(); ++i)
+  {
+    point_[i] = parameters_[i].getValue();
+  }
+  insert_(point_, value_);
+}
+
+/******************************************************************************/
+
+ParameterList& CachedFunctionWrapper::getParameters_()
+{
+  if (moveFunction_())
+    value_ = function_->getValue();
+  return FunctionWrapper::getParameters_();
+}
+
+/******************************************************************************/
+
+void CachedFunctionWrapper::update_()
+{
+  for (size_t i = 0; i < parameters_.size(); ++i)
+  {
+    point_[i] = parameters_[i].getValue();
+  }
+
+  auto it = index_.find(point_);
+  if (it != index_.end())
+  {
+    nbHits_++;
+    value_ = it->second->second;
+    // Move the entry at the front, as the most recently used:
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return;
+  }
+
+  nbMisses_++;
+  moveFunction_();
+  value_ = function_->getValue();
+  insert_(point_, value_);
+}
+
+/******************************************************************************/
+
+bool CachedFunctionWrapper::moveFunction_()
+{
+  const ParameterList& pl = function_->getParameters();
+  vector<size_t> changed;
+  for (size_t i = 0; i < parameters_.size(); ++i)
+  {
+    if (pl[i].getValue() != parameters_[i].getValue())
+      changed.push_back(i);
+  }
+  if (changed.empty())
+    return false;
+  function_->setParameters(parameters_.createSubList(changed));
+  return true;
+}
+
+/******************************************************************************/
+
+void CachedFunctionWrapper::insert_(const std::vector<double>& point, double value)
+{
+  if (entries_.size() == capacity_)
+  {
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+  entries_.push_front(make_pair(point, value));
+  index_[point] = entries_.begin();
+}
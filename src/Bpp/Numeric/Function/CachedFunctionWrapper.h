@@ -0,0 +1,217 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_NUMERIC_FUNCTION_CACHEDFUNCTIONWRAPPER_H
+#define BPP_NUMERIC_FUNCTION_CACHEDFUNCTIONWRAPPER_H
+
+
+#include "Functions.h"
+
+// From the STL:
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Function wrapper remembering the values of the last points computed.
+ *
+ * Optimizers, and line searches in particular, often compute the function again at a point
+ * where it was just computed. This wrapper keeps the values of the last computed points in
+ * a cache, and only passes the points which are not in the cache to the wrapped function.
+ * Points are identified by the exact values of all parameters, so that a point is only found
+ * in the cache if it is bitwise identical to a point already computed. When the cache is
+ * full, the least recently used point is discarded.
+ *
+ * The wrapper keeps its own copy of the parameters, which is returned by getParameters().
+ * The wrapped function is only updated when the function has to be computed, so that it may
+ * not be at the current point of the wrapper when the value was found in the cache. The
+ * function must not be modified other than through the wrapper while the wrapper is in use,
+ * or the cache must be cleared.
+ *
+ * Only the value of the function is cached: derivable functions, for which derivatives are
+ * computed together with the value, should not be wrapped.
+ */
+class CachedFunctionWrapper :
+  public FunctionWrapper
+{
+private:
+  /**
+   * @brief Hash of the bits of a parameter vector.
+   */
+  class PointHash
+  {
+public:
+    size_t operator()(const std::vector<double>& point) const;
+  };
+
+  typedef std::list< std::pair<std::vector<double>, double> > Entries;
+
+  /**
+   * @brief The cached points and values, from the most to the least recently used.
+   */
+  Entries entries_;
+
+  /**
+   * @brief Bitwise comparison of two points.
+   */
+  class PointEqual
+  {
+public:
+    bool operator()(const std::vector<double>& p1, const std::vector<double>& p2) const;
+  };
+
+  std::unordered_map<std::vector<double>, Entries::iterator, PointHash, PointEqual> index_;
+  size_t capacity_;
+
+  ParameterList parameters_;
+  double value_;
+  std::vector<double> point_;
+  unsigned int nbHits_, nbMisses_;
+
+public:
+  /**
+   * @brief Build a new cache for the given function.
+   *
+   * The function is assumed to be computed at its current point, which is stored in the cache.
+   *
+   * @param function The function to wrap.
+   * @param capacity The maximum number of points to remember.
+   */
+  CachedFunctionWrapper(std::shared_ptr<FunctionInterface> function, size_t capacity = 16);
+
+  CachedFunctionWrapper(const CachedFunctionWrapper& cfw);
+
+  CachedFunctionWrapper& operator=(const CachedFunctionWrapper& cfw);
+
+  virtual ~CachedFunctionWrapper() {}
+
+  CachedFunctionWrapper* clone() const override { return new CachedFunctionWrapper(*this); }
+
+public:
+  void setParameters(const ParameterList& parameters) override
+  {
+    parameters_.setParametersValues(parameters);
+    update_();
+  }
+
+  const ParameterList& getParameters() const override { return parameters_; }
+
+  const Parameter& parameter(const std::string& name) const override { return parameters_.parameter(name); }
+
+  double getParameterValue(const std::string& name) const override { return parameters_.getParameterValue(name); }
+
+  double getValue() const override { return value_; }
+
+  double f(const ParameterList& parameters) override
+  {
+    setParameters(parameters);
+    return value_;
+  }
+
+  void setAllParametersValues(const ParameterList& parameters) override
+  {
+    parameters_.setAllParametersValues(parameters);
+    update_();
+  }
+
+  void setParameterValue(const std::string& name, double value) override
+  {
+    parameters_.setParameterValue(name, value);
+    update_();
+  }
+
+  void setParametersValues(const ParameterList& parameters) override
+  {
+    parameters_.setParametersValues(parameters);
+    update_();
+  }
+
+  bool matchParametersValues(const ParameterList& parameters) override
+  {
+    bool test = parameters_.matchParametersValues(parameters);
+    if (test)
+      update_();
+    return test;
+  }
+
+  void removeConstraint(const std::string& name) override
+  {
+    function_->removeConstraint(name);
+    parameters_.parameter(name).removeConstraint();
+  }
+
+  void setConstraint(const std::string& name, std::shared_ptr<ConstraintInterface> constraint) override
+  {
+    function_->setConstraint(name, constraint);
+    parameters_.parameter(name).setConstraint(constraint);
+  }
+
+  void setNamespace(const std::string& prefix) override
+  {
+    function_->setNamespace(prefix);
+    synchronize();
+  }
+
+  /**
+   * @brief Set the maximum number of points to remember.
+   *
+   * @param capacity The new capacity. The least recently used points are discarded if needed.
+   */
+  void setCapacity(size_t capacity);
+
+  size_t getCapacity() const { return capacity_; }
+
+  /**
+   * @return The number of points currently in the cache.
+   */
+  size_t getNumberOfCachedPoints() const { return entries_.size(); }
+
+  /**
+   * @brief Discard all cached points, and read the current point and value of the wrapped function.
+   *
+   * This must be called if the wrapped function was modified outside of the wrapper.
+   */
+  void synchronize();
+
+  /**
+   * @return The number of points for which the value was found in the cache.
+   */
+  unsigned int getNumberOfHits() const { return nbHits_; }
+
+  /**
+   * @return The number of points for which the wrapped function was computed.
+   */
+  unsigned int getNumberOfMisses() const { return nbMisses_; }
+
+  void resetCounters()
+  {
+    nbHits_ = 0;
+    nbMisses_ = 0;
+  }
+
+protected:
+  /**
+   * @brief Give access to the parameters of the wrapped function, after moving it to the current point.
+   */
+  ParameterList& getParameters_() override;
+
+private:
+  /**
+   * @brief Look for the current point in the cache, and compute the function if it is not found.
+   */
+  void update_();
+
+  /**
+   * @brief Move the wrapped function to the current point, if needed.
+   *
+   * @return true if the function was computed.
+   */
+  bool moveFunction_();
+
+  void insert_(const std::vector<double>& point, double value);
+};
+} // end of namespace bpp.
+#endif // BPP_NUMERIC_FUNCTION_CACHEDFUNCTIONWRAPPER_H
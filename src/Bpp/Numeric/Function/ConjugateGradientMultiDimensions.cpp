@@ -29,6 +29,7 @@ void ConjugateGradientMultiDimensions::doInit(const ParameterList& params)
   firstOrderDerivableFunction().enableFirstOrderDerivatives(true);
   function().setParameters(params);
   getGradient(xi_);
+  nbGradientEval_++;
 
   for (size_t i = 0; i < nbParams; ++i)
   {
@@ -45,9 +46,11 @@ double ConjugateGradientMultiDimensions::doStep()
   size_t n = getParameters().size();
   // Loop over iterations.
   firstOrderDerivableFunction().enableFirstOrderDerivatives(false);
+  auto lineSearchStart = std::chrono::steady_clock::now();
   nbEval_ += OneDimensionOptimizationTools::lineMinimization(f1dim_,
         getParameters_(), xi_, getStopCondition()->getTolerance(),
         0, 0, getVerbose() > 0 ? getVerbose() - 1 : 0);
+  addLineSearchTime_(lineSearchStart);
 
   firstOrderDerivableFunction().enableFirstOrderDerivatives(true);
   f = getFunction()->f(getParameters());
@@ -57,6 +60,7 @@ double ConjugateGradientMultiDimensions::doStep()
     return f;
   }
   getGradient(xi_);
+  nbGradientEval_++;
 
   dgg = gg = 0.0;
   for (unsigned j = 0; j < n; j++)
@@ -4,6 +4,7 @@
 
 #include "../NumTools.h"
 #include "DownhillSimplexMethod.h"
+#include "FunctionTools.h"
 
 using namespace bpp;
 using namespace std;
@@ -21,7 +22,8 @@ double DownhillSimplexMethod::DSMStopCondition::getCurrentTolerance() const
 /******************************************************************************/
 
 DownhillSimplexMethod::DownhillSimplexMethod(std::shared_ptr<FunctionInterface> function) :
-  AbstractOptimizer(function), simplex_(), y_(), pSum_(), iHighest_(0), iNextHighest_(0), iLowest_(0)
+  AbstractOptimizer(function), simplex_(), y_(), pSum_(), iHighest_(0), iNextHighest_(0), iLowest_(0),
+  threadPool_(), speculative_(false), workers_()
 {
   // Default values:
   nbEvalMax_ = 5000;
@@ -31,15 +33,50 @@ DownhillSimplexMethod::DownhillSimplexMethod(std::shared_ptr<FunctionInterface>
 
 /******************************************************************************/
 
+DownhillSimplexMethod::DownhillSimplexMethod(const DownhillSimplexMethod& dsm) :
+  AbstractOptimizer(dsm),
+  simplex_(dsm.simplex_),
+  y_(dsm.y_),
+  pSum_(dsm.pSum_),
+  iHighest_(dsm.iHighest_),
+  iNextHighest_(dsm.iNextHighest_),
+  iLowest_(dsm.iLowest_),
+  threadPool_(dsm.threadPool_),
+  speculative_(dsm.speculative_),
+  workers_() // Copies of the function are not shared.
+{}
+
+/******************************************************************************/
+
+DownhillSimplexMethod& DownhillSimplexMethod::operator=(const DownhillSimplexMethod& dsm)
+{
+  AbstractOptimizer::operator=(dsm);
+  simplex_      = dsm.simplex_;
+  y_            = dsm.y_;
+  pSum_         = dsm.pSum_;
+  iHighest_     = dsm.iHighest_;
+  iNextHighest_ = dsm.iNextHighest_;
+  iLowest_      = dsm.iLowest_;
+  threadPool_   = dsm.threadPool_;
+  speculative_  = dsm.speculative_;
+  workers_.clear();
+  return *this;
+}
+
+/******************************************************************************/
+
 void DownhillSimplexMethod::doInit(const ParameterList& params)
 {
   size_t nDim = getParameters().size();
   nbEval_ = 0;
+  // The function may have changed since the last optimization:
+  workers_.clear();
 
   // Initialize the simplex:
   simplex_.resize(nDim + 1);
   y_.resize(nDim + 1);
   double lambda = 0.2; // 20% of the parameter value.
+  vector<ParameterList> points(nDim + 1);
   for (unsigned int i = 1; i < nDim + 1; i++)
   {
     // Copy the vector...
@@ -51,14 +88,21 @@ void DownhillSimplexMethod::doInit(const ParameterList& params)
       // simplex_[i][j].setValue(getParameters()[j].getValue() * (1. + (j == i - 1 ? lambda : 0.)));
       simplex_[i][j].setValue(getParameters()[j].getValue() + (j == i - 1 ? lambda : 0.));
     }
-    // Compute the corresponding f value:
-    y_[i] = getFunction()->f(simplex_[i]);
-    nbEval_++;
+    points[i - 1] = simplex_[i];
   }
   // Last function evaluation, setting current value:
   simplex_[0] = getParameters();
-  y_[0] = getFunction()->f(simplex_[0]);
-  nbEval_++;
+  points[nDim] = simplex_[0];
+
+  // Compute the corresponding f values:
+  vector<double> values;
+  evaluate_(points, values);
+  for (size_t i = 1; i < nDim + 1; i++)
+  {
+    y_[i] = values[i - 1];
+  }
+  y_[0] = values[nDim];
+  nbEval_ += static_cast<unsigned int>(nDim + 1);
 
   pSum_ = getPSum();
 }
@@ -106,6 +150,61 @@ double DownhillSimplexMethod::doStep()
   // First extrapolate by a factor -1 through the face of the simplex
   // across from high point, i.e., reflect the simplex from the high point.</p>
 
+  vector<ParameterList> points;
+  if (threadPool_ && speculative_)
+  {
+    // Compute all candidate points at once, as they would be computed in the serial case:
+    try
+    {
+      ParameterList reflected = extrapolate_(pSum_, simplex_[iHighest_], -1.0);
+      ParameterList pSumReflected = pSum_;
+      for (size_t j = 0; j < nDim; j++)
+      {
+        pSumReflected[j].setValue(pSum_[j].getValue() + reflected[j].getValue() - simplex_[iHighest_][j].getValue());
+      }
+      points = {
+        reflected,
+        extrapolate_(pSumReflected, reflected, 2.0),
+        extrapolate_(pSum_, simplex_[iHighest_], 0.5),
+        extrapolate_(pSumReflected, reflected, 0.5)
+      };
+    }
+    catch (ConstraintException& ce)
+    {
+      // Some candidate point is out of bounds: proceed as in the serial case.
+      points.clear();
+    }
+  }
+
+  if (!points.empty())
+  {
+    vector<double> values;
+    evaluate_(points, values);
+    nbEval_ += static_cast<unsigned int>(points.size());
+
+    bool isReflected = values[0] < y_[iHighest_];
+    replaceHighest_(points[0], values[0]);
+    if (values[0] <= y_[iLowest_])
+    {
+      // Expansion, from the reflected point. If it did not replace the high point, which
+      // only happens when all values are equal, expand from the high point as in the serial case.
+      if (isReflected)
+        replaceHighest_(points[1], values[1]);
+      else
+        tryExtrapolation(2.0);
+    }
+    else if (values[0] >= y_[iNextHighest_])
+    {
+      // Contraction, from the high point or from the reflected point if it replaced it.
+      double ySave = y_[iHighest_];
+      size_t k = isReflected ? 3 : 2;
+      replaceHighest_(points[k], values[k]);
+      if (values[k] >= ySave)
+        shrink_();
+    }
+    return y_[iLowest_];
+  }
+
   double yTry = tryExtrapolation(-1.0);
   if (yTry <= y_[iLowest_])
   {
@@ -118,23 +217,7 @@ double DownhillSimplexMethod::doStep()
     double ySave = y_[iHighest_];
     yTry = tryExtrapolation(0.5);
     if (yTry >= ySave)
-    {
-      for (size_t i = 0; i < mpts; i++)
-      {
-        if (i != iLowest_)
-        {
-          for (size_t j = 0; j < nDim; j++)
-          {
-            pSum_[j].setValue(0.5 * (simplex_[i][j].getValue() + simplex_[iLowest_][j].getValue()));
-            simplex_[i][j].setValue(pSum_[j].getValue());
-          }
-          y_[i] = getFunction()->f(pSum_);
-          nbEval_++;
-        }
-      }
-      nbEval_ += static_cast<unsigned int>(nDim);
-      pSum_ = getPSum();
-    }
+      shrink_();
   }
 
   return y_[iLowest_];
@@ -175,9 +258,23 @@ ParameterList DownhillSimplexMethod::getPSum()
 /******************************************************************************/
 
 double DownhillSimplexMethod::tryExtrapolation(double fac)
+{
+  ParameterList pTry = extrapolate_(pSum_, simplex_[iHighest_], fac);
+  // Now compute the function for this new set of parameters:
+  double yTry = getFunction()->f(pTry);
+  nbEval_++;
+
+  // Then test this new point:
+  replaceHighest_(pTry, yTry);
+  return yTry;
+}
+
+/******************************************************************************/
+
+ParameterList DownhillSimplexMethod::extrapolate_(const ParameterList& pSum, const ParameterList& pHigh, double fac) const
 {
   size_t ndim = simplex_.getDimension();
-  double fac1, fac2, yTry;
+  double fac1, fac2;
 
   fac1 = (1.0 - fac) / static_cast<double>(ndim);
   fac2 = fac1 - fac;
@@ -187,15 +284,18 @@ double DownhillSimplexMethod::tryExtrapolation(double fac)
   // and initialize it:
   for (size_t j = 0; j < ndim; j++)
   {
-    pTry[j].setValue(pSum_[j].getValue() * fac1 - simplex_[iHighest_][j].getValue() * fac2);
+    pTry[j].setValue(pSum[j].getValue() * fac1 - pHigh[j].getValue() * fac2);
   }
-  // Now compute the function for this new set of parameters:
-  yTry = getFunction()->f(pTry);
-  nbEval_++;
+  return pTry;
+}
 
-  // Then test this new point:
+/******************************************************************************/
+
+void DownhillSimplexMethod::replaceHighest_(const ParameterList& pTry, double yTry)
+{
   if (yTry < y_[iHighest_])
   {
+    size_t ndim = simplex_.getDimension();
     y_[iHighest_] = yTry;
     for (size_t j = 0; j < ndim; j++)
     {
@@ -203,7 +303,66 @@ double DownhillSimplexMethod::tryExtrapolation(double fac)
       simplex_[iHighest_][j].setValue(pTry[j].getValue());
     }
   }
-  return yTry;
+}
+
+/******************************************************************************/
+
+void DownhillSimplexMethod::shrink_()
+{
+  size_t nDim = simplex_.getDimension();
+  size_t mpts = nDim + 1;
+
+  vector<size_t> vertices;
+  vector<ParameterList> points;
+  for (size_t i = 0; i < mpts; i++)
+  {
+    if (i != iLowest_)
+    {
+      for (size_t j = 0; j < nDim; j++)
+      {
+        simplex_[i][j].setValue(0.5 * (simplex_[i][j].getValue() + simplex_[iLowest_][j].getValue()));
+      }
+      vertices.push_back(i);
+      points.push_back(simplex_[i]);
+    }
+  }
+  vector<double> values;
+  evaluate_(points, values);
+  for (size_t k = 0; k < vertices.size(); ++k)
+  {
+    y_[vertices[k]] = values[k];
+  }
+  nbEval_ += static_cast<unsigned int>(2 * nDim);
+  pSum_ = getPSum();
+}
+
+/******************************************************************************/
+
+void DownhillSimplexMethod::evaluate_(const std::vector<ParameterList>& points, std::vector<double>& values)
+{
+  values.resize(points.size());
+  if (!threadPool_ || points.size() < 2)
+  {
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+      values[i] = getFunction()->f(points[i]);
+    }
+    return;
+  }
+
+  if (workers_.size() != threadPool_->getNumberOfThreads())
+  {
+    workers_.resize(threadPool_->getNumberOfThreads());
+    for (auto& worker : workers_)
+    {
+      worker = FunctionTools::deepClone(*getFunction());
+    }
+  }
+  size_t last = points.size() - 1;
+  threadPool_->parallelFor(points.size(), [&](size_t i, size_t thread) {
+        FunctionInterface& f = i == last ? function() : *workers_[thread];
+        values[i] = f.f(points[i]);
+      });
 }
 
 /******************************************************************************/
@@ -6,6 +6,7 @@
 #define BPP_NUMERIC_FUNCTION_DOWNHILLSIMPLEXMETHOD_H
 
 
+#include "../../Utils/ThreadPool.h"
 #include "../VectorTools.h"
 #include "AbstractOptimizer.h"
 
@@ -24,6 +25,16 @@ namespace bpp
  * </pre>
  * or there:
  * <a href="http://en.wikipedia.org/wiki/Nelder-Mead_method">http://en.wikipedia.org/wiki/Nelder-Mead_method</a>.
+ *
+ * The vertices of the initial simplex, and the vertices of a shrunk simplex, can be computed in
+ * parallel by providing a ThreadPool (see setThreadPool). Each thread then works on its own copy of
+ * the function, obtained with FunctionTools::deepClone() at initialization, so that wrapped
+ * functions are copied too. In addition, the reflected, expanded and contracted points of a step
+ * can be computed speculatively, all at once (see
+ * setSpeculativeEvaluation): this requires more evaluations per step, but their cost in time is
+ * the one of a single evaluation when enough threads are available.
+ * In all cases, the same points are computed and compared in the same order as in the serial
+ * algorithm, so that the result does not depend on the number of threads.
  */
 class DownhillSimplexMethod :
   public AbstractOptimizer
@@ -71,6 +82,14 @@ protected:
   ParameterList pSum_;
   unsigned int iHighest_, iNextHighest_, iLowest_;
 
+  std::shared_ptr<ThreadPool> threadPool_;
+  bool speculative_;
+
+  /**
+   * @brief One copy of the function for each thread of the pool.
+   */
+  std::vector<std::shared_ptr<FunctionInterface>> workers_;
+
 public:
   /**
    * @brief Build a new Downhill Simplex optimizer.
@@ -79,6 +98,10 @@ public:
    */
   DownhillSimplexMethod(std::shared_ptr<FunctionInterface> function);
 
+  DownhillSimplexMethod(const DownhillSimplexMethod& dsm);
+
+  DownhillSimplexMethod& operator=(const DownhillSimplexMethod& dsm);
+
   virtual ~DownhillSimplexMethod() {}
 
   DownhillSimplexMethod* clone() const { return new DownhillSimplexMethod(*this); }
@@ -101,6 +124,33 @@ public:
 
   double doStep();
 
+  /**
+   * @brief Set the thread pool used to compute the function at several points in parallel.
+   *
+   * The copies of the function used by each thread are made at initialization, and are only
+   * updated with the values of the parameters to optimize.
+   *
+   * @param threadPool A thread pool, or a null pointer for a serial computation (the default).
+   */
+  void setThreadPool(std::shared_ptr<ThreadPool> threadPool)
+  {
+    threadPool_ = threadPool;
+    workers_.clear();
+  }
+
+  std::shared_ptr<ThreadPool> getThreadPool() const { return threadPool_; }
+
+  /**
+   * @brief Compute the reflected, expanded and contracted points of each step in parallel.
+   *
+   * This has no effect if no thread pool is set.
+   *
+   * @param yn Tell if candidate points should be computed speculatively.
+   */
+  void setSpeculativeEvaluation(bool yn) { speculative_ = yn; }
+
+  bool isSpeculativeEvaluation() const { return speculative_; }
+
 protected:
   /**
    * @name Specific inner methods
@@ -123,6 +173,34 @@ protected:
   double tryExtrapolation(double fac);
 
   /** @} */
+
+private:
+  /**
+   * @brief Extrapolates by a factor fac through the face of the simplex from a given high point.
+   *
+   * @param pSum The sum of the vertices of the simplex.
+   * @param pHigh The high point.
+   * @param fac Extrapolation factor.
+   * @return The new point.
+   */
+  ParameterList extrapolate_(const ParameterList& pSum, const ParameterList& pHigh, double fac) const;
+
+  /**
+   * @brief Replace the high point by a new point if it is better.
+   */
+  void replaceHighest_(const ParameterList& pTry, double yTry);
+
+  /**
+   * @brief Shrink the simplex toward its low point.
+   */
+  void shrink_();
+
+  /**
+   * @brief Compute the function at several points, in parallel if a thread pool is set.
+   *
+   * The function itself is used for the last point, so that it is set to this point afterwards.
+   */
+  void evaluate_(const std::vector<ParameterList>& points, std::vector<double>& values);
 };
 } // end of namespace bpp.
 #endif // BPP_NUMERIC_FUNCTION_DOWNHILLSIMPLEXMETHOD_H
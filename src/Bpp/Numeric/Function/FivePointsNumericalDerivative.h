@@ -52,30 +52,18 @@ class FivePointsNumericalDerivative :
   public AbstractNumericalDerivative
 {
 private:
-  double f1_, f2_, f3_, f4_, f5_;
+  double f3_;
 
 public:
   FivePointsNumericalDerivative(std::shared_ptr<FunctionInterface> function) :
     AbstractNumericalDerivative(function),
-    f1_(),
-    f2_(),
-    f3_(),
-    f4_(),
-    f5_() {}
+    f3_() {}
   FivePointsNumericalDerivative(std::shared_ptr<FirstOrderDerivable> function) :
     AbstractNumericalDerivative(function),
-    f1_(),
-    f2_(),
-    f3_(),
-    f4_(),
-    f5_() {}
+    f3_() {}
   FivePointsNumericalDerivative(std::shared_ptr<SecondOrderDerivable> function) :
     AbstractNumericalDerivative(function),
-    f1_(),
-    f2_(),
-    f3_(),
-    f4_(),
-    f5_() {}
+    f3_() {}
   virtual ~FivePointsNumericalDerivative() {}
 
   FivePointsNumericalDerivative* clone() const override { return new FivePointsNumericalDerivative(*this); }
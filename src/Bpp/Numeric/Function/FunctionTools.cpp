@@ -4,6 +4,7 @@
 
 #include "../../App/ApplicationTools.h"
 #include "FunctionTools.h"
+#include "ReparametrizationFunctionWrapper.h"
 
 using namespace bpp;
 
@@ -124,3 +125,13 @@ shared_ptr<DataTable> FunctionTools::computeGrid(
   // and we are done:
   return data;
 }
+
+std::shared_ptr<FunctionInterface> FunctionTools::deepClone(const FunctionInterface& function)
+{
+  shared_ptr<FunctionInterface> copy(dynamic_cast<FunctionInterface*>(function.clone()));
+  if (auto wrapper = dynamic_pointer_cast<FunctionWrapper>(copy))
+    wrapper->setFunction(deepClone(wrapper->function()));
+  else if (auto reparametrization = dynamic_pointer_cast<ReparametrizationFunctionWrapper>(copy))
+    reparametrization->setFunction(deepClone(reparametrization->function()));
+  return copy;
+}
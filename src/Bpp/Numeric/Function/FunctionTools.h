@@ -78,6 +78,17 @@ public:
   static std::shared_ptr<DataTable> computeGrid(
       FunctionInterface& function,
       const ParameterGrid& grid);
+
+  /**
+   * @brief Copy a function, and recursively the functions it wraps.
+   *
+   * Copies of a FunctionWrapper or of a ReparametrizationFunctionWrapper share the wrapped
+   * function: use this method to obtain a copy which can be used in another thread.
+   *
+   * @param function The function to copy.
+   * @return A copy of the function, sharing no wrapped function with the original.
+   */
+  static std::shared_ptr<FunctionInterface> deepClone(const FunctionInterface& function);
 };
 } // end of namespace bpp
 #endif // BPP_NUMERIC_FUNCTION_FUNCTIONTOOLS_H
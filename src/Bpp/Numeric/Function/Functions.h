@@ -64,6 +64,34 @@ public:
    */
   virtual void setParameters(const ParameterList& parameters) = 0;
 
+  /**
+   * @brief Set the point where the function must be computed, from parameters given by their positions.
+   *
+   * Only parameters whose value differs from the current one are passed to the function. The
+   * default implementation calls setParameters with a list of these parameters, and functions
+   * for which setParameters is equivalent to matchParametersValues can use
+   * matchBoundParametersValues instead, to avoid any name lookup.
+   *
+   * @param slots The positions of the parameters in getParameters(), as returned by bindParameters.
+   * @param values The new values, values[k] corresponding to the parameter at position slots[k].
+   * @param changed An optional mask: if not null, only the slots k for which (*changed)[k] is true are considered.
+   * @see Parametrizable::bindParameters
+   */
+  virtual void setBoundParameters(const std::vector<size_t>& slots, const double* values, const std::vector<bool>* changed = nullptr)
+  {
+    ParameterList pl;
+    for (size_t k = 0; k < slots.size(); ++k)
+    {
+      if (changed && !(*changed)[k])
+        continue;
+      const Parameter& p = getParameters()[slots[k]];
+      if (p.getValue() != values[k])
+        pl.addParameter(new Parameter(p.getName(), values[k]));
+    }
+    if (pl.size() > 0)
+      setParameters(pl);
+  }
+
   /**
    * @brief Get the value of the function at the current point.
    *
@@ -261,6 +289,19 @@ public:
     return function_;
   }
 
+  /**
+   * @brief Change the wrapped function.
+   *
+   * As copies of a wrapper share the wrapped function, this can be used together with
+   * clone() to obtain a fully independent copy of the wrapper.
+   *
+   * @param function The new function to wrap, which must have the same parameters as the current one.
+   */
+  virtual void setFunction(std::shared_ptr<FunctionInterface> function)
+  {
+    function_ = function;
+  }
+
 
   bool hasParameter(const std::string& name) const override
   {
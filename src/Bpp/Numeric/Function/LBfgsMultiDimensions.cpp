@@ -0,0 +1,294 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "LBfgsMultiDimensions.h"
+#include "OneDimensionOptimizationTools.h"
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+LBfgsMultiDimensions::LBfgsMultiDimensions(std::shared_ptr<FirstOrderDerivable> function, size_t memory) :
+  AbstractOptimizer(function),
+  memory_(memory),
+  Up_(),
+  Lo_(),
+  p_(),
+  gradient_(),
+  xi_(),
+  dg_(),
+  s_(),
+  y_(),
+  rho_(),
+  alpha_(),
+  first_(0),
+  nbPairs_(0),
+  active_(),
+  f1dim_(new DirectionFunction(function))
+{
+  if (memory_ == 0)
+    throw Exception("LBfgsMultiDimensions. Memory must be at least 1.");
+  setDefaultStopCondition_(make_shared<FunctionStopCondition>(this));
+  setStopCondition(getDefaultStopCondition());
+  setOptimizationProgressCharacter(".");
+}
+
+/******************************************************************************/
+
+void LBfgsMultiDimensions::doInit(const ParameterList& params)
+{
+  size_t nbParams = params.size();
+  p_.resize(nbParams);
+  gradient_.resize(nbParams);
+  xi_.resize(nbParams);
+  dg_.resize(nbParams);
+  Up_.resize(nbParams);
+  Lo_.resize(nbParams);
+
+  s_.assign(memory_, Vdouble(nbParams));
+  y_.assign(memory_, Vdouble(nbParams));
+  rho_.assign(memory_, 0);
+  alpha_.assign(memory_, 0);
+  active_.assign(nbParams, false);
+  first_ = 0;
+  nbPairs_ = 0;
+
+  for (size_t i = 0; i < nbParams; i++)
+  {
+    auto cp = params[i].getConstraint();
+    if (!cp)
+    {
+      Up_[i] = NumConstants::VERY_BIG();
+      Lo_[i] = -NumConstants::VERY_BIG();
+    }
+    else
+    {
+      Up_[i] = cp->getAcceptedLimit(NumConstants::VERY_BIG()) - NumConstants::TINY();
+      Lo_[i] = cp->getAcceptedLimit(-NumConstants::VERY_BIG()) + NumConstants::TINY();
+    }
+  }
+
+  firstOrderDerivableFunction().enableFirstOrderDerivatives(true);
+  function().setParameters(params);
+
+  getGradient(gradient_);
+  nbGradientEval_++;
+
+  for (size_t i = 0; i < nbParams; ++i)
+  {
+    p_[i] = getParameters()[i].getValue();
+  }
+}
+
+/******************************************************************************/
+
+double LBfgsMultiDimensions::doStep()
+{
+  double f;
+  size_t n = getParameters().size();
+
+  for (size_t i = 0; i < n; ++i)
+  {
+    p_[i] = getParameters()[i].getValue();
+  }
+
+  setDirection_();
+
+  firstOrderDerivableFunction().enableFirstOrderDerivatives(false);
+  auto lineSearchStart = std::chrono::steady_clock::now();
+  nbEval_ += OneDimensionOptimizationTools::lineSearch(f1dim_,
+        getParameters_(), xi_,
+        gradient_,
+        0, 0,
+        getVerbose() > 0 ? getVerbose() - 1 : 0);
+  addLineSearchTime_(lineSearchStart);
+  firstOrderDerivableFunction().enableFirstOrderDerivatives(true);
+
+  for (size_t i = 0; i < n; ++i)
+  {
+    xi_[i] = getParameters_()[i].getValue() - p_[i];
+  }
+
+  f = getFunction()->f(getParameters());
+  if (f > currentValue_)
+  {
+    printMessage("!!! Function increase !!!");
+    printMessage("!!! Optimization might have failed. Try to reparametrize your function to remove constraints.");
+    tolIsReached_ = true;
+    return f;
+  }
+
+  if (tolIsReached_)
+  {
+    return f;
+  }
+
+  for (size_t i = 0; i < n; i++)
+  {
+    dg_[i] = gradient_[i];
+  }
+
+  getGradient(gradient_);
+  nbGradientEval_++;
+
+  for (size_t i = 0; i < n; i++)
+  {
+    dg_[i] = gradient_[i] - dg_[i];
+  }
+
+  double sy(0), sumdg(0), sumxi(0);
+  for (size_t i = 0; i < n; i++)
+  {
+    sy += dg_[i] * xi_[i];
+    sumdg += dg_[i] * dg_[i];
+    sumxi += xi_[i] * xi_[i];
+  }
+
+  // Store the new variation only if the curvature condition is met, as in BfgsMultiDimensions:
+  if (sy > sqrt(1e-7 * sumdg * sumxi))
+  {
+    size_t k;
+    if (nbPairs_ < memory_)
+    {
+      k = (first_ + nbPairs_) % memory_;
+      nbPairs_++;
+    }
+    else
+    {
+      // Overwrite the oldest one:
+      k = first_;
+      first_ = (first_ + 1) % memory_;
+    }
+    s_[k] = xi_;
+    y_[k] = dg_;
+    rho_[k] = 1. / sy;
+  }
+
+  return f;
+}
+
+/******************************************************************************/
+
+void LBfgsMultiDimensions::getGradient(std::vector<double>& gradient) const
+{
+  for (unsigned int i = 0; i < gradient.size(); i++)
+  {
+    gradient[i] = firstOrderDerivableFunction().getFirstOrderDerivative(getParameters()[i].getName());
+  }
+}
+
+/******************************************************************************/
+
+void LBfgsMultiDimensions::setDirection_()
+{
+  size_t nbParams = getParameters().size();
+
+  // Parameters on a bound with the gradient pointing outside are kept fixed,
+  // and the recursion is restricted to the other ones:
+  for (size_t i = 0; i < nbParams; ++i)
+  {
+    active_[i] = (p_[i] >= Up_[i] - NumConstants::TINY() && gradient_[i] < 0)
+                 || (p_[i] <= Lo_[i] + NumConstants::TINY() && gradient_[i] > 0);
+  }
+
+  // Two-loop recursion, from the newest to the oldest variation and back:
+  for (size_t i = 0; i < nbParams; ++i)
+  {
+    xi_[i] = active_[i] ? 0 : -gradient_[i];
+  }
+  for (size_t j = nbPairs_; j > 0; --j)
+  {
+    size_t k = (first_ + j - 1) % memory_;
+    double a = 0;
+    for (size_t i = 0; i < nbParams; ++i)
+    {
+      a += s_[k][i] * xi_[i];
+    }
+    alpha_[k] = rho_[k] * a;
+    for (size_t i = 0; i < nbParams; ++i)
+    {
+      if (!active_[i])
+        xi_[i] -= alpha_[k] * y_[k][i];
+    }
+  }
+  if (nbPairs_ > 0)
+  {
+    // Scale the initial approximation of the inverse Hessian with the newest variation:
+    size_t k = (first_ + nbPairs_ - 1) % memory_;
+    double yy = 0;
+    for (size_t i = 0; i < nbParams; ++i)
+    {
+      if (!active_[i])
+        yy += y_[k][i] * y_[k][i];
+    }
+    double gamma = yy > 0 ? 1. / (rho_[k] * yy) : 1.;
+    for (size_t i = 0; i < nbParams; ++i)
+    {
+      xi_[i] *= gamma;
+    }
+  }
+  for (size_t j = 0; j < nbPairs_; ++j)
+  {
+    size_t k = (first_ + j) % memory_;
+    double b = 0;
+    for (size_t i = 0; i < nbParams; ++i)
+    {
+      b += y_[k][i] * xi_[i];
+    }
+    b *= rho_[k];
+    for (size_t i = 0; i < nbParams; ++i)
+    {
+      if (!active_[i])
+        xi_[i] += (alpha_[k] - b) * s_[k][i];
+    }
+  }
+
+  boundDirection_();
+
+  double slope = 0;
+  for (size_t i = 0; i < nbParams; ++i)
+  {
+    slope += xi_[i] * gradient_[i];
+  }
+  if (slope >= 0 && nbPairs_ > 0)
+  {
+    // Not a descent direction: restart from the steepest descent.
+    first_ = 0;
+    nbPairs_ = 0;
+    for (size_t i = 0; i < nbParams; ++i)
+    {
+      xi_[i] = active_[i] ? 0 : -gradient_[i];
+    }
+    boundDirection_();
+  }
+}
+
+/******************************************************************************/
+
+void LBfgsMultiDimensions::boundDirection_()
+{
+  size_t nbParams = getParameters().size();
+
+  double v = 1, alpmax = 1;
+  for (size_t i = 0; i < nbParams; ++i)
+  {
+    if ((xi_[i] > 0) && (p_[i] + NumConstants::TINY() * xi_[i] < Up_[i]))
+      v = (Up_[i] - p_[i]) / xi_[i];
+    else if ((xi_[i] < 0) && (p_[i] + NumConstants::TINY() * xi_[i] > Lo_[i]))
+      v = (Lo_[i] - p_[i]) / xi_[i];
+    if (v < alpmax)
+      alpmax = v;
+  }
+
+  for (size_t i = 0; i < nbParams; i++)
+  {
+    if (p_[i] + NumConstants::TINY() * xi_[i] >= Up_[i])
+      xi_[i] = Up_[i] - p_[i];
+    else if (p_[i] + NumConstants::TINY() * xi_[i] <= Lo_[i])
+      xi_[i] = Lo_[i] - p_[i];
+    else
+      xi_[i] *= alpmax;
+  }
+}
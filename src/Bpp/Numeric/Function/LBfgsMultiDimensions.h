@@ -0,0 +1,159 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_NUMERIC_FUNCTION_LBFGSMULTIDIMENSIONS_H
+#define BPP_NUMERIC_FUNCTION_LBFGSMULTIDIMENSIONS_H
+
+
+#include "../VectorTools.h"
+#include "AbstractOptimizer.h"
+#include "DirectionFunction.h"
+
+namespace bpp
+{
+/**
+ * @brief Limited memory Broyden–Fletcher–Goldfarb–Shanno (L-BFGS) optimization method.
+ *
+ * Instead of storing the approximation of the inverse Hessian matrix as BfgsMultiDimensions does,
+ * this method keeps the last @f$m@f$ variations of parameters and gradients, from which the search
+ * direction is computed with the two-loop recursion of:
+ *
+ *  Updating quasi-Newton matrices with limited storage, Jorge Nocedal.
+ *    Math Comp (1980) 35:773-782
+ *
+ * Memory use and computation time of each step are in @f$O(m \times n)@f$ for @f$n@f$ parameters,
+ * so that this method is suitable for large numbers of parameters.
+ * Simple bounds on parameters are handled as in BfgsMultiDimensions: the direction is shortened
+ * so that the line search stays within the bounds. In addition, parameters lying on a bound with
+ * the gradient pointing outside are kept fixed during the step, and the direction is computed for
+ * the other parameters only. When this does not yield a descent direction, the stored variations
+ * are discarded and the steepest descent direction is used.
+ */
+class LBfgsMultiDimensions :
+  public AbstractOptimizer
+{
+protected:
+  /**
+   * @brief The number of variations to store.
+   */
+  size_t memory_;
+
+  // vectors of the Lower & Upper bounds of the parameters
+  Vdouble Up_, Lo_;
+
+  mutable Vdouble p_, gradient_, xi_, dg_;
+
+  /**
+   * @brief Circular buffers of the last variations of parameters (s) and gradients (y).
+   *
+   * The oldest variation is at position first_, and nbPairs_ variations are stored.
+   */
+  VVdouble s_, y_;
+  Vdouble rho_, alpha_;
+  size_t first_, nbPairs_;
+
+  /**
+   * @brief Parameters kept fixed on one of their bounds for the current step.
+   */
+  std::vector<bool> active_;
+
+  mutable std::shared_ptr<DirectionFunction> f1dim_;
+
+public:
+  /**
+   * @brief Build a new LBfgsMultiDimensions optimizer.
+   *
+   * @param function The function to optimize.
+   * @param memory The number of variations of parameters and gradients to store.
+   */
+  LBfgsMultiDimensions(std::shared_ptr<FirstOrderDerivable> function, size_t memory = 10);
+
+  virtual ~LBfgsMultiDimensions() {}
+
+  LBfgsMultiDimensions* clone() const override { return new LBfgsMultiDimensions(*this); }
+
+public:
+  /**
+   * @name From AbstractOptimizer.
+   *
+   * @{
+   */
+  void setFunction(std::shared_ptr<FunctionInterface> function) override
+  {
+    AbstractOptimizer::setFunction(function);
+    f1dim_ = std::make_shared<DirectionFunction>(function);
+  }
+
+  void doInit(const ParameterList& params) override;
+
+  double doStep() override;
+  /** @} */
+
+  /**
+   * @brief Set the number of variations of parameters and gradients to store.
+   *
+   * This takes effect at the next call of init().
+   *
+   * @param memory The number of variations (at least 1).
+   */
+  void setMemory(size_t memory)
+  {
+    if (memory == 0)
+      throw Exception("LBfgsMultiDimensions::setMemory. Memory must be at least 1.");
+    memory_ = memory;
+  }
+
+  size_t getMemory() const { return memory_; }
+
+  const FirstOrderDerivable& firstOrderDerivableFunction() const
+  {
+    if (function_)
+    {
+      return *dynamic_pointer_cast<const FirstOrderDerivable>(function_);
+    }
+    else
+    {
+      throw NullPointerException("LBfgsMultiDimensions::firstOrderDerivableFunction() : no function associated to this optimizer.");
+    }
+  }
+
+  FirstOrderDerivable& firstOrderDerivableFunction()
+  {
+    if (function_)
+    {
+      return *dynamic_pointer_cast<FirstOrderDerivable>(function_);
+    }
+    else
+    {
+      throw NullPointerException("LBfgsMultiDimensions::firstOrderDerivableFunction() : no function associated to this optimizer.");
+    }
+  }
+
+  std::shared_ptr<const FirstOrderDerivable> getFirstOrderDerivableFunction() const
+  {
+    return dynamic_pointer_cast<const FirstOrderDerivable>(function_);
+  }
+
+  std::shared_ptr<FirstOrderDerivable> getFirstOrderDerivableFunction()
+  {
+    return dynamic_pointer_cast<FirstOrderDerivable>(function_);
+  }
+
+  void getGradient(std::vector<double>& gradient) const;
+
+private:
+  /**
+   * @brief Compute the search direction from the stored variations, with the two-loop recursion.
+   *
+   * To be used after gradient_ & p_ are computed.
+   */
+  void setDirection_();
+
+  /**
+   * @brief Shorten the direction so that the line search stays within the bounds.
+   */
+  void boundDirection_();
+};
+} // end of namespace bpp.
+#endif // BPP_NUMERIC_FUNCTION_LBFGSMULTIDIMENSIONS_H
@@ -24,7 +24,9 @@ MetaOptimizer::MetaOptimizer(
   AbstractOptimizer(function),
   optDesc_(std::move(desc)), optParameters_(optDesc_->getNumberOfOptimizers()),
   nbParameters_(optDesc_->getNumberOfOptimizers()), n_(n),
-  precisionStep_(-1.), stepCount_(0), initialValue_(-1.)
+  precisionStep_(-1.), stepCount_(0), initialValue_(-1.),
+  adaptive_(false), maxRepeats_(4), rates_(), lastValues_(), lastPoints_(), converged_(),
+  firstOrderFunction_(), secondOrderFunction_(), derivatives_(0)
 {
   setDefaultStopCondition_(make_shared<FunctionStopCondition>(this));
   setStopCondition(getDefaultStopCondition());
@@ -43,7 +45,16 @@ MetaOptimizer::MetaOptimizer(
   n_(opt.n_),
   precisionStep_(opt.precisionStep_),
   stepCount_(opt.stepCount_),
-  initialValue_(opt.initialValue_)
+  initialValue_(opt.initialValue_),
+  adaptive_(opt.adaptive_),
+  maxRepeats_(opt.maxRepeats_),
+  rates_(opt.rates_),
+  lastValues_(opt.lastValues_),
+  lastPoints_(opt.lastPoints_),
+  converged_(opt.converged_),
+  firstOrderFunction_(opt.firstOrderFunction_),
+  secondOrderFunction_(opt.secondOrderFunction_),
+  derivatives_(opt.derivatives_)
 {}
 
 /**************************************************************************/
@@ -59,6 +70,15 @@ MetaOptimizer& MetaOptimizer::operator=(
   precisionStep_ = opt.precisionStep_;
   stepCount_     = opt.stepCount_;
   initialValue_  = opt.initialValue_;
+  adaptive_      = opt.adaptive_;
+  maxRepeats_    = opt.maxRepeats_;
+  rates_         = opt.rates_;
+  lastValues_    = opt.lastValues_;
+  lastPoints_    = opt.lastPoints_;
+  converged_     = opt.converged_;
+  firstOrderFunction_  = opt.firstOrderFunction_;
+  secondOrderFunction_ = opt.secondOrderFunction_;
+  derivatives_   = opt.derivatives_;
   return *this;
 }
 
@@ -86,10 +106,17 @@ void MetaOptimizer::doInit(const ParameterList& parameters)
   }
 
   // Initialize optimizers:
+  firstOrderFunction_ = dynamic_pointer_cast<FirstOrderDerivable>(getFunction());
+  secondOrderFunction_ = dynamic_pointer_cast<SecondOrderDerivable>(getFunction());
+  derivatives_ = 0;
   for (unsigned int i = 0; i < optDesc_->getNumberOfOptimizers(); ++i)
   {
     if (nbParameters_[i] > 0)
     {
+      if (optDesc_->requiresFirstOrderDerivatives(i) && !firstOrderFunction_)
+        throw Exception("MetaOptimizer::init. Optimizer " + optDesc_->getName(i) + " requires first order derivatives.");
+      if (optDesc_->requiresSecondOrderDerivatives(i) && !secondOrderFunction_)
+        throw Exception("MetaOptimizer::init. Optimizer " + optDesc_->getName(i) + " requires second order derivatives.");
       OptimizerInterface& opt = optDesc_->optimizer(i);
       opt.updateParameters(updateParameters());
       opt.setProfiler(getProfiler());
@@ -104,6 +131,11 @@ void MetaOptimizer::doInit(const ParameterList& parameters)
 
   getFunction()->setParameters(getParameters());
   initialValue_ = getFunction()->getValue();
+  // Forget previous iterations:
+  rates_.assign(optDesc_->getNumberOfOptimizers(), -1.);
+  lastValues_.assign(optDesc_->getNumberOfOptimizers(), initialValue_);
+  lastPoints_.assign(optDesc_->getNumberOfOptimizers(), vector<double>());
+  converged_.assign(optDesc_->getNumberOfOptimizers(), false);
   // Reset counter:
   stepCount_ = 1;
   // Recompute step if precision has changed:
@@ -116,52 +148,162 @@ double MetaOptimizer::doStep()
 {
   stepCount_++;
 
-  int tolTest = 0;
   double tol = getStopCondition()->getTolerance();
   if (stepCount_ <= n_)
   {
     tol = initialValue_ * pow(10, stepCount_ * precisionStep_);
   }
 
-  for (unsigned int i = 0; i < optDesc_->getNumberOfOptimizers(); ++i)
+  vector<unsigned int> nbRuns = schedule_(tol);
+  int tolTest = 0;
+  for (size_t i = 0; i < optDesc_->getNumberOfOptimizers(); ++i)
   {
-    if (nbParameters_[i] > 0)
+    for (unsigned int k = 0; k < nbRuns[i] && !(k > 0 && converged_[i]); ++k)
     {
-      if (getVerbose() > 1 && ApplicationTools::message)
-      {
-        (ApplicationTools::message->endLine() << optDesc_->getName(i)).endLine();
-        ApplicationTools::message->flush();
-      }
-      if (optDesc_->requiresFirstOrderDerivatives(i))
-        dynamic_cast<FirstOrderDerivable&>(function()).enableFirstOrderDerivatives(true);
-      if (optDesc_->requiresSecondOrderDerivatives(i))
-        dynamic_cast<SecondOrderDerivable&>(function()).enableSecondOrderDerivatives(true);
-
-      optParameters_[i].matchParametersValues(getParameters());
-      OptimizerInterface& opt = optDesc_->optimizer(i);
-      opt.getStopCondition()->setTolerance(tol);
-      opt.init(optParameters_[i]);
-      if (optDesc_->getIterationType(i) == MetaOptimizerInfos::IT_TYPE_STEP)
-        opt.step();
-      else if (optDesc_->getIterationType(i) == MetaOptimizerInfos::IT_TYPE_FULL)
-        opt.optimize();
-      else
-        throw Exception("MetaOptimizer::step. Unknown iteration type specified.");
-      nbEval_ += opt.getNumberOfEvaluations();
-      if (optDesc_->requiresFirstOrderDerivatives(i))
-        dynamic_cast<FirstOrderDerivable&>(function()).enableFirstOrderDerivatives(false);
-      if (optDesc_->requiresSecondOrderDerivatives(i))
-        dynamic_cast<SecondOrderDerivable&>(function()).enableSecondOrderDerivatives(false);
-      if (getVerbose() > 1)
-        cout << endl;
-
-      getParameters_().matchParametersValues(opt.getParameters());
+      runOptimizer_(i, tol);
     }
     tolTest += nbParameters_[i] > 0 ? 1 : 0;
   }
-  tolIsReached_ = (tolTest == 1);
+  setDerivatives_(0);
+
+  if (adaptive_)
+  {
+    // Check that no optimizer may improve the function further:
+    double value = getFunction()->getValue();
+    tolIsReached_ = true;
+    for (size_t i = 0; i < optDesc_->getNumberOfOptimizers(); ++i)
+    {
+      if (nbParameters_[i] > 0 && !(converged_[i] && lastValues_[i] - value <= tol))
+        tolIsReached_ = false;
+    }
+  }
+  else
+  {
+    tolIsReached_ = (tolTest == 1);
+  }
 
   return getFunction()->getValue();
 }
 
 /**************************************************************************/
+
+vector<unsigned int> MetaOptimizer::schedule_(double tol) const
+{
+  size_t n = optDesc_->getNumberOfOptimizers();
+  vector<unsigned int> nbRuns(n, 0);
+  double value = getFunction()->getValue();
+  double sumRates = 0;
+  unsigned int nbRates = 0;
+  for (size_t i = 0; i < n; ++i)
+  {
+    if (nbParameters_[i] == 0)
+      continue;
+    // Converged optimizers are skipped, unless the others moved the function significantly since:
+    if (adaptive_ && converged_[i] && lastValues_[i] - value <= tol)
+      continue;
+    nbRuns[i] = 1;
+    if (rates_[i] > 0)
+    {
+      sumRates += rates_[i];
+      nbRates++;
+    }
+  }
+  if (adaptive_ && nbRates > 1)
+  {
+    double meanRate = sumRates / nbRates;
+    for (size_t i = 0; i < n; ++i)
+    {
+      if (nbRuns[i] > 0 && rates_[i] > meanRate)
+        nbRuns[i] = min(maxRepeats_, static_cast<unsigned int>(floor(rates_[i] / meanRate + 0.5)));
+    }
+  }
+  return nbRuns;
+}
+
+/**************************************************************************/
+
+void MetaOptimizer::runOptimizer_(size_t i, double tol)
+{
+  if (getVerbose() > 1 && ApplicationTools::message)
+  {
+    (ApplicationTools::message->endLine() << optDesc_->getName(i)).endLine();
+    ApplicationTools::message->flush();
+  }
+  auto start = chrono::steady_clock::now();
+  setDerivatives_(optDesc_->requiresSecondOrderDerivatives(i) ? 2 : (optDesc_->requiresFirstOrderDerivatives(i) ? 1 : 0));
+
+  OptimizerInterface& opt = optDesc_->optimizer(i);
+  AbstractOptimizer* aopt = dynamic_cast<AbstractOptimizer*>(&opt);
+  opt.getStopCondition()->setTolerance(tol);
+
+  // The optimizer is initialized again only if some parameters changed since its last iteration:
+  const ParameterList& pl = getParameters();
+  bool moved = lastPoints_[i].size() != pl.size();
+  for (size_t j = 0; !moved && j < pl.size(); ++j)
+  {
+    moved = pl[j].getValue() != lastPoints_[i][j];
+  }
+  double valueBefore = getFunction()->getValue();
+  unsigned int nbEval = 0, nbGradientEval = 0;
+  double lineSearchTime = 0;
+  if (moved)
+  {
+    optParameters_[i].matchParametersValues(pl);
+    opt.init(optParameters_[i]);
+  }
+  else
+  {
+    nbEval = opt.getNumberOfEvaluations();
+    if (aopt)
+    {
+      nbGradientEval = aopt->getNumberOfGradientEvaluations();
+      lineSearchTime = aopt->getLineSearchTime();
+    }
+  }
+
+  if (optDesc_->getIterationType(i) == MetaOptimizerInfos::IT_TYPE_STEP)
+    opt.step();
+  else if (optDesc_->getIterationType(i) == MetaOptimizerInfos::IT_TYPE_FULL)
+  {
+    opt.optimize();
+    nbEval = 0; // Counter is reset by optimize().
+  }
+  else
+    throw Exception("MetaOptimizer::step. Unknown iteration type specified.");
+
+  nbEval_ += opt.getNumberOfEvaluations() >= nbEval ? opt.getNumberOfEvaluations() - nbEval : opt.getNumberOfEvaluations();
+  if (aopt)
+  {
+    nbGradientEval_ += aopt->getNumberOfGradientEvaluations() - nbGradientEval;
+    lineSearchTime_ += aopt->getLineSearchTime() - lineSearchTime;
+  }
+  if (getVerbose() > 1)
+    cout << endl;
+
+  getParameters_().matchParametersValues(opt.getParameters());
+
+  // Record the improvement of the function:
+  double valueAfter = getFunction()->getValue();
+  double time = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  rates_[i] = max(valueBefore - valueAfter, 0.) / max(time, 1e-9);
+  converged_[i] = valueBefore - valueAfter <= tol;
+  lastValues_[i] = valueAfter;
+  lastPoints_[i].resize(pl.size());
+  for (size_t j = 0; j < pl.size(); ++j)
+  {
+    lastPoints_[i][j] = pl[j].getValue();
+  }
+}
+
+/**************************************************************************/
+
+void MetaOptimizer::setDerivatives_(unsigned short order)
+{
+  if ((order > 0) != (derivatives_ > 0))
+    firstOrderFunction_->enableFirstOrderDerivatives(order > 0);
+  if ((order > 1) != (derivatives_ > 1))
+    secondOrderFunction_->enableSecondOrderDerivatives(order > 1);
+  derivatives_ = order;
+}
+
+/**************************************************************************/
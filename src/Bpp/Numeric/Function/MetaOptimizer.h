@@ -155,6 +155,20 @@ public:
  *
  * This optimizer can be used with numerical derivatives.
  *
+ * An optimizer is not initialized again if none of the parameters changed since its last
+ * iteration, so that optimizers performing one step at a time keep their internal state
+ * (for instance the approximation of the Hessian matrix in BfgsMultiDimensions).
+ * Derivatives of the function are enabled only when switching to an optimizer which requires
+ * them, and disabled at the end of each step.
+ *
+ * With adaptive scheduling (see setAdaptiveScheduling), the improvement of the function per
+ * second of computation is measured for each optimizer. At each step, optimizers are run in turn
+ * as before, but optimizers with an improvement rate above the average are run several times
+ * in a row, up to a maximum number of repeats. An optimizer which improved the function by less
+ * than the current tolerance is considered as converged, and is skipped until the other
+ * optimizers improved the function by more than the tolerance. The optimization stops when all
+ * optimizers have converged.
+ *
  * @see MetaOptimizerInfos.
  */
 class MetaOptimizer :
@@ -169,6 +183,31 @@ private:
   unsigned int stepCount_;
   double initialValue_;
 
+  bool adaptive_;
+  unsigned int maxRepeats_;
+
+  /**
+   * @brief For each optimizer, the improvement of the function per second during its last iteration.
+   *
+   * A negative value means that the optimizer was not run yet.
+   */
+  std::vector<double> rates_;
+
+  /**
+   * @brief For each optimizer, the value of the function and the values of all parameters after its last iteration.
+   */
+  std::vector<double> lastValues_;
+  std::vector< std::vector<double> > lastPoints_;
+  std::vector<bool> converged_;
+
+  std::shared_ptr<FirstOrderDerivable> firstOrderFunction_;
+  std::shared_ptr<SecondOrderDerivable> secondOrderFunction_;
+
+  /**
+   * @brief The order of the derivatives currently enabled (0, 1 or 2).
+   */
+  unsigned short derivatives_;
+
 public:
   /**
    * @brief Build a new MetaOptimizer object.
@@ -196,6 +235,8 @@ public:
     {
       optDesc_->getOptimizer(i)->setFunction(function);
     }
+    firstOrderFunction_ = nullptr;
+    secondOrderFunction_ = nullptr;
   }
 
   void doInit(const ParameterList& parameters) override;
@@ -211,6 +252,51 @@ public:
    * @return The MetaOptimizerInfos object associated to this optimizer.
    */
   const MetaOptimizerInfos optimizers() const { return *optDesc_; }
+
+  /**
+   * @brief Enable or disable the adaptive scheduling of optimizers.
+   *
+   * @param yn Tell if the number of iterations of each optimizer should depend on its improvement rate.
+   */
+  void setAdaptiveScheduling(bool yn) { adaptive_ = yn; }
+
+  bool isAdaptiveScheduling() const { return adaptive_; }
+
+  /**
+   * @brief Set the maximum number of iterations in a row of one optimizer, with adaptive scheduling.
+   *
+   * @param maxRepeats The maximum number of iterations (at least 1).
+   */
+  void setMaximumNumberOfRepeats(unsigned int maxRepeats)
+  {
+    if (maxRepeats == 0)
+      throw Exception("MetaOptimizer::setMaximumNumberOfRepeats. Number of repeats must be at least 1.");
+    maxRepeats_ = maxRepeats;
+  }
+
+  unsigned int getMaximumNumberOfRepeats() const { return maxRepeats_; }
+
+  /**
+   * @return The improvement of the function per second during the last iteration of the ith optimizer,
+   * or a negative value if it was not run yet.
+   */
+  double getImprovementRate(size_t i) const { return rates_[i]; }
+
+private:
+  /**
+   * @return The number of iterations of each optimizer for the current step.
+   */
+  std::vector<unsigned int> schedule_(double tol) const;
+
+  /**
+   * @brief Perform one iteration of the ith optimizer.
+   */
+  void runOptimizer_(size_t i, double tol);
+
+  /**
+   * @brief Enable the derivatives of the function up to the given order, and disable the others.
+   */
+  void setDerivatives_(unsigned short order);
 };
 } // end of namespace bpp.
 #endif // BPP_NUMERIC_FUNCTION_METAOPTIMIZER_H
@@ -0,0 +1,166 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "FunctionTools.h"
+#include "MultiStartOptimizer.h"
+
+// From the STL:
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+using namespace bpp;
+using namespace std;
+
+namespace
+{
+/**
+ * @brief Thrown by MultiStartListener to interrupt an optimization.
+ */
+class StartInterruption :
+  public Exception
+{
+public:
+  StartInterruption() :
+    Exception("MultiStartOptimizer. Start interrupted.") {}
+};
+
+/**
+ * @brief Count the steps of one start, share its values and interrupt it when needed.
+ */
+class MultiStartListener :
+  public OptimizationListener
+{
+private:
+  atomic<double>& incumbent_;
+  const atomic<bool>& stop_;
+  double threshold_;
+  unsigned int minNbSteps_;
+
+public:
+  unsigned int nbSteps;
+
+public:
+  MultiStartListener(atomic<double>& incumbent, const atomic<bool>& stop, double threshold, unsigned int minNbSteps) :
+    incumbent_(incumbent), stop_(stop), threshold_(threshold), minNbSteps_(minNbSteps), nbSteps(0) {}
+
+public:
+  void optimizationInitializationPerformed(const OptimizationEvent& /* event */) {}
+
+  void optimizationStepPerformed(const OptimizationEvent& event)
+  {
+    nbSteps++;
+    double value = event.getOptimizer()->getFunctionValue();
+    double best = incumbent_.load();
+    while (value < best && !incumbent_.compare_exchange_weak(best, value))
+    {}
+    if (stop_.load())
+      throw StartInterruption();
+    if (nbSteps >= minNbSteps_ && value > best + threshold_)
+      throw StartInterruption();
+  }
+
+  bool listenerModifiesParameters() const { return false; }
+};
+
+/**
+ * @brief Sort key of a result, NaN values being ranked last.
+ */
+double rankValue(const MultiStartResult& result)
+{
+  return std::isnan(result.value) ? numeric_limits<double>::infinity() : result.value;
+}
+}
+
+/******************************************************************************/
+
+MultiStartOptimizer::MultiStartOptimizer(std::shared_ptr<OptimizerInterface> optimizer) :
+  optimizer_(optimizer),
+  threadPool_(),
+  abandonThreshold_(numeric_limits<double>::infinity()),
+  abandonMinNbSteps_(1),
+  targetValue_(-numeric_limits<double>::infinity())
+{
+  if (!optimizer_ || !optimizer_->hasFunction())
+    throw Exception("MultiStartOptimizer. The optimizer must be associated to a function.");
+}
+
+/******************************************************************************/
+
+std::vector<MultiStartResult> MultiStartOptimizer::optimize(const std::vector<ParameterList>& starts) const
+{
+  // One independent copy of the function for each thread:
+  size_t nbThreads = threadPool_ ? threadPool_->getNumberOfThreads() : 1;
+  vector< shared_ptr<FunctionInterface> > functions(nbThreads);
+  for (size_t t = 0; t < nbThreads; ++t)
+  {
+    functions[t] = FunctionTools::deepClone(*optimizer_->getFunction());
+  }
+
+  atomic<double> incumbent(numeric_limits<double>::infinity());
+  atomic<bool> stop(false);
+  vector<MultiStartResult> results(starts.size());
+  // Not vector<bool>, whose packed elements cannot be written by several threads:
+  vector<unsigned char> run(starts.size(), 0);
+
+  auto optimizeStart = [&](size_t s, size_t thread) {
+    if (stop.load())
+      return;
+    shared_ptr<OptimizerInterface> optimizer(optimizer_->clone());
+    optimizer->setFunction(functions[thread]);
+    optimizer->setVerbose(0);
+    optimizer->setMessageHandler(nullptr);
+    optimizer->setProfiler(nullptr);
+    auto listener = make_shared<MultiStartListener>(incumbent, stop, abandonThreshold_, abandonMinNbSteps_);
+    optimizer->addOptimizationListener(listener);
+
+    MultiStartResult& result = results[s];
+    result.start = s;
+    auto begin = chrono::steady_clock::now();
+    try
+    {
+      optimizer->init(starts[s]);
+      optimizer->optimize();
+    }
+    catch (StartInterruption& si)
+    {
+      result.abandoned = true;
+    }
+    result.time = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    result.parameters = optimizer->getParameters();
+    result.value = optimizer->getFunctionValue();
+    result.nbEvaluations = optimizer->getNumberOfEvaluations();
+    result.nbSteps = listener->nbSteps;
+    run[s] = 1;
+
+    double best = incumbent.load();
+    while (result.value < best && !incumbent.compare_exchange_weak(best, result.value))
+    {}
+    if (result.value <= targetValue_)
+      stop.store(true);
+  };
+
+  if (threadPool_)
+    threadPool_->parallelFor(starts.size(), optimizeStart);
+  else
+  {
+    for (size_t s = 0; s < starts.size(); ++s)
+    {
+      optimizeStart(s, 0);
+    }
+  }
+
+  vector<MultiStartResult> ranked;
+  for (size_t s = 0; s < starts.size(); ++s)
+  {
+    if (run[s])
+      ranked.push_back(results[s]);
+  }
+  stable_sort(ranked.begin(), ranked.end(), [](const MultiStartResult& a, const MultiStartResult& b) {
+    return rankValue(a) < rankValue(b);
+  });
+  return ranked;
+}
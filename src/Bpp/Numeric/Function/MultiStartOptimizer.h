@@ -0,0 +1,156 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_NUMERIC_FUNCTION_MULTISTARTOPTIMIZER_H
+#define BPP_NUMERIC_FUNCTION_MULTISTARTOPTIMIZER_H
+
+
+#include "../../Utils/ThreadPool.h"
+#include "Optimizer.h"
+
+// From the STL:
+#include <memory>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Result of the optimization of one starting point by a MultiStartOptimizer.
+ */
+class MultiStartResult
+{
+public:
+  /**
+   * @brief The index of the starting point.
+   */
+  size_t start;
+
+  /**
+   * @brief The parameters at the end of the optimization.
+   */
+  ParameterList parameters;
+
+  /**
+   * @brief The function value at the end of the optimization.
+   */
+  double value;
+
+  /**
+   * @brief The number of function evaluations, as returned by OptimizerInterface::getNumberOfEvaluations().
+   */
+  unsigned int nbEvaluations;
+
+  /**
+   * @brief The number of optimization steps performed.
+   */
+  unsigned int nbSteps;
+
+  /**
+   * @brief The wall time of the optimization, in seconds.
+   */
+  double time;
+
+  /**
+   * @brief Tell if the optimization was abandoned before convergence (see MultiStartOptimizer::setAbandonThreshold).
+   */
+  bool abandoned;
+
+public:
+  MultiStartResult() :
+    start(0), parameters(), value(0), nbEvaluations(0), nbSteps(0), time(0), abandoned(false) {}
+};
+
+/**
+ * @brief Optimize a function from several starting points, in parallel.
+ *
+ * Each starting point is optimized by a copy of a prototype optimizer, set up with the
+ * desired stop condition, constraint policy, etc. The function of the prototype is copied
+ * once for each thread of the pool, so that the starting points can be processed
+ * concurrently. Functions wrapped by a FunctionWrapper (e.g. numerical derivatives) or a
+ * ReparametrizationFunctionWrapper are copied as well, at any depth. Starting points are
+ * distributed dynamically over the threads, so that starts of unequal durations are balanced.
+ *
+ * The best function value reached so far by any start (the incumbent) is shared between
+ * threads, and can be used to terminate starts early:
+ * - a start is abandoned if, after a given number of steps, its current value is still
+ *   worse than the incumbent by more than a threshold (see setAbandonThreshold);
+ * - all starts are stopped, and the remaining ones skipped, once the incumbent reaches a
+ *   target value (see setTargetValue).
+ *
+ * Without early termination, the result of each start only depends on the starting point,
+ * and results are identical whatever the number of threads. With early termination, which
+ * starts are cut depends on the order in which they are processed.
+ *
+ * The prototype optimizer and its function are not modified. Messages and profiles of the
+ * copies are disabled, as they would be interleaved.
+ */
+class MultiStartOptimizer
+{
+private:
+  std::shared_ptr<OptimizerInterface> optimizer_;
+  std::shared_ptr<ThreadPool> threadPool_;
+  double abandonThreshold_;
+  unsigned int abandonMinNbSteps_;
+  double targetValue_;
+
+public:
+  /**
+   * @brief Build a new MultiStartOptimizer.
+   *
+   * @param optimizer The prototype optimizer, associated to the function to optimize. Both
+   * are copied for each thread. Apart from wrapped functions, which are copied too, copies
+   * of the function must not share state modified when optimizing.
+   */
+  MultiStartOptimizer(std::shared_ptr<OptimizerInterface> optimizer);
+
+  virtual ~MultiStartOptimizer() {}
+
+public:
+  /**
+   * @brief Set the thread pool used to optimize the starting points in parallel.
+   *
+   * @param threadPool A thread pool, or a null pointer for a serial computation (the default).
+   */
+  void setThreadPool(std::shared_ptr<ThreadPool> threadPool) { threadPool_ = threadPool; }
+
+  std::shared_ptr<ThreadPool> getThreadPool() const { return threadPool_; }
+
+  /**
+   * @brief Abandon starts which are not promising.
+   *
+   * @param threshold A start is abandoned if its current value is greater than the incumbent plus this threshold.
+   * Use infinity (the default) to never abandon starts.
+   * @param minNbSteps The number of optimization steps a start performs before it can be abandoned.
+   */
+  void setAbandonThreshold(double threshold, unsigned int minNbSteps = 1)
+  {
+    abandonThreshold_ = threshold;
+    abandonMinNbSteps_ = minNbSteps;
+  }
+
+  double getAbandonThreshold() const { return abandonThreshold_; }
+
+  unsigned int getAbandonMinimumNumberOfSteps() const { return abandonMinNbSteps_; }
+
+  /**
+   * @brief Stop all starts once a function value is reached.
+   *
+   * @param target The target value. Use -infinity (the default) to optimize all starts until convergence.
+   */
+  void setTargetValue(double target) { targetValue_ = target; }
+
+  double getTargetValue() const { return targetValue_; }
+
+  /**
+   * @brief Optimize the function from each starting point.
+   *
+   * @param starts The starting points. Each list is passed to OptimizerInterface::init.
+   * @return The results of the starts which were run, sorted by increasing function value
+   * (and by index of the starting point in case of ties). Starts skipped because the target
+   * value was reached are not reported.
+   */
+  std::vector<MultiStartResult> optimize(const std::vector<ParameterList>& starts) const;
+};
+} // end of namespace bpp.
+#endif // BPP_NUMERIC_FUNCTION_MULTISTARTOPTIMIZER_H
@@ -42,6 +42,7 @@ double NewtonOneDimension::doStep()
   double newValue;
   double firstOrderDerivative = firstOrderDerivableFunction().getFirstOrderDerivative(_param);
   double secondOrderDerivative = secondOrderDerivableFunction().getSecondOrderDerivative(_param);
+  nbGradientEval_++;
   if (secondOrderDerivative <= 0)
   {
     printMessage("!!! Second order derivative is negative (" + TextTools::toString(getParameters()[0].getValue()) + "). No move performed.");
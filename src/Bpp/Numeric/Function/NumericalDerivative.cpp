@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "FunctionTools.h"
+#include "NumericalDerivative.h"
+
+using namespace bpp;
+using namespace std;
+
+void AbstractNumericalDerivative::setPoint_()
+{
+  const ParameterList& pl = function_->getParameters();
+  point_.resize(pl.size());
+  pointSlots_.resize(pl.size());
+  for (size_t i = 0; i < pl.size(); ++i)
+  {
+    point_[i] = pl[i].getValue();
+    pointSlots_[i] = i;
+  }
+
+  if (!threadPool_)
+    return;
+  size_t nbThreads = threadPool_->getNumberOfThreads();
+  if (workers_.size() != nbThreads || workers_[0]->getNumberOfParameters() != pl.size())
+  {
+    workers_.clear();
+    for (size_t t = 0; t < nbThreads; ++t)
+    {
+      shared_ptr<FunctionInterface> worker = FunctionTools::deepClone(*function_);
+      // Analytical derivatives are not needed for the evaluations:
+      auto worker1 = dynamic_pointer_cast<FirstOrderDerivable>(worker);
+      if (worker1)
+        worker1->enableFirstOrderDerivatives(false);
+      auto worker2 = dynamic_pointer_cast<SecondOrderDerivable>(worker);
+      if (worker2)
+        worker2->enableSecondOrderDerivatives(false);
+      workers_.push_back(worker);
+    }
+  }
+  threadPool_->parallelFor(workers_.size(), [&](size_t t, size_t /* thread */) {
+    workers_[t]->setBoundParameters(pointSlots_, &point_[0]);
+  });
+}
+
+void AbstractNumericalDerivative::resetPoint_(const ParameterList& parameters)
+{
+  // The changed parameters are all in the list. If evaluations were made on copies,
+  // the function only has to be updated to compute analytical derivatives:
+  if (!threadPool_ || function1_ || function2_)
+    function_->setParameters(parameters);
+}
+
+void AbstractNumericalDerivative::runTasks_(size_t n, const std::function<void(size_t, size_t)>& f)
+{
+  if (threadPool_)
+    threadPool_->parallelFor(n, f);
+  else
+  {
+    for (size_t i = 0; i < n; ++i)
+    {
+      f(i, 0);
+    }
+  }
+}
+
+double AbstractNumericalDerivative::evaluate_(size_t thread, const std::vector<size_t>& slots, const std::vector<double>& values)
+{
+  FunctionInterface& f = threadPool_ ? *workers_[thread] : *function_;
+  vector<double> x(point_);
+  for (size_t k = 0; k < slots.size(); ++k)
+  {
+    x[slots[k]] = values[k];
+  }
+  f.setBoundParameters(pointSlots_, &x[0]);
+  return f.getValue();
+}
+
+std::vector<size_t> AbstractNumericalDerivative::bindVariables_(const ParameterList& parameters, std::vector<size_t>& indices) const
+{
+  vector<string> names;
+  indices.clear();
+  for (size_t i = 0; i < variables_.size(); ++i)
+  {
+    if (parameters.hasParameter(variables_[i]))
+    {
+      indices.push_back(i);
+      names.push_back(variables_[i]);
+    }
+  }
+  return function_->bindParameters(names);
+}
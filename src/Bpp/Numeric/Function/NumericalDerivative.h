@@ -6,11 +6,14 @@
 #define BPP_NUMERIC_FUNCTION_NUMERICALDERIVATIVE_H
 
 
+#include "../../Utils/ThreadPool.h"
 #include "../Matrix/Matrix.h"
 #include "Functions.h"
 
 // From the STL:
+#include <functional>
 #include <map>
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -59,6 +62,13 @@ public:
  * In the first case, all derivatives will be computed numerically.
  * In the second case, first order derivative will be computed numerically only if no appropriate analytical derivative is available, second order derivative will always be computed numerically.
  * In the last case, first and second order derivative will be computed numerically only if no appropriate analytical derivative is available.
+ *
+ * The function evaluations needed for each variable (and each pair of variables for cross
+ * derivatives) are independent, and can be run in parallel by providing a ThreadPool (see
+ * setThreadPool). Each thread then works on its own copy of the function, obtained with
+ * FunctionTools::deepClone(), so that functions wrapped by the function are copied too. Apart
+ * from these, copies must not share any state modified when parameters are set. As each derivative
+ * only depends on the point where it is computed, results do not depend on the number of threads.
  */
 class AbstractNumericalDerivative :
   public virtual NumericalDerivativeInterface,
@@ -75,26 +85,43 @@ protected:
   RowMatrix<double> crossDer2_;
   bool computeD1_, computeD2_, computeCrossD2_;
 
+  std::shared_ptr<ThreadPool> threadPool_;
+
+  /**
+   * @brief One copy of the function for each thread of the pool.
+   */
+  std::vector<std::shared_ptr<FunctionInterface>> workers_;
+
+  /**
+   * @brief Values of all parameters of the function at the point where derivatives are computed.
+   */
+  std::vector<double> point_;
+  std::vector<size_t> pointSlots_;
+
 public:
   AbstractNumericalDerivative(std::shared_ptr<FunctionInterface> function) :
     FunctionWrapper(function), function1_(0), function2_(0),
     h_(0.0001), variables_(), index_(), der1_(), der2_(), crossDer2_(),
-    computeD1_(true), computeD2_(true), computeCrossD2_(false) {}
+    computeD1_(true), computeD2_(true), computeCrossD2_(false),
+    threadPool_(), workers_(), point_(), pointSlots_() {}
 
   AbstractNumericalDerivative(std::shared_ptr<FirstOrderDerivable> function) :
     FunctionWrapper(function), function1_(function), function2_(0),
     h_(0.0001), variables_(), index_(), der1_(), der2_(), crossDer2_(),
-    computeD1_(true), computeD2_(true), computeCrossD2_(false) {}
+    computeD1_(true), computeD2_(true), computeCrossD2_(false),
+    threadPool_(), workers_(), point_(), pointSlots_() {}
 
   AbstractNumericalDerivative(std::shared_ptr<SecondOrderDerivable> function) :
     FunctionWrapper(function), function1_(function), function2_(function),
     h_(0.0001), variables_(), index_(), der1_(), der2_(), crossDer2_(),
-    computeD1_(true), computeD2_(true), computeCrossD2_(false) {}
+    computeD1_(true), computeD2_(true), computeCrossD2_(false),
+    threadPool_(), workers_(), point_(), pointSlots_() {}
 
   AbstractNumericalDerivative(const AbstractNumericalDerivative& ad) :
     FunctionWrapper(ad), function1_(ad.function1_), function2_(ad.function2_),
     h_(ad.h_), variables_(ad.variables_), index_(ad.index_), der1_(ad.der1_), der2_(ad.der2_), crossDer2_(ad.crossDer2_),
-    computeD1_(ad.computeD1_), computeD2_(ad.computeD2_), computeCrossD2_(ad.computeCrossD2_) {}
+    computeD1_(ad.computeD1_), computeD2_(ad.computeD2_), computeCrossD2_(ad.computeCrossD2_),
+    threadPool_(ad.threadPool_), workers_(), point_(ad.point_), pointSlots_(ad.pointSlots_) {}
 
   AbstractNumericalDerivative& operator=(const AbstractNumericalDerivative& ad)
   {
@@ -110,6 +137,10 @@ public:
     computeD1_ = ad.computeD1_;
     computeD2_ = ad.computeD2_;
     computeCrossD2_ = ad.computeCrossD2_;
+    threadPool_ = ad.threadPool_;
+    workers_.clear();
+    point_ = ad.point_;
+    pointSlots_ = ad.pointSlots_;
     return *this;
   }
 
@@ -122,6 +153,34 @@ public:
 
   double getInterval() const override { return h_; }
 
+  /**
+   * @brief Set the thread pool used to evaluate the function at several points in parallel.
+   *
+   * The copies of the function used by each thread are made at the next computation of
+   * derivatives. They are updated with the parameter values of the function, but not with
+   * any other change made to the function: in this case, this method should be called
+   * again to make new copies. The pool is shared with the copies of this object.
+   *
+   * @param threadPool A thread pool, or a null pointer for a serial computation (the default).
+   */
+  void setThreadPool(std::shared_ptr<ThreadPool> threadPool)
+  {
+    threadPool_ = threadPool;
+    workers_.clear();
+  }
+
+  std::shared_ptr<ThreadPool> getThreadPool() const { return threadPool_; }
+
+  void setFunction(std::shared_ptr<FunctionInterface> function) override
+  {
+    FunctionWrapper::setFunction(function);
+    if (function1_)
+      function1_ = std::dynamic_pointer_cast<FirstOrderDerivable>(function);
+    if (function2_)
+      function2_ = std::dynamic_pointer_cast<SecondOrderDerivable>(function);
+    workers_.clear();
+  }
+
   void setParametersToDerivate(const std::vector<std::string>& variables) override
   {
     variables_ = variables;
@@ -242,6 +301,46 @@ protected:
    * as the inner parameters of the function will be changed when computing the numerical derivatives.
    */
   virtual void updateDerivatives(const ParameterList& parameters) = 0;
+
+  /**
+   * @brief Store the current parameter values of the function as the point where derivatives are computed.
+   *
+   * If a thread pool is set, the copies of the function are created if needed and set to this point.
+   */
+  void setPoint_();
+
+  /**
+   * @brief Restore the point where derivatives are computed in the function, and compute
+   * analytical derivatives if any.
+   *
+   * @param parameters The parameters passed to updateDerivatives.
+   */
+  void resetPoint_(const ParameterList& parameters);
+
+  /**
+   * @brief Run f(task, thread) for each task in [0, n), in parallel if a thread pool is set.
+   */
+  void runTasks_(size_t n, const std::function<void(size_t, size_t)>& f);
+
+  /**
+   * @brief Evaluate the function at the current point, with some parameters changed.
+   *
+   * @param thread The index of the thread running the evaluation, as passed by runTasks_.
+   * @param slots The positions of the changed parameters.
+   * @param values Their new values.
+   * @return The value of the function.
+   * @throw ConstraintException If a value does not match the constraint of the corresponding parameter.
+   */
+  double evaluate_(size_t thread, const std::vector<size_t>& slots, const std::vector<double>& values);
+
+  /**
+   * @brief Positions in the function of the variables that are in a given list.
+   *
+   * @param parameters The list of parameters.
+   * @param indices [out] The index in variables_ of each variable found.
+   * @return The position of each variable found in the parameters of the function.
+   */
+  std::vector<size_t> bindVariables_(const ParameterList& parameters, std::vector<size_t>& indices) const;
 };
 } // end of namespace bpp.
 #endif // BPP_NUMERIC_FUNCTION_NUMERICALDERIVATIVE_H
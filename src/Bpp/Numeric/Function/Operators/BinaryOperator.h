@@ -39,11 +39,21 @@ public:
     return left_;
   }
 
+  std::shared_ptr<const Operator> getLeftSon() const
+  {
+    return left_;
+  }
+
   std::shared_ptr<Operator> getRightSon()
   {
     return right_;
   }
 
+  std::shared_ptr<const Operator> getRightSon() const
+  {
+    return right_;
+  }
+
   char getSymbol() const
   {
     return symb_;
@@ -81,7 +91,7 @@ public:
     case '+':
       return dl + dr;
     case '-':
-      return dl - dl;
+      return dl - dr;
     case '/':
       if (r == 0)
         return 0;
@@ -118,7 +128,7 @@ public:
       if (r == 0)
         return 0;
 
-      return (d2l * r - d2r * l ) / r2 - ( 2 * dl * ( dl * r - dr * l) ) / r3;
+      return (d2l * r - d2r * l ) / r2 - ( 2 * dr * ( dl * r - dr * l) ) / r3;
 
     case '*':
       return d2l * r + d2r * l + 2 * dr * dl;
@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: CECILL-2.1
 
 #include <algorithm>
+#include <cmath>
 
 #include "BinaryOperator.h"
 #include "ComputationTree.h"
@@ -15,7 +16,8 @@ using namespace std;
 using namespace bpp;
 
 ComputationTree::ComputationTree(const std::string& formula, const std::map<std::string, std::shared_ptr<FunctionInterface>>& functionNames) :
-  AssociationTreeGlobalGraphObserver<Operator, short>(true)
+  AssociationTreeGlobalGraphObserver<Operator, short>(true),
+  tape_()
 {
   getGraph();
 
@@ -30,6 +32,7 @@ ComputationTree::ComputationTree(const std::string& formula, const std::map<std:
   string form2 = TextTools::removeWhiteSpaces(formula);
 
   setRoot(readFormula_(str2, functionNames));
+  flatten_(getRoot());
 }
 
 std::shared_ptr<Operator> ComputationTree::readFormula_(const std::string& formula, const std::map<std::string, std::shared_ptr<FunctionInterface>>& functionNames)
@@ -194,3 +197,233 @@ std::string ComputationTree::output() const
   }
   return op;
 }
+
+
+size_t ComputationTree::flatten_(std::shared_ptr<const Operator> op)
+{
+  const BinaryOperator* bop = dynamic_cast<const BinaryOperator*>(op.get());
+  if (bop)
+  {
+    size_t left = flatten_(bop->getLeftSon());
+    size_t right = flatten_(bop->getRightSon());
+    switch (bop->getSymbol())
+    {
+    case '+':
+      tape_.push_back(Instruction(Instruction::ADD, left, right));
+      break;
+    case '-':
+      tape_.push_back(Instruction(Instruction::SUBTRACT, left, right));
+      break;
+    case '*':
+      tape_.push_back(Instruction(Instruction::MULTIPLY, left, right));
+      break;
+    case '/':
+      tape_.push_back(Instruction(Instruction::DIVIDE, left, right));
+      break;
+    default:
+      throw Exception("ComputationTree::flatten_ : unknown operator " + std::string(1, bop->getSymbol()));
+    }
+    return tape_.size() - 1;
+  }
+
+  const NegativeOperator* nop = dynamic_cast<const NegativeOperator*>(op.get());
+  if (nop)
+  {
+    size_t son = flatten_(nop->getSon());
+    tape_.push_back(Instruction(Instruction::NEGATIVE, son));
+    return tape_.size() - 1;
+  }
+
+  const MathOperator* mop = dynamic_cast<const MathOperator*>(op.get());
+  if (mop)
+  {
+    size_t son = flatten_(mop->getSon());
+    if (mop->getName() == "exp")
+      tape_.push_back(Instruction(Instruction::EXP, son));
+    else if (mop->getName() == "log")
+      tape_.push_back(Instruction(Instruction::LOG, son));
+    else
+      throw Exception("ComputationTree::flatten_ : unknown function " + mop->getName());
+    return tape_.size() - 1;
+  }
+
+  // Constants and functions:
+  Instruction leaf(Instruction::LEAF);
+  leaf.leaf = op;
+  const FunctionOperator<SecondOrderDerivable>* fop = dynamic_cast<const FunctionOperator<SecondOrderDerivable>*>(op.get());
+  if (fop)
+    leaf.function = std::shared_ptr<const SecondOrderDerivable>(op, &fop->getFunction()); // Keeps the operator alive.
+  tape_.push_back(leaf);
+  return tape_.size() - 1;
+}
+
+double ComputationTree::sweep_(const std::vector<std::string>& variables, const std::vector<double>* direction, std::vector<double>& gradient, std::vector<double>* product) const
+{
+  size_t n = tape_.size();
+  size_t nbVar = variables.size();
+  bool second = direction != 0;
+
+  // Forward sweep: values, and derivatives along the direction.
+  vector<double> v(n), t(second ? n : 0);
+  for (size_t k = 0; k < n; ++k)
+  {
+    const Instruction& ins = tape_[k];
+    double l = v[ins.left], r = v[ins.right];
+    switch (ins.type)
+    {
+    case Instruction::LEAF:
+      v[k] = ins.leaf->getValue();
+      if (second)
+      {
+        t[k] = 0;
+        for (size_t i = 0; i < nbVar; ++i)
+        {
+          if ((*direction)[i] != 0)
+            t[k] += (*direction)[i] * ins.leaf->getFirstOrderDerivative(variables[i]);
+        }
+      }
+      break;
+    case Instruction::ADD:
+      v[k] = l + r;
+      if (second)
+        t[k] = t[ins.left] + t[ins.right];
+      break;
+    case Instruction::SUBTRACT:
+      v[k] = l - r;
+      if (second)
+        t[k] = t[ins.left] - t[ins.right];
+      break;
+    case Instruction::MULTIPLY:
+      v[k] = l * r;
+      if (second)
+        t[k] = t[ins.left] * r + l * t[ins.right];
+      break;
+    case Instruction::DIVIDE:
+      // As in BinaryOperator, division by zero yields zero.
+      v[k] = r == 0 ? 0 : l / r;
+      if (second)
+        t[k] = r == 0 ? 0 : (t[ins.left] * r - l * t[ins.right]) / (r * r);
+      break;
+    case Instruction::NEGATIVE:
+      v[k] = -l;
+      if (second)
+        t[k] = -t[ins.left];
+      break;
+    case Instruction::EXP:
+      v[k] = exp(l);
+      if (second)
+        t[k] = v[k] * t[ins.left];
+      break;
+    case Instruction::LOG:
+      v[k] = log(l);
+      if (second)
+        t[k] = t[ins.left] / l;
+      break;
+    }
+  }
+
+  // Backward sweep: derivatives of the root with respect to each operator (a),
+  // and their derivatives along the direction (b).
+  vector<double> a(n, 0.), b(second ? n : 0, 0.);
+  a[n - 1] = 1.;
+  for (size_t k = n; k > 0; --k)
+  {
+    const Instruction& ins = tape_[k - 1];
+    double ak = a[k - 1];
+    double bk = second ? b[k - 1] : 0;
+    double l = v[ins.left], r = v[ins.right];
+    switch (ins.type)
+    {
+    case Instruction::LEAF:
+      break;
+    case Instruction::ADD:
+      a[ins.left] += ak;
+      a[ins.right] += ak;
+      if (second)
+      {
+        b[ins.left] += bk;
+        b[ins.right] += bk;
+      }
+      break;
+    case Instruction::SUBTRACT:
+      a[ins.left] += ak;
+      a[ins.right] -= ak;
+      if (second)
+      {
+        b[ins.left] += bk;
+        b[ins.right] -= bk;
+      }
+      break;
+    case Instruction::MULTIPLY:
+      a[ins.left] += ak * r;
+      a[ins.right] += ak * l;
+      if (second)
+      {
+        b[ins.left] += bk * r + ak * t[ins.right];
+        b[ins.right] += bk * l + ak * t[ins.left];
+      }
+      break;
+    case Instruction::DIVIDE:
+      if (r != 0)
+      {
+        double r2 = r * r;
+        a[ins.left] += ak / r;
+        a[ins.right] -= ak * l / r2;
+        if (second)
+        {
+          b[ins.left] += bk / r - ak * t[ins.right] / r2;
+          b[ins.right] += -(bk * l + ak * t[ins.left]) / r2 + 2 * ak * l * t[ins.right] / (r2 * r);
+        }
+      }
+      break;
+    case Instruction::NEGATIVE:
+      a[ins.left] -= ak;
+      if (second)
+        b[ins.left] -= bk;
+      break;
+    case Instruction::EXP:
+      a[ins.left] += ak * v[k - 1];
+      if (second)
+        b[ins.left] += bk * v[k - 1] + ak * t[k - 1];
+      break;
+    case Instruction::LOG:
+      a[ins.left] += ak / l;
+      if (second)
+        b[ins.left] += bk / l - ak * t[ins.left] / (l * l);
+      break;
+    }
+  }
+
+  // Combine with the derivatives of the leaves:
+  gradient.assign(nbVar, 0.);
+  if (second)
+    product->assign(nbVar, 0.);
+  for (size_t k = 0; k < n; ++k)
+  {
+    const Instruction& ins = tape_[k];
+    if (ins.type != Instruction::LEAF || (a[k] == 0 && (!second || b[k] == 0)))
+      continue;
+    for (size_t i = 0; i < nbVar; ++i)
+    {
+      double d = ins.leaf->getFirstOrderDerivative(variables[i]);
+      gradient[i] += a[k] * d;
+      if (second)
+      {
+        double hu = 0;
+        for (size_t j = 0; a[k] != 0 && j < nbVar; ++j)
+        {
+          double u = (*direction)[j];
+          if (u == 0)
+            continue;
+          if (j == i)
+            hu += u * ins.leaf->getSecondOrderDerivative(variables[i]);
+          else if (ins.function)
+            hu += u * ins.function->getSecondOrderDerivative(variables[j], variables[i]);
+        }
+        (*product)[i] += b[k] * d + a[k] * hu;
+      }
+    }
+  }
+
+  return v[n - 1];
+}
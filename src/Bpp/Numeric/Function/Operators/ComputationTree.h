@@ -6,6 +6,7 @@
 #define BPP_NUMERIC_FUNCTION_OPERATORS_COMPUTATIONTREE_H
 
 #include <memory>
+#include <vector>
 
 #include "../../../Graph/AssociationTreeGraphImplObserver.h"
 #include "../Functions.h"
@@ -16,14 +17,72 @@ namespace bpp
 /**
  * @brief Defines a Computation Tree based on Operators.
  *
+ * Derivatives are computed by automatic differentiation in reverse mode: the tree is flattened
+ * at construction into a list of instructions (the tape), where the sons of each operator come
+ * before it. A forward sweep over the tape computes the values of all operators, and a backward
+ * sweep the derivatives of the root with respect to each of them. The derivatives with respect to
+ * any number of variables are then obtained from the derivatives of the functions at the leaves,
+ * in a single pass (see getValueAndGradient). Second order derivatives are obtained by
+ * differentiating both sweeps along a direction (see getHessianVectorProduct).
  */
 
 class ComputationTree :
   public AssociationTreeGlobalGraphObserver<Operator, short>
 {
+private:
+  /**
+   * @brief One operator of the flattened tree.
+   */
+  class Instruction
+  {
+public:
+    enum Type { LEAF, ADD, SUBTRACT, MULTIPLY, DIVIDE, NEGATIVE, EXP, LOG };
+
+    Type type;
+
+    /**
+     * @brief Positions of the sons in the tape.
+     */
+    size_t left, right;
+
+    /**
+     * @brief The operator, for leaves only.
+     */
+    std::shared_ptr<const Operator> leaf;
+
+    /**
+     * @brief The function of the leaf, if it has second order derivatives.
+     */
+    std::shared_ptr<const SecondOrderDerivable> function;
+
+public:
+    Instruction(Type t, size_t l = 0, size_t r = 0) :
+      type(t), left(l), right(r), leaf(), function() {}
+  };
+
+  std::vector<Instruction> tape_;
+
 private:
   std::shared_ptr<Operator> readFormula_(const std::string& formula, const std::map<std::string, std::shared_ptr<FunctionInterface>>& functionNames);
 
+  /**
+   * @brief Append the instructions of a subtree to the tape.
+   *
+   * @return The position of the root of the subtree in the tape.
+   */
+  size_t flatten_(std::shared_ptr<const Operator> op);
+
+  /**
+   * @brief Forward and backward sweeps over the tape.
+   *
+   * @param variables The variables to derivate.
+   * @param direction The direction of the Hessian-vector product, or 0 if not needed.
+   * @param gradient The first order derivatives with respect to the variables.
+   * @param product The Hessian-vector product, or 0 if not needed.
+   * @return The value of the tree.
+   */
+  double sweep_(const std::vector<std::string>& variables, const std::vector<double>* direction, std::vector<double>& gradient, std::vector<double>* product) const;
+
 public:
   /*
    * @brief Tree for numerical computation given a formula (such as
@@ -46,12 +105,49 @@ public:
 
   double getFirstOrderDerivative(const std::string& variable) const
   {
-    return getRoot()->getFirstOrderDerivative(variable);
+    std::vector<double> gradient;
+    sweep_(std::vector<std::string>(1, variable), 0, gradient, 0);
+    return gradient[0];
   }
 
   double getSecondOrderDerivative(const std::string& variable) const
   {
-    return getRoot()->getSecondOrderDerivative(variable);
+    std::vector<double> gradient, product;
+    std::vector<double> direction(1, 1.);
+    sweep_(std::vector<std::string>(1, variable), &direction, gradient, &product);
+    return product[0];
+  }
+
+  /**
+   * @brief Compute the value and the first order derivatives with respect to several variables.
+   *
+   * @param variables The variables to derivate.
+   * @param gradient [out] The first order derivatives, in the order of the variables.
+   * @return The value of the tree.
+   */
+  double getValueAndGradient(const std::vector<std::string>& variables, std::vector<double>& gradient) const
+  {
+    return sweep_(variables, 0, gradient, 0);
+  }
+
+  /**
+   * @brief Compute the product of the Hessian matrix with a vector, together with the gradient.
+   *
+   * Cross derivatives of the functions at the leaves are only needed for pairs of variables
+   * with a non-zero coordinate in the direction. They are considered as null for functions
+   * which do not have second order derivatives.
+   *
+   * @param variables The variables to derivate.
+   * @param direction The vector to multiply, with one coordinate for each variable.
+   * @param gradient [out] The first order derivatives, in the order of the variables.
+   * @param product [out] The product of the matrix of second order derivatives with the direction.
+   * @return The value of the tree.
+   */
+  double getHessianVectorProduct(const std::vector<std::string>& variables, const std::vector<double>& direction, std::vector<double>& gradient, std::vector<double>& product) const
+  {
+    if (direction.size() != variables.size())
+      throw Exception("ComputationTree::getHessianVectorProduct. Direction and variables must have the same size.");
+    return sweep_(variables, &direction, gradient, &product);
   }
 
   void readFormula(const std::string& formula, const std::map<std::string, std::shared_ptr<FunctionInterface>>& functionNames)
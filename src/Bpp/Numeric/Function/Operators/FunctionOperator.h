@@ -86,6 +86,11 @@ public:
     return name_;
   }
 
+  const F& getFunction() const
+  {
+    return func_;
+  }
+
   std::string output() const
   {
     return name_;
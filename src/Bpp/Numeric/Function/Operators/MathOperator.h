@@ -47,6 +47,11 @@ public:
     return son_;
   }
 
+  std::shared_ptr<const Operator> getSon() const
+  {
+    return son_;
+  }
+
   double getValue() const
   {
     if (func_)
@@ -36,6 +36,11 @@ public:
     return son_;
   }
 
+  std::shared_ptr<const Operator> getSon() const
+  {
+    return son_;
+  }
+
   double getValue() const
   {
     return -son_->getValue();
@@ -0,0 +1,229 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "AbstractOptimizer.h"
+#include "MetaOptimizer.h"
+#include "OptimizationTraceListener.h"
+
+// From the STL:
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+string OptimizationTraceListener::FORMAT_JSON = "json";
+string OptimizationTraceListener::FORMAT_CSV = "csv";
+
+/******************************************************************************/
+
+namespace
+{
+string formatNumber(double x)
+{
+  if (!std::isfinite(x))
+    return "null";
+  ostringstream oss;
+  oss << setprecision(12) << x;
+  return oss.str();
+}
+
+/**
+ * @brief Quote a string, escaping quotes as in JSON (with a backslash) or as in CSV (RFC 4180, by doubling them).
+ */
+string quote(const string& s, bool csv = false)
+{
+  string res = "\"";
+  for (char c : s)
+  {
+    if (csv && c == '"')
+      res += '"';
+    else if (!csv && (c == '"' || c == '\\'))
+      res += '\\';
+    res += c;
+  }
+  return res + "\"";
+}
+}
+
+/******************************************************************************/
+
+OptimizationTraceListener::OptimizationTraceListener(std::shared_ptr<OutputStream> output, const std::string& format) :
+  output_(output),
+  format_(format),
+  headerWritten_(false),
+  states_(),
+  summaries_()
+{
+  if (format_ != FORMAT_JSON && format_ != FORMAT_CSV)
+    throw Exception("OptimizationTraceListener. Unknown format: " + format);
+}
+
+/******************************************************************************/
+
+void OptimizationTraceListener::watch(std::shared_ptr<OptimizationTraceListener> listener, OptimizerInterface& optimizer, const std::string& name)
+{
+  listener->states_[&optimizer].name = name;
+  optimizer.addOptimizationListener(listener);
+  MetaOptimizer* meta = dynamic_cast<MetaOptimizer*>(&optimizer);
+  if (meta)
+  {
+    MetaOptimizerInfos& infos = meta->optimizers();
+    for (size_t i = 0; i < infos.getNumberOfOptimizers(); ++i)
+    {
+      watch(listener, *infos.getOptimizer(i), name + "/" + infos.getName(i));
+    }
+  }
+}
+
+/******************************************************************************/
+
+OptimizationTraceListener::OptimizerState& OptimizationTraceListener::getState_(const OptimizerInterface* optimizer)
+{
+  auto it = states_.find(optimizer);
+  if (it == states_.end())
+  {
+    it = states_.insert(make_pair(optimizer, OptimizerState())).first;
+    it->second.name = "optimizer" + to_string(states_.size());
+  }
+  return it->second;
+}
+
+/******************************************************************************/
+
+void OptimizationTraceListener::readState_(const OptimizerInterface& optimizer, OptimizerState& state)
+{
+  state.time = chrono::steady_clock::now();
+  const AbstractOptimizer* ao = dynamic_cast<const AbstractOptimizer*>(&optimizer);
+  state.nbEvaluations = ao ? ao->getNumberOfEvaluations() : 0;
+  state.nbGradientEvaluations = ao ? ao->getNumberOfGradientEvaluations() : 0;
+  state.lineSearchTime = ao ? ao->getLineSearchTime() : 0;
+  const ParameterList& pl = optimizer.getParameters();
+  state.parameters.resize(pl.size());
+  for (size_t i = 0; i < pl.size(); ++i)
+  {
+    state.parameters[i] = pl[i].getValue();
+  }
+}
+
+/******************************************************************************/
+
+void OptimizationTraceListener::optimizationInitializationPerformed(const OptimizationEvent& event)
+{
+  const OptimizerInterface* optimizer = event.getOptimizer();
+  readState_(*optimizer, getState_(optimizer));
+}
+
+/******************************************************************************/
+
+void OptimizationTraceListener::optimizationStepPerformed(const OptimizationEvent& event)
+{
+  const OptimizerInterface* optimizer = event.getOptimizer();
+  OptimizerState& state = getState_(optimizer);
+  OptimizerState previous = state;
+  readState_(*optimizer, state);
+  state.step++;
+
+  // Counters are reset at each initialization, and may only increase afterwards:
+  unsigned int nbEvaluations = state.nbEvaluations > previous.nbEvaluations ? state.nbEvaluations - previous.nbEvaluations : 0;
+  unsigned int nbGradientEvaluations = state.nbGradientEvaluations > previous.nbGradientEvaluations ? state.nbGradientEvaluations - previous.nbGradientEvaluations : 0;
+  double lineSearchTime = max(state.lineSearchTime - previous.lineSearchTime, 0.);
+  double time = chrono::duration<double>(state.time - previous.time).count();
+
+  double stepNorm = NAN;
+  if (state.parameters.size() == previous.parameters.size())
+  {
+    stepNorm = 0;
+    for (size_t i = 0; i < state.parameters.size(); ++i)
+    {
+      double d = state.parameters[i] - previous.parameters[i];
+      stepNorm += d * d;
+    }
+    stepNorm = sqrt(stepNorm);
+  }
+
+  OptimizationTraceSummary& summary = summaries_[state.name];
+  summary.nbSteps++;
+  summary.nbEvaluations += nbEvaluations;
+  summary.nbGradientEvaluations += nbGradientEvaluations;
+  summary.time += time;
+  summary.lineSearchTime += lineSearchTime;
+
+  if (output_)
+  {
+    vector<string> keys = {"optimizer", "step", "time", "evaluations", "gradients", "value", "stepNorm", "lineSearchTime"};
+    vector<string> values = {
+      quote(state.name, format_ == FORMAT_CSV),
+      to_string(state.step),
+      formatNumber(time),
+      to_string(nbEvaluations),
+      to_string(nbGradientEvaluations),
+      formatNumber(optimizer->getFunctionValue()),
+      formatNumber(stepNorm),
+      formatNumber(lineSearchTime)
+    };
+    writeRecord_(*output_, keys, values, !headerWritten_);
+    headerWritten_ = true;
+  }
+}
+
+/******************************************************************************/
+
+void OptimizationTraceListener::writeSummary(OutputStream& out) const
+{
+  vector<string> keys = {"optimizer", "steps", "time", "evaluations", "gradients", "lineSearchTime"};
+  bool header = true;
+  for (const auto& summary : summaries_)
+  {
+    vector<string> values = {
+      quote(summary.first, format_ == FORMAT_CSV),
+      to_string(summary.second.nbSteps),
+      formatNumber(summary.second.time),
+      to_string(summary.second.nbEvaluations),
+      to_string(summary.second.nbGradientEvaluations),
+      formatNumber(summary.second.lineSearchTime)
+    };
+    writeRecord_(out, keys, values, header);
+    header = false;
+  }
+}
+
+/******************************************************************************/
+
+void OptimizationTraceListener::writeRecord_(OutputStream& out, const std::vector<std::string>& keys, const std::vector<std::string>& values, bool header) const
+{
+  ostringstream line;
+  if (format_ == FORMAT_JSON)
+  {
+    line << "{";
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+      line << (i > 0 ? ", " : "") << quote(keys[i]) << ": " << values[i];
+    }
+    line << "}";
+  }
+  else
+  {
+    if (header)
+    {
+      for (size_t i = 0; i < keys.size(); ++i)
+      {
+        out << (i > 0 ? "," : "") << keys[i];
+      }
+      out.endLine();
+    }
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+      // Missing values are left empty:
+      line << (i > 0 ? "," : "") << (values[i] == "null" ? "" : values[i]);
+    }
+  }
+  out << line.str();
+  out.endLine();
+}
+
+/******************************************************************************/
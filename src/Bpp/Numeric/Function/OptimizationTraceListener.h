@@ -0,0 +1,156 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_NUMERIC_FUNCTION_OPTIMIZATIONTRACELISTENER_H
+#define BPP_NUMERIC_FUNCTION_OPTIMIZATIONTRACELISTENER_H
+
+
+#include "../../Io/OutputStream.h"
+#include "Optimizer.h"
+
+// From the STL:
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Cumulated statistics of the steps of an optimizer, as recorded by an OptimizationTraceListener.
+ */
+class OptimizationTraceSummary
+{
+public:
+  unsigned int nbSteps;
+  unsigned int nbEvaluations;
+  unsigned int nbGradientEvaluations;
+
+  /**
+   * @brief Wall time of the steps, and of the line searches performed during the steps, in seconds.
+   */
+  double time;
+  double lineSearchTime;
+
+public:
+  OptimizationTraceSummary() :
+    nbSteps(0), nbEvaluations(0), nbGradientEvaluations(0), time(0), lineSearchTime(0) {}
+};
+
+/**
+ * @brief Record the progress of one or several optimizers, step by step.
+ *
+ * For each step performed by a watched optimizer, the listener records:
+ * - the name of the optimizer and the index of the step,
+ * - the wall time of the step, in seconds,
+ * - the number of function and gradient evaluations of the step,
+ * - the function value after the step,
+ * - the Euclidean norm of the variation of parameters during the step,
+ * - the wall time spent in line searches during the step.
+ *
+ * Evaluation counts and line search times are read from AbstractOptimizer, and are zero for
+ * other optimizers. Records are written, one per line, to an output stream, either as JSON
+ * objects or as comma-separated values with a header line. Records are also summed for each
+ * optimizer name (see getSummary), so that the cost of each sub-optimizer of a MetaOptimizer
+ * can be compared.
+ *
+ * Optimizers are registered with the watch method, which also registers the sub-optimizers of a
+ * MetaOptimizer, named after the MetaOptimizerInfos with the parent name as a prefix.
+ *
+ * @code
+ * auto trace = std::make_shared<OptimizationTraceListener>(std::make_shared<StlOutputStream>(std::make_unique<std::ofstream>("trace.jsonl")));
+ * OptimizationTraceListener::watch(trace, optimizer, "main");
+ * optimizer.optimize();
+ * @endcode
+ */
+class OptimizationTraceListener :
+  public OptimizationListener
+{
+public:
+  static std::string FORMAT_JSON;
+  static std::string FORMAT_CSV;
+
+private:
+  /**
+   * @brief State of a watched optimizer at its last event.
+   */
+  class OptimizerState
+  {
+public:
+    std::string name;
+    unsigned int step;
+    std::chrono::steady_clock::time_point time;
+    unsigned int nbEvaluations;
+    unsigned int nbGradientEvaluations;
+    double lineSearchTime;
+    std::vector<double> parameters;
+
+public:
+    OptimizerState() :
+      name(), step(0), time(), nbEvaluations(0), nbGradientEvaluations(0), lineSearchTime(0), parameters() {}
+  };
+
+  std::shared_ptr<OutputStream> output_;
+  std::string format_;
+  bool headerWritten_;
+  std::map<const OptimizerInterface*, OptimizerState> states_;
+  std::map<std::string, OptimizationTraceSummary> summaries_;
+
+public:
+  /**
+   * @brief Build a new trace listener.
+   *
+   * @param output The stream where records are written, or a null pointer to only compute summaries.
+   * @param format Either FORMAT_JSON (one JSON object per line) or FORMAT_CSV.
+   */
+  OptimizationTraceListener(std::shared_ptr<OutputStream> output = nullptr, const std::string& format = FORMAT_JSON);
+
+  virtual ~OptimizationTraceListener() {}
+
+public:
+  /**
+   * @brief Register a listener to an optimizer, and to its sub-optimizers in the case of a MetaOptimizer.
+   *
+   * @param listener The listener to register.
+   * @param optimizer The optimizer to watch.
+   * @param name The name used for the records of this optimizer.
+   */
+  static void watch(std::shared_ptr<OptimizationTraceListener> listener, OptimizerInterface& optimizer, const std::string& name);
+
+  void optimizationInitializationPerformed(const OptimizationEvent& event) override;
+
+  void optimizationStepPerformed(const OptimizationEvent& event) override;
+
+  bool listenerModifiesParameters() const override { return false; }
+
+  /**
+   * @return The statistics summed over all steps, for each optimizer name.
+   */
+  const std::map<std::string, OptimizationTraceSummary>& getSummary() const { return summaries_; }
+
+  /**
+   * @brief Write the statistics of each optimizer, in the format of the records.
+   *
+   * @param out The output stream.
+   */
+  void writeSummary(OutputStream& out) const;
+
+private:
+  OptimizerState& getState_(const OptimizerInterface* optimizer);
+
+  static void readState_(const OptimizerInterface& optimizer, OptimizerState& state);
+
+  /**
+   * @brief Write one record, either as a JSON object or as a CSV line.
+   *
+   * @param out The output stream.
+   * @param keys The names of the fields.
+   * @param values The values of the fields, already formatted. Strings must be quoted according to the format.
+   * @param header Tell if the names of the fields should be written first (CSV only).
+   */
+  void writeRecord_(OutputStream& out, const std::vector<std::string>& keys, const std::vector<std::string>& values, bool header) const;
+};
+} // end of namespace bpp.
+#endif // BPP_NUMERIC_FUNCTION_OPTIMIZATIONTRACELISTENER_H
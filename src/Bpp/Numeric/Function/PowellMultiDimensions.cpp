@@ -80,9 +80,11 @@ double PowellMultiDimensions::doStep()
       xit[j] = xi_[j][i];
     }
     fptt = fret_;
+    auto lineSearchStart = std::chrono::steady_clock::now();
     nbEval_ += OneDimensionOptimizationTools::lineMinimization(
           f1dim_, getParameters_(), xit, getStopCondition()->getTolerance(),
           0, getMessageHandler(), getVerbose() > 0 ? getVerbose() - 1 : 0);
+    addLineSearchTime_(lineSearchStart);
     fret_ = function().f(getParameters());
     if (getVerbose() > 2)
       printPoint(getParameters(), fret_);
@@ -109,9 +111,11 @@ double PowellMultiDimensions::doStep()
     if (t < 0.0)
     {
       // cout << endl << "New direction: drection " << ibig << " removed." << endl;
+      auto lineSearchStart = std::chrono::steady_clock::now();
       nbEval_ += OneDimensionOptimizationTools::lineMinimization(f1dim_,
             getParameters_(), xit, getStopCondition()->getTolerance(),
             0, getMessageHandler(), getVerbose() > 0 ? getVerbose() - 1 : 0);
+      addLineSearchTime_(lineSearchStart);
       fret_ = getFunction()->f(getParameters());
       if (fret_ > fp_)
         throw Exception("DEBUG: PowellMultiDimensions::doStep(). Line minimization failed!");
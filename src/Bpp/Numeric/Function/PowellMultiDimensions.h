@@ -65,6 +65,12 @@ public:
    * @{
    */
   double optimize();
+
+  void setFunction(std::shared_ptr<FunctionInterface> function) override
+  {
+    AbstractOptimizer::setFunction(function);
+    f1dim_ = std::make_shared<DirectionFunction>(function);
+  }
   /** @} */
 
   void doInit(const ParameterList& params);
@@ -87,6 +87,16 @@ public:
 
   virtual std::shared_ptr<FunctionInterface> getFunction() { return function_; }
 
+  /**
+   * @brief Change the reparametrized function.
+   *
+   * As copies of a wrapper share the wrapped function, this can be used together with
+   * clone() to obtain a fully independent copy of the wrapper.
+   *
+   * @param function The new function, which must have the same parameters as the current one.
+   */
+  virtual void setFunction(std::shared_ptr<FunctionInterface> function) { function_ = function; }
+
   void setParameters(const ParameterList& parameters)
   {
     //      parameters.printParameters(std::cout);
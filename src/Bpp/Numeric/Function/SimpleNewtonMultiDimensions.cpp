@@ -68,6 +68,7 @@ double SimpleNewtonMultiDimensions::doStep()
       cout << endl;
     getParameters_().matchParametersValues(getFunction()->getParameters());
     nbEval_ += optimizer_.getNumberOfEvaluations();
+    nbGradientEval_ += optimizer_.getNumberOfGradientEvaluations();
   }
   tolIsReached_ = nbParams_ <= 1;
   return f;
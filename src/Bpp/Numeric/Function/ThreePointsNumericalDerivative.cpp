@@ -27,95 +27,58 @@ void ThreePointsNumericalDerivative::updateDerivatives(const ParameterList& para
       return;
     }
 
-    string lastVar;
-    bool functionChanged = false;
-    ParameterList p;
-    bool start = true;
-    for (size_t i = 0; i < variables_.size(); ++i)
+    setPoint_();
+    vector<size_t> indices;
+    vector<size_t> slots = bindVariables_(parameters, indices);
+    vector<double> precisions(slots.size());
+    for (size_t k = 0; k < slots.size(); ++k)
     {
-      string var = variables_[i];
-      if (!parameters.hasParameter(var))
-        continue;
-      if (!start)
-      {
-        vector<string> vars(2);
-        vars[0] = var;
-        vars[1] = lastVar;
-        p = parameters.createSubList(vars);
-      }
-      else
-      {
-        p = parameters.createSubList(var);
-        start = false;
-      }
-      lastVar = var;
-      functionChanged = true;
-      double value = function_->getParameterValue(var);
-      double h = -(1. + std::abs(value)) * h_;
-      if (abs(h) < p[0].getPrecision())
-        h = h < 0 ? -p[0].getPrecision() : p[0].getPrecision();
-      double hf1(0), hf3(0);
-      unsigned int nbtry = 0;
+      precisions[k] = parameters.parameter(variables_[indices[k]]).getPrecision();
+    }
 
-      // Compute f1_
-      while (hf1 == 0)
-      {
-        try
-        {
-          p[0].setValue(value + h);
-          function_->setParameters(p); // also reset previous parameter...
+    // Each variable is shifted independently from the point:
+    runTasks_(slots.size(), [&](size_t k, size_t thread) {
+      size_t i = indices[k];
+      double value = point_[slots[k]];
+      double h = -(1. + std::abs(value)) * h_;
+      if (abs(h) < precisions[k])
+        h = h < 0 ? -precisions[k] : precisions[k];
 
-          p = p.createSubList(0);
-          f1_ = function_->getValue();
-          if ((abs(f1_) >= NumConstants::VERY_BIG()) || std::isnan(f1_))
-            throw ConstraintException("f1_ too large", &p[0], f1_);
-          else
-            hf1 = h;
-        }
-        catch (ConstraintException& ce)
+      // Try to compute the function on value + h, moving h in case of failure:
+      auto shift = [&](double& f, double& hf) {
+        unsigned int nbtry = 0;
+        while (hf == 0)
         {
-          if (++nbtry == 10) // no possibility to compute derivatives
+          bool valid;
+          try
+          {
+            f = evaluate_(thread, { slots[k] }, { value + h });
+            valid = (abs(f) < NumConstants::VERY_BIG()) && !std::isnan(f);
+          }
+          catch (ConstraintException& ce)
+          {
+            valid = false;
+          }
+          if (valid)
+            hf = h;
+          else if (++nbtry == 10) // no possibility to compute derivatives
             break;
           else if (h < 0)
             h = -h; // try on the right
           else
             h /= -2; // try again on the left with smaller interval
         }
-      }
+      };
 
+      double f1(0), f3(0), hf1(0), hf3(0);
+      shift(f1, hf1);
       if (hf1 != 0)
       {
-        // Compute f3_
         if (h < 0)
           h = -h; // on the right
         else
           h /= 2; //  on the left with smaller interval
-
-        nbtry = 0;
-        while (hf3 == 0)
-        {
-          try
-          {
-            p[0].setValue(value + h);
-            function_->setParameters(p); // also reset previous parameter...
-
-            p = p.createSubList(0);
-            f3_ = function_->getValue();
-            if ((abs(f3_) >= NumConstants::VERY_BIG()) || std::isnan(f3_))
-              throw ConstraintException("f3_ too large", &p[0], f3_);
-            else
-              hf3 = h;
-          }
-          catch (ConstraintException& ce)
-          {
-            if (++nbtry == 10) // no possibility to compute derivatives
-              break;
-            else if (h < 0)
-              h = -h; // try on the right
-            else
-              h /= -2; // try again on the left with smaller interval
-          }
-        }
+        shift(f3, hf3);
       }
 
       if (hf3 == 0)
@@ -125,92 +88,58 @@ void ThreePointsNumericalDerivative::updateDerivatives(const ParameterList& para
       }
       else
       {
-        der1_[i] = (f1_ - f3_) / (hf1 - hf3);
-        der2_[i] = ((f1_ - f2_) / hf1 - (f3_ - f2_) / hf3) * 2 / (hf1 - hf3);
+        der1_[i] = (f1 - f3) / (hf1 - hf3);
+        der2_[i] = ((f1 - f2_) / hf1 - (f3 - f2_) / hf3) * 2 / (hf1 - hf3);
       }
-    }
-
+    });
 
     if (computeCrossD2_)
     {
-      string lastVar1, lastVar2;
-      for (unsigned int i = 0; i < variables_.size(); i++)
+      // The matrix is symmetric, only pairs k1 < k2 are computed:
+      vector< pair<size_t, size_t> > pairs;
+      for (size_t k1 = 0; k1 < slots.size(); ++k1)
       {
-        string var1 = variables_[i];
-        if (!parameters.hasParameter(var1))
-          continue;
-        for (unsigned int j = 0; j < variables_.size(); j++)
+        crossDer2_(indices[k1], indices[k1]) = der2_[indices[k1]];
+        for (size_t k2 = k1 + 1; k2 < slots.size(); ++k2)
         {
-          if (j == i)
-          {
-            crossDer2_(i, j) = der2_[i];
-            continue;
-          }
-          string var2 = variables_[j];
-          if (!parameters.hasParameter(var2))
-            continue;
-
-          vector<string> vars(2);
-          vars[0] = var1;
-          vars[1] = var2;
-          if (i > 0 && j > 0)
-          {
-            if (lastVar1 != var1 && lastVar1 != var2)
-              vars.push_back(lastVar1);
-            if (lastVar2 != var1 && lastVar2 != var2)
-              vars.push_back(lastVar2);
-          }
-          p = parameters.createSubList(vars);
-
-          double value1 = function_->getParameterValue(var1);
-          double value2 = function_->getParameterValue(var2);
-          double h1 = (1. + std::abs(value1)) * h_;
-          double h2 = (1. + std::abs(value2)) * h_;
-
-          // Compute 4 additional points:
-          try
-          {
-            p[0].setValue(value1 - h1);
-            p[1].setValue(value2 - h2);
-            function_->setParameters(p); // also reset previous parameter...
-            vector<size_t> tmp(2);
-            tmp[0] = 0;
-            tmp[1] = 1;
-            p = p.createSubList(tmp); // removed the previous parameters.
-            f11_ = function_->getValue();
-
-            p[1].setValue(value2 + h2);
-            function_->setParameters(p.createSubList(1));
-            f12_ = function_->getValue();
-
-            p[0].setValue(value1 + h1);
-            function_->setParameters(p.createSubList(0));
-            f22_ = function_->getValue();
-
-            p[1].setValue(value2 - h2);
-            function_->setParameters(p.createSubList(1));
-            f21_ = function_->getValue();
+          pairs.push_back(make_pair(k1, k2));
+        }
+      }
 
-            crossDer2_(i, j) = ((f22_ - f21_) - (f12_ - f11_)) / (4 * h1 * h2);
-          }
-          catch (ConstraintException& ce)
-          {
-            throw Exception("ThreePointsNumericalDerivative::setParameters. Could not compute cross derivatives at limit.");
-          }
+      runTasks_(pairs.size(), [&](size_t k, size_t thread) {
+        size_t k1 = pairs[k].first;
+        size_t k2 = pairs[k].second;
+        vector<size_t> crossSlots = { slots[k1], slots[k2] };
+        double value1 = point_[slots[k1]];
+        double value2 = point_[slots[k2]];
+        double h1 = (1. + std::abs(value1)) * h_;
+        double h2 = (1. + std::abs(value2)) * h_;
 
-          lastVar1 = var1;
-          lastVar2 = var2;
+        // Compute 4 additional points:
+        try
+        {
+          double f11 = evaluate_(thread, crossSlots, { value1 - h1, value2 - h2 });
+          double f12 = evaluate_(thread, crossSlots, { value1 - h1, value2 + h2 });
+          double f22 = evaluate_(thread, crossSlots, { value1 + h1, value2 + h2 });
+          double f21 = evaluate_(thread, crossSlots, { value1 + h1, value2 - h2 });
+          double d2 = ((f22 - f21) - (f12 - f11)) / (4 * h1 * h2);
+          crossDer2_(indices[k1], indices[k2]) = d2;
+          crossDer2_(indices[k2], indices[k1]) = d2;
         }
-      }
+        catch (ConstraintException& ce)
+        {
+          throw Exception("ThreePointsNumericalDerivative::setParameters. Could not compute cross derivatives at limit.");
+        }
+      });
     }
 
-    // Reset last parameter and compute analytical derivatives if any.
+    // Reset initial value and compute analytical derivatives if any.
     if (function1_)
       function1_->enableFirstOrderDerivatives(computeD1_);
     if (function2_)
       function2_->enableSecondOrderDerivatives(computeD2_);
-    if (functionChanged)
-      function_->setParameters(parameters.createSubList(lastVar));
+    if (!slots.empty())
+      resetPoint_(parameters);
   }
   else
   {
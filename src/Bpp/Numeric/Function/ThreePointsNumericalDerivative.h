@@ -51,36 +51,18 @@ class ThreePointsNumericalDerivative :
   public AbstractNumericalDerivative
 {
 private:
-  double f1_, f2_, f3_, f11_, f22_, f12_, f21_;
+  double f2_;
 
 public:
   ThreePointsNumericalDerivative (std::shared_ptr<FunctionInterface> function) :
     AbstractNumericalDerivative(function),
-    f1_(),
-    f2_(),
-    f3_(),
-    f11_(),
-    f22_(),
-    f12_(),
-    f21_() {}
+    f2_() {}
   ThreePointsNumericalDerivative(std::shared_ptr<FirstOrderDerivable> function) :
     AbstractNumericalDerivative(function),
-    f1_(),
-    f2_(),
-    f3_(),
-    f11_(),
-    f22_(),
-    f12_(),
-    f21_() {}
+    f2_() {}
   ThreePointsNumericalDerivative(std::shared_ptr<SecondOrderDerivable> function) :
     AbstractNumericalDerivative(function),
-    f1_(),
-    f2_(),
-    f3_(),
-    f11_(),
-    f22_(),
-    f12_(),
-    f21_() {}
+    f2_() {}
   virtual ~ThreePointsNumericalDerivative() {}
 
   ThreePointsNumericalDerivative* clone() const override
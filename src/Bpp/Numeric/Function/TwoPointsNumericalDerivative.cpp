@@ -27,69 +27,55 @@ void TwoPointsNumericalDerivative::updateDerivatives(const ParameterList& parame
       return;
     }
 
-    string lastVar;
-    bool functionChanged = false;
-    ParameterList p;
-    bool start = true;
-    for (size_t i = 0; i < variables_.size(); ++i)
+    setPoint_();
+    vector<size_t> indices;
+    vector<size_t> slots = bindVariables_(parameters, indices);
+    vector<double> precisions(slots.size());
+    for (size_t k = 0; k < slots.size(); ++k)
     {
-      string var = variables_[i];
-      if (!parameters.hasParameter(var))
-        continue;
-      if (!start)
-      {
-        vector<string> vars(2);
-        vars[0] = var;
-        vars[1] = lastVar;
-        p = parameters.createSubList(vars);
-      }
-      else
-      {
-        p = parameters.createSubList(var);
-        start = false;
-      }
-      lastVar = var;
-      functionChanged = true;
-      double value = function_->getParameterValue(var);
+      precisions[k] = parameters.parameter(variables_[indices[k]]).getPrecision();
+    }
+
+    // Each variable is shifted independently from the point:
+    runTasks_(slots.size(), [&](size_t k, size_t thread) {
+      double value = point_[slots[k]];
       double h = -(1. + std::abs(value)) * h_;
-      if (abs(h) < p[0].getPrecision())
-        h = h < 0 ? -p[0].getPrecision() : p[0].getPrecision();
-      double hf2(0);
+      if (abs(h) < precisions[k])
+        h = h < 0 ? -precisions[k] : precisions[k];
+      double f2 = 0, hf2 = 0;
       unsigned int nbtry = 0;
 
       // Compute one other point:
       while (hf2 == 0)
       {
+        bool valid;
         try
         {
-          p[0].setValue(value + h);
-          function_->setParameters(p); // also reset previous parameter...
-
-          p = p.createSubList(0);
-          f2_ = function_->getValue();
-          if ((abs(f2_) >= NumConstants::VERY_BIG()) || std::isnan(f2_))
-            throw ConstraintException("f2_ too large", &p[0], f2_);
-          else
-            hf2 = h;
+          f2 = evaluate_(thread, { slots[k] }, { value + h });
+          valid = (abs(f2) < NumConstants::VERY_BIG()) && !std::isnan(f2);
         }
         catch (ConstraintException& ce)
         {
-          if (++nbtry == 10) // no possibility to compute derivatives
-            break;
-          else if (h < 0)
-            h = -h; // try on the right
-          else
-            h /= -2; // try again on the left with smaller interval
+          valid = false;
         }
+        if (valid)
+          hf2 = h;
+        else if (++nbtry == 10) // no possibility to compute derivatives
+          break;
+        else if (h < 0)
+          h = -h; // try on the right
+        else
+          h /= -2; // try again on the left with smaller interval
       }
 
-      der1_[i] = (f2_ - f1_) / h;
-    }
-    // Reset last parameter and compute analytical derivatives if any:
+      der1_[indices[k]] = (f2 - f1_) / h;
+    });
+
+    // Reset initial value and compute analytical derivatives if any:
     if (function1_)
       function1_->enableFirstOrderDerivatives(computeD1_);
-    if (functionChanged)
-      function_->setParameters(parameters.createSubList(lastVar));
+    if (!slots.empty())
+      resetPoint_(parameters);
   }
   else
   {
@@ -41,17 +41,15 @@ class TwoPointsNumericalDerivative :
   public AbstractNumericalDerivative
 {
 private:
-  double f1_, f2_;
+  double f1_;
 
 public:
   TwoPointsNumericalDerivative(std::shared_ptr<FunctionInterface> function) :
     AbstractNumericalDerivative(function),
-    f1_(),
-    f2_() {}
+    f1_() {}
   TwoPointsNumericalDerivative(std::shared_ptr<FirstOrderDerivable> function) :
     AbstractNumericalDerivative(function),
-    f1_(),
-    f2_() {}
+    f1_() {}
   virtual ~TwoPointsNumericalDerivative() {}
 
   TwoPointsNumericalDerivative* clone() const override
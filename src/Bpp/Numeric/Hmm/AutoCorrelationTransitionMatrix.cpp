@@ -55,7 +55,10 @@ const Matrix<double>& AutoCorrelationTransitionMatrix::getPij() const
     {
       for (size_t j = 0; j < vAutocorrel_.size(); ++j)
       {
-        pij_(i, j) = (i == j) ? vAutocorrel_[i] : (1 - vAutocorrel_[i]) / static_cast<double>(getNumberOfStates() - 1);
+        if (vAutocorrel_.size() == 1)
+          pij_(i, j) = 1.; // A single state can only go to itself.
+        else
+          pij_(i, j) = (i == j) ? vAutocorrel_[i] : (1 - vAutocorrel_[i]) / static_cast<double>(getNumberOfStates() - 1);
       }
     }
 
@@ -70,6 +73,26 @@ const std::vector<double>& AutoCorrelationTransitionMatrix::getEquilibriumFreque
   return eqFreq_;
 }
 
+void AutoCorrelationTransitionMatrix::getDiagonalPlusRankOne(std::vector<double>& d, std::vector<double>& u, std::vector<double>& w) const
+{
+  size_t size = vAutocorrel_.size();
+  d.resize(size);
+  u.resize(size);
+  w.assign(size, 1.);
+  if (size == 1)
+  {
+    // A single state can only go to itself: no rank one term.
+    d[0] = 1.;
+    u[0] = 0.;
+    return;
+  }
+  for (size_t i = 0; i < size; ++i)
+  {
+    u[i] = (1 - vAutocorrel_[i]) / static_cast<double>(size - 1);
+    d[i] = vAutocorrel_[i] - u[i];
+  }
+}
+
 void AutoCorrelationTransitionMatrix::fireParameterChanged(const ParameterList& parameters)
 {
   size_t salph = getNumberOfStates();
@@ -47,6 +47,8 @@ public:
    */
   double Pij(size_t i, size_t j) const override
   {
+    if (vAutocorrel_.size() == 1)
+      return 1.; // A single state can only go to itself.
     return (i == j) ? vAutocorrel_[i] : (1 - vAutocorrel_[i]) / static_cast<double>(getNumberOfStates() - 1);
   }
 
@@ -62,6 +64,14 @@ public:
    */
   const std::vector<double>& getEquilibriumFrequencies() const override;
 
+  /**
+   * @brief The matrix is diagonal plus rank one, with
+   * \f$d_i = \lambda_i - (1 - \lambda_i) / (n - 1)\f$, \f$u_i = (1 - \lambda_i) / (n - 1)\f$ and \f$w_j = 1\f$.
+   */
+  bool isDiagonalPlusRankOne() const override { return true; }
+
+  void getDiagonalPlusRankOne(std::vector<double>& d, std::vector<double>& u, std::vector<double>& w) const override;
+
 
   /*
    * @brief From AbstractParametrizable interface
@@ -0,0 +1,304 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "BatchRescaledHmmLikelihood.h"
+
+// from the STL:
+#include <algorithm>
+#include <cmath>
+
+using namespace bpp;
+using namespace std;
+
+BatchRescaledHmmLikelihood::BatchRescaledHmmLikelihood(
+    std::shared_ptr<HmmStateAlphabet> hiddenAlphabet,
+    std::shared_ptr<HmmTransitionMatrix> transitionMatrix,
+    const std::vector< std::shared_ptr<HmmEmissionProbabilities> >& emissionProbabilities,
+    const std::string& prefix) :
+  AbstractParametrizable(prefix),
+  hiddenAlphabet_(hiddenAlphabet),
+  transitionMatrix_(transitionMatrix),
+  emissionProbabilities_(emissionProbabilities),
+  logLiks_(),
+  dLogLiks_(),
+  d2LogLiks_(),
+  logLik_(),
+  dLogLik_(),
+  dVariable_(),
+  d2LogLik_(),
+  d2Variable_(),
+  threadPool_(),
+  nbStates_()
+{
+  if (!hiddenAlphabet)
+    throw Exception("BatchRescaledHmmLikelihood: null pointer passed for HmmStateAlphabet.");
+  if (!transitionMatrix)
+    throw Exception("BatchRescaledHmmLikelihood: null pointer passed for HmmTransitionMatrix.");
+  if (!hiddenAlphabet_->worksWith(transitionMatrix->hmmStateAlphabet()))
+    throw Exception("BatchRescaledHmmLikelihood: HmmTransitionMatrix and HmmEmissionProbabilities should point toward the same HmmStateAlphabet object.");
+  for (const auto& emissions : emissionProbabilities_)
+  {
+    if (!emissions)
+      throw Exception("BatchRescaledHmmLikelihood: null pointer passed for HmmEmissionProbabilities.");
+    if (!hiddenAlphabet_->worksWith(emissions->hmmStateAlphabet()))
+      throw Exception("BatchRescaledHmmLikelihood: HmmTransitionMatrix and HmmEmissionProbabilities should point toward the same HmmStateAlphabet object.");
+  }
+  nbStates_ = hiddenAlphabet_->getNumberOfStates();
+
+  // Manage parameters. Emission parameters with the same name are shared by all sequences:
+  addParameters_(hiddenAlphabet_->getParameters());
+  addParameters_(transitionMatrix_->getParameters());
+  for (const auto& emissions : emissionProbabilities_)
+  {
+    includeParameters_(emissions->getParameters());
+  }
+
+  // Compute:
+  compute_(0, logLiks_, dLogLiks_, d2LogLiks_);
+  logLik_ = VectorTools::sum(logLiks_);
+}
+
+BatchRescaledHmmLikelihood::BatchRescaledHmmLikelihood(const BatchRescaledHmmLikelihood& lik) :
+  AbstractParametrizable(lik),
+  hiddenAlphabet_(dynamic_cast<HmmStateAlphabet*>(lik.hiddenAlphabet_->clone())),
+  transitionMatrix_(dynamic_cast<HmmTransitionMatrix*>(lik.transitionMatrix_->clone())),
+  emissionProbabilities_(),
+  logLiks_(lik.logLiks_),
+  dLogLiks_(lik.dLogLiks_),
+  d2LogLiks_(lik.d2LogLiks_),
+  logLik_(lik.logLik_),
+  dLogLik_(lik.dLogLik_),
+  dVariable_(lik.dVariable_),
+  d2LogLik_(lik.d2LogLik_),
+  d2Variable_(lik.d2Variable_),
+  threadPool_(lik.threadPool_),
+  nbStates_(lik.nbStates_)
+{
+  // Now adjust pointers:
+  transitionMatrix_->setHmmStateAlphabet(hiddenAlphabet_);
+  for (const auto& emissions : lik.emissionProbabilities_)
+  {
+    emissionProbabilities_.push_back(shared_ptr<HmmEmissionProbabilities>(dynamic_cast<HmmEmissionProbabilities*>(emissions->clone())));
+    emissionProbabilities_.back()->setHmmStateAlphabet(hiddenAlphabet_);
+  }
+}
+
+BatchRescaledHmmLikelihood& BatchRescaledHmmLikelihood::operator=(const BatchRescaledHmmLikelihood& lik)
+{
+  AbstractParametrizable::operator=(lik);
+  hiddenAlphabet_   = shared_ptr<HmmStateAlphabet>(dynamic_cast<HmmStateAlphabet*>(lik.hiddenAlphabet_->clone()));
+  transitionMatrix_ = shared_ptr<HmmTransitionMatrix>(dynamic_cast<HmmTransitionMatrix*>(lik.transitionMatrix_->clone()));
+  logLiks_          = lik.logLiks_;
+  dLogLiks_         = lik.dLogLiks_;
+  d2LogLiks_        = lik.d2LogLiks_;
+  logLik_           = lik.logLik_;
+  dLogLik_          = lik.dLogLik_;
+  dVariable_        = lik.dVariable_;
+  d2LogLik_         = lik.d2LogLik_;
+  d2Variable_       = lik.d2Variable_;
+  threadPool_       = lik.threadPool_;
+  nbStates_         = lik.nbStates_;
+
+  // Now adjust pointers:
+  transitionMatrix_->setHmmStateAlphabet(hiddenAlphabet_);
+  emissionProbabilities_.clear();
+  for (const auto& emissions : lik.emissionProbabilities_)
+  {
+    emissionProbabilities_.push_back(shared_ptr<HmmEmissionProbabilities>(dynamic_cast<HmmEmissionProbabilities*>(emissions->clone())));
+    emissionProbabilities_.back()->setHmmStateAlphabet(hiddenAlphabet_);
+  }
+  return *this;
+}
+
+void BatchRescaledHmmLikelihood::setNamespace(const std::string& nameSpace)
+{
+  AbstractParametrizable::setNamespace(nameSpace);
+
+  hiddenAlphabet_->setNamespace(nameSpace);
+  transitionMatrix_->setNamespace(nameSpace);
+  for (auto& emissions : emissionProbabilities_)
+  {
+    emissions->setNamespace(nameSpace);
+  }
+}
+
+void BatchRescaledHmmLikelihood::fireParameterChanged(const ParameterList& pl)
+{
+  dVariable_ = "";
+  d2Variable_ = "";
+
+  bool alphabetChanged    = hiddenAlphabet_->matchParametersValues(pl);
+  bool transitionsChanged = transitionMatrix_->matchParametersValues(pl);
+  // The transitions and emissions can depend on the alphabet (see RescaledHmmLikelihood):
+  if (alphabetChanged && !transitionsChanged)
+    transitionMatrix_->setParametersValues(transitionMatrix_->getParameters());
+  for (auto& emissions : emissionProbabilities_)
+  {
+    bool emissionChanged = emissions->matchParametersValues(pl);
+    if (alphabetChanged && !emissionChanged)
+      emissions->setParametersValues(emissions->getParameters());
+  }
+
+  compute_(0, logLiks_, dLogLiks_, d2LogLiks_);
+  logLik_ = VectorTools::sum(logLiks_);
+}
+
+/***************************************************************************************************************************/
+
+double BatchRescaledHmmLikelihood::getFirstOrderDerivative(const std::string& variable) const
+{
+  if (variable != dVariable_)
+  {
+    dVariable_ = variable;
+    for (const auto& emissions : emissionProbabilities_)
+    {
+      emissions->computeDEmissionProbabilities(dVariable_);
+    }
+    vector<double> logLiks;
+    compute_(1, logLiks, dLogLiks_, d2LogLiks_);
+    dLogLik_ = VectorTools::sum(dLogLiks_);
+  }
+  return -dLogLik_;
+}
+
+double BatchRescaledHmmLikelihood::getSecondOrderDerivative(const std::string& variable) const
+{
+  if (variable != d2Variable_)
+  {
+    // First and second order derivatives are computed in the same pass:
+    d2Variable_ = variable;
+    dVariable_ = variable;
+    for (const auto& emissions : emissionProbabilities_)
+    {
+      emissions->computeDEmissionProbabilities(dVariable_);
+      emissions->computeD2EmissionProbabilities(d2Variable_);
+    }
+    vector<double> logLiks;
+    compute_(2, logLiks, dLogLiks_, d2LogLiks_);
+    dLogLik_ = VectorTools::sum(dLogLiks_);
+    d2LogLik_ = VectorTools::sum(d2LogLiks_);
+  }
+  return -d2LogLik_;
+}
+
+/***************************************************************************************************************************/
+
+void BatchRescaledHmmLikelihood::compute_(unsigned int order, std::vector<double>& logLiks, std::vector<double>& dLogLiks, std::vector<double>& d2LogLiks) const
+{
+  size_t nbSequences = emissionProbabilities_.size();
+  logLiks.resize(nbSequences);
+  if (order > 0)
+    dLogLiks.resize(nbSequences);
+  if (order > 1)
+    d2LogLiks.resize(nbSequences);
+
+  // Transition probabilities, shared by all sequences:
+  HmmTransitionKernel trans(*transitionMatrix_);
+
+  // Probabilities of the first hidden state:
+  vector<double> init(nbStates_);
+  trans.forward(&transitionMatrix_->getEquilibriumFrequencies()[0], &init[0]);
+
+  auto run = [&](size_t s, size_t /* thread */) {
+               double dummy;
+               computeSequence_(s, trans, init, order, logLiks[s],
+                                order > 0 ? dLogLiks[s] : dummy,
+                                order > 1 ? d2LogLiks[s] : dummy);
+             };
+  if (threadPool_)
+    threadPool_->parallelFor(nbSequences, run);
+  else
+  {
+    for (size_t s = 0; s < nbSequences; ++s)
+    {
+      run(s, 0);
+    }
+  }
+}
+
+void BatchRescaledHmmLikelihood::computeSequence_(size_t sequence, const HmmTransitionKernel& trans, const std::vector<double>& init,
+                                                  unsigned int order, double& logLik, double& dLogLik, double& d2LogLik) const
+{
+  const HmmEmissionProbabilities& emissionProbabilities = *emissionProbabilities_[sequence];
+  size_t nbSites = emissionProbabilities.getNumberOfPositions();
+
+  // Rescaled forward values of the current site, and their derivatives:
+  vector<double> lik(nbStates_), dLik(nbStates_), d2Lik(nbStates_);
+  vector<double> x(init), dx(nbStates_, 0.), d2x(nbStates_, 0.);
+  vector<double> tmp(nbStates_), dTmp(nbStates_), d2Tmp(nbStates_);
+
+  logLik = 0;
+  dLogLik = 0;
+  d2LogLik = 0;
+  for (size_t i = 0; i < nbSites; i++)
+  {
+    if (i > 0)
+    {
+      trans.forward(&lik[0], &x[0]);
+      if (order > 0)
+        trans.forward(&dLik[0], &dx[0]);
+      if (order > 1)
+        trans.forward(&d2Lik[0], &d2x[0]);
+    }
+
+    const vector<double>& emissions = emissionProbabilities(i);
+    double scale = 0;
+    bool negative = false;
+    for (size_t j = 0; j < nbStates_; j++)
+    {
+      tmp[j] = emissions[j] * x[j];
+      negative |= tmp[j] < 0;
+      scale += tmp[j];
+    }
+    if (negative)
+    {
+      // Negative values are rounding errors, set to zero:
+      scale = 0;
+      for (size_t j = 0; j < nbStates_; j++)
+      {
+        tmp[j] = max(tmp[j], 0.);
+        scale += tmp[j];
+      }
+    }
+    logLik += log(scale);
+    for (size_t j = 0; j < nbStates_; j++)
+    {
+      lik[j] = scale > 0 ? tmp[j] / scale : 0;
+    }
+
+    if (order == 0)
+      continue;
+
+    const vector<double>& dEmissions = emissionProbabilities.getDEmissionProbabilities(i);
+    double dScale = 0;
+    for (size_t j = 0; j < nbStates_; j++)
+    {
+      dTmp[j] = dEmissions[j] * x[j] + emissions[j] * dx[j];
+      dScale += dTmp[j];
+    }
+    dLogLik += dScale / scale;
+
+    if (order > 1)
+    {
+      const vector<double>& d2Emissions = emissionProbabilities.getD2EmissionProbabilities(i);
+      double d2Scale = 0;
+      for (size_t j = 0; j < nbStates_; j++)
+      {
+        d2Tmp[j] = d2Emissions[j] * x[j] + 2 * dEmissions[j] * dx[j] + emissions[j] * d2x[j];
+        d2Scale += d2Tmp[j];
+      }
+      d2LogLik += d2Scale / scale - pow(dScale / scale, 2);
+      for (size_t j = 0; j < nbStates_; j++)
+      {
+        d2Lik[j] = d2Tmp[j] / scale - (d2Scale * tmp[j] + 2 * dScale * dTmp[j]) / pow(scale, 2)
+            + 2 * pow(dScale, 2) * tmp[j] / pow(scale, 3);
+      }
+    }
+
+    for (size_t j = 0; j < nbStates_; j++)
+    {
+      dLik[j] = (dTmp[j] * scale - tmp[j] * dScale) / pow(scale, 2);
+    }
+  }
+}
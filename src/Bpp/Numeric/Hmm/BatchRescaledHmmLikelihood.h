@@ -0,0 +1,210 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_NUMERIC_HMM_BATCHRESCALEDHMMLIKELIHOOD_H
+#define BPP_NUMERIC_HMM_BATCHRESCALEDHMMLIKELIHOOD_H
+
+
+#include "../../Utils/ThreadPool.h"
+#include "../AbstractParametrizable.h"
+#include "../Function/Functions.h"
+#include "../VectorTools.h"
+#include "HmmEmissionProbabilities.h"
+#include "HmmStateAlphabet.h"
+#include "HmmTransitionKernel.h"
+#include "HmmTransitionMatrix.h"
+
+// From the STL:
+#include <memory>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Likelihood of several independent sequences under the same hidden Markov model.
+ *
+ * Each sequence is described by its own HmmEmissionProbabilities object, while the hidden
+ * states and the transition matrix are shared. The log-likelihood is the sum of the
+ * log-likelihoods of all sequences, computed with the rescaled forward recursion (see
+ * RescaledHmmLikelihood). This avoids building one likelihood object per sequence when
+ * fitting shared parameters on many short sequences: the transition probabilities are read
+ * once per evaluation for all sequences, and the sequences can be processed in parallel by
+ * providing a ThreadPool (see setThreadPool).
+ *
+ * Parameters with the same name in several emission objects are considered as shared, and
+ * are set in all of them. As for the other HmmLikelihood classes, derivatives are only
+ * available for parameters of the emission probabilities.
+ *
+ * Only the forward recursion is computed, and only the current site is stored for each
+ * sequence, so that memory use does not depend on the length of the sequences. Per-sequence
+ * values are summed in a fixed order, so that results do not depend on the number of threads.
+ */
+class BatchRescaledHmmLikelihood :
+  public virtual SecondOrderDerivable,
+  public AbstractParametrizable
+{
+private:
+  std::shared_ptr<HmmStateAlphabet> hiddenAlphabet_;
+  std::shared_ptr<HmmTransitionMatrix> transitionMatrix_;
+  std::vector< std::shared_ptr<HmmEmissionProbabilities> > emissionProbabilities_;
+
+  /**
+   * @brief Log-likelihood of each sequence, and its derivatives.
+   */
+  std::vector<double> logLiks_;
+  mutable std::vector<double> dLogLiks_;
+  mutable std::vector<double> d2LogLiks_;
+
+  double logLik_;
+  mutable double dLogLik_;
+  mutable std::string dVariable_;
+  mutable double d2LogLik_;
+  mutable std::string d2Variable_;
+
+  std::shared_ptr<ThreadPool> threadPool_;
+
+  size_t nbStates_;
+
+public:
+  /**
+   * @brief Build a new BatchRescaledHmmLikelihood object.
+   *
+   * @param hiddenAlphabet The alphabet of hidden states.
+   * @param transitionMatrix The transition matrix, shared by all sequences.
+   * @param emissionProbabilities One emission object for each sequence. All must point toward
+   * the same HmmStateAlphabet instance as the transition matrix.
+   * @param prefix The namespace of parameters.
+   */
+  BatchRescaledHmmLikelihood(
+      std::shared_ptr<HmmStateAlphabet> hiddenAlphabet,
+      std::shared_ptr<HmmTransitionMatrix> transitionMatrix,
+      const std::vector< std::shared_ptr<HmmEmissionProbabilities> >& emissionProbabilities,
+      const std::string& prefix);
+
+  BatchRescaledHmmLikelihood(const BatchRescaledHmmLikelihood& lik);
+
+  BatchRescaledHmmLikelihood& operator=(const BatchRescaledHmmLikelihood& lik);
+
+  virtual ~BatchRescaledHmmLikelihood() {}
+
+  BatchRescaledHmmLikelihood* clone() const override { return new BatchRescaledHmmLikelihood(*this); }
+
+public:
+  const HmmStateAlphabet& hmmStateAlphabet() const { return *hiddenAlphabet_; }
+  std::shared_ptr<const HmmStateAlphabet> getHmmStateAlphabet() const { return hiddenAlphabet_; }
+
+  const HmmTransitionMatrix& hmmTransitionMatrix() const { return *transitionMatrix_; }
+  std::shared_ptr<const HmmTransitionMatrix> getHmmTransitionMatrix() const { return transitionMatrix_; }
+
+  size_t getNumberOfSequences() const { return emissionProbabilities_.size(); }
+
+  const HmmEmissionProbabilities& hmmEmissionProbabilities(size_t sequence) const { return *emissionProbabilities_[sequence]; }
+  std::shared_ptr<const HmmEmissionProbabilities> getHmmEmissionProbabilities(size_t sequence) const { return emissionProbabilities_[sequence]; }
+
+  /**
+   * @brief Set the thread pool used to process the sequences in parallel.
+   *
+   * The pool is shared with the copies of this object.
+   *
+   * @param threadPool A thread pool, or a null pointer for a serial computation (the default).
+   */
+  void setThreadPool(std::shared_ptr<ThreadPool> threadPool) { threadPool_ = threadPool; }
+
+  std::shared_ptr<ThreadPool> getThreadPool() const { return threadPool_; }
+
+  void setParameters(const ParameterList& pl) override
+  {
+    setParametersValues(pl);
+  }
+
+  void setBoundParameters(const std::vector<size_t>& slots, const double* values, const std::vector<bool>* changed = nullptr) override
+  {
+    matchBoundParametersValues(slots, values, changed);
+  }
+
+  double getValue() const override { return -logLik_; }
+
+  /**
+   * @return The sum of the log-likelihoods of all sequences.
+   */
+  double getLogLikelihood() const { return logLik_; }
+
+  /**
+   * @return The log-likelihoods of all sequences.
+   */
+  const std::vector<double>& getLogLikelihoodForEachSequence() const { return logLiks_; }
+
+  double getLogLikelihoodForASequence(size_t sequence) const { return logLiks_[sequence]; }
+
+  /**
+   * @brief Derivatives of the log-likelihood of a sequence.
+   *
+   * These are the values computed for the last variable passed to getFirstOrderDerivative
+   * and getSecondOrderDerivative respectively.
+   *
+   * @param sequence The index of the sequence.
+   * @{
+   */
+  double getDLogLikelihoodForASequence(size_t sequence) const { return dLogLiks_[sequence]; }
+
+  double getD2LogLikelihoodForASequence(size_t sequence) const { return d2LogLiks_[sequence]; }
+  /** @} */
+
+  void setNamespace(const std::string& nameSpace) override;
+
+  void fireParameterChanged(const ParameterList& pl) override;
+
+  /**
+   * @{
+   *
+   * @brief From FirstOrderDerivable and SecondOrderDerivable.
+   *
+   * Derivatives are those of the function value, that is, -log-likelihood.
+   */
+  void enableFirstOrderDerivatives(bool /* yn */) override {}
+
+  bool enableFirstOrderDerivatives() const override { return true; }
+
+  double getFirstOrderDerivative(const std::string& variable) const override;
+
+  void enableSecondOrderDerivatives(bool /* yn */) override {}
+
+  bool enableSecondOrderDerivatives() const override { return true; }
+
+  double getSecondOrderDerivative(const std::string& variable) const override;
+
+  double getSecondOrderDerivative(const std::string& /* variable1 */, const std::string& /* variable2 */) const override
+  {
+    throw NotImplementedException("BatchRescaledHmmLikelihood::getSecondOrderDerivative is not defined for 2 variables.");
+  }
+  /** @} */
+
+protected:
+  /**
+   * @brief Compute the log-likelihood of all sequences, and its derivatives up to the given order.
+   *
+   * @param order 0 for the log-likelihood only, 1 or 2 to compute derivatives, for which
+   * the derivatives of the emission probabilities must have been computed.
+   * @param logLiks [out] The log-likelihood of each sequence.
+   * @param dLogLiks [out] The first order derivatives, if order > 0.
+   * @param d2LogLiks [out] The second order derivatives, if order > 1.
+   */
+  void compute_(unsigned int order, std::vector<double>& logLiks, std::vector<double>& dLogLiks, std::vector<double>& d2LogLiks) const;
+
+  /**
+   * @brief Forward recursion on one sequence.
+   *
+   * @param sequence The index of the sequence.
+   * @param trans The transition probabilities.
+   * @param init The probabilities of the first hidden state.
+   * @param order The order of derivatives to compute.
+   * @param logLik [out] The log-likelihood of the sequence.
+   * @param dLogLik [out] Its first order derivative, if order > 0.
+   * @param d2LogLik [out] Its second order derivative, if order > 1.
+   */
+  void computeSequence_(size_t sequence, const HmmTransitionKernel& trans, const std::vector<double>& init,
+                        unsigned int order, double& logLik, double& dLogLik, double& d2LogLik) const;
+};
+} // end of namespace bpp.
+#endif // BPP_NUMERIC_HMM_BATCHRESCALEDHMMLIKELIHOOD_H
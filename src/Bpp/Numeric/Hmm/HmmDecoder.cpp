@@ -0,0 +1,206 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "HmmDecoder.h"
+
+// from the STL:
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+using namespace bpp;
+using namespace std;
+
+HmmDecoder::HmmDecoder(
+    std::shared_ptr<const HmmTransitionMatrix> transitionMatrix,
+    std::shared_ptr<const HmmEmissionProbabilities> emissionProbabilities) :
+  transitionMatrix_(transitionMatrix),
+  emissionProbabilities_(emissionProbabilities),
+  breakPoints_(),
+  nbStates_(),
+  nbSites_()
+{
+  if (!transitionMatrix)
+    throw Exception("HmmDecoder: null pointer passed for HmmTransitionMatrix.");
+  if (!emissionProbabilities)
+    throw Exception("HmmDecoder: null pointer passed for HmmEmissionProbabilities.");
+  if (!transitionMatrix_->hmmStateAlphabet().worksWith(emissionProbabilities_->hmmStateAlphabet()))
+    throw Exception("HmmDecoder: HmmTransitionMatrix and HmmEmissionProbabilities should point toward the same HmmStateAlphabet object.");
+
+  nbStates_ = transitionMatrix_->getNumberOfStates();
+  nbSites_ = emissionProbabilities_->getNumberOfPositions();
+}
+
+HmmDecoder::HmmDecoder(const HmmLikelihood& likelihood) :
+  HmmDecoder(likelihood.getHmmTransitionMatrix(), likelihood.getHmmEmissionProbabilities())
+{
+  breakPoints_ = likelihood.getBreakPoints();
+}
+
+/***************************************************************************************************************************/
+
+double HmmDecoder::viterbi(std::vector<size_t>& path) const
+{
+  if (nbStates_ <= static_cast<size_t>(numeric_limits<uint8_t>::max()) + 1)
+    return viterbi_<uint8_t>(path);
+  if (nbStates_ <= static_cast<size_t>(numeric_limits<uint16_t>::max()) + 1)
+    return viterbi_<uint16_t>(path);
+  return viterbi_<size_t>(path);
+}
+
+template<class IndexType>
+double HmmDecoder::viterbi_(std::vector<size_t>& path) const
+{
+  path.resize(nbSites_);
+  if (nbSites_ == 0)
+    return 0;
+
+  double x;
+  size_t kMax;
+
+  // Transition probabilities, in log:
+  vector<double> logTrans(nbStates_ * nbStates_);
+  for (size_t i = 0; i < nbStates_; i++)
+  {
+    size_t ii = i * nbStates_;
+    for (size_t j = 0; j < nbStates_; j++)
+    {
+      logTrans[ii + j] = log(transitionMatrix_->Pij(j, i));
+    }
+  }
+
+  // Probabilities of the first state of a segment, in log:
+  const vector<double>& eqFreq = transitionMatrix_->getEquilibriumFrequencies();
+  vector<double> logInit(nbStates_);
+  for (size_t j = 0; j < nbStates_; j++)
+  {
+    x = 0;
+    for (size_t k = 0; k < nbStates_; k++)
+    {
+      x += transitionMatrix_->Pij(k, j) * eqFreq[k];
+    }
+    logInit[j] = log(x);
+  }
+
+  // Traceback pointers: pointers[i * nbStates_ + j] is the state at site i - 1
+  // on the best path ending in state j at site i.
+  vector<IndexType> pointers(nbSites_ * nbStates_);
+  vector<double> logProb1(nbStates_), logProb2(nbStates_);
+  vector<double>* previousLogProb = &logProb2, * currentLogProb = &logProb1, * tmpLogProb;
+
+  // Initialisation:
+  const vector<double>* emissions = &(*emissionProbabilities_)(0);
+  for (size_t j = 0; j < nbStates_; j++)
+  {
+    (*currentLogProb)[j] = logInit[j] + log((*emissions)[j]);
+  }
+
+  // Recursion:
+  size_t nextBrkPt = nbSites_; // next break point
+  vector<size_t>::const_iterator bpIt = breakPoints_.begin();
+  if (bpIt != breakPoints_.end())
+    nextBrkPt = *bpIt;
+
+  for (size_t i = 1; i < nbSites_; i++)
+  {
+    // Swap pointers:
+    tmpLogProb = previousLogProb;
+    previousLogProb = currentLogProb;
+    currentLogProb = tmpLogProb;
+
+    size_t ii = i * nbStates_;
+    emissions = &(*emissionProbabilities_)(i);
+    if (i < nextBrkPt)
+    {
+      for (size_t j = 0; j < nbStates_; j++)
+      {
+        size_t jj = j * nbStates_;
+        double best = -numeric_limits<double>::infinity();
+        kMax = 0;
+        for (size_t k = 0; k < nbStates_; k++)
+        {
+          x = logTrans[jj + k] + (*previousLogProb)[k];
+          if (x > best)
+          {
+            best = x;
+            kMax = k;
+          }
+        }
+        (*currentLogProb)[j] = best + log((*emissions)[j]);
+        pointers[ii + j] = static_cast<IndexType>(kMax);
+      }
+    }
+    else // Reset markov chain:
+    {
+      // The previous segment ends with its best state whatever the state at this site,
+      // and the log probabilities keep accumulating over segments.
+      double best = -numeric_limits<double>::infinity();
+      kMax = 0;
+      for (size_t k = 0; k < nbStates_; k++)
+      {
+        if ((*previousLogProb)[k] > best)
+        {
+          best = (*previousLogProb)[k];
+          kMax = k;
+        }
+      }
+      for (size_t j = 0; j < nbStates_; j++)
+      {
+        (*currentLogProb)[j] = best + logInit[j] + log((*emissions)[j]);
+        pointers[ii + j] = static_cast<IndexType>(kMax);
+      }
+      bpIt++;
+      if (bpIt != breakPoints_.end())
+        nextBrkPt = *bpIt;
+      else
+        nextBrkPt = nbSites_;
+    }
+  }
+
+  // Termination:
+  double logProb = -numeric_limits<double>::infinity();
+  kMax = 0;
+  for (size_t k = 0; k < nbStates_; k++)
+  {
+    if ((*currentLogProb)[k] > logProb)
+    {
+      logProb = (*currentLogProb)[k];
+      kMax = k;
+    }
+  }
+
+  // Traceback:
+  path[nbSites_ - 1] = kMax;
+  for (size_t i = nbSites_ - 1; i > 0; i--)
+  {
+    path[i - 1] = static_cast<size_t>(pointers[i * nbStates_ + path[i]]);
+  }
+
+  return logProb;
+}
+
+/***************************************************************************************************************************/
+
+void HmmDecoder::posteriorDecoding(const HmmLikelihood& likelihood, std::vector<size_t>& path, std::vector<double>* probs)
+{
+  size_t nbSites = likelihood.hmmEmissionProbabilities().getNumberOfPositions();
+  size_t nbStates = likelihood.hmmStateAlphabet().getNumberOfStates();
+  path.resize(nbSites);
+  if (probs)
+    probs->resize(nbSites);
+
+  for (size_t i = 0; i < nbSites; i++)
+  {
+    Vdouble post = likelihood.getHiddenStatesPosteriorProbabilitiesForASite(i);
+    size_t kMax = 0;
+    for (size_t k = 1; k < nbStates; k++)
+    {
+      if (post[k] > post[kMax])
+        kMax = k;
+    }
+    path[i] = kMax;
+    if (probs)
+      (*probs)[i] = post[kMax];
+  }
+}
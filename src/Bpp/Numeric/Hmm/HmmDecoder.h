@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_NUMERIC_HMM_HMMDECODER_H
+#define BPP_NUMERIC_HMM_HMMDECODER_H
+
+
+#include "HmmEmissionProbabilities.h"
+#include "HmmLikelihood.h"
+#include "HmmTransitionMatrix.h"
+
+// From the STL:
+#include <memory>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Decoding of the hidden states of a hidden Markov model.
+ *
+ * Two decodings are available:
+ * - the Viterbi decoding, which gives the most probable sequence of hidden states
+ *   given the data,
+ * - the posterior (maximum a posteriori) decoding, which gives, for each site, the
+ *   hidden state with the highest posterior probability.
+ *
+ * The Viterbi recursion is performed in log space, using the same HmmTransitionMatrix
+ * and HmmEmissionProbabilities objects as the likelihood classes, and with the same
+ * conventions: the chain is reset to the equilibrium frequencies at each break point,
+ * so that the decoding of each segment is independent of the others.
+ * Only two arrays of size nbStates are used for the recursion, and the traceback
+ * pointers are stored with the smallest integer type able to hold a state index
+ * (one byte per state and site for up to 256 states, two bytes for up to 65536 states).
+ */
+class HmmDecoder
+{
+private:
+  std::shared_ptr<const HmmTransitionMatrix> transitionMatrix_;
+  std::shared_ptr<const HmmEmissionProbabilities> emissionProbabilities_;
+  std::vector<size_t> breakPoints_;
+  size_t nbStates_, nbSites_;
+
+public:
+  /**
+   * @brief Build a new HmmDecoder object.
+   *
+   * @param transitionMatrix The transition probabilities between hidden states.
+   * @param emissionProbabilities The probabilities of the data conditioned on the hidden states.
+   * @throw Exception if a null pointer is passed, or if the two objects do not share the same alphabet.
+   */
+  HmmDecoder(
+      std::shared_ptr<const HmmTransitionMatrix> transitionMatrix,
+      std::shared_ptr<const HmmEmissionProbabilities> emissionProbabilities);
+
+  /**
+   * @brief Build a new HmmDecoder object sharing the model and the break points of a likelihood object.
+   *
+   * @param likelihood The HMM likelihood object.
+   */
+  HmmDecoder(const HmmLikelihood& likelihood);
+
+  virtual ~HmmDecoder() {}
+
+public:
+  const std::vector<size_t>& getBreakPoints() const { return breakPoints_; }
+
+  void setBreakPoints(const std::vector<size_t>& breakPoints) { breakPoints_ = breakPoints; }
+
+  /**
+   * @brief Compute the most probable path of hidden states (Viterbi algorithm).
+   *
+   * Ties are resolved in favor of the state with the smallest index.
+   *
+   * @param path [out] The hidden state for each site.
+   * @return The log probability of the joint data and path, summed over all segments.
+   */
+  double viterbi(std::vector<size_t>& path) const;
+
+  /**
+   * @return The most probable path of hidden states (Viterbi algorithm).
+   */
+  std::vector<size_t> getViterbiPath() const
+  {
+    std::vector<size_t> path;
+    viterbi(path);
+    return path;
+  }
+
+  /**
+   * @brief Compute the posterior decoding of the hidden states.
+   *
+   * Posterior probabilities are retrieved one site at a time, so that the full
+   * matrix of posterior probabilities is never stored.
+   *
+   * @param likelihood An HMM likelihood object, with the same model as this decoder.
+   * @param path [out] For each site, the hidden state with the highest posterior probability.
+   * @param probs [out] (optional) If non-null, the posterior probability of each state in the path.
+   */
+  static void posteriorDecoding(const HmmLikelihood& likelihood, std::vector<size_t>& path, std::vector<double>* probs = 0);
+
+private:
+  template<class IndexType>
+  double viterbi_(std::vector<size_t>& path) const;
+};
+} // end of namespace bpp.
+#endif // BPP_NUMERIC_HMM_HMMDECODER_H
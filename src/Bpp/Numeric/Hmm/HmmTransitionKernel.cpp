@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "../Matrix/MatrixKernels.h"
+#include "HmmTransitionKernel.h"
+
+using namespace bpp;
+using namespace std;
+
+HmmTransitionKernel::HmmTransitionKernel(const HmmTransitionMatrix& transitionMatrix, bool useStructure) :
+  nbStates_(transitionMatrix.getNumberOfStates()),
+  structured_(useStructure && transitionMatrix.isDiagonalPlusRankOne()),
+  forwardTrans_(),
+  backwardTrans_(),
+  d_(),
+  u_(),
+  w_()
+{
+  if (structured_)
+  {
+    transitionMatrix.getDiagonalPlusRankOne(d_, u_, w_);
+    return;
+  }
+
+  forwardTrans_.resize(nbStates_ * nbStates_);
+  backwardTrans_.resize(nbStates_ * nbStates_);
+  for (size_t i = 0; i < nbStates_; i++)
+  {
+    size_t ii = i * nbStates_;
+    for (size_t j = 0; j < nbStates_; j++)
+    {
+      double p = transitionMatrix.Pij(i, j);
+      backwardTrans_[ii + j] = p;
+      forwardTrans_[j * nbStates_ + i] = p;
+    }
+  }
+}
+
+/******************************************************************************/
+
+void HmmTransitionKernel::forward(const double* x, double* y) const
+{
+  if (structured_)
+  {
+    double s = 0;
+    for (size_t k = 0; k < nbStates_; k++)
+    {
+      s += u_[k] * x[k];
+    }
+    for (size_t j = 0; j < nbStates_; j++)
+    {
+      y[j] = d_[j] * x[j] + w_[j] * s;
+    }
+    return;
+  }
+
+  MatrixKernels::gemv(nbStates_, nbStates_, forwardTrans_.data(), nbStates_, x, y);
+}
+
+void HmmTransitionKernel::backward(const double* x, double* y) const
+{
+  if (structured_)
+  {
+    double s = 0;
+    for (size_t k = 0; k < nbStates_; k++)
+    {
+      s += w_[k] * x[k];
+    }
+    for (size_t j = 0; j < nbStates_; j++)
+    {
+      y[j] = d_[j] * x[j] + u_[j] * s;
+    }
+    return;
+  }
+
+  MatrixKernels::gemv(nbStates_, nbStates_, backwardTrans_.data(), nbStates_, x, y);
+}
@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_NUMERIC_HMM_HMMTRANSITIONKERNEL_H
+#define BPP_NUMERIC_HMM_HMMTRANSITIONKERNEL_H
+
+
+#include "HmmTransitionMatrix.h"
+
+// From the STL:
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Products of vectors with a transition matrix, as used in the HMM recursions.
+ *
+ * This class takes a snapshot of the transition probabilities of an HmmTransitionMatrix,
+ * and computes the two products needed by the forward and backward recursions of the
+ * HMM likelihood classes. When the matrix declares a diagonal plus rank one structure
+ * (see HmmTransitionMatrix::isDiagonalPlusRankOne), the products are computed in O(n)
+ * operations instead of O(n^2), n being the number of hidden states. Otherwise, the
+ * matrix is stored once for each product, in a layout where each output value is the
+ * dot product of a contiguous row with the input vector, and the products are computed
+ * with the vectorized MatrixKernels::gemv.
+ *
+ * Products only read the snapshot, and can be called concurrently from several threads.
+ * The snapshot has to be rebuilt when the transition probabilities change.
+ */
+class HmmTransitionKernel
+{
+private:
+  size_t nbStates_;
+  bool structured_;
+
+  /**
+   * @brief Dense storages: forwardTrans_[j * nbStates_ + k] = P(k, j) and backwardTrans_[j * nbStates_ + k] = P(j, k).
+   */
+  std::vector<double> forwardTrans_;
+  std::vector<double> backwardTrans_;
+
+  /**
+   * @brief Structured storage: P(i, j) = delta(i, j) d_i + u_i w_j.
+   */
+  std::vector<double> d_, u_, w_;
+
+public:
+  /**
+   * @param transitionMatrix The transition matrix to take a snapshot of.
+   * @param useStructure If false, the dense storage is used even if the matrix is structured.
+   */
+  HmmTransitionKernel(const HmmTransitionMatrix& transitionMatrix, bool useStructure = true);
+
+public:
+  size_t getNumberOfStates() const { return nbStates_; }
+
+  /**
+   * @return true if the products use the diagonal plus rank one structure of the matrix.
+   */
+  bool isStructured() const { return structured_; }
+
+  /**
+   * @brief Compute \f$y_j = \sum_k P(k, j) x_k\f$, as in the forward recursion.
+   *
+   * @param x [in] A vector of nbStates values.
+   * @param y [out] A vector of nbStates values, not overlapping with x.
+   */
+  void forward(const double* x, double* y) const;
+
+  /**
+   * @brief Compute \f$y_j = \sum_k P(j, k) x_k\f$, as in the backward recursion.
+   *
+   * @param x [in] A vector of nbStates values.
+   * @param y [out] A vector of nbStates values, not overlapping with x.
+   */
+  void backward(const double* x, double* y) const;
+};
+} // end of namespace bpp.
+#endif // BPP_NUMERIC_HMM_HMMTRANSITIONKERNEL_H
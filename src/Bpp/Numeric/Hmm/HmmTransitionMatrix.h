@@ -69,6 +69,32 @@ public:
    * @return The vector of equilibrium frequencies of the Markov chain described by the matrix.
    */
   virtual const std::vector<double>& getEquilibriumFrequencies() const = 0;
+
+  /**
+   * @brief Tell if the matrix is the sum of a diagonal matrix and of a rank one matrix.
+   *
+   * Such matrices, of the form \f$P_{i,j} = \delta_{i,j} d_i + u_i w_j\f$, allow the HMM
+   * recursions to be computed in O(n) instead of O(n^2) operations per site, n being the
+   * number of hidden states. This is the case for instance when all transitions from a
+   * given state toward other states have the same probability.
+   *
+   * @return true if getDiagonalPlusRankOne can be used.
+   */
+  virtual bool isDiagonalPlusRankOne() const { return false; }
+
+  /**
+   * @brief Get the decomposition \f$P_{i,j} = \delta_{i,j} d_i + u_i w_j\f$ of a structured matrix.
+   *
+   * @param d [out] The diagonal part.
+   * @param u [out] The column vector of the rank one part.
+   * @param w [out] The row vector of the rank one part.
+   * @throw NotImplementedException if the matrix has no such structure.
+   * @see isDiagonalPlusRankOne
+   */
+  virtual void getDiagonalPlusRankOne(std::vector<double>& /* d */, std::vector<double>& /* u */, std::vector<double>& /* w */) const
+  {
+    throw NotImplementedException("HmmTransitionMatrix::getDiagonalPlusRankOne. The matrix has no diagonal plus rank one structure.");
+  }
 };
 } // end of namespace bpp
 #endif // BPP_NUMERIC_HMM_HMMTRANSITIONMATRIX_H
@@ -10,6 +10,22 @@
 using namespace bpp;
 using namespace std;
 
+namespace
+{
+// Set z[k] = exp(logv[k] - m) with m the maximum of logv, and return m.
+// Sums of probabilities can then be computed in linear space with the transition kernel,
+// instead of one logsum per term.
+double shiftedExp(const vector<double>& logv, vector<double>& z)
+{
+  double m = *max_element(logv.begin(), logv.end());
+  for (size_t k = 0; k < logv.size(); k++)
+  {
+    z[k] = exp(logv[k] - m);
+  }
+  return m;
+}
+}
+
 LogsumHmmLikelihood::LogsumHmmLikelihood(
     std::shared_ptr<HmmStateAlphabet> hiddenAlphabet,
     std::shared_ptr<HmmTransitionMatrix> transitionMatrix,
@@ -97,34 +113,23 @@ void LogsumHmmLikelihood::computeLikelihood()
 
 void LogsumHmmLikelihood::computeForward_()
 {
-  double x, a;
-  vector<double> logTrans(nbStates_ * nbStates_);
+  vector<double> x(nbStates_), z(nbStates_), logPrev(nbStates_);
 
   // Transition probabilities:
-  for (size_t i = 0; i < nbStates_; i++)
+  HmmTransitionKernel trans(*transitionMatrix_);
+
+  // Initialisation:
+  vector<double> logInit(nbStates_);
+  trans.forward(&transitionMatrix_->getEquilibriumFrequencies()[0], &x[0]);
+  for (size_t j = 0; j < nbStates_; j++)
   {
-    size_t ii = i * nbStates_;
-    for (size_t j = 0; j < nbStates_; j++)
-    {
-      logTrans[ii + j] = log(transitionMatrix_->Pij(j, i));
-    }
+    logInit[j] = log(x[j]);
   }
 
-  // Initialisation:
   const vector<double>* emissions = &(*emissionProbabilities_)(0);
-
   for (size_t j = 0; j < nbStates_; j++)
   {
-    size_t jj = j * nbStates_;
-    x = logTrans[jj] + log(transitionMatrix_->getEquilibriumFrequencies()[0]);
-
-    for (size_t k = 1; k < nbStates_; k++)
-    {
-      a = logTrans[k + jj] + log(transitionMatrix_->getEquilibriumFrequencies()[k]);
-      x = NumTools::logsum(x, a);
-    }
-
-    logLikelihood_[j] = log((*emissions)[j]) + x;
+    logLikelihood_[j] = log((*emissions)[j]) + logInit[j];
   }
 
   // Recursion:
@@ -141,16 +146,12 @@ void LogsumHmmLikelihood::computeForward_()
     emissions = &(*emissionProbabilities_)(i);
     if (i < nextBrkPt)
     {
+      logPrev.assign(logLikelihood_.begin() + static_cast<ptrdiff_t>(iip), logLikelihood_.begin() + static_cast<ptrdiff_t>(ii));
+      double m = shiftedExp(logPrev, z);
+      trans.forward(&z[0], &x[0]);
       for (size_t j = 0; j < nbStates_; j++)
       {
-        size_t jj = j * nbStates_;
-        x = logTrans[jj] + logLikelihood_[iip];
-        for (size_t k = 1; k < nbStates_; k++)
-        {
-          a = logTrans[jj + k] + logLikelihood_[iip + k];
-          x = NumTools::logsum(x, a);
-        }
-        logLikelihood_[ii + j] = log((*emissions)[j]) + x;
+        logLikelihood_[ii + j] = log((*emissions)[j]) + m + log(x[j]);
       }
     }
     else // Reset markov chain:
@@ -165,14 +166,7 @@ void LogsumHmmLikelihood::computeForward_()
 
       for (size_t j = 0; j < nbStates_; j++)
       {
-        size_t jj = j * nbStates_;
-        x = logTrans[jj] + log(transitionMatrix_->getEquilibriumFrequencies()[0]);
-        for (size_t k = 1; k < nbStates_; k++)
-        {
-          a = logTrans[jj + k] + log(transitionMatrix_->getEquilibriumFrequencies()[k]);
-          x = NumTools::logsum(x, a);
-        }
-        logLikelihood_[ii + j] = log((*emissions)[j]) + x;
+        logLikelihood_[ii + j] = log((*emissions)[j]) + logInit[j];
       }
       bpIt++;
       if (bpIt != breakPoints_.end())
@@ -213,19 +207,10 @@ void LogsumHmmLikelihood::computeBackward_() const
     }
   }
 
-  double x;
+  vector<double> x(nbStates_), z(nbStates_), logv(nbStates_);
 
   // Transition probabilities:
-  vector<double> logTrans(nbStates_ * nbStates_);
-  for (size_t i = 0; i < nbStates_; i++)
-  {
-    size_t ii = i * nbStates_;
-    for (size_t j = 0; j < nbStates_; j++)
-    {
-      logTrans[ii + j] = log(transitionMatrix_->Pij(i, j));
-    }
-  }
-
+  HmmTransitionKernel trans(*transitionMatrix_);
 
   // Initialisation:
   const vector<double>* emissions = 0;
@@ -245,15 +230,15 @@ void LogsumHmmLikelihood::computeBackward_() const
     emissions = &(*emissionProbabilities_)(i);
     if (i > nextBrkPt)
     {
+      for (size_t k = 0; k < nbStates_; k++)
+      {
+        logv[k] = log((*emissions)[k]) + backLogLikelihood_[i][k];
+      }
+      double m = shiftedExp(logv, z);
+      trans.backward(&z[0], &x[0]);
       for (size_t j = 0; j < nbStates_; j++)
       {
-        size_t jj = j * nbStates_;
-        x = log((*emissions)[0]) + logTrans[jj] + backLogLikelihood_[i][0];
-        for (size_t k = 1; k < nbStates_; k++)
-        {
-          x = NumTools::logsum(x, log((*emissions)[k]) + logTrans[jj + k] + backLogLikelihood_[i][k]);
-        }
-        backLogLikelihood_[i - 1][j] = x;
+        backLogLikelihood_[i - 1][j] = m + log(x[j]);
       }
     }
     else // Reset markov chain
@@ -390,9 +375,10 @@ void LogsumHmmLikelihood::computeDForward_() const
   partialDLogLikelihoods_.clear();
 
   vector<double> num(nbStates_), num2(nbStates_);
+  vector<double> z(nbStates_), dz(nbStates_), zSum(nbStates_), dNum(nbStates_);
 
   // Transition probabilities:
-  const ColMatrix<double> trans(transitionMatrix_->getPij());
+  HmmTransitionKernel trans(*transitionMatrix_);
 
   // Initialisation:
   const vector<double>* emissions = &(*emissionProbabilities_)(0);
@@ -422,15 +408,20 @@ void LogsumHmmLikelihood::computeDForward_() const
       num[kp] = logLikelihood_[iip + kp];
     }
 
-    num -= num[VectorTools::whichMax(num)];
+    num -= VectorTools::max(num);
 
     if (i < nextBrkPt)
     {
+      for (size_t k = 0; k < nbStates_; k++)
+      {
+        z[k] = exp(num[k]);
+        dz[k] = z[k] * dLogLikelihood_[i - 1][k];
+      }
+      trans.forward(&z[0], &zSum[0]);
+      trans.forward(&dz[0], &dNum[0]);
       for (size_t j = 0; j < nbStates_; j++)
       {
-        num2 = dLogLikelihood_[i - 1] * trans.getCol(j);
-
-        dLogLikelihood_[i][j] = (*dEmissions)[j] / (*emissions)[j] + VectorTools::sumExp(num, num2) / VectorTools::sumExp(num, trans.getCol(j));
+        dLogLikelihood_[i][j] = (*dEmissions)[j] / (*emissions)[j] + dNum[j] / zSum[j];
       }
     }
     else // Reset markov chain:
@@ -458,7 +449,7 @@ void LogsumHmmLikelihood::computeDForward_() const
     num[kp] = logLikelihood_[nbStates_ * (nbSites_ - 1) + kp];
   }
 
-  num -= num[VectorTools::whichMax(num)];
+  num -= VectorTools::max(num);
 
   partialDLogLikelihoods_.push_back(VectorTools::sumExp(num, dLogLikelihood_[nbSites_ - 1]) / VectorTools::sumExp(num));
 
@@ -497,10 +488,11 @@ void LogsumHmmLikelihood::computeD2Forward_() const
 
   partialD2LogLikelihoods_.clear();
 
-  vector<double> num(nbStates_), num2(nbStates_), num3(nbStates_);
+  vector<double> num(nbStates_), num2(nbStates_);
+  vector<double> z(nbStates_), dz(nbStates_), d2z(nbStates_), zSum(nbStates_), dNum(nbStates_), d2Num(nbStates_);
 
   // Transition probabilities:
-  const ColMatrix<double> trans(transitionMatrix_->getPij());
+  HmmTransitionKernel trans(*transitionMatrix_);
 
   // Initialisation:
   const vector<double>* emissions = &(*emissionProbabilities_)(0);
@@ -517,7 +509,6 @@ void LogsumHmmLikelihood::computeD2Forward_() const
   vector<size_t>::const_iterator bpIt = breakPoints_.begin();
   if (bpIt != breakPoints_.end())
     nextBrkPt = *bpIt;
-  partialDLogLikelihoods_.clear();
 
   for (size_t i = 1; i < nbSites_; i++)
   {
@@ -532,19 +523,22 @@ void LogsumHmmLikelihood::computeD2Forward_() const
       num[kp] = logLikelihood_[iip + kp];
     }
 
-    num -= num[VectorTools::whichMax(num)];
+    num -= VectorTools::max(num);
 
     if (i < nextBrkPt)
     {
+      for (size_t k = 0; k < nbStates_; k++)
+      {
+        z[k] = exp(num[k]);
+        dz[k] = z[k] * dLogLikelihood_[i - 1][k];
+        d2z[k] = z[k] * (dLogLikelihood_[i - 1][k] * dLogLikelihood_[i - 1][k] + d2LogLikelihood_[i - 1][k]);
+      }
+      trans.forward(&z[0], &zSum[0]);
+      trans.forward(&dz[0], &dNum[0]);
+      trans.forward(&d2z[0], &d2Num[0]);
       for (size_t j = 0; j < nbStates_; j++)
       {
-        double den = VectorTools::sumExp(num, trans.getCol(j));
-
-        num2 = dLogLikelihood_[i - 1] * trans.getCol(j);
-
-        num3 = (dLogLikelihood_[i - 1] * dLogLikelihood_[i - 1] + d2LogLikelihood_[i - 1]) * trans.getCol(j);
-
-        d2LogLikelihood_[i][j] =  VectorTools::sumExp(num, num3) / den - pow(VectorTools::sumExp(num, num2) / den, 2);
+        d2LogLikelihood_[i][j] = (*d2Emissions)[j] / (*emissions)[j] - pow((*dEmissions)[j] / (*emissions)[j], 2) + d2Num[j] / zSum[j] - pow(dNum[j] / zSum[j], 2);
       }
     }
     else // Reset markov chain:
@@ -577,7 +571,7 @@ void LogsumHmmLikelihood::computeD2Forward_() const
     num[kp] = logLikelihood_[nbStates_ * (nbSites_ - 1) + kp];
   }
 
-  num -= num[VectorTools::whichMax(num)];
+  num -= VectorTools::max(num);
 
   double den = VectorTools::sumExp(num);
 
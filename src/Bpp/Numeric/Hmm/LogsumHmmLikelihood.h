@@ -10,6 +10,7 @@
 #include "../Matrix/Matrix.h"
 #include "../NumTools.h"
 #include "HmmLikelihood.h"
+#include "HmmTransitionKernel.h"
 
 // From the STL:
 #include <vector>
@@ -187,6 +188,11 @@ public:
     setParametersValues(pl);
   }
 
+  void setBoundParameters(const std::vector<size_t>& slots, const double* values, const std::vector<bool>* changed = nullptr) override
+  {
+    matchBoundParametersValues(slots, values, changed);
+  }
+
   double getValue() const override { return -logLik_; }
 
   double getLogLikelihood() const override { return logLik_; }
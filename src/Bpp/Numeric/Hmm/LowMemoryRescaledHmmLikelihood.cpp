@@ -15,7 +15,8 @@ LowMemoryRescaledHmmLikelihood::LowMemoryRescaledHmmLikelihood(
     std::shared_ptr<HmmTransitionMatrix> transitionMatrix,
     std::shared_ptr<HmmEmissionProbabilities> emissionProbabilities,
     const std::string& prefix,
-    size_t maxSize) :
+    size_t maxSize,
+    size_t checkpointInterval) :
   AbstractHmmLikelihood(),
   AbstractParametrizable(prefix),
   hiddenAlphabet_(hiddenAlphabet),
@@ -26,6 +27,12 @@ LowMemoryRescaledHmmLikelihood::LowMemoryRescaledHmmLikelihood(
   logLik_(),
   maxSize_(maxSize),
   breakPoints_(),
+  segmentStarts_(),
+  checkpointInterval_(checkpointInterval),
+  forwardCheckpoints_(),
+  scaleCheckpoints_(),
+  backwardCheckpoints_(),
+  backwardCheckpointsUpToDate_(false),
   nbStates_(),
   nbSites_()
 {
@@ -52,6 +59,7 @@ LowMemoryRescaledHmmLikelihood::LowMemoryRescaledHmmLikelihood(
   likelihood2_.resize(nbStates_);
 
   // Compute:
+  computeSegments_();
   computeForward_();
 }
 
@@ -66,6 +74,9 @@ void LowMemoryRescaledHmmLikelihood::setNamespace(const std::string& nameSpace)
 
 void LowMemoryRescaledHmmLikelihood::fireParameterChanged(const ParameterList& pl)
 {
+  dVariable_ = "";
+  d2Variable_ = "";
+
   bool alphabetChanged    = hiddenAlphabet_->matchParametersValues(pl);
   bool transitionsChanged = transitionMatrix_->matchParametersValues(pl);
   bool emissionChanged    = emissionProbabilities_->matchParametersValues(pl);
@@ -82,149 +93,441 @@ void LowMemoryRescaledHmmLikelihood::fireParameterChanged(const ParameterList& p
 
 /***************************************************************************************************************************/
 
-void LowMemoryRescaledHmmLikelihood::computeForward_()
+void LowMemoryRescaledHmmLikelihood::computeSegments_()
 {
-  double x;
-  vector<double> tmp(nbStates_);
-  vector<double> lScales(min(maxSize_, nbSites_));
-  vector<double> trans(nbStates_ * nbStates_);
+  // Same rule as a sequential recursion resetting the chain at the first site
+  // greater or equal to each breakpoint in turn.
+  segmentStarts_.clear();
+  if (nbSites_ == 0)
+    return;
+  segmentStarts_.push_back(0);
+  size_t pos = 1;
+  for (size_t bp : breakPoints_)
+  {
+    size_t start = max(bp, pos);
+    if (start >= nbSites_)
+      break;
+    segmentStarts_.push_back(start);
+    pos = start + 1;
+  }
+}
 
-  // Transition probabilities:
-  for (size_t i = 0; i < nbStates_; i++)
+double LowMemoryRescaledHmmLikelihood::sortedSum_(std::vector<double>& values, size_t size)
+{
+  greater<double> cmp;
+  sort(values.begin(), values.begin() + static_cast<ptrdiff_t>(size), cmp);
+  double sum = 0;
+  for (size_t i = 0; i < size; ++i)
   {
-    size_t ii = i * nbStates_;
-    for (size_t j = 0; j < nbStates_; j++)
-    {
-      trans[ii + j] = transitionMatrix_->Pij(j, i);
-    }
+    sum += values[i];
   }
+  return sum;
+}
+
+/***************************************************************************************************************************/
+
+double LowMemoryRescaledHmmLikelihood::computeForwardSite_(
+    size_t site,
+    bool reset,
+    const HmmTransitionKernel& trans,
+    const std::vector<double>& init,
+    const double* previous,
+    double* current,
+    std::vector<double>& x,
+    std::vector<double>& tmp) const
+{
+  if (reset)
+    x = init;
+  else
+    trans.forward(previous, &x[0]);
 
-  // Initialisation:
   double scale = 0;
-  const vector<double>* emissions = &(*emissionProbabilities_)(0);
+  const vector<double>& emissions = (*emissionProbabilities_)(site);
+  bool negative = false;
   for (size_t j = 0; j < nbStates_; j++)
   {
-    size_t jj = j * nbStates_;
-    x = 0;
-    for (size_t k = 0; k < nbStates_; k++)
+    tmp[j] = emissions[j] * x[j];
+    negative |= tmp[j] < 0;
+    scale += tmp[j];
+  }
+  if (negative)
+  {
+    // Negative values are rounding errors, set to zero:
+    scale = 0;
+    for (size_t j = 0; j < nbStates_; j++)
     {
-      x += trans[k + jj] * transitionMatrix_->getEquilibriumFrequencies()[k];
+      tmp[j] = max(tmp[j], 0.);
+      scale += tmp[j];
     }
-    tmp[j] = (*emissions)[j] * x;
-    scale += tmp[j];
   }
+
   for (size_t j = 0; j < nbStates_; j++)
   {
-    likelihood1_[j] = tmp[j] / scale;
+    if (scale > 0)
+      current[j] = tmp[j] / scale;
+    else
+      current[j] = 0;
   }
-  lScales[0] = log(scale);
+  return scale;
+}
 
-  vector<double>* previousLikelihood = &likelihood2_, * currentLikelihood = &likelihood1_, * tmpLikelihood;
+void LowMemoryRescaledHmmLikelihood::computeForward_()
+{
+  vector<double> tmp(nbStates_), x(nbStates_);
+  vector<double> lScales(min(maxSize_, nbSites_));
 
-  // Recursion:
-  size_t nextBrkPt = nbSites_; // next break point
-  vector<size_t>::const_iterator bpIt = breakPoints_.begin();
-  if (bpIt != breakPoints_.end())
-    nextBrkPt = *bpIt;
+  // Transition probabilities:
+  HmmTransitionKernel trans(*transitionMatrix_);
+
+  // Initialisation:
+  vector<double> init(nbStates_);
+  trans.forward(&transitionMatrix_->getEquilibriumFrequencies()[0], &init[0]);
+
+  size_t nbBlocks = 0;
+  if (checkpointInterval_ > 0)
+  {
+    nbBlocks = getNumberOfBlocks_();
+    forwardCheckpoints_.resize(nbBlocks * nbStates_);
+    scaleCheckpoints_.resize(nbBlocks);
+  }
+  else
+  {
+    forwardCheckpoints_.clear();
+    scaleCheckpoints_.clear();
+  }
+  backwardCheckpoints_.clear();
+  backwardCheckpointsUpToDate_ = false;
 
-  double a;
+  vector<double>* previousLikelihood = &likelihood2_, * currentLikelihood = &likelihood1_;
+
+  // Recursion:
   logLik_ = 0;
   size_t offset = 0;
-  greater<double> cmp;
-  for (size_t i = 1; i < nbSites_; i++)
+  size_t nextSegment = 1; // index of the next segment start
+  for (size_t i = 0; i < nbSites_; i++)
   {
-    // Swap pointers:
-    tmpLikelihood = previousLikelihood;
-    previousLikelihood = currentLikelihood;
-    currentLikelihood = tmpLikelihood;
+    swap(previousLikelihood, currentLikelihood);
 
-    scale = 0;
-    emissions = &(*emissionProbabilities_)(i);
-    if (i < nextBrkPt)
+    bool reset = (i == 0);
+    if (nextSegment < segmentStarts_.size() && i == segmentStarts_[nextSegment])
     {
-      for (size_t j = 0; j < nbStates_; j++)
+      // Reset markov chain:
+      reset = true;
+      nextSegment++;
+    }
+    double scale = computeForwardSite_(i, reset, trans, init, &(*previousLikelihood)[0], &(*currentLikelihood)[0], x, tmp);
+
+    if (checkpointInterval_ > 0 && i % checkpointInterval_ == 0)
+    {
+      size_t b = i / checkpointInterval_;
+      copy(currentLikelihood->begin(), currentLikelihood->end(), forwardCheckpoints_.begin() + static_cast<ptrdiff_t>(b * nbStates_));
+      scaleCheckpoints_[b] = scale;
+    }
+
+    lScales[i - offset] = log(scale);
+
+    if (i - offset == maxSize_ - 1)
+    {
+      // We make partial calculations and reset the arrays:
+      logLik_ += sortedSum_(lScales, maxSize_);
+      offset += maxSize_;
+    }
+  }
+  logLik_ += sortedSum_(lScales, nbSites_ - offset);
+}
+
+/***************************************************************************************************************************/
+
+void LowMemoryRescaledHmmLikelihood::computeForwardBlock_(
+    size_t block,
+    const HmmTransitionKernel& trans,
+    const std::vector<double>& init,
+    std::vector<double>& likelihood,
+    std::vector<double>& scales) const
+{
+  size_t begin = block * checkpointInterval_;
+  size_t end = min(begin + checkpointInterval_, nbSites_);
+  vector<double> tmp(nbStates_), x(nbStates_);
+
+  likelihood.resize((end - begin) * nbStates_);
+  scales.resize(end - begin);
+  copy(forwardCheckpoints_.begin() + static_cast<ptrdiff_t>(block * nbStates_),
+       forwardCheckpoints_.begin() + static_cast<ptrdiff_t>((block + 1) * nbStates_),
+       likelihood.begin());
+  scales[0] = scaleCheckpoints_[block];
+  for (size_t i = begin + 1; i < end; i++)
+  {
+    size_t ii = (i - begin) * nbStates_;
+    scales[i - begin] = computeForwardSite_(i, isSegmentStart_(i), trans, init, &likelihood[ii - nbStates_], &likelihood[ii], x, tmp);
+  }
+}
+
+void LowMemoryRescaledHmmLikelihood::computeBackwardSite_(
+    size_t site,
+    const HmmTransitionKernel& trans,
+    double scale,
+    const double* back,
+    double* previousBack,
+    std::vector<double>& tmp) const
+{
+  const vector<double>& emissions = (*emissionProbabilities_)(site);
+  for (size_t k = 0; k < nbStates_; k++)
+  {
+    tmp[k] = emissions[k] * back[k];
+  }
+  trans.backward(&tmp[0], previousBack);
+  for (size_t j = 0; j < nbStates_; j++)
+  {
+    previousBack[j] /= scale;
+  }
+}
+
+void LowMemoryRescaledHmmLikelihood::computeBackward_(std::vector<std::vector<double>>* probs, size_t offset) const
+{
+  if (checkpointInterval_ == 0)
+    throw NotImplementedException("LowMemoryRescaledHmmLikelihood::computeBackward_. Posterior probabilities require a checkpoint interval, see setCheckpointInterval.");
+
+  // Transition probabilities:
+  HmmTransitionKernel trans(*transitionMatrix_);
+  vector<double> init(nbStates_);
+  trans.forward(&transitionMatrix_->getEquilibriumFrequencies()[0], &init[0]);
+
+  size_t nbBlocks = getNumberOfBlocks_();
+  backwardCheckpoints_.resize(nbBlocks * nbStates_);
+
+  vector<double> likelihood, scales, tmp(nbStates_);
+  vector<double> back(nbStates_, 1.), previousBack(nbStates_);
+  for (size_t b = nbBlocks; b > 0; b--)
+  {
+    size_t begin = (b - 1) * checkpointInterval_;
+    size_t end = min(begin + checkpointInterval_, nbSites_);
+    copy(back.begin(), back.end(), backwardCheckpoints_.begin() + static_cast<ptrdiff_t>((b - 1) * nbStates_));
+    computeForwardBlock_(b - 1, trans, init, likelihood, scales);
+
+    for (size_t i = end; i > begin; i--)
+    {
+      size_t site = i - 1;
+      if (probs)
       {
-        size_t jj = j * nbStates_;
-        x = 0;
-        for (size_t k = 0; k < nbStates_; k++)
+        vector<double>& p = (*probs)[offset + site];
+        for (size_t j = 0; j < nbStates_; j++)
         {
-          a = trans[jj + k] * (*previousLikelihood)[k];
-          if (a < 0)
-          {
-            // *ApplicationTools::warning << "Negative value for likelihood at " << i << ", state " << j << ": " << _likelihood[i-1][k] << ", Pij = " << _hiddenModel->Pij(k, j) << endl;
-            a = 0;
-          }
-          x += a;
+          p[j] = likelihood[(site - begin) * nbStates_ + j] * back[j];
         }
-        tmp[j] = (*emissions)[j] * x;
-        if (tmp[j] < 0)
-        {
-          // *ApplicationTools::warning << "Negative emission probability at " << i << ", state " << j << ": " << _emissions[i][j] << endl;
-          tmp[j] = 0;
-        }
-        scale += tmp[j];
       }
+      if (site == 0)
+        break;
+      if (isSegmentStart_(site))
+        fill(previousBack.begin(), previousBack.end(), 1.);
+      else
+        computeBackwardSite_(site, trans, scales[site - begin], &back[0], &previousBack[0], tmp);
+      swap(back, previousBack);
     }
-    else // Reset markov chain:
+  }
+  backwardCheckpointsUpToDate_ = true;
+}
+
+/***************************************************************************************************************************/
+
+double LowMemoryRescaledHmmLikelihood::getLikelihoodForASite(size_t site) const
+{
+  Vdouble probs = getHiddenStatesPosteriorProbabilitiesForASite(site);
+  double x = 0;
+  for (size_t i = 0; i < nbStates_; i++)
+  {
+    x += probs[i] * (*emissionProbabilities_)(site, i);
+  }
+
+  return x;
+}
+
+Vdouble LowMemoryRescaledHmmLikelihood::getLikelihoodForEachSite() const
+{
+  std::vector<std::vector<double>> vv;
+  getHiddenStatesPosteriorProbabilities(vv);
+
+  Vdouble ret(nbSites_);
+  for (size_t i = 0; i < nbSites_; i++)
+  {
+    ret[i] = 0;
+    for (size_t j = 0; j < nbStates_; j++)
     {
+      ret[i] += vv[i][j] * (*emissionProbabilities_)(i, j);
+    }
+  }
+
+  return ret;
+}
+
+/***************************************************************************************************************************/
+
+Vdouble LowMemoryRescaledHmmLikelihood::getHiddenStatesPosteriorProbabilitiesForASite(size_t site) const
+{
+  if (!backwardCheckpointsUpToDate_)
+    computeBackward_(nullptr, 0);
+
+  // Recompute the block of the site, and go backward from the end of the block:
+  HmmTransitionKernel trans(*transitionMatrix_);
+  vector<double> init(nbStates_);
+  trans.forward(&transitionMatrix_->getEquilibriumFrequencies()[0], &init[0]);
+
+  size_t b = site / checkpointInterval_;
+  size_t begin = b * checkpointInterval_;
+  size_t end = min(begin + checkpointInterval_, nbSites_);
+  vector<double> likelihood, scales, tmp(nbStates_);
+  computeForwardBlock_(b, trans, init, likelihood, scales);
+
+  vector<double> back(backwardCheckpoints_.begin() + static_cast<ptrdiff_t>(b * nbStates_),
+                      backwardCheckpoints_.begin() + static_cast<ptrdiff_t>((b + 1) * nbStates_));
+  vector<double> previousBack(nbStates_);
+  for (size_t i = end - 1; i > site; i--)
+  {
+    if (isSegmentStart_(i))
+      fill(previousBack.begin(), previousBack.end(), 1.);
+    else
+      computeBackwardSite_(i, trans, scales[i - begin], &back[0], &previousBack[0], tmp);
+    swap(back, previousBack);
+  }
+
+  Vdouble probs(nbStates_);
+  for (size_t j = 0; j < nbStates_; j++)
+  {
+    probs[j] = likelihood[(site - begin) * nbStates_ + j] * back[j];
+  }
+
+  return probs;
+}
+
+void LowMemoryRescaledHmmLikelihood::getHiddenStatesPosteriorProbabilities(std::vector<std::vector<double>>& probs, bool append) const
+{
+  if (checkpointInterval_ == 0)
+    throw NotImplementedException("LowMemoryRescaledHmmLikelihood::getHiddenStatesPosteriorProbabilities. Posterior probabilities require a checkpoint interval, see setCheckpointInterval.");
+
+  size_t offset = append ? probs.size() : 0;
+  probs.resize(offset + nbSites_);
+  for (size_t i = 0; i < nbSites_; i++)
+  {
+    probs[offset + i].resize(nbStates_);
+  }
+
+  computeBackward_(&probs, offset);
+}
+
+/***************************************************************************************************************************/
+
+void LowMemoryRescaledHmmLikelihood::computeDLikelihood_() const
+{
+  computeDForward_(1);
+}
+
+void LowMemoryRescaledHmmLikelihood::computeD2Likelihood_() const
+{
+  // The second order recursion uses the first order one:
+  if (dVariable_ != d2Variable_)
+  {
+    dVariable_ = d2Variable_;
+    emissionProbabilities_->computeDEmissionProbabilities(dVariable_);
+  }
+  computeDForward_(2);
+}
+
+void LowMemoryRescaledHmmLikelihood::computeDForward_(unsigned int order) const
+{
+  vector<double> tmp(nbStates_), dTmp(nbStates_), d2Tmp(nbStates_);
+  vector<double> x(nbStates_), dx(nbStates_), d2x(nbStates_);
+  size_t bufferSize = min(maxSize_, nbSites_);
+  vector<double> dLScales(bufferSize), d2LScales(order > 1 ? bufferSize : 0);
+
+  // Transition probabilities:
+  HmmTransitionKernel trans(*transitionMatrix_);
+  vector<double> init(nbStates_);
+  trans.forward(&transitionMatrix_->getEquilibriumFrequencies()[0], &init[0]);
+
+  // The forward values are recomputed along the derivatives, for the previous and current sites:
+  vector<double> likelihood(nbStates_), previousLikelihood(nbStates_);
+  vector<double> dLikelihood(nbStates_), previousDLikelihood(nbStates_);
+  vector<double> d2Likelihood(order > 1 ? nbStates_ : 0), previousD2Likelihood(order > 1 ? nbStates_ : 0);
+
+  double dLogLik = 0, d2LogLik = 0;
+  size_t offset = 0;
+  size_t nextSegment = 1;
+  for (size_t i = 0; i < nbSites_; i++)
+  {
+    swap(likelihood, previousLikelihood);
+    swap(dLikelihood, previousDLikelihood);
+    swap(d2Likelihood, previousD2Likelihood);
+
+    bool reset = (i == 0);
+    if (nextSegment < segmentStarts_.size() && i == segmentStarts_[nextSegment])
+    {
+      reset = true;
+      nextSegment++;
+    }
+
+    const vector<double>& emissions = (*emissionProbabilities_)(i);
+    const vector<double>& dEmissions = emissionProbabilities_->getDEmissionProbabilities(i);
+    if (reset)
+    {
+      x = init;
+      fill(dx.begin(), dx.end(), 0.);
+      fill(d2x.begin(), d2x.end(), 0.);
+    }
+    else
+    {
+      trans.forward(&previousLikelihood[0], &x[0]);
+      trans.forward(&previousDLikelihood[0], &dx[0]);
+      if (order > 1)
+        trans.forward(&previousD2Likelihood[0], &d2x[0]);
+    }
+
+    double scale = 0, dScale = 0, d2Scale = 0;
+    for (size_t j = 0; j < nbStates_; j++)
+    {
+      tmp[j] = emissions[j] * x[j];
+      dTmp[j] = dEmissions[j] * x[j] + emissions[j] * dx[j];
+      scale += tmp[j];
+      dScale += dTmp[j];
+    }
+    if (order > 1)
+    {
+      const vector<double>& d2Emissions = emissionProbabilities_->getD2EmissionProbabilities(i);
       for (size_t j = 0; j < nbStates_; j++)
       {
-        size_t jj = j * nbStates_;
-        x = 0;
-        for (size_t k = 0; k < nbStates_; k++)
-        {
-          a = trans[jj + k] * transitionMatrix_->getEquilibriumFrequencies()[k];
-          if (a < 0)
-          {
-            // *ApplicationTools::warning << "Negative value for likelihood at " << i << ", state " << j << ": " << _likelihood[i-1][k] << ", Pij = " << _hiddenModel->Pij(k, j) << endl;
-            a = 0;
-          }
-          x += a;
-        }
-        tmp[j] = (*emissions)[j] * x;
-        if (tmp[j] < 0)
-        {
-          // *ApplicationTools::warning << "Negative emission probability at " << i << ", state " << j << ": " << _emissions[i][j] << endl;
-          tmp[j] = 0;
-        }
-        scale += tmp[j];
+        d2Tmp[j] = d2Emissions[j] * x[j] + 2 * dEmissions[j] * dx[j] + emissions[j] * d2x[j];
+        d2Scale += d2Tmp[j];
       }
-      bpIt++;
-      if (bpIt != breakPoints_.end())
-        nextBrkPt = *bpIt;
-      else
-        nextBrkPt = nbSites_;
     }
 
     for (size_t j = 0; j < nbStates_; j++)
     {
-      if (scale > 0)
-        (*currentLikelihood)[j] = tmp[j] / scale;
-      else
-        (*currentLikelihood)[j] = 0;
+      likelihood[j] = tmp[j] / scale;
+      dLikelihood[j] = (dTmp[j] * scale - tmp[j] * dScale) / pow(scale, 2);
     }
-    lScales[i - offset] = log(scale);
+    if (order > 1)
+    {
+      for (size_t j = 0; j < nbStates_; j++)
+      {
+        d2Likelihood[j] = d2Tmp[j] / scale - (d2Scale * tmp[j] + 2 * dScale * dTmp[j]) / pow(scale, 2)
+            +  2 * pow(dScale, 2) * tmp[j] / pow(scale, 3);
+      }
+      d2LScales[i - offset] = d2Scale / scale - pow(dScale / scale, 2);
+    }
+    dLScales[i - offset] = dScale / scale;
 
     if (i - offset == maxSize_ - 1)
     {
       // We make partial calculations and reset the arrays:
-      double partialLogLik = 0;
-      sort(lScales.begin(), lScales.end(), cmp);
-      for (size_t j = 0; j < maxSize_; ++j)
-      {
-        partialLogLik += lScales[j];
-      }
-      logLik_ += partialLogLik;
+      dLogLik += sortedSum_(dLScales, maxSize_);
+      if (order > 1)
+        d2LogLik += sortedSum_(d2LScales, maxSize_);
       offset += maxSize_;
     }
   }
-  sort(lScales.begin(), lScales.begin() + static_cast<ptrdiff_t>(nbSites_ - offset), cmp);
-  double partialLogLik = 0;
-  for (size_t i = 0; i < nbSites_ - offset; ++i)
+  dLogLik += sortedSum_(dLScales, nbSites_ - offset);
+  dLogLik_ = dLogLik;
+  if (order > 1)
   {
-    partialLogLik += lScales[i];
+    d2LogLik += sortedSum_(d2LScales, nbSites_ - offset);
+    d2LogLik_ = d2LogLik;
   }
-  logLik_ += partialLogLik;
 }
-
-/***************************************************************************************************************************/
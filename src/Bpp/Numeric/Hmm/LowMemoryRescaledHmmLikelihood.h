@@ -9,8 +9,10 @@
 #include "../AbstractParametrizable.h"
 #include "../Matrix/Matrix.h"
 #include "HmmLikelihood.h"
+#include "HmmTransitionKernel.h"
 
 // From the STL:
+#include <algorithm>
 #include <vector>
 #include <memory>
 
@@ -23,10 +25,15 @@ namespace bpp
  * but does not store the full likelihood array. The benefit of it is a significantly reduced
  * memory usage, allowing to compute likelihood for very large data sets.
  *
- * The drawback is that this class can't compute posterior
- * probabilities, neither derivatives of the likelihoods, and can
- * hence only be used to compute likelihoods.
+ * Derivatives of the likelihood are computed with a forward recursion which only keeps the
+ * current site, and have the same memory usage.
  *
+ * By default, posterior probabilities can't be computed. They become available by setting a
+ * checkpoint interval k (see setCheckpointInterval): the forward values of one site every k
+ * sites are then stored during the forward recursion. The backward recursion processes the
+ * blocks of k sites from the last to the first, recomputing the forward values of each block
+ * from its checkpoint. Memory usage is then O((n / k + k) . nbStates) for n sites, which is
+ * minimal for k close to sqrt(n), at the cost of a second forward recursion.
  */
 
 class LowMemoryRescaledHmmLikelihood :
@@ -53,6 +60,30 @@ private:
 
   std::vector<size_t> breakPoints_;
 
+  /**
+   * @brief First site of each independent segment, as defined by the breakpoints.
+   */
+  std::vector<size_t> segmentStarts_;
+
+  /**
+   * @brief Distance between two checkpoints, or 0 if checkpoints are disabled.
+   */
+  size_t checkpointInterval_;
+
+  /**
+   * @brief Forward values and scales of the first site of each block.
+   *
+   * forwardCheckpoints_[b * nbStates_ + j] corresponds to the forward value of state j at site b * checkpointInterval_.
+   */
+  std::vector<double> forwardCheckpoints_;
+  std::vector<double> scaleCheckpoints_;
+
+  /**
+   * @brief Backward values of the last site of each block, filled by the backward recursion.
+   */
+  mutable std::vector<double> backwardCheckpoints_;
+  mutable bool backwardCheckpointsUpToDate_;
+
   size_t nbStates_, nbSites_;
 
 public:
@@ -70,13 +101,15 @@ public:
    * @param prefix A namespace for parameter names.
    * @param maxSize the maximum size of the vector of scales. If this size is exceeded, then a temporary likelihood computation is made and stored, and the vector is reset.
    * the size of the vector specify the memory usage of the class. A two low value can lead to numerical precision errors.
+   * @param checkpointInterval The distance between two checkpoints, or 0 to disable posterior probabilities (see setCheckpointInterval).
    */
   LowMemoryRescaledHmmLikelihood(
       std::shared_ptr<HmmStateAlphabet> hiddenAlphabet,
       std::shared_ptr<HmmTransitionMatrix> transitionMatrix,
       std::shared_ptr<HmmEmissionProbabilities> emissionProbabilities,
       const std::string& prefix,
-      size_t maxSize = 1000000);
+      size_t maxSize = 1000000,
+      size_t checkpointInterval = 0);
 
   LowMemoryRescaledHmmLikelihood(const LowMemoryRescaledHmmLikelihood& lik) :
     AbstractHmmLikelihood(lik),
@@ -89,6 +122,12 @@ public:
     logLik_(lik.logLik_),
     maxSize_(lik.maxSize_),
     breakPoints_(lik.breakPoints_),
+    segmentStarts_(lik.segmentStarts_),
+    checkpointInterval_(lik.checkpointInterval_),
+    forwardCheckpoints_(lik.forwardCheckpoints_),
+    scaleCheckpoints_(lik.scaleCheckpoints_),
+    backwardCheckpoints_(lik.backwardCheckpoints_),
+    backwardCheckpointsUpToDate_(lik.backwardCheckpointsUpToDate_),
     nbStates_(lik.nbStates_),
     nbSites_(lik.nbSites_)
   {
@@ -109,6 +148,12 @@ public:
     logLik_                = lik.logLik_;
     maxSize_               = lik.maxSize_;
     breakPoints_           = lik.breakPoints_;
+    segmentStarts_         = lik.segmentStarts_;
+    checkpointInterval_    = lik.checkpointInterval_;
+    forwardCheckpoints_    = lik.forwardCheckpoints_;
+    scaleCheckpoints_      = lik.scaleCheckpoints_;
+    backwardCheckpoints_   = lik.backwardCheckpoints_;
+    backwardCheckpointsUpToDate_ = lik.backwardCheckpointsUpToDate_;
     nbStates_              = lik.nbStates_;
     nbSites_               = lik.nbSites_;
 
@@ -144,16 +189,37 @@ public:
   void setBreakPoints(const std::vector<size_t>& breakPoints) override
   {
     breakPoints_ = breakPoints;
+    computeSegments_();
     computeForward_();
   }
 
   const std::vector<size_t>& getBreakPoints() const override { return breakPoints_; }
 
+  /**
+   * @brief Set the distance between two checkpoints of the forward recursion.
+   *
+   * @param interval The number of sites between two checkpoints, or 0 to disable checkpoints
+   * and posterior probabilities. A value close to the square root of the number of sites
+   * minimizes memory usage.
+   */
+  void setCheckpointInterval(size_t interval)
+  {
+    checkpointInterval_ = interval;
+    computeForward_();
+  }
+
+  size_t getCheckpointInterval() const { return checkpointInterval_; }
+
   void setParameters(const ParameterList& pl) override
   {
     setParametersValues(pl);
   }
 
+  void setBoundParameters(const std::vector<size_t>& slots, const double* values, const std::vector<bool>* changed = nullptr) override
+  {
+    matchBoundParametersValues(slots, values, changed);
+  }
+
   double getValue() const override { return -logLik_; }
 
   double getLogLikelihood() const override { return logLik_; }
@@ -162,40 +228,96 @@ public:
 
   void fireParameterChanged(const ParameterList& pl) override;
 
-  double getLikelihoodForASite(size_t site) const override
-  {
-    throw (NotImplementedException("LowMemoryRescaledHmmLikelihood::getLikelihoodForASite. This class can't compute posterior probabilities, use RescaledHmmLikelihood instead."));
-  }
+  double getLikelihoodForASite(size_t site) const override;
 
+  Vdouble getLikelihoodForEachSite() const override;
 
-  Vdouble getLikelihoodForEachSite() const override
-  {
-    throw (NotImplementedException("LowMemoryRescaledHmmLikelihood::getLikelihoodForEachSite. This class can't compute posterior probabilities, use RescaledHmmLikelihood instead."));
-  }
+  Vdouble getHiddenStatesPosteriorProbabilitiesForASite(size_t site) const override;
 
-  Vdouble getHiddenStatesPosteriorProbabilitiesForASite(size_t site) const override
-  {
-    throw (NotImplementedException("LowMemoryRescaledHmmLikelihood::getHiddenStatesPosteriorProbabilitiesForASite. This class can't compute posterior probabilities, use RescaledHmmLikelihood instead."));
-  }
-
-  void getHiddenStatesPosteriorProbabilities(std::vector<std::vector<double>>& probs, bool append = false) const override
-  {
-    throw (NotImplementedException("LowMemoryRescaledHmmLikelihood::getHiddenStatesPosteriorProbabilities. This class can't compute posterior probabilities, use RescaledHmmLikelihood instead."));
-  }
+  void getHiddenStatesPosteriorProbabilities(std::vector<std::vector<double>>& probs, bool append = false) const override;
 
 protected:
   void computeForward_();
 
-  void computeDLikelihood_() const override
+  void computeSegments_();
+
+  /**
+   * @brief Compute the rescaled forward values of a site.
+   *
+   * @param site The position of the site.
+   * @param reset True if the site is the first of a segment.
+   * @param trans The transition probabilities.
+   * @param init The probabilities of the first hidden state of a segment.
+   * @param previous [in] The forward values of the previous site, unused if reset is true.
+   * @param current [out] The forward values of the site.
+   * @param x, tmp Work vectors of nbStates_ elements.
+   * @return The scale of the site.
+   */
+  double computeForwardSite_(size_t site, bool reset, const HmmTransitionKernel& trans, const std::vector<double>& init,
+                             const double* previous, double* current, std::vector<double>& x, std::vector<double>& tmp) const;
+
+  /**
+   * @brief Recompute the forward values and scales of all sites of a block, from its checkpoint.
+   *
+   * @param block The index of the block.
+   * @param trans The transition probabilities.
+   * @param init The probabilities of the first hidden state of a segment.
+   * @param likelihood [out] The forward values, site after site.
+   * @param scales [out] The scales of each site.
+   */
+  void computeForwardBlock_(size_t block, const HmmTransitionKernel& trans, const std::vector<double>& init,
+                            std::vector<double>& likelihood, std::vector<double>& scales) const;
+
+  /**
+   * @brief Compute the backward values of the previous site from the ones of a site.
+   *
+   * @param site The position of the site, which must not be the first of a segment.
+   * @param trans The transition probabilities.
+   * @param scale The scale of the site.
+   * @param back [in] The backward values of the site.
+   * @param previousBack [out] The backward values of site - 1.
+   * @param tmp A work vector of nbStates_ elements.
+   */
+  void computeBackwardSite_(size_t site, const HmmTransitionKernel& trans, double scale,
+                            const double* back, double* previousBack, std::vector<double>& tmp) const;
+
+  /**
+   * @brief Run the backward recursion block by block, and store the backward checkpoints.
+   *
+   * @param probs If not null, the posterior probabilities of site i are stored in (*probs)[offset + i].
+   * @param offset See probs.
+   */
+  void computeBackward_(std::vector<std::vector<double>>* probs, size_t offset) const;
+
+  /**
+   * @brief Sum the first size values in decreasing order.
+   */
+  static double sortedSum_(std::vector<double>& values, size_t size);
+
+  /**
+   * @return True if the given site is the first of a segment.
+   */
+  bool isSegmentStart_(size_t site) const
   {
-    throw (NotImplementedException("LowMemoryRescaledHmmLikelihood::computeDLikelihood_. Use RescaledHmmLikelihood instead."));
+    return std::binary_search(segmentStarts_.begin(), segmentStarts_.end(), site);
   }
 
-  void computeD2Likelihood_() const override
+  size_t getNumberOfBlocks_() const
   {
-    throw (NotImplementedException("LowMemoryRescaledHmmLikelihood::computeD2Likelihood_. Use RescaledHmmLikelihood instead."));
+    return (nbSites_ + checkpointInterval_ - 1) / checkpointInterval_;
   }
 
+  void computeDLikelihood_() const override;
+
+  void computeD2Likelihood_() const override;
+
+  /**
+   * @brief Forward recursion of the log-likelihood derivatives.
+   *
+   * @param order 1 for first order derivatives only, 2 for first and second order derivatives.
+   */
+  void computeDForward_(unsigned int order) const;
+
   double getDLogLikelihoodForASite(size_t site) const override
   {
     throw (NotImplementedException("LowMemoryRescaledHmmLikelihood::getDLogLikelihoodForASite. Use RescaledHmmLikelihood instead."));
@@ -31,6 +31,8 @@ RescaledHmmLikelihood::RescaledHmmLikelihood(
   d2Scales_(),
   logLik_(),
   breakPoints_(),
+  segmentStarts_(),
+  threadPool_(),
   nbStates_(),
   nbSites_()
 {
@@ -58,6 +60,7 @@ RescaledHmmLikelihood::RescaledHmmLikelihood(
   scales_.resize(nbSites_);
 
   // Compute:
+  computeSegments_();
   computeForward_();
 }
 
@@ -72,6 +75,9 @@ void RescaledHmmLikelihood::setNamespace(const std::string& nameSpace)
 
 void RescaledHmmLikelihood::fireParameterChanged(const ParameterList& pl)
 {
+  dVariable_ = "";
+  d2Variable_ = "";
+
   bool alphabetChanged    = hiddenAlphabet_->matchParametersValues(pl);
   bool transitionsChanged = transitionMatrix_->matchParametersValues(pl);
   bool emissionChanged    = emissionProbabilities_->matchParametersValues(pl);
@@ -89,117 +95,135 @@ void RescaledHmmLikelihood::fireParameterChanged(const ParameterList& pl)
 
 /***************************************************************************************************************************/
 
-void RescaledHmmLikelihood::computeForward_()
+void RescaledHmmLikelihood::computeSegments_()
 {
-  double x;
-  vector<double> tmp(nbStates_);
-  vector<double> lScales(nbSites_);
-  vector<double> trans(nbStates_ * nbStates_);
+  // Same rule as a sequential recursion resetting the chain at the first site
+  // greater or equal to each breakpoint in turn.
+  segmentStarts_.clear();
+  if (nbSites_ == 0)
+    return;
+  segmentStarts_.push_back(0);
+  size_t pos = 1;
+  for (size_t bp : breakPoints_)
+  {
+    size_t start = max(bp, pos);
+    if (start >= nbSites_)
+      break;
+    segmentStarts_.push_back(start);
+    pos = start + 1;
+  }
+}
 
-  // Transition probabilities:
+void RescaledHmmLikelihood::runOnSegments_(const std::function<void(size_t, size_t, size_t)>& f) const
+{
+  size_t nbSegments = segmentStarts_.size();
+  auto runSegment = [&](size_t s, size_t /* thread */) {
+                      f(s, segmentStarts_[s], s + 1 < nbSegments ? segmentStarts_[s + 1] : nbSites_);
+                    };
+  if (threadPool_)
+    threadPool_->parallelFor(nbSegments, runSegment);
+  else
+  {
+    for (size_t s = 0; s < nbSegments; ++s)
+    {
+      runSegment(s, 0);
+    }
+  }
+}
+
+double RescaledHmmLikelihood::sortedSum_(std::vector<double>& values)
+{
+  greater<double> cmp;
+  sort(values.begin(), values.end(), cmp);
+  double sum = 0;
+  for (size_t i = 0; i < values.size(); ++i)
+  {
+    sum += values[i];
+  }
+  return sum;
+}
+
+/***************************************************************************************************************************/
+
+void RescaledHmmLikelihood::computeForward_()
+{
+  // Check transition probabilities:
   for (size_t i = 0; i < nbStates_; i++)
   {
-    size_t ii = i * nbStates_;
     for (size_t j = 0; j < nbStates_; j++)
     {
-      trans[ii + j] = transitionMatrix_->Pij(j, i);
-      if (std::isnan(trans[ii + j]))
+      double p = transitionMatrix_->Pij(j, i);
+      if (std::isnan(p))
         throw Exception("RescaledHmmLikelihood::computeForward_. NaN transition probability");
-      if (trans[ii + j] < 0)
-        throw Exception("RescaledHmmLikelihood::computeForward_. Negative transition probability: " + TextTools::toString(trans[ii + j]));
+      if (p < 0)
+        throw Exception("RescaledHmmLikelihood::computeForward_. Negative transition probability: " + TextTools::toString(p));
+    }
+  }
+  HmmTransitionKernel trans(*transitionMatrix_);
+
+  // Probabilities of the first state of each segment:
+  vector<double> init(nbStates_);
+  trans.forward(&transitionMatrix_->getEquilibriumFrequencies()[0], &init[0]);
+
+  // Recursion on each segment:
+  vector< vector<string> > warnings(segmentStarts_.size());
+  runOnSegments_([&](size_t s, size_t begin, size_t end) {
+                   computeForwardSegment_(begin, end, trans, init, warnings[s]);
+                 });
+  for (const auto& segmentWarnings : warnings)
+  {
+    for (const auto& w : segmentWarnings)
+    {
+      (*ApplicationTools::warning << w).endLine();
     }
   }
 
+  // The log-scales are summed in decreasing order, whatever the way segments were processed:
+  vector<double> lScales(nbSites_);
+  for (size_t i = 0; i < nbSites_; i++)
+  {
+    lScales[i] = log(scales_[i]);
+  }
+  logLik_ = sortedSum_(lScales);
+}
+
+void RescaledHmmLikelihood::computeForwardSegment_(size_t begin, size_t end, const HmmTransitionKernel& trans, const std::vector<double>& init, std::vector<std::string>& warnings)
+{
+  vector<double> tmp(nbStates_), x(nbStates_);
+
   // Initialisation:
-  scales_[0] = 0;
-  const vector<double>* emissions = &(*emissionProbabilities_)(0);
+  scales_[begin] = 0;
+  const vector<double>* emissions = &(*emissionProbabilities_)(begin);
   for (size_t j = 0; j < nbStates_; j++)
   {
-    size_t jj = j * nbStates_;
-    x = 0;
-    for (size_t k = 0; k < nbStates_; k++)
-    {
-      x += trans[k + jj] * transitionMatrix_->getEquilibriumFrequencies()[k];
-      // cerr << j << "\t" << k << "\t" << trans[k + jj] << "\t" << transitionMatrix_->getEquilibriumFrequencies()[k] << "\t" << trans[k + jj] * transitionMatrix_->getEquilibriumFrequencies()[k] << "\t" << x << endl;
-    }
-    tmp[j] = (*emissions)[j] * x;
-    // cerr << "e[j]=" << (*emissions)[j] << "\t" << tmp[j] << endl;
-    scales_[0] += tmp[j];
+    tmp[j] = (*emissions)[j] * init[j];
+    scales_[begin] += tmp[j];
   }
   for (size_t j = 0; j < nbStates_; j++)
   {
-    likelihood_[j] = tmp[j] / scales_[0];
+    if (scales_[begin] > 0)
+      likelihood_[begin * nbStates_ + j] = tmp[j] / scales_[begin];
+    else
+      likelihood_[begin * nbStates_ + j] = 0;
   }
-  lScales[0] = log(scales_[0]);
 
   // Recursion:
-  size_t nextBrkPt = nbSites_; // next break point
-  vector<size_t>::const_iterator bpIt = breakPoints_.begin();
-  if (bpIt != breakPoints_.end())
-    nextBrkPt = *bpIt;
-
-  double a;
-  for (size_t i = 1; i < nbSites_; i++)
+  for (size_t i = begin + 1; i < end; i++)
   {
     size_t ii = i * nbStates_;
     size_t iip = (i - 1) * nbStates_;
     scales_[i] = 0;
     emissions = &(*emissionProbabilities_)(i);
-    if (i < nextBrkPt)
-    {
-      for (size_t j = 0; j < nbStates_; j++)
-      {
-        size_t jj = j * nbStates_;
-        x = 0;
-        for (size_t k = 0; k < nbStates_; k++)
-        {
-          a = trans[jj + k] * likelihood_[iip + k];
-          // if (a < 0)
-          // {
-          //  (*ApplicationTools::warning << "Negative value for likelihood at " << i << ", state " << j << ": " << likelihood_[iip + k] << ", Pij = " << trans[jj + k]).endLine();
-          //  a = 0;
-          // }
-          x += a;
-        }
-        tmp[j] = (*emissions)[j] * x;
-        if (tmp[j] < 0)
-        {
-          (*ApplicationTools::warning << "Negative probability at " << i << ", state " << j << ": " << (*emissions)[j] << "\t" << x).endLine();
-          tmp[j] = 0;
-        }
-        scales_[i] += tmp[j];
-      }
-    }
-    else // Reset markov chain:
+    trans.forward(&likelihood_[iip], &x[0]);
+    bool negative = false;
+    for (size_t j = 0; j < nbStates_; j++)
     {
-      for (size_t j = 0; j < nbStates_; j++)
-      {
-        size_t jj = j * nbStates_;
-        x = 0;
-        for (size_t k = 0; k < nbStates_; k++)
-        {
-          a = trans[jj + k] * transitionMatrix_->getEquilibriumFrequencies()[k];
-          // if (a < 0)
-          // {
-          //  (*ApplicationTools::warning << "Negative value for likelihood at " << i << ", state " << j << ": ,Pij = " << trans[jj + k]).endLine();
-          //  a = 0;
-          // }
-          x += a;
-        }
-        tmp[j] = (*emissions)[j] * x;
-        // if (tmp[j] < 0)
-        // {
-        //  (*ApplicationTools::warning << "Negative emission probability at " << i << ", state " << j << ": " << (*emissions)[j]).endLine();
-        //  tmp[j] = 0;
-        // }
-        scales_[i] += tmp[j];
-      }
-      bpIt++;
-      if (bpIt != breakPoints_.end())
-        nextBrkPt = *bpIt;
-      else
-        nextBrkPt = nbSites_;
+      tmp[j] = (*emissions)[j] * x[j];
+      negative |= tmp[j] < 0;
+      scales_[i] += tmp[j];
     }
+    if (negative)
+      scales_[i] = discardNegativeProbabilities_(i, tmp, x, warnings);
 
     for (size_t j = 0; j < nbStates_; j++)
     {
@@ -208,15 +232,23 @@ void RescaledHmmLikelihood::computeForward_()
       else
         likelihood_[ii + j] = 0;
     }
-    lScales[i] = log(scales_[i]);
   }
-  greater<double> cmp;
-  sort(lScales.begin(), lScales.end(), cmp);
-  logLik_ = 0;
-  for (size_t i = 0; i < nbSites_; ++i)
+}
+
+double RescaledHmmLikelihood::discardNegativeProbabilities_(size_t site, std::vector<double>& tmp, const std::vector<double>& x, std::vector<std::string>& warnings) const
+{
+  const vector<double>& emissions = (*emissionProbabilities_)(site);
+  double scale = 0;
+  for (size_t j = 0; j < nbStates_; j++)
   {
-    logLik_ += lScales[i];
+    if (tmp[j] < 0)
+    {
+      warnings.push_back("Negative probability at " + TextTools::toString(site) + ", state " + TextTools::toString(j) + ": " + TextTools::toString(emissions[j]) + "\t" + TextTools::toString(x[j]));
+      tmp[j] = 0;
+    }
+    scale += tmp[j];
   }
+  return scale;
 }
 
 /***************************************************************************************************************************/
@@ -232,65 +264,40 @@ void RescaledHmmLikelihood::computeBackward_() const
     }
   }
 
-  double x;
-
   // Transition probabilities:
-  vector<double> trans(nbStates_ * nbStates_);
-  for (size_t i = 0; i < nbStates_; i++)
-  {
-    size_t ii = i * nbStates_;
-    for (size_t j = 0; j < nbStates_; j++)
-    {
-      trans[ii + j] = transitionMatrix_->Pij(i, j);
-    }
-  }
+  HmmTransitionKernel trans(*transitionMatrix_);
 
+  runOnSegments_([&](size_t /* s */, size_t begin, size_t end) {
+                   computeBackwardSegment_(begin, end, trans);
+                 });
 
-  // Initialisation:
-  const vector<double>* emissions = 0;
-  size_t nextBrkPt = 0; // next break point
-  vector<size_t>::const_reverse_iterator bpIt = breakPoints_.rbegin();
-  if (bpIt != breakPoints_.rend())
-    nextBrkPt = *bpIt;
+  backLikelihoodUpToDate_ = true;
+}
 
+void RescaledHmmLikelihood::computeBackwardSegment_(size_t begin, size_t end, const HmmTransitionKernel& trans) const
+{
+  vector<double> tmp(nbStates_);
+
+  // Initialisation:
   for (size_t j = 0; j < nbStates_; j++)
   {
-    x = 0;
-    backLikelihood_[nbSites_ - 1][j] = 1.;
+    backLikelihood_[end - 1][j] = 1.;
   }
 
   // Recursion:
-  for (size_t i = nbSites_ - 1; i > 0; i--)
+  for (size_t i = end - 1; i > begin; i--)
   {
-    emissions = &(*emissionProbabilities_)(i);
-    if (i > nextBrkPt)
+    const vector<double>* emissions = &(*emissionProbabilities_)(i);
+    for (size_t k = 0; k < nbStates_; k++)
     {
-      for (size_t j = 0; j < nbStates_; j++)
-      {
-        x = 0;
-        size_t jj = j * nbStates_;
-        for (size_t k = 0; k < nbStates_; k++)
-        {
-          x += (*emissions)[k] * trans[jj + k] * backLikelihood_[i][k];
-        }
-        backLikelihood_[i - 1][j] = x / scales_[i];
-      }
+      tmp[k] = (*emissions)[k] * backLikelihood_[i][k];
     }
-    else // Reset markov chain
+    trans.backward(&tmp[0], &backLikelihood_[i - 1][0]);
+    for (size_t j = 0; j < nbStates_; j++)
     {
-      for (size_t j = 0; j < nbStates_; j++)
-      {
-        backLikelihood_[i - 1][j] = 1.;
-      }
-      bpIt++;
-      if (bpIt != breakPoints_.rend())
-        nextBrkPt = *bpIt;
-      else
-        nextBrkPt = 0;
+      backLikelihood_[i - 1][j] /= scales_[i];
     }
   }
-
-  backLikelihoodUpToDate_ = true;
 }
 
 /***************************************************************************************************************************/
@@ -381,42 +388,48 @@ void RescaledHmmLikelihood::computeDForward_() const
   if (dScales_.size() == 0)
     dScales_.resize(nbSites_);
 
-  double x;
-  vector<double> tmp(nbStates_), dTmp(nbStates_);
-  vector<double> dLScales(nbSites_);
-
   // Transition probabilities:
-  const ColMatrix<double> trans(transitionMatrix_->getPij());
+  HmmTransitionKernel trans(*transitionMatrix_);
+
+  // Probabilities of the first state of each segment:
+  vector<double> init(nbStates_);
+  trans.forward(&transitionMatrix_->getEquilibriumFrequencies()[0], &init[0]);
+
+  runOnSegments_([&](size_t /* s */, size_t begin, size_t end) {
+                   computeDForwardSegment_(begin, end, trans, init);
+                 });
 
+  vector<double> dLScales(nbSites_);
+  for (size_t i = 0; i < nbSites_; i++)
+  {
+    dLScales[i] = dScales_[i] / scales_[i];
+  }
+  dLogLik_ = sortedSum_(dLScales);
+}
+
+void RescaledHmmLikelihood::computeDForwardSegment_(size_t begin, size_t end, const HmmTransitionKernel& trans, const std::vector<double>& init) const
+{
+  vector<double> tmp(nbStates_), dTmp(nbStates_), x(nbStates_), dx(nbStates_);
   // Initialisation:
-  dScales_[0] = 0;
-  const vector<double>* emissions = &(*emissionProbabilities_)(0);
-  const vector<double>* dEmissions = &emissionProbabilities_->getDEmissionProbabilities(0);
+  dScales_[begin] = 0;
+  const vector<double>* emissions = &(*emissionProbabilities_)(begin);
+  const vector<double>* dEmissions = &emissionProbabilities_->getDEmissionProbabilities(begin);
 
   for (size_t j = 0; j < nbStates_; j++)
   {
-    dTmp[j] = (*dEmissions)[j] * transitionMatrix_->getEquilibriumFrequencies()[j];
-    tmp[j] = (*emissions)[j] * transitionMatrix_->getEquilibriumFrequencies()[j];
+    dTmp[j] = (*dEmissions)[j] * init[j];
+    tmp[j] = (*emissions)[j] * init[j];
 
-    dScales_[0] += dTmp[j];
+    dScales_[begin] += dTmp[j];
   }
 
-  dLScales[0] = dScales_[0] / scales_[0];
-
-
   for (size_t j = 0; j < nbStates_; j++)
   {
-    dLikelihood_[0][j] = (dTmp[j] * scales_[0] - tmp[j] * dScales_[0]) / pow(scales_[0], 2);
+    dLikelihood_[begin][j] = (dTmp[j] * scales_[begin] - tmp[j] * dScales_[begin]) / pow(scales_[begin], 2);
   }
 
   // Recursion:
-
-  size_t nextBrkPt = nbSites_; // next break point
-  vector<size_t>::const_iterator bpIt = breakPoints_.begin();
-  if (bpIt != breakPoints_.end())
-    nextBrkPt = *bpIt;
-
-  for (size_t i = 1; i < nbSites_; i++)
+  for (size_t i = begin + 1; i < end; i++)
   {
     size_t iip = (i - 1) * nbStates_;
 
@@ -425,54 +438,21 @@ void RescaledHmmLikelihood::computeDForward_() const
     emissions = &(*emissionProbabilities_)(i);
     dEmissions = &emissionProbabilities_->getDEmissionProbabilities(i);
 
-    if (i < nextBrkPt)
-    {
-      for (size_t j = 0; j < nbStates_; j++)
-      {
-        x = 0;
-        for (size_t k = 0; k < nbStates_; k++)
-        {
-          x += trans(k, j) * likelihood_[iip + k];
-        }
-
-        tmp[j] = (*emissions)[j] * x;
-        dTmp[j] = (*dEmissions)[j] * x + (*emissions)[j] * VectorTools::sum(trans.getCol(j) * dLikelihood_[i - 1]);
-
-        dScales_[i] += dTmp[j];
-      }
-    }
-    else // Reset markov chain:
+    trans.forward(&likelihood_[iip], &x[0]);
+    trans.forward(&dLikelihood_[i - 1][0], &dx[0]);
+    for (size_t j = 0; j < nbStates_; j++)
     {
-      for (size_t j = 0; j < nbStates_; j++)
-      {
-        dTmp[j] = (*dEmissions)[j] * transitionMatrix_->getEquilibriumFrequencies()[j];
-        tmp[j] = (*emissions)[j] * transitionMatrix_->getEquilibriumFrequencies()[j];
-
-        dScales_[i] += dTmp[j];
-      }
+      tmp[j] = (*emissions)[j] * x[j];
+      dTmp[j] = (*dEmissions)[j] * x[j] + (*emissions)[j] * dx[j];
 
-      bpIt++;
-      if (bpIt != breakPoints_.end())
-        nextBrkPt = *bpIt;
-      else
-        nextBrkPt = nbSites_;
+      dScales_[i] += dTmp[j];
     }
 
-    dLScales[i] = dScales_[i] / scales_[i];
-
     for (size_t j = 0; j < nbStates_; j++)
     {
       dLikelihood_[i][j] = (dTmp[j] * scales_[i] - tmp[j] * dScales_[i]) / pow(scales_[i], 2);
     }
   }
-
-  greater<double> cmp;
-  sort(dLScales.begin(), dLScales.end(), cmp);
-  dLogLik_ = 0;
-  for (size_t i = 0; i < nbSites_; ++i)
-  {
-    dLogLik_ += dLScales[i];
-  }
 }
 
 double RescaledHmmLikelihood::getDLogLikelihoodForASite(size_t site) const
@@ -497,90 +477,79 @@ void RescaledHmmLikelihood::computeD2Forward_() const
   if (d2Scales_.size() == 0)
     d2Scales_.resize(nbSites_);
 
-  double x;
-  vector<double> tmp(nbStates_), dTmp(nbStates_), d2Tmp(nbStates_);
-  vector<double> d2LScales(nbSites_);
+  // The second order recursion uses the first order one:
+  if (dVariable_ != d2Variable_)
+  {
+    dVariable_ = d2Variable_;
+    emissionProbabilities_->computeDEmissionProbabilities(dVariable_);
+    computeDForward_();
+  }
 
   // Transition probabilities:
-  const ColMatrix<double> trans(transitionMatrix_->getPij());
+  HmmTransitionKernel trans(*transitionMatrix_);
+
+  // Probabilities of the first state of each segment:
+  vector<double> init(nbStates_);
+  trans.forward(&transitionMatrix_->getEquilibriumFrequencies()[0], &init[0]);
 
+  runOnSegments_([&](size_t /* s */, size_t begin, size_t end) {
+                   computeD2ForwardSegment_(begin, end, trans, init);
+                 });
+
+  vector<double> d2LScales(nbSites_);
+  for (size_t i = 0; i < nbSites_; i++)
+  {
+    d2LScales[i] = d2Scales_[i] / scales_[i] - pow(dScales_[i] / scales_[i], 2);
+  }
+  d2LogLik_ = sortedSum_(d2LScales);
+}
+
+void RescaledHmmLikelihood::computeD2ForwardSegment_(size_t begin, size_t end, const HmmTransitionKernel& trans, const std::vector<double>& init) const
+{
+  vector<double> tmp(nbStates_), dTmp(nbStates_), d2Tmp(nbStates_), x(nbStates_), dx(nbStates_), d2x(nbStates_);
   // Initialisation:
-  d2Scales_[0] = 0;
-  const vector<double>* emissions = &(*emissionProbabilities_)(0);
-  const vector<double>* dEmissions = &emissionProbabilities_->getDEmissionProbabilities(0);
-  const vector<double>* d2Emissions = &emissionProbabilities_->getD2EmissionProbabilities(0);
+  d2Scales_[begin] = 0;
+  const vector<double>* emissions = &(*emissionProbabilities_)(begin);
+  const vector<double>* dEmissions = &emissionProbabilities_->getDEmissionProbabilities(begin);
+  const vector<double>* d2Emissions = &emissionProbabilities_->getD2EmissionProbabilities(begin);
 
   for (size_t j = 0; j < nbStates_; j++)
   {
-    tmp[j] = (*emissions)[j] * transitionMatrix_->getEquilibriumFrequencies()[j];
-    dTmp[j] = (*dEmissions)[j] * transitionMatrix_->getEquilibriumFrequencies()[j];
-    d2Tmp[j] = (*d2Emissions)[j] * transitionMatrix_->getEquilibriumFrequencies()[j];
+    tmp[j] = (*emissions)[j] * init[j];
+    dTmp[j] = (*dEmissions)[j] * init[j];
+    d2Tmp[j] = (*d2Emissions)[j] * init[j];
 
-    d2Scales_[0] += d2Tmp[j];
+    d2Scales_[begin] += d2Tmp[j];
   }
 
-  d2LScales[0] = d2Scales_[0] / scales_[0] - pow(dScales_[0] / scales_[0], 2);
-
   for (size_t j = 0; j < nbStates_; j++)
   {
-    d2Likelihood_[0][j] = d2Tmp[j] / scales_[0] - (d2Scales_[0] * tmp[j] + 2 * dScales_[0] * dTmp[j]) / pow(scales_[0], 2)
-        +  2 * pow(dScales_[0], 2) * tmp[j] / pow(scales_[0], 3);
+    d2Likelihood_[begin][j] = d2Tmp[j] / scales_[begin] - (d2Scales_[begin] * tmp[j] + 2 * dScales_[begin] * dTmp[j]) / pow(scales_[begin], 2)
+        +  2 * pow(dScales_[begin], 2) * tmp[j] / pow(scales_[begin], 3);
   }
 
   // Recursion:
-
-  size_t nextBrkPt = nbSites_; // next break point
-  vector<size_t>::const_iterator bpIt = breakPoints_.begin();
-  if (bpIt != breakPoints_.end())
-    nextBrkPt = *bpIt;
-
-  for (size_t i = 1; i < nbSites_; i++)
+  for (size_t i = begin + 1; i < end; i++)
   {
-    dScales_[i] = 0;
+    size_t iip = (i - 1) * nbStates_;
+
+    d2Scales_[i] = 0;
 
     emissions = &(*emissionProbabilities_)(i);
     dEmissions = &emissionProbabilities_->getDEmissionProbabilities(i);
     d2Emissions = &emissionProbabilities_->getD2EmissionProbabilities(i);
 
-    if (i < nextBrkPt)
-    {
-      size_t iip = (i - 1) * nbStates_;
-
-      for (size_t j = 0; j < nbStates_; j++)
-      {
-        x = 0;
-        for (size_t k = 0; k < nbStates_; k++)
-        {
-          x += trans(k, j) * likelihood_[iip + k];
-        }
-
-        tmp[j] = (*emissions)[j] * x;
-        dTmp[j] = (*dEmissions)[j] * x + (*emissions)[j] * VectorTools::sum(trans.getCol(j) * dLikelihood_[i - 1]);
-        d2Tmp[j] = (*d2Emissions)[j] * x + 2 * (*dEmissions)[j] * VectorTools::sum(trans.getCol(j) * dLikelihood_[i - 1])
-            + (*emissions)[j] * VectorTools::sum(trans.getCol(j) * d2Likelihood_[i - 1]);
-
-        d2Scales_[i] += d2Tmp[j];
-      }
-    }
-    else // Reset markov chain:
+    trans.forward(&likelihood_[iip], &x[0]);
+    trans.forward(&dLikelihood_[i - 1][0], &dx[0]);
+    trans.forward(&d2Likelihood_[i - 1][0], &d2x[0]);
+    for (size_t j = 0; j < nbStates_; j++)
     {
-      for (size_t j = 0; j < nbStates_; j++)
-      {
-        tmp[j] = (*emissions)[j] * transitionMatrix_->getEquilibriumFrequencies()[j];
-        dTmp[j] = (*dEmissions)[j] * transitionMatrix_->getEquilibriumFrequencies()[j];
-        d2Tmp[j] = (*d2Emissions)[j] * transitionMatrix_->getEquilibriumFrequencies()[j];
-
-        d2Scales_[i] += d2Tmp[j];
-      }
-
-      bpIt++;
-      if (bpIt != breakPoints_.end())
-        nextBrkPt = *bpIt;
-      else
-        nextBrkPt = nbSites_;
-    }
+      tmp[j] = (*emissions)[j] * x[j];
+      dTmp[j] = (*dEmissions)[j] * x[j] + (*emissions)[j] * dx[j];
+      d2Tmp[j] = (*d2Emissions)[j] * x[j] + 2 * (*dEmissions)[j] * dx[j] + (*emissions)[j] * d2x[j];
 
-    d2LScales[i] = d2Scales_[i] / scales_[i] - pow(dScales_[i] / scales_[i], 2);
+      d2Scales_[i] += d2Tmp[j];
+    }
 
     for (size_t j = 0; j < nbStates_; j++)
     {
@@ -588,14 +557,6 @@ void RescaledHmmLikelihood::computeD2Forward_() const
           +  2 * pow(dScales_[i], 2) * tmp[j] / pow(scales_[i], 3);
     }
   }
-
-  greater<double> cmp;
-  sort(d2LScales.begin(), d2LScales.end(), cmp);
-  dLogLik_ = 0;
-  for (size_t i = 0; i < nbSites_; ++i)
-  {
-    d2LogLik_ += d2LScales[i];
-  }
 }
 
 /***************************************************************************************************************************/
@@ -6,13 +6,16 @@
 #define BPP_NUMERIC_HMM_RESCALEDHMMLIKELIHOOD_H
 
 
+#include "../../Utils/ThreadPool.h"
 #include "../AbstractParametrizable.h"
 #include "../Matrix/Matrix.h"
 #include "HmmLikelihood.h"
+#include "HmmTransitionKernel.h"
 
 // From the STL:
-#include <vector>
+#include <functional>
 #include <memory>
+#include <vector>
 
 namespace bpp
 {
@@ -21,6 +24,11 @@ namespace bpp
  *
  * This implementation uses the rescaling method described in Durbin et al "Biological sequence analysis", Cambridge University Press.
  * It also offer the possibility to specify "breakpoints", where the chain will be reset to the equilibrium frequencies.
+ *
+ * As the segments between breakpoints are independent, the forward, backward and derivative recursions
+ * can be run on several segments in parallel, by providing a ThreadPool (see setThreadPool).
+ * The log-likelihood is then obtained by summing the log-scales of all sites in a fixed order, so that
+ * the results do not depend on the number of threads.
  */
 class RescaledHmmLikelihood :
   public virtual AbstractHmmLikelihood,
@@ -83,6 +91,13 @@ private:
 
   std::vector<size_t> breakPoints_;
 
+  /**
+   * @brief First site of each independent segment, as defined by the breakpoints.
+   */
+  std::vector<size_t> segmentStarts_;
+
+  std::shared_ptr<ThreadPool> threadPool_;
+
   size_t nbStates_, nbSites_;
 
 public:
@@ -116,6 +131,8 @@ public:
     d2Scales_(lik.d2Scales_),
     logLik_(lik.logLik_),
     breakPoints_(lik.breakPoints_),
+    segmentStarts_(lik.segmentStarts_),
+    threadPool_(lik.threadPool_),
     nbStates_(lik.nbStates_),
     nbSites_(lik.nbSites_)
   {
@@ -141,6 +158,8 @@ public:
     d2Scales_              = lik.d2Scales_;
     logLik_                = lik.logLik_;
     breakPoints_           = lik.breakPoints_;
+    segmentStarts_         = lik.segmentStarts_;
+    threadPool_            = lik.threadPool_;
     nbStates_              = lik.nbStates_;
     nbSites_               = lik.nbSites_;
 
@@ -176,17 +195,34 @@ public:
   void setBreakPoints(const std::vector<size_t>& breakPoints) override
   {
     breakPoints_ = breakPoints;
+    computeSegments_();
     computeForward_();
     backLikelihoodUpToDate_ = false;
   }
 
   const std::vector<size_t>& getBreakPoints() const override { return breakPoints_; }
 
+  /**
+   * @brief Set the thread pool used to process the segments between breakpoints in parallel.
+   *
+   * The pool is shared with the copies of this object.
+   *
+   * @param threadPool A thread pool, or a null pointer for a serial computation (the default).
+   */
+  void setThreadPool(std::shared_ptr<ThreadPool> threadPool) { threadPool_ = threadPool; }
+
+  std::shared_ptr<ThreadPool> getThreadPool() const { return threadPool_; }
+
   void setParameters(const ParameterList& pl) override
   {
     setParametersValues(pl);
   }
 
+  void setBoundParameters(const std::vector<size_t>& slots, const double* values, const std::vector<bool>* changed = nullptr) override
+  {
+    matchBoundParametersValues(slots, values, changed);
+  }
+
   double getValue() const override { return -logLik_; }
 
   double getLogLikelihood() const override { return logLik_; }
@@ -211,6 +247,37 @@ protected:
   void computeForward_();
   void computeBackward_() const;
 
+  void computeSegments_();
+
+  /**
+   * @brief Run f(segment, begin, end) on each segment [begin, end) of the data, in parallel if a thread pool is set.
+   */
+  void runOnSegments_(const std::function<void(size_t, size_t, size_t)>& f) const;
+
+  void computeForwardSegment_(size_t begin, size_t end, const HmmTransitionKernel& trans, const std::vector<double>& init, std::vector<std::string>& warnings);
+  void computeBackwardSegment_(size_t begin, size_t end, const HmmTransitionKernel& trans) const;
+
+  /**
+   * @brief Set the negative values of a site to zero, and record a warning for each of them.
+   *
+   * This is only called when negative values were found, so that the forward recursion
+   * does not branch on each value.
+   *
+   * @param site The position of the site.
+   * @param tmp [in,out] The unscaled forward values of the site.
+   * @param x [in] The transition products of the site.
+   * @param warnings [out] Where warnings are appended.
+   * @return The sum of the corrected values.
+   */
+  double discardNegativeProbabilities_(size_t site, std::vector<double>& tmp, const std::vector<double>& x, std::vector<std::string>& warnings) const;
+  void computeDForwardSegment_(size_t begin, size_t end, const HmmTransitionKernel& trans, const std::vector<double>& init) const;
+  void computeD2ForwardSegment_(size_t begin, size_t end, const HmmTransitionKernel& trans, const std::vector<double>& init) const;
+
+  /**
+   * @brief Sum the given values in decreasing order.
+   */
+  static double sortedSum_(std::vector<double>& values);
+
 
   void computeDLikelihood_() const override
   {
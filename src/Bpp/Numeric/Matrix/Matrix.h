@@ -5,10 +5,12 @@
 #ifndef BPP_NUMERIC_MATRIX_MATRIX_H
 #define BPP_NUMERIC_MATRIX_MATRIX_H
 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 
 #include "../../Clonable.h"
+#include "../../Utils/AlignedAllocator.h"
 #include "../NumConstants.h"
 #include "../NumTools.h"
 #include "../VectorExceptions.h"
@@ -298,6 +300,173 @@ public:
   }
 };
 
+/**
+ * @brief A non-owning view on a matrix stored by rows with a constant stride.
+ *
+ * Element \f$(i,j)\f$ is stored at data()[i * stride() + j]. Views are
+ * obtained from DenseMatrix and LinearMatrix (rows, columns or rectangular
+ * blocks), and can be passed to any function taking a Matrix, without copying
+ * the data. They remain valid as long as the underlying matrix is not resized
+ * or destroyed.
+ *
+ * A view cannot be resized: resize() only accepts the current dimensions, so
+ * that a view can be used as the output of functions like MatrixTools::mult.
+ *
+ * @warning Views built from a constant matrix are returned as constant objects,
+ * but copying them gives write access to the data.
+ */
+template<class Scalar>
+class DenseMatrixView :
+  public Matrix<Scalar>
+{
+private:
+  Scalar* data_;
+  size_t rows_;
+  size_t cols_;
+  size_t stride_;
+
+public:
+  /**
+   * @brief Build a view on existing data.
+   *
+   * @param data A pointer to the first element.
+   * @param nRows The number of rows.
+   * @param nCols The number of columns.
+   * @param stride The distance between two successive rows.
+   */
+  DenseMatrixView(Scalar* data, size_t nRows, size_t nCols, size_t stride) :
+    data_(data),
+    rows_(nRows),
+    cols_(nCols),
+    stride_(stride) {}
+
+  DenseMatrixView(const DenseMatrixView&) = default;
+
+  /**
+   * @brief Copy the content of a matrix with the same dimensions into the viewed data.
+   *
+   * @throw DimensionException If the dimensions differ.
+   */
+  DenseMatrixView& operator=(const Matrix<Scalar>& m)
+  {
+    resize(m.getNumberOfRows(), m.getNumberOfColumns());
+    for (size_t i = 0; i < rows_; i++)
+    {
+      Scalar* ri = rowData(i);
+      for (size_t j = 0; j < cols_; j++)
+      {
+        ri[j] = m(i, j);
+      }
+    }
+    return *this;
+  }
+
+  DenseMatrixView& operator=(const DenseMatrixView& m)
+  {
+    return operator=(static_cast<const Matrix<Scalar>&>(m));
+  }
+
+  virtual ~DenseMatrixView() {}
+
+public:
+  /**
+   * @return A copy of the view, pointing to the same data.
+   */
+  DenseMatrixView* clone() const { return new DenseMatrixView(*this); }
+
+  const Scalar& operator()(size_t i, size_t j) const { return data_[i * stride_ + j]; }
+
+  Scalar& operator()(size_t i, size_t j) { return data_[i * stride_ + j]; }
+
+  size_t getNumberOfRows() const { return rows_; }
+
+  size_t getNumberOfColumns() const { return cols_; }
+
+  std::vector<Scalar> row(size_t i) const
+  {
+    const Scalar* ri = rowData(i);
+    return std::vector<Scalar>(ri, ri + cols_);
+  }
+
+  std::vector<Scalar> col(size_t j) const
+  {
+    std::vector<Scalar> c(rows_);
+    for (size_t i = 0; i < rows_; i++) { c[i] = data_[i * stride_ + j]; }
+    return c;
+  }
+
+  /**
+   * @brief Views cannot be resized.
+   *
+   * @throw DimensionException If the requested dimensions differ from the current ones.
+   */
+  void resize(size_t nRows, size_t nCols)
+  {
+    if (nRows != rows_)
+      throw DimensionException("DenseMatrixView::resize: a view cannot be resized.", nRows, rows_);
+    if (nCols != cols_)
+      throw DimensionException("DenseMatrixView::resize: a view cannot be resized.", nCols, cols_);
+  }
+
+  /**
+   * @return A pointer to the first element.
+   */
+  const Scalar* data() const { return data_; }
+
+  Scalar* data() { return data_; }
+
+  /**
+   * @return The distance between two successive rows.
+   */
+  size_t stride() const { return stride_; }
+
+  /**
+   * @return A pointer to the first element of row i.
+   * @param i The index of the row.
+   */
+  const Scalar* rowData(size_t i) const { return data_ + i * stride_; }
+
+  Scalar* rowData(size_t i) { return data_ + i * stride_; }
+
+  /**
+   * @return A view on the rectangular block starting at (i, j), with nRows rows and nCols columns.
+   */
+  DenseMatrixView block(size_t i, size_t j, size_t nRows, size_t nCols)
+  {
+    checkBlock_(i, j, nRows, nCols);
+    return DenseMatrixView(data_ + i * stride_ + j, nRows, nCols, stride_);
+  }
+
+  const DenseMatrixView block(size_t i, size_t j, size_t nRows, size_t nCols) const
+  {
+    checkBlock_(i, j, nRows, nCols);
+    return DenseMatrixView(data_ + i * stride_ + j, nRows, nCols, stride_);
+  }
+
+  /**
+   * @return A 1 x n view on row i.
+   */
+  DenseMatrixView rowView(size_t i) { return block(i, 0, 1, cols_); }
+
+  const DenseMatrixView rowView(size_t i) const { return block(i, 0, 1, cols_); }
+
+  /**
+   * @return A n x 1 view on column j.
+   */
+  DenseMatrixView colView(size_t j) { return block(0, j, rows_, 1); }
+
+  const DenseMatrixView colView(size_t j) const { return block(0, j, rows_, 1); }
+
+private:
+  void checkBlock_(size_t i, size_t j, size_t nRows, size_t nCols) const
+  {
+    if (i + nRows > rows_)
+      throw DimensionException("DenseMatrixView::block: rows out of range.", i + nRows, rows_);
+    if (j + nCols > cols_)
+      throw DimensionException("DenseMatrixView::block: columns out of range.", j + nCols, cols_);
+  }
+};
+
 /**
  * @brief Matrix storage in one vector.
  *
@@ -381,6 +550,20 @@ public:
 
   size_t getNumberOfColumns() const { return cols_; }
 
+  /**
+   * @return A pointer to the underlying storage, row after row.
+   */
+  const Scalar* data() const { return m_.data(); }
+
+  Scalar* data() { return m_.data(); }
+
+  /**
+   * @return A view on the whole matrix.
+   */
+  DenseMatrixView<Scalar> view() { return DenseMatrixView<Scalar>(m_.data(), rows_, cols_, cols_); }
+
+  const DenseMatrixView<Scalar> view() const { return DenseMatrixView<Scalar>(const_cast<Scalar*>(m_.data()), rows_, cols_, cols_); }
+
   std::vector<Scalar> row(size_t i) const
   {
     std::vector<Scalar> r(getNumberOfColumns());
@@ -492,6 +675,220 @@ private:
   }
 };
 
+/**
+ * @brief Dense matrix storage in one aligned buffer.
+ *
+ * Elements are stored by rows in a single buffer aligned on 64 bytes (a cache
+ * line). Each row is padded so that the distance between two successive rows,
+ * given by stride(), keeps every row aligned. Element access is in \f$O(1)\f$
+ * and involves no pointer chasing, and row, column and block views
+ * (DenseMatrixView) can be obtained without copying.
+ *
+ * This storage is recognized by MatrixTools, which then works directly on the
+ * underlying buffer.
+ *
+ * Basic usage:
+ * @code
+ * DenseMatrix<double> m(3, 4);
+ * m(1, 2) = 5.;
+ * DenseMatrixView<double> b = m.block(1, 1, 2, 3); // b(0, 1) is m(1, 2)
+ * MatrixTools::fill(b, 0.);                      // Set the block to 0.
+ * @endcode
+ */
+template<class Scalar>
+class DenseMatrix :
+  public Matrix<Scalar>
+{
+public:
+  /**
+   * @brief The alignment of the buffer and of all rows, in bytes.
+   */
+  static const size_t ALIGNMENT = 64;
+
+private:
+  std::vector<Scalar, AlignedAllocator<Scalar, ALIGNMENT>> m_;
+  size_t rows_;
+  size_t cols_;
+  size_t stride_;
+
+public:
+  /**
+   * @brief Build a 0 x 0 matrix.
+   */
+  DenseMatrix() : m_(), rows_(0), cols_(0), stride_(0) {}
+
+  /**
+   * @brief Build a nRow x nCol matrix, with all elements initialized to 0.
+   */
+  DenseMatrix(size_t nRow, size_t nCol) :
+    m_(nRow * paddedStride(nCol)),
+    rows_(nRow),
+    cols_(nCol),
+    stride_(paddedStride(nCol)) {}
+
+  DenseMatrix(const Matrix<Scalar>& m) :
+    m_(m.getNumberOfRows() * paddedStride(m.getNumberOfColumns())),
+    rows_(m.getNumberOfRows()),
+    cols_(m.getNumberOfColumns()),
+    stride_(paddedStride(m.getNumberOfColumns()))
+  {
+    for (size_t i = 0; i < rows_; i++)
+    {
+      Scalar* ri = rowData(i);
+      for (size_t j = 0; j < cols_; j++)
+      {
+        ri[j] = m(i, j);
+      }
+    }
+  }
+
+  DenseMatrix(const DenseMatrix&) = default;
+
+  DenseMatrix& operator=(const DenseMatrix&) = default;
+
+  DenseMatrix& operator=(const Matrix<Scalar>& m)
+  {
+    if (&m == this)
+      return *this;
+    rows_ = m.getNumberOfRows();
+    cols_ = m.getNumberOfColumns();
+    stride_ = paddedStride(cols_);
+    m_.assign(rows_ * stride_, Scalar());
+    for (size_t i = 0; i < rows_; i++)
+    {
+      Scalar* ri = rowData(i);
+      for (size_t j = 0; j < cols_; j++)
+      {
+        ri[j] = m(i, j);
+      }
+    }
+    return *this;
+  }
+
+  virtual ~DenseMatrix() {}
+
+public:
+  DenseMatrix* clone() const { return new DenseMatrix(*this); }
+
+  const Scalar& operator()(size_t i, size_t j) const { return m_[i * stride_ + j]; }
+
+  Scalar& operator()(size_t i, size_t j) { return m_[i * stride_ + j]; }
+
+  size_t getNumberOfRows() const { return rows_; }
+
+  size_t getNumberOfColumns() const { return cols_; }
+
+  std::vector<Scalar> row(size_t i) const
+  {
+    const Scalar* ri = rowData(i);
+    return std::vector<Scalar>(ri, ri + cols_);
+  }
+
+  std::vector<Scalar> col(size_t j) const
+  {
+    std::vector<Scalar> c(rows_);
+    for (size_t i = 0; i < rows_; i++) { c[i] = m_[i * stride_ + j]; }
+    return c;
+  }
+
+  /**
+   * @copydoc Matrix::resize
+   *
+   * Values in the common part of the old and new dimensions are kept, new
+   * elements are set to 0.
+   */
+  void resize(size_t nRows, size_t nCols)
+  {
+    if (nRows == rows_ && nCols == cols_)
+      return;
+    size_t newStride = paddedStride(nCols);
+    if (newStride == stride_)
+    {
+      // Rows stay in place: only clear the new columns of the kept rows.
+      for (size_t i = 0; i < std::min(rows_, nRows); i++)
+      {
+        Scalar* ri = rowData(i);
+        for (size_t j = cols_; j < nCols; j++) { ri[j] = Scalar(); }
+      }
+      m_.resize(nRows * newStride);
+    }
+    else
+    {
+      std::vector<Scalar, AlignedAllocator<Scalar, ALIGNMENT>> tmp(nRows * newStride);
+      size_t nc = std::min(cols_, nCols);
+      for (size_t i = 0; i < std::min(rows_, nRows); i++)
+      {
+        const Scalar* ri = rowData(i);
+        std::copy(ri, ri + nc, tmp.begin() + static_cast<std::ptrdiff_t>(i * newStride));
+      }
+      m_.swap(tmp);
+    }
+    rows_ = nRows;
+    cols_ = nCols;
+    stride_ = newStride;
+  }
+
+  /**
+   * @return A pointer to the first element (64-byte aligned).
+   */
+  const Scalar* data() const { return m_.data(); }
+
+  Scalar* data() { return m_.data(); }
+
+  /**
+   * @return The distance between two successive rows, in number of elements.
+   */
+  size_t stride() const { return stride_; }
+
+  /**
+   * @return A pointer to the first element of row i (64-byte aligned).
+   * @param i The index of the row.
+   */
+  const Scalar* rowData(size_t i) const { return m_.data() + i * stride_; }
+
+  Scalar* rowData(size_t i) { return m_.data() + i * stride_; }
+
+  /**
+   * @return A view on the whole matrix.
+   */
+  DenseMatrixView<Scalar> view() { return DenseMatrixView<Scalar>(m_.data(), rows_, cols_, stride_); }
+
+  const DenseMatrixView<Scalar> view() const { return DenseMatrixView<Scalar>(const_cast<Scalar*>(m_.data()), rows_, cols_, stride_); }
+
+  /**
+   * @return A view on the rectangular block starting at (i, j), with nRows rows and nCols columns.
+   * @throw DimensionException If the block does not fit in the matrix.
+   */
+  DenseMatrixView<Scalar> block(size_t i, size_t j, size_t nRows, size_t nCols) { return view().block(i, j, nRows, nCols); }
+
+  const DenseMatrixView<Scalar> block(size_t i, size_t j, size_t nRows, size_t nCols) const { return view().block(i, j, nRows, nCols); }
+
+  /**
+   * @return A 1 x n view on row i.
+   */
+  DenseMatrixView<Scalar> rowView(size_t i) { return block(i, 0, 1, cols_); }
+
+  const DenseMatrixView<Scalar> rowView(size_t i) const { return block(i, 0, 1, cols_); }
+
+  /**
+   * @return A n x 1 view on column j.
+   */
+  DenseMatrixView<Scalar> colView(size_t j) { return block(0, j, rows_, 1); }
+
+  const DenseMatrixView<Scalar> colView(size_t j) const { return block(0, j, rows_, 1); }
+
+  /**
+   * @return The row stride used for a given number of columns, so that all
+   * rows are aligned on ALIGNMENT bytes.
+   * @param nCols The number of columns.
+   */
+  static size_t paddedStride(size_t nCols)
+  {
+    const size_t a = (ALIGNMENT % sizeof(Scalar) == 0) ? ALIGNMENT / sizeof(Scalar) : 1;
+    return (nCols + a - 1) / a * a;
+  }
+};
+
 template<class Scalar>
 bool operator==(const Matrix<Scalar>& m1, const Matrix<Scalar>& m2)
 {
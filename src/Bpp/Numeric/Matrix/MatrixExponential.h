@@ -0,0 +1,565 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_NUMERIC_MATRIX_MATRIXEXPONENTIAL_H
+#define BPP_NUMERIC_MATRIX_MATRIXEXPONENTIAL_H
+
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+#include "../../Exceptions.h"
+#include "../NumTools.h"
+#include "../VectorExceptions.h"
+#include "EigenValue.h"
+#include "LUDecomposition.h"
+#include "Matrix.h"
+#include "MatrixKernels.h"
+
+namespace bpp
+{
+/**
+ * @brief Computation of \f$\exp(t.A)\f$ for a fixed square matrix A and many values of t.
+ *
+ * The eigen decomposition \f$A = V . D . V^{-1}\f$ is computed once when the
+ * object is built. Then for each t:
+ * - \f$\exp(t.A)\f$ is obtained with one matrix product, \f$O(n^3)\f$ (see exp(t, O));
+ * - several values of t can be processed at once (see exp(vt, vO));
+ * - \f$\exp(t.A).v\f$ and \f$v.\exp(t.A)\f$ are obtained in \f$O(n^2)\f$,
+ *   without computing the exponential itself (see expTimesVector and vectorTimesExp).
+ *
+ * Complex eigenvalues are supported: D is then block diagonal, with 2x2 blocks
+ * [a, b; -b, a] for eigenvalues a +/- ib (see EigenValue), and
+ * \f$\exp(t.D)\f$ has blocks \f$e^{at}\f$[cos(bt), sin(bt); -sin(bt), cos(bt)].
+ *
+ * If A is not diagonalizable, or if the matrix of eigenvectors is too badly
+ * conditioned for the decomposition to be reliable, the exponential is
+ * computed for each t with the scaling and squaring method with Padé
+ * approximants (N. J. Higham, SIAM J. Matrix Anal. Appl. 26(4):1179-1193, 2005).
+ *
+ * Basic usage:
+ * @code
+ * MatrixExponential<double> expQ(Q); // Diagonalize Q once
+ * RowMatrix<double> P;
+ * for (double t : branchLengths)
+ * {
+ *   expQ.exp(t, P);                   // P = exp(t.Q)
+ *   ...
+ * }
+ * @endcode
+ */
+template<class Scalar>
+class MatrixExponential
+{
+private:
+  size_t n_;
+
+  /**
+   * @brief A copy of the input matrix, used by the Padé approximation.
+   */
+  DenseMatrix<Scalar> A_;
+
+  /**
+   * @brief The 1-norm of A.
+   */
+  Scalar normA_;
+
+  bool diagonalizable_;
+
+  /**
+   * @brief True if all eigenvalues are real.
+   */
+  bool realSpectrum_;
+
+  std::vector<Scalar> d_;
+  std::vector<Scalar> e_;
+  DenseMatrix<Scalar> V_;
+  DenseMatrix<Scalar> VInv_;
+
+public:
+  /**
+   * @brief Decompose a matrix.
+   *
+   * @param A The square matrix to exponentiate.
+   * @param maxConditionNumber The maximum acceptable condition number (in
+   * 1-norm) of the matrix of eigenvectors. Above this value, the Padé
+   * approximation is used instead of the eigen decomposition.
+   * @throw DimensionException If A is not a square matrix.
+   */
+  MatrixExponential(const Matrix<Scalar>& A, Scalar maxConditionNumber = 1e12) :
+    n_(A.getNumberOfRows()),
+    A_(A),
+    normA_(norm1_(A_)),
+    diagonalizable_(false),
+    realSpectrum_(true),
+    d_(),
+    e_(),
+    V_(),
+    VInv_()
+  {
+    if (n_ != A.getNumberOfColumns())
+      throw DimensionException("MatrixExponential: A must be a square matrix.", A.getNumberOfColumns(), n_);
+    if (n_ == 0)
+    {
+      diagonalizable_ = true;
+      return;
+    }
+
+    EigenValue<Scalar> eigen(A);
+    d_ = eigen.getRealEigenValues();
+    e_ = eigen.getImagEigenValues();
+    V_ = eigen.getV();
+    for (size_t i = 0; i < n_; i++)
+    {
+      if (e_[i] != 0)
+        realSpectrum_ = false;
+    }
+
+    try
+    {
+      LUDecomposition<Scalar> lu(V_);
+      RowMatrix<Scalar> id(n_, n_);
+      for (size_t i = 0; i < n_; i++) { id(i, i) = 1; }
+      lu.solve(id, VInv_);
+      Scalar cond = norm1_(V_) * norm1_(VInv_);
+      diagonalizable_ = std::isfinite(static_cast<double>(cond)) && cond <= maxConditionNumber;
+    }
+    catch (ZeroDivisionException&)
+    {
+      diagonalizable_ = false;
+    }
+  }
+
+  virtual ~MatrixExponential() {}
+
+public:
+  /**
+   * @return The dimension of the matrix.
+   */
+  size_t getSize() const { return n_; }
+
+  /**
+   * @return True if the eigen decomposition is used, false if the Padé approximation is used.
+   */
+  bool isDiagonalizable() const { return diagonalizable_; }
+
+  /**
+   * @return The real parts of the eigenvalues.
+   */
+  const std::vector<Scalar>& getRealEigenValues() const { return d_; }
+
+  /**
+   * @return The imaginary parts of the eigenvalues.
+   */
+  const std::vector<Scalar>& getImagEigenValues() const { return e_; }
+
+  /**
+   * @return The matrix of eigenvectors V.
+   */
+  const DenseMatrix<Scalar>& getV() const { return V_; }
+
+  /**
+   * @return The inverse of the matrix of eigenvectors.
+   * @throw Exception If A is not diagonalizable.
+   */
+  const DenseMatrix<Scalar>& getVInverse() const
+  {
+    if (!diagonalizable_)
+      throw Exception("MatrixExponential::getVInverse. Matrix is not diagonalizable.");
+    return VInv_;
+  }
+
+  /**
+   * @brief Compute \f$\exp(t.A)\f$.
+   *
+   * @param t The scalar multiplying A.
+   * @param O [out] The exponential.
+   */
+  void exp(Scalar t, Matrix<Scalar>& O) const
+  {
+    DenseMatrix<Scalar>* dO = dynamic_cast<DenseMatrix<Scalar>*>(&O);
+    DenseMatrix<Scalar> tmp;
+    DenseMatrix<Scalar>& R = dO ? *dO : tmp;
+    if (diagonalizable_)
+    {
+      DenseMatrix<Scalar> VE;
+      scaledEigenVectors_(t, VE);
+      mult_(VE, VInv_, R);
+    }
+    else
+    {
+      pade_(t, R);
+    }
+    if (!dO)
+      copy_(R, O);
+  }
+
+  /**
+   * @brief Compute \f$\exp(t.A)\f$ for several values of t.
+   *
+   * When A is diagonalizable with real eigenvalues, all exponentials are
+   * computed in one pass with MatrixKernels::gemmDiagBatch.
+   *
+   * @param vt The values of t.
+   * @param vO [out] The exponentials, one for each value of t.
+   */
+  template<class MatrixO>
+  void exp(const std::vector<Scalar>& vt, std::vector<MatrixO>& vO) const
+  {
+    vO.resize(vt.size());
+    if constexpr (std::is_same<Scalar, double>::value && std::is_same<MatrixO, DenseMatrix<double>>::value)
+    {
+      if (diagonalizable_ && realSpectrum_ && n_ > 0)
+      {
+        std::vector<std::vector<double>> vD(vt.size(), std::vector<double>(n_));
+        std::vector<const double*> diagonals(vt.size());
+        std::vector<std::vector<double*>> rowsO(vt.size(), std::vector<double*>(n_));
+        std::vector<double* const*> outputs(vt.size());
+        for (size_t k = 0; k < vt.size(); k++)
+        {
+          for (size_t i = 0; i < n_; i++) { vD[k][i] = std::exp(vt[k] * d_[i]); }
+          diagonals[k] = vD[k].data();
+          vO[k].resize(n_, n_);
+          for (size_t i = 0; i < n_; i++) { rowsO[k][i] = vO[k].rowData(i); }
+          outputs[k] = rowsO[k].data();
+        }
+        std::vector<const double*> rowsV(n_), rowsVInv(n_);
+        for (size_t i = 0; i < n_; i++)
+        {
+          rowsV[i] = V_.rowData(i);
+          rowsVInv[i] = VInv_.rowData(i);
+        }
+        MatrixKernels::gemmDiagBatch(n_, n_, n_, rowsV.data(), diagonals.data(), vt.size(), rowsVInv.data(), outputs.data());
+        return;
+      }
+    }
+    for (size_t k = 0; k < vt.size(); k++)
+    {
+      exp(vt[k], vO[k]);
+    }
+  }
+
+  /**
+   * @brief Compute \f$\exp(t.A).v\f$ in \f$O(n^2)\f$ (if A is diagonalizable).
+   *
+   * @param t The scalar multiplying A.
+   * @param v The vector.
+   * @param out [out] The product.
+   * @throw DimensionException If v has not the appropriate size.
+   */
+  void expTimesVector(Scalar t, const std::vector<Scalar>& v, std::vector<Scalar>& out) const
+  {
+    if (v.size() != n_)
+      throw DimensionException("MatrixExponential::expTimesVector.", v.size(), n_);
+    if (!diagonalizable_)
+    {
+      DenseMatrix<Scalar> E;
+      pade_(t, E);
+      matTimesVector_(E, v, out);
+      return;
+    }
+    // out = V . exp(tD) . (V^-1 . v)
+    std::vector<Scalar> w;
+    matTimesVector_(VInv_, v, w);
+    std::vector<Scalar> ew(n_);
+    for (size_t i = 0; i < n_; i++)
+    {
+      if (e_[i] > 0)
+      {
+        Scalar ea = std::exp(t * d_[i]);
+        Scalar c = ea * std::cos(t * e_[i]);
+        Scalar s = ea * std::sin(t * e_[i]);
+        ew[i] = c * w[i] + s * w[i + 1];
+        ew[i + 1] = -s * w[i] + c * w[i + 1];
+        i++;
+      }
+      else
+      {
+        ew[i] = std::exp(t * d_[i]) * w[i];
+      }
+    }
+    matTimesVector_(V_, ew, out);
+  }
+
+  /**
+   * @brief Compute \f$v.\exp(t.A)\f$ in \f$O(n^2)\f$ (if A is diagonalizable).
+   *
+   * @param t The scalar multiplying A.
+   * @param v The (row) vector.
+   * @param out [out] The product.
+   * @throw DimensionException If v has not the appropriate size.
+   */
+  void vectorTimesExp(Scalar t, const std::vector<Scalar>& v, std::vector<Scalar>& out) const
+  {
+    if (v.size() != n_)
+      throw DimensionException("MatrixExponential::vectorTimesExp.", v.size(), n_);
+    if (!diagonalizable_)
+    {
+      DenseMatrix<Scalar> E;
+      pade_(t, E);
+      vectorTimesMat_(v, E, out);
+      return;
+    }
+    // out = ((v . V) . exp(tD)) . V^-1
+    std::vector<Scalar> w;
+    vectorTimesMat_(v, V_, w);
+    std::vector<Scalar> we(n_);
+    for (size_t i = 0; i < n_; i++)
+    {
+      if (e_[i] > 0)
+      {
+        Scalar ea = std::exp(t * d_[i]);
+        Scalar c = ea * std::cos(t * e_[i]);
+        Scalar s = ea * std::sin(t * e_[i]);
+        we[i] = c * w[i] - s * w[i + 1];
+        we[i + 1] = s * w[i] + c * w[i + 1];
+        i++;
+      }
+      else
+      {
+        we[i] = std::exp(t * d_[i]) * w[i];
+      }
+    }
+    vectorTimesMat_(we, VInv_, out);
+  }
+
+private:
+  /**
+   * @brief Compute V . exp(t.D), in O(n^2).
+   */
+  void scaledEigenVectors_(Scalar t, DenseMatrix<Scalar>& VE) const
+  {
+    VE.resize(n_, n_);
+    for (size_t j = 0; j < n_; j++)
+    {
+      if (e_[j] > 0)
+      {
+        // 2x2 block for eigenvalues d_[j] +/- i.e_[j], on columns j and j + 1.
+        Scalar ea = std::exp(t * d_[j]);
+        Scalar c = ea * std::cos(t * e_[j]);
+        Scalar s = ea * std::sin(t * e_[j]);
+        for (size_t i = 0; i < n_; i++)
+        {
+          Scalar v0 = V_(i, j);
+          Scalar v1 = V_(i, j + 1);
+          VE(i, j) = c * v0 - s * v1;
+          VE(i, j + 1) = s * v0 + c * v1;
+        }
+        j++;
+      }
+      else
+      {
+        Scalar ed = std::exp(t * d_[j]);
+        for (size_t i = 0; i < n_; i++)
+        {
+          VE(i, j) = V_(i, j) * ed;
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Compute exp(t.A) with the scaling and squaring method.
+   */
+  void pade_(Scalar t, DenseMatrix<Scalar>& E) const
+  {
+    // Coefficients and thresholds for Padé approximants of degree 3, 5, 7, 9, 13 (Higham 2005).
+    static const double b3[] = { 120., 60., 12., 1. };
+    static const double b5[] = { 30240., 15120., 3360., 420., 30., 1. };
+    static const double b7[] = { 17297280., 8648640., 1995840., 277200., 25200., 1512., 56., 1. };
+    static const double b9[] = { 17643225600., 8821612800., 2075673600., 302702400., 30270240., 2162160., 110880., 3960., 90., 1. };
+    static const double b13[] = { 64764752532480000., 32382376266240000., 7771770303897600., 1187353796428800., 129060195264000., 10559470521600., 670442572800., 33522128640., 1323241920., 40840800., 960960., 16380., 182., 1. };
+    static const double theta[] = { 1.495585217958292e-2, 2.539398330063230e-1, 9.504178996162932e-1, 2.097847961257068, 5.371920351148152 };
+
+    DenseMatrix<Scalar> X(A_);
+    scale_(X, t);
+    Scalar norm = NumTools::abs<Scalar>(t) * normA_;
+
+    DenseMatrix<Scalar> I(n_, n_);
+    for (size_t i = 0; i < n_; i++) { I(i, i) = 1; }
+
+    unsigned int s = 0;
+    DenseMatrix<Scalar> U, V, X2, X4, X6, tmp;
+    mult_(X, X, X2);
+    if (norm <= theta[3])
+    {
+      const double* b = b9;
+      size_t m = 9;
+      if (norm <= theta[0])
+      {
+        b = b3; m = 3;
+      }
+      else if (norm <= theta[1])
+      {
+        b = b5; m = 5;
+      }
+      else if (norm <= theta[2])
+      {
+        b = b7; m = 7;
+      }
+      // U = X . sum_k b[2k+1] X^2k, V = sum_k b[2k] X^2k
+      DenseMatrix<Scalar> P(I);
+      DenseMatrix<Scalar> W(n_, n_);
+      V.resize(n_, n_);
+      for (size_t k = 0; 2 * k <= m; k++)
+      {
+        if (k > 0)
+        {
+          mult_(P, X2, tmp);
+          P = tmp;
+        }
+        axpy_(V, static_cast<Scalar>(b[2 * k]), P);
+        if (2 * k + 1 <= m)
+          axpy_(W, static_cast<Scalar>(b[2 * k + 1]), P);
+      }
+      mult_(X, W, U);
+    }
+    else
+    {
+      if (norm > theta[4])
+      {
+        s = static_cast<unsigned int>(std::ceil(std::log2(static_cast<double>(norm / static_cast<Scalar>(theta[4])))));
+        Scalar f = static_cast<Scalar>(std::ldexp(1., -static_cast<int>(s)));
+        scale_(X, f);
+        scale_(X2, f * f);
+      }
+      mult_(X2, X2, X4);
+      mult_(X2, X4, X6);
+      const double* b = b13;
+      // U = X . [X6 . (b13 X6 + b11 X4 + b9 X2) + b7 X6 + b5 X4 + b3 X2 + b1 I]
+      DenseMatrix<Scalar> W1(n_, n_), W2(n_, n_);
+      axpy_(W1, static_cast<Scalar>(b[13]), X6);
+      axpy_(W1, static_cast<Scalar>(b[11]), X4);
+      axpy_(W1, static_cast<Scalar>(b[9]), X2);
+      mult_(X6, W1, W2);
+      axpy_(W2, static_cast<Scalar>(b[7]), X6);
+      axpy_(W2, static_cast<Scalar>(b[5]), X4);
+      axpy_(W2, static_cast<Scalar>(b[3]), X2);
+      axpy_(W2, static_cast<Scalar>(b[1]), I);
+      mult_(X, W2, U);
+      // V = X6 . (b12 X6 + b10 X4 + b8 X2) + b6 X6 + b4 X4 + b2 X2 + b0 I
+      DenseMatrix<Scalar> Z(n_, n_);
+      axpy_(Z, static_cast<Scalar>(b[12]), X6);
+      axpy_(Z, static_cast<Scalar>(b[10]), X4);
+      axpy_(Z, static_cast<Scalar>(b[8]), X2);
+      mult_(X6, Z, V);
+      axpy_(V, static_cast<Scalar>(b[6]), X6);
+      axpy_(V, static_cast<Scalar>(b[4]), X4);
+      axpy_(V, static_cast<Scalar>(b[2]), X2);
+      axpy_(V, static_cast<Scalar>(b[0]), I);
+    }
+
+    // Solve (V - U) . E = (V + U)
+    DenseMatrix<Scalar> num(V), den(V);
+    axpy_(num, static_cast<Scalar>(1), U);
+    axpy_(den, static_cast<Scalar>(-1), U);
+    LUDecomposition<Scalar> lu(den);
+    lu.solve(num, E);
+
+    for (unsigned int k = 0; k < s; k++)
+    {
+      mult_(E, E, tmp);
+      E = tmp;
+    }
+  }
+
+  static void mult_(const DenseMatrix<Scalar>& A, const DenseMatrix<Scalar>& B, DenseMatrix<Scalar>& O)
+  {
+    size_t m = A.getNumberOfRows();
+    size_t k = A.getNumberOfColumns();
+    size_t n = B.getNumberOfColumns();
+    O.resize(m, n);
+    if constexpr (std::is_same<Scalar, double>::value)
+    {
+      MatrixKernels::gemm(m, n, k, A.data(), A.stride(), B.data(), B.stride(), O.data(), O.stride());
+    }
+    else
+    {
+      for (size_t i = 0; i < m; i++)
+      {
+        Scalar* oi = O.rowData(i);
+        for (size_t j = 0; j < n; j++) { oi[j] = 0; }
+        for (size_t p = 0; p < k; p++)
+        {
+          Scalar aip = A(i, p);
+          const Scalar* bp = B.rowData(p);
+          for (size_t j = 0; j < n; j++) { oi[j] += aip * bp[j]; }
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Y += a.X
+   */
+  static void axpy_(DenseMatrix<Scalar>& Y, Scalar a, const DenseMatrix<Scalar>& X)
+  {
+    for (size_t i = 0; i < Y.getNumberOfRows(); i++)
+    {
+      Scalar* yi = Y.rowData(i);
+      const Scalar* xi = X.rowData(i);
+      for (size_t j = 0; j < Y.getNumberOfColumns(); j++) { yi[j] += a * xi[j]; }
+    }
+  }
+
+  static void scale_(DenseMatrix<Scalar>& X, Scalar a)
+  {
+    for (size_t i = 0; i < X.getNumberOfRows(); i++)
+    {
+      Scalar* xi = X.rowData(i);
+      for (size_t j = 0; j < X.getNumberOfColumns(); j++) { xi[j] *= a; }
+    }
+  }
+
+  static void matTimesVector_(const DenseMatrix<Scalar>& M, const std::vector<Scalar>& v, std::vector<Scalar>& out)
+  {
+    out.assign(M.getNumberOfRows(), 0);
+    for (size_t i = 0; i < M.getNumberOfRows(); i++)
+    {
+      const Scalar* mi = M.rowData(i);
+      Scalar s = 0;
+      for (size_t j = 0; j < M.getNumberOfColumns(); j++) { s += mi[j] * v[j]; }
+      out[i] = s;
+    }
+  }
+
+  static void vectorTimesMat_(const std::vector<Scalar>& v, const DenseMatrix<Scalar>& M, std::vector<Scalar>& out)
+  {
+    out.assign(M.getNumberOfColumns(), 0);
+    for (size_t i = 0; i < M.getNumberOfRows(); i++)
+    {
+      const Scalar* mi = M.rowData(i);
+      Scalar vi = v[i];
+      for (size_t j = 0; j < M.getNumberOfColumns(); j++) { out[j] += vi * mi[j]; }
+    }
+  }
+
+  static void copy_(const DenseMatrix<Scalar>& A, Matrix<Scalar>& O)
+  {
+    O.resize(A.getNumberOfRows(), A.getNumberOfColumns());
+    for (size_t i = 0; i < A.getNumberOfRows(); i++)
+    {
+      const Scalar* ai = A.rowData(i);
+      for (size_t j = 0; j < A.getNumberOfColumns(); j++) { O(i, j) = ai[j]; }
+    }
+  }
+
+  /**
+   * @return The 1-norm (maximum absolute column sum) of a matrix.
+   */
+  static Scalar norm1_(const DenseMatrix<Scalar>& A)
+  {
+    std::vector<Scalar> sums(A.getNumberOfColumns(), 0);
+    for (size_t i = 0; i < A.getNumberOfRows(); i++)
+    {
+      const Scalar* ai = A.rowData(i);
+      for (size_t j = 0; j < A.getNumberOfColumns(); j++) { sums[j] += NumTools::abs<Scalar>(ai[j]); }
+    }
+    Scalar norm = 0;
+    for (auto s : sums) { norm = NumTools::max<Scalar>(norm, s); }
+    return norm;
+  }
+};
+} // end of namespace bpp.
+#endif // BPP_NUMERIC_MATRIX_MATRIXEXPONENTIAL_H
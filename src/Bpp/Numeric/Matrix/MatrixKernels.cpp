@@ -0,0 +1,614 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "MatrixKernels.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define BPP_MATRIXKERNELS_X86
+#include <immintrin.h>
+#endif
+
+using namespace bpp;
+using namespace std;
+
+const size_t MatrixKernels::DENSE_THRESHOLD = 512;
+
+namespace
+{
+/******************************************************************************/
+
+// Cache blocking parameters. MC must be a multiple of all MR, and NC of all NR.
+const size_t KC = 256;
+const size_t MC = 96;
+const size_t NC = 2048;
+
+// Largest register tile among all micro-kernels.
+const size_t MR_MAX = 8;
+const size_t NR_MAX = 16;
+
+/**
+ * A micro-kernel computes a mr x nr tile of C from a packed sliver of A
+ * (kc x mr, column after column) and a packed sliver of B (kc x nr, row after
+ * row). Results are written in c[i][col + j], added to the previous content if
+ * accumulate is true.
+ */
+typedef void (*MicroKernel)(size_t kc, const double* a, const double* b, double* const* c, size_t col, bool accumulate);
+
+struct KernelSpec
+{
+  size_t mr;
+  size_t nr;
+  MicroKernel kernel;
+};
+
+/******************************************************************************/
+
+template<size_t MR, size_t NR>
+void kernelScalar(size_t kc, const double* a, const double* b, double* const* c, size_t col, bool accumulate)
+{
+  double acc[MR][NR] = {};
+  for (size_t p = 0; p < kc; ++p)
+  {
+    for (size_t i = 0; i < MR; ++i)
+    {
+      double ai = a[i];
+      for (size_t j = 0; j < NR; ++j)
+      {
+        acc[i][j] += ai * b[j];
+      }
+    }
+    a += MR;
+    b += NR;
+  }
+  for (size_t i = 0; i < MR; ++i)
+  {
+    double* ci = c[i] + col;
+    if (accumulate)
+      for (size_t j = 0; j < NR; ++j) { ci[j] += acc[i][j]; }
+    else
+      for (size_t j = 0; j < NR; ++j) { ci[j] = acc[i][j]; }
+  }
+}
+
+/**
+ * A matrix-vector kernel computes y = A . x, A having m rows of n elements
+ * separated by lda.
+ */
+typedef void (*GemvKernel)(size_t m, size_t n, const double* A, size_t lda, const double* x, double* y);
+
+void gemvScalar(size_t m, size_t n, const double* A, size_t lda, const double* x, double* y)
+{
+  size_t i = 0;
+  for ( ; i + 4 <= m; i += 4)
+  {
+    const double* a0 = A + i * lda;
+    const double* a1 = a0 + lda;
+    const double* a2 = a1 + lda;
+    const double* a3 = a2 + lda;
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (size_t p = 0; p < n; ++p)
+    {
+      double xp = x[p];
+      s0 += a0[p] * xp;
+      s1 += a1[p] * xp;
+      s2 += a2[p] * xp;
+      s3 += a3[p] * xp;
+    }
+    y[i] = s0;
+    y[i + 1] = s1;
+    y[i + 2] = s2;
+    y[i + 3] = s3;
+  }
+  for ( ; i < m; ++i)
+  {
+    const double* ai = A + i * lda;
+    double s = 0;
+    for (size_t p = 0; p < n; ++p)
+    {
+      s += ai[p] * x[p];
+    }
+    y[i] = s;
+  }
+}
+
+#ifdef BPP_MATRIXKERNELS_X86
+
+__attribute__((target("avx2,fma")))
+void kernelAvx2(size_t kc, const double* a, const double* b, double* const* c, size_t col, bool accumulate)
+{
+  // 6 x 8 tile: 12 accumulators.
+  __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+  __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+  __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+  __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+  __m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd();
+  __m256d c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+  for (size_t p = 0; p < kc; ++p)
+  {
+    __m256d b0 = _mm256_loadu_pd(b);
+    __m256d b1 = _mm256_loadu_pd(b + 4);
+    __m256d ai;
+    ai = _mm256_broadcast_sd(a);
+    c00 = _mm256_fmadd_pd(ai, b0, c00); c01 = _mm256_fmadd_pd(ai, b1, c01);
+    ai = _mm256_broadcast_sd(a + 1);
+    c10 = _mm256_fmadd_pd(ai, b0, c10); c11 = _mm256_fmadd_pd(ai, b1, c11);
+    ai = _mm256_broadcast_sd(a + 2);
+    c20 = _mm256_fmadd_pd(ai, b0, c20); c21 = _mm256_fmadd_pd(ai, b1, c21);
+    ai = _mm256_broadcast_sd(a + 3);
+    c30 = _mm256_fmadd_pd(ai, b0, c30); c31 = _mm256_fmadd_pd(ai, b1, c31);
+    ai = _mm256_broadcast_sd(a + 4);
+    c40 = _mm256_fmadd_pd(ai, b0, c40); c41 = _mm256_fmadd_pd(ai, b1, c41);
+    ai = _mm256_broadcast_sd(a + 5);
+    c50 = _mm256_fmadd_pd(ai, b0, c50); c51 = _mm256_fmadd_pd(ai, b1, c51);
+    a += 6;
+    b += 8;
+  }
+  __m256d acc[6][2] = {
+    { c00, c01 }, { c10, c11 }, { c20, c21 }, { c30, c31 }, { c40, c41 }, { c50, c51 }
+  };
+  for (size_t i = 0; i < 6; ++i)
+  {
+    double* ci = c[i] + col;
+    if (accumulate)
+    {
+      acc[i][0] = _mm256_add_pd(acc[i][0], _mm256_loadu_pd(ci));
+      acc[i][1] = _mm256_add_pd(acc[i][1], _mm256_loadu_pd(ci + 4));
+    }
+    _mm256_storeu_pd(ci, acc[i][0]);
+    _mm256_storeu_pd(ci + 4, acc[i][1]);
+  }
+}
+
+__attribute__((target("avx512f")))
+void kernelAvx512(size_t kc, const double* a, const double* b, double* const* c, size_t col, bool accumulate)
+{
+  // 8 x 16 tile: 16 accumulators.
+  __m512d acc[8][2];
+#pragma GCC unroll 8
+  for (size_t i = 0; i < 8; ++i)
+  {
+    acc[i][0] = _mm512_setzero_pd();
+    acc[i][1] = _mm512_setzero_pd();
+  }
+  for (size_t p = 0; p < kc; ++p)
+  {
+    __m512d b0 = _mm512_loadu_pd(b);
+    __m512d b1 = _mm512_loadu_pd(b + 8);
+#pragma GCC unroll 8
+    for (size_t i = 0; i < 8; ++i)
+    {
+      __m512d ai = _mm512_set1_pd(a[i]);
+      acc[i][0] = _mm512_fmadd_pd(ai, b0, acc[i][0]);
+      acc[i][1] = _mm512_fmadd_pd(ai, b1, acc[i][1]);
+    }
+    a += 8;
+    b += 16;
+  }
+  for (size_t i = 0; i < 8; ++i)
+  {
+    double* ci = c[i] + col;
+    if (accumulate)
+    {
+      acc[i][0] = _mm512_add_pd(acc[i][0], _mm512_loadu_pd(ci));
+      acc[i][1] = _mm512_add_pd(acc[i][1], _mm512_loadu_pd(ci + 8));
+    }
+    _mm512_storeu_pd(ci, acc[i][0]);
+    _mm512_storeu_pd(ci + 8, acc[i][1]);
+  }
+}
+
+__attribute__((target("avx2,fma")))
+inline double hsumAvx2(__m256d v)
+{
+  __m128d s = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+  return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+}
+
+__attribute__((target("avx2,fma")))
+void gemvAvx2(size_t m, size_t n, const double* A, size_t lda, const double* x, double* y)
+{
+  size_t n4 = n & ~static_cast<size_t>(3);
+  size_t i = 0;
+  for ( ; i + 4 <= m; i += 4)
+  {
+    const double* a0 = A + i * lda;
+    const double* a1 = a0 + lda;
+    const double* a2 = a1 + lda;
+    const double* a3 = a2 + lda;
+    __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+    __m256d s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+    for (size_t p = 0; p < n4; p += 4)
+    {
+      __m256d xp = _mm256_loadu_pd(x + p);
+      s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a0 + p), xp, s0);
+      s1 = _mm256_fmadd_pd(_mm256_loadu_pd(a1 + p), xp, s1);
+      s2 = _mm256_fmadd_pd(_mm256_loadu_pd(a2 + p), xp, s2);
+      s3 = _mm256_fmadd_pd(_mm256_loadu_pd(a3 + p), xp, s3);
+    }
+    // Horizontal sums of the four accumulators in one vector:
+    __m256d h01 = _mm256_hadd_pd(s0, s1);
+    __m256d h23 = _mm256_hadd_pd(s2, s3);
+    __m256d r = _mm256_add_pd(_mm256_permute2f128_pd(h01, h23, 0x20), _mm256_permute2f128_pd(h01, h23, 0x31));
+    _mm256_storeu_pd(y + i, r);
+    for (size_t p = n4; p < n; ++p)
+    {
+      double xp = x[p];
+      y[i] += a0[p] * xp;
+      y[i + 1] += a1[p] * xp;
+      y[i + 2] += a2[p] * xp;
+      y[i + 3] += a3[p] * xp;
+    }
+  }
+  for ( ; i < m; ++i)
+  {
+    const double* ai = A + i * lda;
+    __m256d s = _mm256_setzero_pd();
+    for (size_t p = 0; p < n4; p += 4)
+    {
+      s = _mm256_fmadd_pd(_mm256_loadu_pd(ai + p), _mm256_loadu_pd(x + p), s);
+    }
+    double t = hsumAvx2(s);
+    for (size_t p = n4; p < n; ++p)
+    {
+      t += ai[p] * x[p];
+    }
+    y[i] = t;
+  }
+}
+
+__attribute__((target("avx512f")))
+inline double hsumAvx512(__m512d v)
+{
+  alignas(64) double t[8];
+  _mm512_store_pd(t, v);
+  return ((t[0] + t[1]) + (t[2] + t[3])) + ((t[4] + t[5]) + (t[6] + t[7]));
+}
+
+__attribute__((target("avx512f")))
+void gemvAvx512(size_t m, size_t n, const double* A, size_t lda, const double* x, double* y)
+{
+  size_t n8 = n & ~static_cast<size_t>(7);
+  __mmask8 tail = static_cast<__mmask8>((1u << (n - n8)) - 1);
+  __m512d xt = _mm512_maskz_loadu_pd(tail, x + n8);
+  size_t i = 0;
+  for ( ; i + 4 <= m; i += 4)
+  {
+    const double* a0 = A + i * lda;
+    const double* a1 = a0 + lda;
+    const double* a2 = a1 + lda;
+    const double* a3 = a2 + lda;
+    __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd();
+    __m512d s2 = _mm512_setzero_pd(), s3 = _mm512_setzero_pd();
+    for (size_t p = 0; p < n8; p += 8)
+    {
+      __m512d xp = _mm512_loadu_pd(x + p);
+      s0 = _mm512_fmadd_pd(_mm512_loadu_pd(a0 + p), xp, s0);
+      s1 = _mm512_fmadd_pd(_mm512_loadu_pd(a1 + p), xp, s1);
+      s2 = _mm512_fmadd_pd(_mm512_loadu_pd(a2 + p), xp, s2);
+      s3 = _mm512_fmadd_pd(_mm512_loadu_pd(a3 + p), xp, s3);
+    }
+    if (tail)
+    {
+      s0 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(tail, a0 + n8), xt, s0);
+      s1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(tail, a1 + n8), xt, s1);
+      s2 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(tail, a2 + n8), xt, s2);
+      s3 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(tail, a3 + n8), xt, s3);
+    }
+    y[i] = hsumAvx512(s0);
+    y[i + 1] = hsumAvx512(s1);
+    y[i + 2] = hsumAvx512(s2);
+    y[i + 3] = hsumAvx512(s3);
+  }
+  for ( ; i < m; ++i)
+  {
+    const double* ai = A + i * lda;
+    __m512d s = _mm512_setzero_pd();
+    for (size_t p = 0; p < n8; p += 8)
+    {
+      s = _mm512_fmadd_pd(_mm512_loadu_pd(ai + p), _mm512_loadu_pd(x + p), s);
+    }
+    if (tail)
+      s = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(tail, ai + n8), xt, s);
+    y[i] = hsumAvx512(s);
+  }
+}
+
+#endif
+
+/******************************************************************************/
+
+MatrixKernels::SimdLevel detectSimdLevel()
+{
+#ifdef BPP_MATRIXKERNELS_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f"))
+    return MatrixKernels::SimdLevel::AVX512;
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    return MatrixKernels::SimdLevel::AVX2;
+#endif
+  return MatrixKernels::SimdLevel::SCALAR;
+}
+
+MatrixKernels::SimdLevel supportedLevel()
+{
+  static const MatrixKernels::SimdLevel level = detectSimdLevel();
+  return level;
+}
+
+atomic<int>& currentLevel()
+{
+  static atomic<int> level(static_cast<int>(supportedLevel()));
+  return level;
+}
+
+KernelSpec getKernel(MatrixKernels::SimdLevel level)
+{
+  switch (level)
+  {
+#ifdef BPP_MATRIXKERNELS_X86
+  case MatrixKernels::SimdLevel::AVX512:
+    return KernelSpec{8, 16, &kernelAvx512};
+  case MatrixKernels::SimdLevel::AVX2:
+    return KernelSpec{6, 8, &kernelAvx2};
+#endif
+  default:
+    return KernelSpec{4, 8, &kernelScalar<4, 8>};
+  }
+}
+
+GemvKernel getGemvKernel(MatrixKernels::SimdLevel level)
+{
+  switch (level)
+  {
+#ifdef BPP_MATRIXKERNELS_X86
+  case MatrixKernels::SimdLevel::AVX512:
+    return &gemvAvx512;
+  case MatrixKernels::SimdLevel::AVX2:
+    return &gemvAvx2;
+#endif
+  default:
+    return &gemvScalar;
+  }
+}
+
+/******************************************************************************/
+
+/**
+ * Pack rows [i0, i0 + mc) and columns [p0, p0 + kc) of A into slivers of mr
+ * rows, stored column after column. Incomplete slivers are padded with zeros.
+ * If d is not null, column p of A is multiplied by d[p] on the fly.
+ */
+void packA(size_t mc, size_t kc, const double* const* A, const double* d, size_t i0, size_t p0, size_t mr, double* ap)
+{
+  for (size_t ir = 0; ir < mc; ir += mr)
+  {
+    size_t mrEff = min(mr, mc - ir);
+    for (size_t i = 0; i < mrEff; ++i)
+    {
+      const double* ai = A[i0 + ir + i] + p0;
+      if (d)
+      {
+        const double* dp = d + p0;
+        for (size_t p = 0; p < kc; ++p)
+        {
+          ap[p * mr + i] = ai[p] * dp[p];
+        }
+      }
+      else
+      {
+        for (size_t p = 0; p < kc; ++p)
+        {
+          ap[p * mr + i] = ai[p];
+        }
+      }
+    }
+    for (size_t i = mrEff; i < mr; ++i)
+    {
+      for (size_t p = 0; p < kc; ++p)
+      {
+        ap[p * mr + i] = 0.;
+      }
+    }
+    ap += mr * kc;
+  }
+}
+
+/**
+ * Pack rows [p0, p0 + kc) and columns [j0, j0 + nc) of B into slivers of nr
+ * columns, stored row after row. Incomplete slivers are padded with zeros.
+ */
+void packB(size_t kc, size_t nc, const double* const* B, size_t p0, size_t j0, size_t nr, double* bp)
+{
+  for (size_t jr = 0; jr < nc; jr += nr)
+  {
+    size_t nrEff = min(nr, nc - jr);
+    for (size_t p = 0; p < kc; ++p)
+    {
+      const double* bpj = B[p0 + p] + j0 + jr;
+      double* dest = bp + p * nr;
+      size_t j = 0;
+      for ( ; j < nrEff; ++j) { dest[j] = bpj[j]; }
+      for ( ; j < nr; ++j) { dest[j] = 0.; }
+    }
+    bp += nr * kc;
+  }
+}
+
+/******************************************************************************/
+
+
+/**
+ * Compute C[t] (+)= A . diag(D[t]) . B for t in [0, nBatch), or C[0] (+)= A . B
+ * if D is null. Panels of B are packed once and shared by all products.
+ */
+void gemmDriver(size_t m, size_t n, size_t k,
+                const double* const* A,
+                const double* const* D,
+                size_t nBatch,
+                const double* const* B,
+                double* const* const* C,
+                bool accumulate)
+{
+  if (m == 0 || n == 0)
+    return;
+  if (k == 0)
+  {
+    if (!accumulate)
+      for (size_t t = 0; t < nBatch; ++t)
+        for (size_t i = 0; i < m; ++i) { fill(C[t][i], C[t][i] + n, 0.); }
+    return;
+  }
+
+  KernelSpec spec = getKernel(MatrixKernels::getSimdLevel());
+  const size_t mr = spec.mr;
+  const size_t nr = spec.nr;
+
+  // Packing buffers are kept between calls to avoid reallocations.
+  thread_local vector<double> aPack;
+  thread_local vector<double> bPack;
+  aPack.resize(MC * KC);
+  bPack.resize(KC * NC);
+
+  // Edge tiles are computed in a local buffer then copied.
+  double edge[MR_MAX * NR_MAX];
+  double* edgeRows[MR_MAX];
+  for (size_t i = 0; i < MR_MAX; ++i) { edgeRows[i] = edge + i * nr; }
+
+  for (size_t jc = 0; jc < n; jc += NC)
+  {
+    size_t nc = min(NC, n - jc);
+    for (size_t pc = 0; pc < k; pc += KC)
+    {
+      size_t kc = min(KC, k - pc);
+      bool acc = accumulate || pc > 0;
+      packB(kc, nc, B, pc, jc, nr, bPack.data());
+      for (size_t t = 0; t < nBatch; ++t)
+      {
+        double* const* Ct = C[t];
+        for (size_t ic = 0; ic < m; ic += MC)
+        {
+          size_t mc = min(MC, m - ic);
+          packA(mc, kc, A, D ? D[t] : nullptr, ic, pc, mr, aPack.data());
+          for (size_t jr = 0; jr < nc; jr += nr)
+          {
+            size_t nrEff = min(nr, nc - jr);
+            const double* bp = bPack.data() + jr * kc;
+            for (size_t ir = 0; ir < mc; ir += mr)
+            {
+              size_t mrEff = min(mr, mc - ir);
+              const double* ap = aPack.data() + ir * kc;
+              if (mrEff == mr && nrEff == nr)
+              {
+                spec.kernel(kc, ap, bp, Ct + ic + ir, jc + jr, acc);
+              }
+              else
+              {
+                spec.kernel(kc, ap, bp, edgeRows, 0, false);
+                for (size_t i = 0; i < mrEff; ++i)
+                {
+                  double* ci = Ct[ic + ir + i] + jc + jr;
+                  const double* ei = edgeRows[i];
+                  if (acc)
+                    for (size_t j = 0; j < nrEff; ++j) { ci[j] += ei[j]; }
+                  else
+                    for (size_t j = 0; j < nrEff; ++j) { ci[j] = ei[j]; }
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+} // end of anonymous namespace.
+
+/******************************************************************************/
+
+void MatrixKernels::gemm(size_t m, size_t n, size_t k,
+                         const double* const* A,
+                         const double* const* B,
+                         double* const* C,
+                         bool accumulate)
+{
+  gemmDriver(m, n, k, A, nullptr, 1, B, &C, accumulate);
+}
+
+/******************************************************************************/
+
+void MatrixKernels::gemmDiag(size_t m, size_t n, size_t k,
+                             const double* const* A,
+                             const double* D,
+                             const double* const* B,
+                             double* const* C,
+                             bool accumulate)
+{
+  gemmDriver(m, n, k, A, &D, 1, B, &C, accumulate);
+}
+
+/******************************************************************************/
+
+void MatrixKernels::gemmDiagBatch(size_t m, size_t n, size_t k,
+                                  const double* const* A,
+                                  const double* const* D,
+                                  size_t nBatch,
+                                  const double* const* B,
+                                  double* const* const* C)
+{
+  gemmDriver(m, n, k, A, D, nBatch, B, C, false);
+}
+
+/******************************************************************************/
+
+void MatrixKernels::gemm(size_t m, size_t n, size_t k,
+                         const double* A, size_t lda,
+                         const double* B, size_t ldb,
+                         double* C, size_t ldc)
+{
+  vector<const double*> aRows(m), bRows(k);
+  vector<double*> cRows(m);
+  for (size_t i = 0; i < m; ++i)
+  {
+    aRows[i] = A + i * lda;
+    cRows[i] = C + i * ldc;
+  }
+  for (size_t p = 0; p < k; ++p)
+  {
+    bRows[p] = B + p * ldb;
+  }
+  gemm(m, n, k, aRows.data(), bRows.data(), cRows.data());
+}
+
+/******************************************************************************/
+
+void MatrixKernels::gemv(size_t m, size_t n,
+                         const double* A, size_t lda,
+                         const double* x,
+                         double* y)
+{
+  getGemvKernel(getSimdLevel())(m, n, A, lda, x, y);
+}
+
+/******************************************************************************/
+
+MatrixKernels::SimdLevel MatrixKernels::getSimdLevel()
+{
+  return static_cast<SimdLevel>(currentLevel().load(memory_order_relaxed));
+}
+
+MatrixKernels::SimdLevel MatrixKernels::getSupportedSimdLevel()
+{
+  return supportedLevel();
+}
+
+void MatrixKernels::setSimdLevel(SimdLevel level)
+{
+  currentLevel().store(static_cast<int>(min(level, supportedLevel())), memory_order_relaxed);
+}
+
+/******************************************************************************/
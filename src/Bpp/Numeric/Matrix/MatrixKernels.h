@@ -0,0 +1,167 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_NUMERIC_MATRIX_MATRIXKERNELS_H
+#define BPP_NUMERIC_MATRIX_MATRIXKERNELS_H
+
+#include <cstddef>
+
+namespace bpp
+{
+/**
+ * @brief Low-level dense linear algebra kernels on raw double storage.
+ *
+ * These functions are used by MatrixTools when the operands have a storage
+ * that can be addressed directly (DenseMatrix, DenseMatrixView, LinearMatrix,
+ * RowMatrix), bypassing the virtual element accessors of the Matrix interface.
+ *
+ * The matrix product is computed in the spirit of the BLIS/GotoBLAS design:
+ * operands are packed into cache-sized panels, and a register-blocked
+ * micro-kernel computes small tiles of the output. Several micro-kernels are
+ * compiled in (portable scalar, AVX2+FMA and AVX-512 on x86 targets built with
+ * GCC or Clang), and the best one supported by the running CPU is selected at
+ * runtime.
+ *
+ * All matrices are stored by rows, and described by an array of row pointers,
+ * so that storages with non-contiguous rows (like RowMatrix) can be used
+ * without copy.
+ */
+class MatrixKernels
+{
+public:
+  /**
+   * @brief Instruction sets for which a micro-kernel is available.
+   */
+  enum class SimdLevel { SCALAR = 0, AVX2 = 1, AVX512 = 2 };
+
+  /**
+   * @brief Minimum number of multiply-adds (m.n.k) for which MatrixTools
+   * uses the dense kernels instead of the generic implementation.
+   */
+  static const size_t DENSE_THRESHOLD;
+
+public:
+  /**
+   * @brief Compute C = A . B.
+   *
+   * @param m Number of rows of A and C.
+   * @param n Number of columns of B and C.
+   * @param k Number of columns of A and rows of B.
+   * @param A [in] Row pointers of A (m rows of at least k elements).
+   * @param B [in] Row pointers of B (k rows of at least n elements).
+   * @param C [out] Row pointers of C (m rows of at least n elements).
+   * C must not overlap with A or B.
+   * @param accumulate If true, compute C += A . B instead.
+   */
+  static void gemm(size_t m, size_t n, size_t k,
+                   const double* const* A,
+                   const double* const* B,
+                   double* const* C,
+                   bool accumulate = false);
+
+  /**
+   * @brief Compute C = A . diag(D) . B.
+   *
+   * The columns of A are scaled by D while A is packed, so that this costs
+   * the same as a plain product.
+   *
+   * @param m Number of rows of A and C.
+   * @param n Number of columns of B and C.
+   * @param k Number of columns of A, rows of B and size of D.
+   * @param A [in] Row pointers of A (m rows of at least k elements).
+   * @param D [in] The diagonal elements (k elements).
+   * @param B [in] Row pointers of B (k rows of at least n elements).
+   * @param C [out] Row pointers of C (m rows of at least n elements).
+   * C must not overlap with A or B.
+   * @param accumulate If true, compute C += A . diag(D) . B instead.
+   */
+  static void gemmDiag(size_t m, size_t n, size_t k,
+                       const double* const* A,
+                       const double* D,
+                       const double* const* B,
+                       double* const* C,
+                       bool accumulate = false);
+
+  /**
+   * @brief Compute C[t] = A . diag(D[t]) . B for several diagonal matrices.
+   *
+   * All products are computed in one pass: the panels of B are packed once
+   * and shared by all diagonals, which is faster than independent calls to
+   * gemmDiag when many diagonals are used with the same A and B, as in the
+   * computation of \f$\exp(t.Q)\f$ for many t from a diagonalization of Q.
+   *
+   * @param m Number of rows of A and C[t].
+   * @param n Number of columns of B and C[t].
+   * @param k Number of columns of A, rows of B and size of D[t].
+   * @param A [in] Row pointers of A (m rows of at least k elements).
+   * @param D [in] The nBatch diagonals (k elements each).
+   * @param nBatch The number of diagonals.
+   * @param B [in] Row pointers of B (k rows of at least n elements).
+   * @param C [out] nBatch arrays of row pointers, one for each output matrix.
+   */
+  static void gemmDiagBatch(size_t m, size_t n, size_t k,
+                            const double* const* A,
+                            const double* const* D,
+                            size_t nBatch,
+                            const double* const* B,
+                            double* const* const* C);
+
+  /**
+   * @brief Compute C = A . B, with matrices stored by rows with a constant stride.
+   *
+   * @param m Number of rows of A and C.
+   * @param n Number of columns of B and C.
+   * @param k Number of columns of A and rows of B.
+   * @param A [in] Data of A.
+   * @param lda Distance between two successive rows of A.
+   * @param B [in] Data of B.
+   * @param ldb Distance between two successive rows of B.
+   * @param C [out] Data of C.
+   * @param ldc Distance between two successive rows of C.
+   */
+  static void gemm(size_t m, size_t n, size_t k,
+                   const double* A, size_t lda,
+                   const double* B, size_t ldb,
+                   double* C, size_t ldc);
+
+  /**
+   * @brief Compute y = A . x, with A stored by rows with a constant stride.
+   *
+   * Each element of y is the dot product of a row of A with x. Several rows are
+   * processed at once, with the same instruction sets as the matrix product.
+   *
+   * @param m Number of rows of A and size of y.
+   * @param n Number of columns of A and size of x.
+   * @param A [in] Data of A.
+   * @param lda Distance between two successive rows of A.
+   * @param x [in] A vector of n elements.
+   * @param y [out] A vector of m elements, not overlapping with A or x.
+   */
+  static void gemv(size_t m, size_t n,
+                   const double* A, size_t lda,
+                   const double* x,
+                   double* y);
+
+  /**
+   * @return The instruction set currently used by the kernels.
+   */
+  static SimdLevel getSimdLevel();
+
+  /**
+   * @return The best instruction set supported by the running CPU.
+   */
+  static SimdLevel getSupportedSimdLevel();
+
+  /**
+   * @brief Restrict the instruction set used by the kernels.
+   *
+   * The level actually used is the minimum of the requested one and the one
+   * supported by the CPU. This is mostly useful for testing and benchmarking.
+   *
+   * @param level The maximum level to use.
+   */
+  static void setSimdLevel(SimdLevel level);
+};
+} // end of namespace bpp.
+#endif // BPP_NUMERIC_MATRIX_MATRIXKERNELS_H
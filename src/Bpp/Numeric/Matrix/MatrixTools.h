@@ -7,12 +7,16 @@
 
 #include <cstdio>
 #include <iostream>
+#include <type_traits>
+#include <typeinfo>
 
 #include "../../Io/OutputStream.h"
 #include "../VectorTools.h"
 #include "EigenValue.h"
 #include "LUDecomposition.h"
 #include "Matrix.h"
+#include "MatrixExponential.h"
+#include "MatrixKernels.h"
 
 namespace bpp
 {
@@ -213,6 +217,14 @@ public:
   }
 
   /**
+   * @brief Product of two matrices.
+   *
+   * If all three matrices are DenseMatrix<double>, DenseMatrixView<double>,
+   * LinearMatrix<double> or RowMatrix<double>, the product is computed
+   * directly on their storage with the cache-blocked kernel of
+   * MatrixKernels::gemm. In that case O must not share data with A or B.
+   * Otherwise, a generic implementation using the Matrix interface is used.
+   *
    * @param A [in] First matrix.
    * @param B [in] Second matrix.
    * @param O [out] The product of two matrices.
@@ -226,6 +238,11 @@ public:
     size_t ncB = B.getNumberOfColumns();
     if (ncA != nrB) throw DimensionException("MatrixTools::mult(). nrows B != ncols A.", nrB, ncA);
     O.resize(nrA, ncB);
+    if constexpr (std::is_same<Scalar, double>::value)
+    {
+      if (multDense_(A, B, O))
+        return;
+    }
     for (size_t i = 0; i < nrA; i++)
     {
       for (size_t j = 0; j < ncB; j++)
@@ -280,6 +297,10 @@ public:
    * Since D is a diagonal matrix, this function is more efficient than doing
    * mult(mult(A, diag(D)), B), which involves two 0(n^3) operations.
    *
+   * For matrices with a storage known by MatrixKernels (see mult(A, B, O)),
+   * the columns of A are scaled by D once, and the product is computed with
+   * the dense kernel MatrixKernels::gemmDiag.
+   *
    * @param A [in] The first matrix.
    * @param D [in] The diagonal matrix (only diagonal elements in a vector)
    * @param B [in] The second matrix.
@@ -296,6 +317,11 @@ public:
     if (ncA != nrB) throw DimensionException("MatrixTools::mult(). nrows B != ncols A.", nrB, ncA);
     if (ncA != D.size()) throw DimensionException("MatrixTools::mult(). Vector size is not equal to matrix size.", D.size(), ncA);
     O.resize(nrA, ncB);
+    if constexpr (std::is_same<Scalar, double>::value)
+    {
+      if (multDiagDense_(A, D, B, O))
+        return;
+    }
     for (size_t i = 0; i < nrA; i++)
     {
       for (size_t j = 0; j < ncB; j++)
@@ -326,6 +352,10 @@ public:
    * @param O  [out] The dot product of two matrices (real part)
    * @param iO [out] The dot product of two matrices(imaginary part)
    * @throw DimensionException If matrices have not the appropriate size.
+   *
+   * For matrices with a storage known by MatrixKernels, the columns of A + i.iA
+   * are scaled by D + i.iD once, and the product is computed with four real
+   * dense products.
    */
   template<class Scalar>
   static void mult(const Matrix<Scalar>& A, const Matrix<Scalar>& iA, const std::vector<Scalar>& D, const std::vector<Scalar>& iD, const Matrix<Scalar>& B, const Matrix<Scalar>& iB, Matrix<Scalar>& O, Matrix<Scalar>& iO)
@@ -336,8 +366,15 @@ public:
     size_t ncB = B.getNumberOfColumns();
     if (ncA != nrB) throw DimensionException("MatrixTools::mult(). nrows B != ncols A.", nrB, ncA);
     if (ncA != D.size()) throw DimensionException("MatrixTools::mult(). Vector size is not equal to matrix size.", D.size(), ncA);
+    if (ncA != iD.size()) throw DimensionException("MatrixTools::mult(). Vector size is not equal to matrix size.", iD.size(), ncA);
     O.resize(nrA, ncB);
-    Scalar ab, iaib, iab, aib;
+    iO.resize(nrA, ncB);
+    if constexpr (std::is_same<Scalar, double>::value)
+    {
+      if (multDiagDense_(A, iA, D, iD, B, iB, O, iO))
+        return;
+    }
+    Scalar ab, aib;
 
     for (size_t i = 0; i < nrA; i++)
     {
@@ -403,6 +440,48 @@ public:
     }
   }
 
+  /**
+   * @brief Compute A . D[t] . B for several diagonal matrices D[t] in one pass.
+   *
+   * This is typically used to get \f$\exp(t.Q) = V . \exp(t.\Lambda) . V^{-1}\f$
+   * for many values of t, from one diagonalization of Q. For matrices with
+   * a storage known by MatrixKernels, all products are computed by
+   * MatrixKernels::gemmDiagBatch, sharing the packing of B.
+   *
+   * @param A [in] The first matrix.
+   * @param vD [in] The diagonal matrices (only diagonal elements in vectors).
+   * @param B [in] The second matrix.
+   * @param vO [out] The result matrices, one for each element of vD.
+   * @throw DimensionException If matrices have not the appropriate size.
+   */
+  template<class Scalar, class MatrixO>
+  static void mult(const Matrix<Scalar>& A, const std::vector<std::vector<Scalar>>& vD, const Matrix<Scalar>& B, std::vector<MatrixO>& vO)
+  {
+    size_t ncA = A.getNumberOfColumns();
+    size_t nrA = A.getNumberOfRows();
+    size_t nrB = B.getNumberOfRows();
+    size_t ncB = B.getNumberOfColumns();
+    if (ncA != nrB) throw DimensionException("MatrixTools::mult(). nrows B != ncols A.", nrB, ncA);
+    for (const auto& D : vD)
+    {
+      if (ncA != D.size()) throw DimensionException("MatrixTools::mult(). Vector size is not equal to matrix size.", D.size(), ncA);
+    }
+    vO.resize(vD.size());
+    for (auto& O : vO)
+    {
+      O.resize(nrA, ncB);
+    }
+    if constexpr (std::is_same<Scalar, double>::value)
+    {
+      if (multDiagBatchDense_(A, vD, B, vO))
+        return;
+    }
+    for (size_t t = 0; t < vD.size(); t++)
+    {
+      mult(A, vD[t], B, vO[t]);
+    }
+  }
+
   /**
    * @brief Add matrix B to matrix A.
    *
@@ -523,13 +602,17 @@ public:
   }
 
   /**
-   * @brief Perform matrix exponentiation using diagonalization.
+   * @brief Perform matrix exponentiation.
+   *
+   * The exponential is computed with MatrixExponential, using diagonalization
+   * when possible, and the Padé approximation otherwise.
    *
-   * @warning This method currently relies only on diagonalization, so it won't work if your matrix is not diagonalizable.
-   * The function may be extended later to deal with other cases.
+   * @note This function decomposes A at each call. To compute
+   * \f$\exp(t.A)\f$ for many values of t, build a MatrixExponential object
+   * once and reuse it.
    *
    * @param A [in] The matrix.
-   * @param O [out]\f$\prod_{i=1}^p m\f$.
+   * @param O [out]\f$\exp(A)\f$.
    * @throw DimensionException If m is not a square matrix.
    */
   template<class Scalar>
@@ -537,11 +620,8 @@ public:
   {
     size_t n = A.getNumberOfRows();
     if (n != A.getNumberOfColumns()) throw DimensionException("MatrixTools::exp(). nrows != ncols.", A.getNumberOfColumns(), A.getNumberOfRows());
-    EigenValue<Scalar> eigen(A);
-    RowMatrix<Scalar> rightEV, leftEV;
-    rightEV = eigen.getV();
-    inv(rightEV, leftEV);
-    mult(rightEV, VectorTools::exp(eigen.getRealEigenValues()), leftEV, O);
+    MatrixExponential<Scalar> expA(A);
+    expA.exp(1, O);
   }
 
   /**
@@ -1551,6 +1631,215 @@ public:
 
     return lapCost;
   }
+
+private:
+  /**
+   * @brief Get the buffer of a matrix stored by rows with a constant stride.
+   *
+   * @param M [in] The matrix.
+   * @param data [out] A pointer to the first element.
+   * @param stride [out] The distance between two successive rows.
+   * @return False if M is not known to have such a storage, true otherwise.
+   */
+  static bool getStridedStorage_(const Matrix<double>& M, const double*& data, size_t& stride)
+  {
+    // Exact types only: derived classes may redefine element access.
+    const std::type_info& type = typeid(M);
+    if (type == typeid(DenseMatrix<double>))
+    {
+      const auto* dm = dynamic_cast<const DenseMatrix<double>*>(&M);
+      data = dm->data();
+      stride = dm->stride();
+      return true;
+    }
+    if (type == typeid(DenseMatrixView<double>))
+    {
+      const auto* dv = dynamic_cast<const DenseMatrixView<double>*>(&M);
+      data = dv->data();
+      stride = dv->stride();
+      return true;
+    }
+    if (type == typeid(LinearMatrix<double>))
+    {
+      const auto* lm = dynamic_cast<const LinearMatrix<double>*>(&M);
+      data = lm->data();
+      stride = lm->getNumberOfColumns();
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * @brief Get pointers to the rows of a matrix, if its storage is directly addressable.
+   *
+   * @param M [in] The matrix.
+   * @param rows [out] The row pointers.
+   * @return False if the storage of M is not known, true otherwise.
+   */
+  static bool getRowPointers_(const Matrix<double>& M, std::vector<const double*>& rows)
+  {
+    size_t nr = M.getNumberOfRows();
+    rows.resize(nr);
+    const double* data = nullptr;
+    size_t stride = 0;
+    if (getStridedStorage_(M, data, stride))
+    {
+      for (size_t i = 0; i < nr; i++)
+      {
+        rows[i] = data + i * stride;
+      }
+      return true;
+    }
+    if (typeid(M) == typeid(RowMatrix<double>))
+    {
+      const auto* rm = dynamic_cast<const RowMatrix<double>*>(&M);
+      for (size_t i = 0; i < nr; i++)
+      {
+        rows[i] = rm->getRow(i).data();
+      }
+      return true;
+    }
+    return false;
+  }
+
+  static bool getRowPointers_(Matrix<double>& M, std::vector<double*>& rows)
+  {
+    std::vector<const double*> cRows;
+    if (!getRowPointers_(static_cast<const Matrix<double>&>(M), cRows))
+      return false;
+    rows.resize(cRows.size());
+    for (size_t i = 0; i < cRows.size(); i++)
+    {
+      rows[i] = const_cast<double*>(cRows[i]);
+    }
+    return true;
+  }
+
+  /**
+   * @brief Compute O = A . B with MatrixKernels::gemm, if possible.
+   *
+   * O must already have the correct dimensions.
+   *
+   * @return False if the product could not be computed that way.
+   */
+  static bool multDense_(const Matrix<double>& A, const Matrix<double>& B, Matrix<double>& O)
+  {
+    size_t m = A.getNumberOfRows();
+    size_t k = A.getNumberOfColumns();
+    size_t n = B.getNumberOfColumns();
+    if (m * n * k < MatrixKernels::DENSE_THRESHOLD || &O == &A || &O == &B)
+      return false;
+    std::vector<const double*> rowsA, rowsB;
+    std::vector<double*> rowsO;
+    if (!getRowPointers_(A, rowsA) || !getRowPointers_(B, rowsB) || !getRowPointers_(O, rowsO))
+      return false;
+    MatrixKernels::gemm(m, n, k, rowsA.data(), rowsB.data(), rowsO.data());
+    return true;
+  }
+
+  /**
+   * @brief Compute O = A . diag(D) . B with MatrixKernels::gemmDiag, if possible.
+   *
+   * O must already have the correct dimensions.
+   *
+   * @return False if the product could not be computed that way.
+   */
+  static bool multDiagDense_(const Matrix<double>& A, const std::vector<double>& D, const Matrix<double>& B, Matrix<double>& O)
+  {
+    size_t m = A.getNumberOfRows();
+    size_t k = A.getNumberOfColumns();
+    size_t n = B.getNumberOfColumns();
+    if (m * n * k < MatrixKernels::DENSE_THRESHOLD || &O == &A || &O == &B)
+      return false;
+    std::vector<const double*> rowsA, rowsB;
+    std::vector<double*> rowsO;
+    if (!getRowPointers_(A, rowsA) || !getRowPointers_(B, rowsB) || !getRowPointers_(O, rowsO))
+      return false;
+    MatrixKernels::gemmDiag(m, n, k, rowsA.data(), D.data(), rowsB.data(), rowsO.data());
+    return true;
+  }
+
+  /**
+   * @brief Complex version of multDiagDense_.
+   *
+   * With P + i.Q the columns of A + i.iA scaled by D + i.iD,
+   * O = P . B - Q . iB and iO = P . iB + Q . B.
+   */
+  static bool multDiagDense_(const Matrix<double>& A, const Matrix<double>& iA, const std::vector<double>& D, const std::vector<double>& iD, const Matrix<double>& B, const Matrix<double>& iB, Matrix<double>& O, Matrix<double>& iO)
+  {
+    size_t m = A.getNumberOfRows();
+    size_t k = A.getNumberOfColumns();
+    size_t n = B.getNumberOfColumns();
+    if (m * n * k < MatrixKernels::DENSE_THRESHOLD)
+      return false;
+    if (&O == &A || &O == &iA || &O == &B || &O == &iB || &iO == &A || &iO == &iA || &iO == &B || &iO == &iB)
+      return false;
+    if (iA.getNumberOfRows() != m || iA.getNumberOfColumns() != k || iB.getNumberOfRows() != k || iB.getNumberOfColumns() != n)
+      return false;
+    std::vector<const double*> rowsA, rowsIA, rowsB, rowsIB;
+    std::vector<double*> rowsO, rowsIO;
+    if (!getRowPointers_(A, rowsA) || !getRowPointers_(iA, rowsIA) || !getRowPointers_(B, rowsB) || !getRowPointers_(iB, rowsIB)
+        || !getRowPointers_(O, rowsO) || !getRowPointers_(iO, rowsIO))
+      return false;
+
+    DenseMatrix<double> P(m, k), Q(m, k), mQ(m, k);
+    for (size_t i = 0; i < m; i++)
+    {
+      const double* a = rowsA[i];
+      const double* ia = rowsIA[i];
+      double* p = P.rowData(i);
+      double* q = Q.rowData(i);
+      double* mq = mQ.rowData(i);
+      for (size_t j = 0; j < k; j++)
+      {
+        p[j] = a[j] * D[j] - ia[j] * iD[j];
+        q[j] = a[j] * iD[j] + ia[j] * D[j];
+        mq[j] = -q[j];
+      }
+    }
+    std::vector<const double*> rowsP, rowsQ, rowsMQ;
+    getRowPointers_(P, rowsP);
+    getRowPointers_(Q, rowsQ);
+    getRowPointers_(mQ, rowsMQ);
+    MatrixKernels::gemm(m, n, k, rowsP.data(), rowsB.data(), rowsO.data());
+    MatrixKernels::gemm(m, n, k, rowsMQ.data(), rowsIB.data(), rowsO.data(), true);
+    MatrixKernels::gemm(m, n, k, rowsP.data(), rowsIB.data(), rowsIO.data());
+    MatrixKernels::gemm(m, n, k, rowsQ.data(), rowsB.data(), rowsIO.data(), true);
+    return true;
+  }
+
+  /**
+   * @brief Compute vO[t] = A . diag(vD[t]) . B with MatrixKernels::gemmDiagBatch, if possible.
+   *
+   * All vO[t] must already have the correct dimensions.
+   *
+   * @return False if the products could not be computed that way.
+   */
+  template<class MatrixO>
+  static bool multDiagBatchDense_(const Matrix<double>& A, const std::vector<std::vector<double>>& vD, const Matrix<double>& B, std::vector<MatrixO>& vO)
+  {
+    size_t m = A.getNumberOfRows();
+    size_t k = A.getNumberOfColumns();
+    size_t n = B.getNumberOfColumns();
+    if (m * n * k < MatrixKernels::DENSE_THRESHOLD)
+      return false;
+    std::vector<const double*> rowsA, rowsB;
+    if (!getRowPointers_(A, rowsA) || !getRowPointers_(B, rowsB))
+      return false;
+    size_t nBatch = vD.size();
+    std::vector<std::vector<double*>> rowsO(nBatch);
+    std::vector<double* const*> outputs(nBatch);
+    std::vector<const double*> diagonals(nBatch);
+    for (size_t t = 0; t < nBatch; t++)
+    {
+      if (!getRowPointers_(vO[t], rowsO[t]))
+        return false;
+      outputs[t] = rowsO[t].data();
+      diagonals[t] = vD[t].data();
+    }
+    MatrixKernels::gemmDiagBatch(m, n, k, rowsA.data(), diagonals.data(), nBatch, rowsB.data(), outputs.data());
+    return true;
+  }
 };
 } // end of namespace bpp.
 #endif // BPP_NUMERIC_MATRIX_MATRIXTOOLS_H
@@ -14,7 +14,8 @@ using namespace std;
 /** Copy constructor: *********************************************************/
 
 ParameterList::ParameterList(const ParameterList& pl) :
-  parameters_(pl.size())
+  parameters_(pl.size()),
+  index_(pl.index_)
 {
   // Now copy all parameters:
   for (size_t i = 0; i < size(); ++i)
@@ -35,6 +36,7 @@ ParameterList& ParameterList::operator=(const ParameterList& pl)
   {
     parameters_[i] = shared_ptr<Parameter>(pl.parameters_[i]->clone());
   }
+  index_ = pl.index_;
 
   return *this;
 }
@@ -49,71 +51,103 @@ ParameterList::~ParameterList()
 
 /******************************************************************************/
 
-const Parameter& ParameterList::parameter(const std::string& name) const
+void ParameterList::reindex()
 {
-  for (size_t i = 0; i < size(); i++)
+  index_.clear();
+  index_.reserve(parameters_.size());
+  for (size_t i = 0; i < parameters_.size(); ++i)
   {
-    const Parameter* p = parameters_[i].get();
-    if (p->getName() == name)
-      return *p;
+    // emplace keeps the first position in case of duplicated names:
+    index_.emplace(parameters_[i]->getName(), i);
   }
-  throw ParameterNotFoundException("ParameterList::parameter('name').", name);
 }
 
-/******************************************************************************/
-
-const shared_ptr<Parameter>& ParameterList::getParameter(const std::string& name) const
+size_t ParameterList::findParameter_(const std::string& name) const
 {
-  for (size_t i = 0; i < size(); i++)
+  auto it = index_.find(name);
+  if (it != index_.end() && parameters_[it->second]->getName() == name)
+    return it->second;
+  // Not indexed under this name, or the parameter was renamed directly:
+  for (size_t i = 0; i < parameters_.size(); ++i)
   {
-    const shared_ptr<Parameter>& p = parameters_[i];
-    if (p->getName() == name)
-      return p;
+    if (parameters_[i]->getName() == name)
+      return i;
   }
-  throw ParameterNotFoundException("ParameterList::getParameter('name').", name);
+  return parameters_.size();
 }
 
+void ParameterList::pushParameter_(const std::shared_ptr<Parameter>& param)
+{
+  parameters_.push_back(param);
+  index_.emplace(param->getName(), parameters_.size() - 1);
+}
 
-/******************************************************************************/
-
-double ParameterList::getParameterValue(const std::string& name) const
+void ParameterList::replaceInIndex_(size_t index, const std::string& oldName)
 {
-  for (size_t i = 0; i < size(); i++)
+  const std::string& name = parameters_[index]->getName();
+  if (name == oldName)
+    return;
+
+  auto it = index_.find(oldName);
+  if (it != index_.end() && it->second == index)
   {
-    const Parameter* p = parameters_[i].get();
-    if (p->getName() == name)
-      return p->getValue();
+    index_.erase(it);
+    // Another parameter may have the same name:
+    for (size_t i = index + 1; i < parameters_.size(); ++i)
+    {
+      if (parameters_[i]->getName() == oldName)
+      {
+        index_.emplace(oldName, i);
+        break;
+      }
+    }
   }
-  throw ParameterNotFoundException("ParameterList::getParameterValue('name').", name);
+  auto found = index_.emplace(name, index);
+  if (!found.second && found.first->second > index)
+    found.first->second = index;
 }
 
 /******************************************************************************/
 
-Parameter& ParameterList::parameter(const std::string& name)
+const Parameter& ParameterList::parameter(const std::string& name) const
 {
-  for (size_t i = 0; i < size(); i++)
-  {
-    Parameter* p = parameters_[i].get();
-    if (p->getName() == name)
-      return *p;
-  }
+  size_t i = findParameter_(name);
+  if (i < size())
+    return *parameters_[i];
   throw ParameterNotFoundException("ParameterList::parameter('name').", name);
 }
 
 /******************************************************************************/
 
-shared_ptr<Parameter>& ParameterList::getParameter(const std::string& name)
+const shared_ptr<Parameter>& ParameterList::getParameter(const std::string& name) const
 {
-  for (size_t i = 0; i < size(); i++)
-  {
-    shared_ptr<Parameter>& p = parameters_[i];
-    if (p->getName() == name)
-      return p;
-  }
+  size_t i = findParameter_(name);
+  if (i < size())
+    return parameters_[i];
   throw ParameterNotFoundException("ParameterList::getParameter('name').", name);
 }
 
 
+/******************************************************************************/
+
+double ParameterList::getParameterValue(const std::string& name) const
+{
+  size_t i = findParameter_(name);
+  if (i < size())
+    return parameters_[i]->getValue();
+  throw ParameterNotFoundException("ParameterList::getParameterValue('name').", name);
+}
+
+/******************************************************************************/
+
+Parameter& ParameterList::parameter(const std::string& name)
+{
+  size_t i = findParameter_(name);
+  if (i < size())
+    return *parameters_[i];
+  throw ParameterNotFoundException("ParameterList::parameter('name').", name);
+}
+
 /******************************************************************************/
 
 ParameterList ParameterList::createSubList(const std::vector<std::string>& names) const
@@ -158,7 +192,7 @@ ParameterList ParameterList::createSubList(const std::vector<size_t>& parameters
   for (auto iparam : parameters)
   {
     if (iparam < size())
-      pl.parameters_.push_back(shared_ptr<Parameter>(parameters_[iparam]->clone()));
+      pl.pushParameter_(shared_ptr<Parameter>(parameters_[iparam]->clone()));
   }
   return pl;
 }
@@ -183,7 +217,7 @@ ParameterList ParameterList::createSubList(size_t parameter) const
 {
   ParameterList pl;
   if (parameter < size())
-    pl.parameters_.push_back(shared_ptr<Parameter>(parameters_[parameter]->clone()));
+    pl.pushParameter_(shared_ptr<Parameter>(parameters_[parameter]->clone()));
   return pl;
 }
 
@@ -196,8 +230,8 @@ ParameterList ParameterList::getCommonParametersWith(const ParameterList& params
   {
     const Parameter& p = params[i];
     if (hasParameter(p.getName()))
-      pl.parameters_.push_back(shared_ptr<Parameter>(p.clone()));
-    // We use push_back instead of addParameter because we are sure the name is not duplicated.
+      pl.pushParameter_(shared_ptr<Parameter>(p.clone()));
+    // We use pushParameter_ instead of addParameter because we are sure the name is not duplicated.
   }
 
   return pl;
@@ -257,7 +291,7 @@ void ParameterList::addParameter(const Parameter& param)
 {
   if (hasParameter(param.getName()))
     throw ParameterException("ParameterList::addParameter. Parameter with name '" + param.getName() + "' already exists.", &param);
-  parameters_.push_back(shared_ptr<Parameter>(param.clone()));
+  pushParameter_(shared_ptr<Parameter>(param.clone()));
 }
 
 /******************************************************************************/
@@ -266,17 +300,18 @@ void ParameterList::addParameter(Parameter* param)
 {
   if (hasParameter(param->getName()))
     throw ParameterException("ParameterList::addParameter. Parameter with name '" + param->getName() + "' already exists.", param);
-  parameters_.push_back(shared_ptr<Parameter>(param));
+  pushParameter_(shared_ptr<Parameter>(param));
 }
 
 /******************************************************************************/
 
 void ParameterList::shareParameter(const std::shared_ptr<Parameter>& param)
 {
-  if (hasParameter(param->getName()))
-    setParameterValue(param->getName(), param->getValue());
+  size_t i = findParameter_(param->getName());
+  if (i < size())
+    parameters_[i]->setValue(param->getValue());
   else
-    parameters_.push_back(param);
+    pushParameter_(param);
 }
 
 
@@ -286,7 +321,18 @@ void ParameterList::setParameter(size_t index, const Parameter& param)
 {
   if (index >= size())
     throw IndexOutOfBoundsException("ParameterList::setParameter.", index, 0, size());
+  string oldName = parameters_[index]->getName();
   parameters_[index] = shared_ptr<Parameter>(param.clone());
+  replaceInIndex_(index, oldName);
+}
+
+void ParameterList::setParameter(size_t index, const std::shared_ptr<Parameter>& param)
+{
+  if (index >= size())
+    throw IndexOutOfBoundsException("ParameterList::setParameter.", index, 0, size());
+  string oldName = parameters_[index]->getName();
+  parameters_[index] = param;
+  replaceInIndex_(index, oldName);
 }
 
 
@@ -296,10 +342,11 @@ void ParameterList::includeParameters(const ParameterList& params)
 {
   for (size_t i = 0; i < params.size(); i++)
   {
-    if (hasParameter(params[i].getName()))
-      setParameterValue(params[i].getName(), params[i].getValue());
+    size_t j = findParameter_(params[i].getName());
+    if (j < size())
+      parameters_[j]->setValue(params[i].getValue());
     else
-      parameters_.push_back(shared_ptr<Parameter>(params[i].clone()));
+      pushParameter_(shared_ptr<Parameter>(params[i].clone()));
   }
 }
 
@@ -358,9 +405,10 @@ void ParameterList::setParametersValues(const ParameterList& params)
   // First we check if all values are correct:
   for (vector<shared_ptr<Parameter>>::const_iterator it = params.parameters_.begin(); it < params.parameters_.end(); it++)
   {
-    if (hasParameter((*it)->getName()))
+    size_t i = findParameter_((*it)->getName());
+    if (i < size())
     {
-      Parameter* p = &parameter((*it)->getName());
+      Parameter* p = parameters_[i].get();
       if (p->hasConstraint() && !p->getConstraint()->isCorrect((*it)->getValue()))
         throw ConstraintException("ParameterList::setParametersValues()", p, (*it)->getValue());
     }
@@ -370,9 +418,10 @@ void ParameterList::setParametersValues(const ParameterList& params)
   {
     for (vector<shared_ptr<Parameter>>::const_iterator it = params.parameters_.begin(); it < params.parameters_.end(); it++)
     {
-      if (hasParameter((*it)->getName()))
+      size_t i = findParameter_((*it)->getName());
+      if (i < size())
       {
-        Parameter* p = &parameter((*it)->getName());
+        Parameter* p = parameters_[i].get();
         p->setValue((*it)->getValue());
       }
     }
@@ -386,9 +435,10 @@ bool ParameterList::testParametersValues(const ParameterList& params) const
   // First we check if all values are correct:
   for (vector<shared_ptr<Parameter>>::const_iterator it = params.parameters_.begin(); it < params.parameters_.end(); it++)
   {
-    if (hasParameter((*it)->getName()))
+    size_t i = findParameter_((*it)->getName());
+    if (i < size())
     {
-      const Parameter* p = &parameter((*it)->getName());
+      const Parameter* p = parameters_[i].get();
       if (p->hasConstraint() && !p->getConstraint()->isCorrect((*it)->getValue()))
         throw ConstraintException("ParameterList::testParametersValues()", p, (*it)->getValue());
     }
@@ -399,9 +449,10 @@ bool ParameterList::testParametersValues(const ParameterList& params) const
 
   for (vector<shared_ptr<Parameter>>::const_iterator it = params.parameters_.begin(); it < params.parameters_.end(); it++)
   {
-    if (hasParameter((*it)->getName()))
+    size_t i = findParameter_((*it)->getName());
+    if (i < size())
     {
-      const Parameter* p = &parameter((*it)->getName());
+      const Parameter* p = parameters_[i].get();
       if (p->getValue() != (*it)->getValue())
         ch |= 1;
     }
@@ -416,9 +467,10 @@ bool ParameterList::matchParametersValues(const ParameterList& params, vector<si
   // First we check if all values are correct:
   for (vector<shared_ptr<Parameter>>::const_iterator it = params.parameters_.begin(); it < params.parameters_.end(); it++)
   {
-    if (hasParameter((*it)->getName()))
+    size_t i = findParameter_((*it)->getName());
+    if (i < size())
     {
-      Parameter* p = &parameter((*it)->getName());
+      Parameter* p = parameters_[i].get();
       if (p->hasConstraint() && !p->getConstraint()->isCorrect((*it)->getValue()))
         throw ConstraintException("ParameterList::matchParametersValues()", p, (*it)->getValue());
     }
@@ -430,9 +482,10 @@ bool ParameterList::matchParametersValues(const ParameterList& params, vector<si
   size_t pos = 0;
   for (vector<shared_ptr<Parameter>>::const_iterator it = params.parameters_.begin(); it < params.parameters_.end(); it++)
   {
-    if (hasParameter((*it)->getName()))
+    size_t i = findParameter_((*it)->getName());
+    if (i < size())
     {
-      Parameter* p = &parameter((*it)->getName());
+      Parameter* p = parameters_[i].get();
       if (p->getValue() != (*it)->getValue())
       {
         ch |= 1;
@@ -469,13 +522,7 @@ void ParameterList::setParameters(const ParameterList& params)
 /******************************************************************************/
 bool ParameterList::hasParameter(const std::string& name) const
 {
-  for (unsigned int i = 0; i < size(); i++)
-  {
-    const Parameter* p = parameters_[i].get();
-    if (p->getName() == name)
-      return true;
-  }
-  return false;
+  return findParameter_(name) < size();
 }
 
 /******************************************************************************/
@@ -483,9 +530,10 @@ void ParameterList::matchParameters(const ParameterList& params)
 {
   for (vector<shared_ptr<Parameter>>::const_iterator it = params.parameters_.begin(); it < params.parameters_.end(); it++)
   {
-    if (hasParameter((*it)->getName()))
+    size_t i = findParameter_((*it)->getName());
+    if (i < size())
     {
-      Parameter* p = &parameter((*it)->getName());
+      Parameter* p = parameters_[i].get();
       *p = **it;
     }
   }
@@ -494,13 +542,12 @@ void ParameterList::matchParameters(const ParameterList& params)
 /******************************************************************************/
 void ParameterList::deleteParameter(const std::string& name)
 {
-  for (auto it = parameters_.begin(); it != parameters_.end(); ++it)
+  size_t i = findParameter_(name);
+  if (i < size())
   {
-    if ((*it)->getName() == name)
-    {
-      it = parameters_.erase(it);
-      return;
-    }
+    parameters_.erase(parameters_.begin() + static_cast<ptrdiff_t>(i));
+    reindex();
+    return;
   }
   throw ParameterNotFoundException("ParameterList::deleteParameter", name);
 }
@@ -530,6 +577,7 @@ void ParameterList::deleteParameter(size_t index)
   if (index >= size())
     throw IndexOutOfBoundsException("ParameterList::deleteParameter.", index, 0, size());
   parameters_.erase(parameters_.begin() + static_cast<ptrdiff_t>(index));
+  reindex();
 }
 
 /******************************************************************************/
@@ -546,16 +594,15 @@ void ParameterList::deleteParameters(const std::vector<size_t>& indices)
     //    delete p;
     parameters_.erase(parameters_.begin() + static_cast<ptrdiff_t>(index));
   }
+  reindex();
 }
 
 /******************************************************************************/
 size_t ParameterList::whichParameterHasName(const std::string& name) const
 {
-  for (size_t i = 0; i < size(); ++i)
-  {
-    if (parameters_[i]->getName() == name)
-      return i;
-  }
+  size_t i = findParameter_(name);
+  if (i < size())
+    return i;
   throw ParameterNotFoundException("ParameterList::whichParameterHasName.", name);
 }
 
@@ -577,6 +624,7 @@ void ParameterList::printParameters(OutputStream& out) const
 void ParameterList::reset()
 {
   parameters_.resize(0);
+  index_.clear();
 }
 
 /******************************************************************************/
@@ -14,6 +14,7 @@
 #include <vector>
 #include <string>
 #include <iostream>
+#include <unordered_map>
 
 namespace bpp
 {
@@ -23,6 +24,14 @@ namespace bpp
  * @author Julien Dutheil, Laurent Gueguen
  * This is a vector of Parameter with a few additional methods, mainly for giving
  * name access.
+ *
+ * Access by name uses a hash index of the positions of the parameters, so that it takes
+ * constant time. The index is kept up to date by the methods of the list, so that lookups
+ * never modify the list and can be run concurrently. Parameters may also be renamed
+ * directly, with Parameter::setName(), through operator[] or through another list sharing
+ * them: lookups check the name of the parameter found in the index, and otherwise scan the
+ * list, so that they still return correct answers, but in linear time until reindex() is
+ * called.
  */
 class ParameterList :
   public Clonable
@@ -30,11 +39,16 @@ class ParameterList :
 private:
   std::vector<std::shared_ptr<Parameter>> parameters_;
 
+  /**
+   * @brief Position of the first parameter with each name.
+   */
+  std::unordered_map<std::string, size_t> index_;
+
 public:
   /**
    * @brief Build a new ParameterList object.
    */
-  ParameterList() : parameters_() {}
+  ParameterList() : parameters_(), index_() {}
 
   /**
    * @brief Copy constructor
@@ -67,7 +81,6 @@ public:
    * @warning No check is performed on the validity of the index given as input!
    */
   virtual const std::shared_ptr<Parameter>& getParameter(size_t i) const { return parameters_[i]; }
-  virtual std::shared_ptr<Parameter>& getParameter(size_t i) { return parameters_[i]; }
 
   /**
    * @brief Get the parameter with name <i>name</i>.
@@ -106,15 +119,6 @@ public:
    */
   virtual Parameter& parameter(const std::string& name);
 
-  /**
-   * @brief Get the parameter with name <i>name</i> as a shared pointer.
-   *
-   * @param name The name of the parameter to look for.
-   * @return A shared parameter toward the parameter with name <i>name</i>.
-   * @throw ParameterNotFoundException If no parameter with the given name is found.
-   */
-  virtual std::shared_ptr<Parameter>& getParameter(const std::string& name);
-
   /**
    * @brief Get given parameters as a sublist.
    *
@@ -228,6 +232,15 @@ public:
    */
   virtual void setParameter(size_t index, const Parameter& param);
 
+  /**
+   * @brief Replace given parameter by a shared one.
+   *
+   * @param index The position of the parameter to replace.
+   * @param param The shared_ptr parameter to put in the list.
+   * @throw IndexOutOfBoundsException if the index is not valid.
+   */
+  virtual void setParameter(size_t index, const std::shared_ptr<Parameter>& param);
+
   //  virtual void setParameter(size_t index, Parameter* param);
 
   /**
@@ -409,6 +422,32 @@ public:
    * @brief Reset the list: delete all parameters.
    */
   virtual void reset();
+
+  /**
+   * @brief Rebuild the index of the names, after parameters of the list were renamed directly.
+   */
+  void reindex();
+
+protected:
+  /**
+   * @brief Get the position of a parameter from the index, or by scanning the list if the
+   * index does not give a parameter with this name.
+   *
+   * @param name The name of the parameter to look for.
+   * @return The position of the first parameter with the given name, or size() if there is none.
+   */
+  size_t findParameter_(const std::string& name) const;
+
+  /**
+   * @brief Add a parameter at the end of the list, without checking its name.
+   */
+  void pushParameter_(const std::shared_ptr<Parameter>& param);
+
+private:
+  /**
+   * @brief Update the index after the parameter at a given position was replaced.
+   */
+  void replaceInIndex_(size_t index, const std::string& oldName);
 };
 } // end of namespace bpp.
 #endif // BPP_NUMERIC_PARAMETERLIST_H
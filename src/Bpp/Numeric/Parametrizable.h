@@ -156,6 +156,62 @@ public:
    */
   virtual std::string getParameterNameWithoutNamespace(const std::string& name) const = 0;
 
+  /**
+   * @name Access to parameters by position.
+   *
+   * Names are resolved once into positions in getParameters() with bindParameters, after which
+   * values can be set from a plain array without any name lookup or ParameterList copy. This is
+   * intended for callers setting the same parameters many times, like optimizers.
+   *
+   * @warning Positions are only valid as long as no parameter is added to or removed from the object.
+   *
+   * @{
+   */
+
+  /**
+   * @brief Get the positions of parameters in the list returned by getParameters().
+   *
+   * @param names The names of the parameters, including the namespace.
+   * @return The position of each parameter.
+   * @throw ParameterNotFoundException If a name does not correspond to any parameter.
+   */
+  virtual std::vector<size_t> bindParameters(const std::vector<std::string>& names) const
+  {
+    std::vector<size_t> slots(names.size());
+    for (size_t k = 0; k < names.size(); ++k)
+    {
+      slots[k] = getParameters().whichParameterHasName(names[k]);
+    }
+    return slots;
+  }
+
+  /**
+   * @brief Update the values of parameters given by their positions.
+   *
+   * This method behaves as matchParametersValues, with a list containing the given parameters.
+   * The default implementation builds such a list, and should be specialized for efficiency.
+   *
+   * @param slots The positions of the parameters, as returned by bindParameters.
+   * @param values The new values, values[k] corresponding to the parameter at position slots[k].
+   * @param changed An optional mask: if not null, only the slots k for which (*changed)[k] is true are considered.
+   * @return True if at least one parameter value has been changed.
+   * @throw ConstraintException If a value does not match the constraint of the corresponding parameter.
+   */
+  virtual bool matchBoundParametersValues(const std::vector<size_t>& slots, const double* values, const std::vector<bool>* changed = nullptr)
+  {
+    ParameterList pl;
+    for (size_t k = 0; k < slots.size(); ++k)
+    {
+      if (changed && !(*changed)[k])
+        continue;
+      const Parameter& p = getParameters()[slots[k]];
+      if (p.getValue() != values[k])
+        pl.addParameter(new Parameter(p.getName(), values[k]));
+    }
+    return pl.size() > 0 && matchParametersValues(pl);
+  }
+  /** @} */
+
 protected:
   /**
    * @brief Get all parameters available.
@@ -264,6 +264,7 @@ public:
       {
         pl[i].setName(pl[i].getName() + "_" + TextTools::toString(objectIndex));
       }
+      pl.reindex();
     }
     return pl;
   }
@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_UTILS_ALIGNEDALLOCATOR_H
+#define BPP_UTILS_ALIGNEDALLOCATOR_H
+
+#include <cstddef>
+#include <limits>
+#include <new>
+
+namespace bpp
+{
+/**
+ * @brief A standard allocator returning memory aligned on a given boundary.
+ *
+ * Typical use is to get cache-line (and SIMD register) aligned buffers:
+ * @code
+ * std::vector<double, AlignedAllocator<double, 64>> v(100);
+ * @endcode
+ *
+ * @tparam T The type of allocated objects.
+ * @tparam Alignment The alignment in bytes, a power of two at least equal to alignof(T).
+ */
+template<class T, std::size_t Alignment = 64>
+class AlignedAllocator
+{
+  static_assert((Alignment & (Alignment - 1)) == 0, "AlignedAllocator: alignment must be a power of two.");
+  static_assert(Alignment >= alignof(T), "AlignedAllocator: alignment must be at least that of the type.");
+
+public:
+  typedef T value_type;
+
+  template<class U>
+  struct rebind
+  {
+    typedef AlignedAllocator<U, Alignment> other;
+  };
+
+public:
+  AlignedAllocator() noexcept {}
+
+  template<class U>
+  AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+  T* allocate(std::size_t n)
+  {
+    if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+      throw std::bad_array_new_length();
+    return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+  }
+
+  void deallocate(T* p, std::size_t) noexcept
+  {
+    ::operator delete(p, std::align_val_t(Alignment));
+  }
+};
+
+template<class T, class U, std::size_t Alignment>
+bool operator==(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) { return true; }
+
+template<class T, class U, std::size_t Alignment>
+bool operator!=(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) { return false; }
+} // end of namespace bpp.
+#endif // BPP_UTILS_ALIGNEDALLOCATOR_H
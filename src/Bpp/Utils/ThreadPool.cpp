@@ -0,0 +1,136 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "ThreadPool.h"
+
+using namespace bpp;
+using namespace std;
+
+namespace
+{
+// Set while the current thread runs an iteration of a parallel loop.
+thread_local bool insideParallelLoop = false;
+}
+
+ThreadPool::ThreadPool(size_t nbThreads) :
+  workers_(),
+  mutex_(),
+  runMutex_(),
+  start_(),
+  done_(),
+  job_(0),
+  jobSize_(0),
+  next_(0),
+  generation_(0),
+  nbActive_(0),
+  stop_(false),
+  exception_()
+{
+  if (nbThreads == 0)
+    nbThreads = getDefaultNumberOfThreads();
+  for (size_t i = 1; i < nbThreads; ++i)
+  {
+    workers_.emplace_back(&ThreadPool::workerLoop_, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    lock_guard<mutex> lock(mutex_);
+    stop_ = true;
+  }
+  start_.notify_all();
+  for (auto& worker : workers_)
+  {
+    worker.join();
+  }
+}
+
+size_t ThreadPool::getDefaultNumberOfThreads()
+{
+  size_t n = static_cast<size_t>(thread::hardware_concurrency());
+  return n > 0 ? n : 1;
+}
+
+/******************************************************************************/
+
+void ThreadPool::run_(size_t n, const std::function<void(size_t, size_t)>& f)
+{
+  // The caller runs the loop alone, in its own slot of this pool.
+  if (workers_.empty() || n <= 1 || insideParallelLoop)
+  {
+    for (size_t i = 0; i < n; ++i)
+    {
+      f(i, 0);
+    }
+    return;
+  }
+
+  lock_guard<mutex> runLock(runMutex_);
+  {
+    lock_guard<mutex> lock(mutex_);
+    job_ = &f;
+    jobSize_ = n;
+    next_ = 0;
+    nbActive_ = workers_.size();
+    exception_ = nullptr;
+    ++generation_;
+  }
+  start_.notify_all();
+
+  work_(0);
+
+  exception_ptr e;
+  {
+    unique_lock<mutex> lock(mutex_);
+    done_.wait(lock, [this]() { return nbActive_ == 0; });
+    job_ = 0;
+    e = exception_;
+    exception_ = nullptr;
+  }
+  if (e)
+    rethrow_exception(e);
+}
+
+void ThreadPool::work_(size_t threadIndex)
+{
+  insideParallelLoop = true;
+  for (size_t i = next_++; i < jobSize_; i = next_++)
+  {
+    try
+    {
+      (*job_)(i, threadIndex);
+    }
+    catch (...)
+    {
+      lock_guard<mutex> lock(mutex_);
+      if (!exception_)
+        exception_ = current_exception();
+      next_ = jobSize_;
+    }
+  }
+  insideParallelLoop = false;
+}
+
+void ThreadPool::workerLoop_(size_t threadIndex)
+{
+  size_t generation = 0;
+  while (true)
+  {
+    {
+      unique_lock<mutex> lock(mutex_);
+      start_.wait(lock, [this, generation]() { return stop_ || generation_ != generation; });
+      if (stop_)
+        return;
+      generation = generation_;
+    }
+    work_(threadIndex);
+    {
+      lock_guard<mutex> lock(mutex_);
+      if (--nbActive_ == 0)
+        done_.notify_one();
+    }
+  }
+}
@@ -0,0 +1,109 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_UTILS_THREADPOOL_H
+#define BPP_UTILS_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief A fixed-size pool of threads running parallel loops.
+ *
+ * The pool is made of getNumberOfThreads() - 1 worker threads, the thread calling
+ * parallelFor taking part in the computation. Iterations are distributed dynamically:
+ * each thread takes the next unprocessed index until all are done, so that loops
+ * with iterations of unequal cost are balanced.
+ *
+ * Each iteration is given the index of the thread running it, in
+ * [0, getNumberOfThreads()), which can be used to address per-thread workspaces.
+ * The assignment of iterations to threads is not deterministic: callers wanting
+ * reproducible results should store the result of each iteration separately and
+ * combine them afterwards in a fixed order.
+ *
+ * A call to parallelFor from within an iteration (of this or another pool) runs
+ * serially in the calling thread, with thread index 0, and concurrent calls from
+ * several external threads are processed one after the other.
+ *
+ * @code
+ * ThreadPool pool(4);
+ * std::vector<double> res(n);
+ * pool.parallelFor(n, [&](size_t i, size_t thread) { res[i] = f(i); });
+ * @endcode
+ */
+class ThreadPool
+{
+private:
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::mutex runMutex_;
+  std::condition_variable start_;
+  std::condition_variable done_;
+  const std::function<void(size_t, size_t)>* job_;
+  size_t jobSize_;
+  std::atomic<size_t> next_;
+  size_t generation_;
+  size_t nbActive_;
+  bool stop_;
+  std::exception_ptr exception_;
+
+public:
+  /**
+   * @brief Build a new thread pool.
+   *
+   * @param nbThreads The total number of threads used by parallel loops,
+   * including the calling thread. 0 means getDefaultNumberOfThreads().
+   */
+  explicit ThreadPool(size_t nbThreads = 0);
+
+  ThreadPool(const ThreadPool&) = delete;
+
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  ~ThreadPool();
+
+public:
+  /**
+   * @return The number of threads used by parallel loops, including the calling thread.
+   */
+  size_t getNumberOfThreads() const { return workers_.size() + 1; }
+
+  /**
+   * @brief Run f(i, thread) for i in [0, n), and wait for all iterations to finish.
+   *
+   * If an iteration throws an exception, the remaining iterations are not started,
+   * and the exception is rethrown in the calling thread.
+   *
+   * @param n The number of iterations.
+   * @param f The function to run, taking the iteration index and the thread index.
+   */
+  template<class F>
+  void parallelFor(size_t n, F f)
+  {
+    std::function<void(size_t, size_t)> job(std::move(f));
+    run_(n, job);
+  }
+
+  /**
+   * @return The number of concurrent threads supported by the system (at least 1).
+   */
+  static size_t getDefaultNumberOfThreads();
+
+private:
+  void run_(size_t n, const std::function<void(size_t, size_t)>& f);
+
+  void work_(size_t threadIndex);
+
+  void workerLoop_(size_t threadIndex);
+};
+} // end of namespace bpp.
+#endif // BPP_UTILS_THREADPOOL_H
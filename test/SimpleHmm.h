@@ -0,0 +1,137 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Numeric/AbstractParametrizable.h>
+#include <Bpp/Numeric/Hmm/HmmEmissionProbabilities.h>
+#include <Bpp/Numeric/Hmm/HmmStateAlphabet.h>
+#include <Bpp/Numeric/Random/RandomTools.h>
+#include <Bpp/Text/TextTools.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+// A minimal hidden Markov model for the tests of the Hmm classes:
+// hidden states are anonymous, and the data is a sequence of 0/1 values,
+// emitted by state i with probability p_i for 1 and 1 - p_i for 0.
+
+class SimpleHmmState :
+  public virtual Clonable
+{
+public:
+  SimpleHmmState* clone() const { return new SimpleHmmState(*this); }
+};
+
+class SimpleHmmStateAlphabet :
+  public virtual HmmStateAlphabet,
+  public AbstractParametrizable
+{
+private:
+  size_t nbStates_;
+  SimpleHmmState state_;
+
+public:
+  SimpleHmmStateAlphabet(size_t nbStates) : AbstractParametrizable(""), nbStates_(nbStates), state_() {}
+
+  SimpleHmmStateAlphabet* clone() const { return new SimpleHmmStateAlphabet(*this); }
+
+  const Clonable& getState(size_t /* stateIndex */) const { return state_; }
+
+  size_t getNumberOfStates() const { return nbStates_; }
+
+  bool worksWith(const HmmStateAlphabet& stateAlphabet) const { return &stateAlphabet == this; }
+};
+
+class SimpleHmmEmissionProbabilities :
+  public virtual HmmEmissionProbabilities,
+  public AbstractParametrizable
+{
+private:
+  std::shared_ptr<const HmmStateAlphabet> alph_;
+  std::vector<int> data_;
+  std::vector<std::vector<double>> emissions_;
+  mutable std::vector<std::vector<double>> dEmissions_;
+  mutable std::vector<std::vector<double>> d2Emissions_;
+
+public:
+  SimpleHmmEmissionProbabilities(std::shared_ptr<const HmmStateAlphabet> alph, const std::vector<int>& data) :
+    AbstractParametrizable(""),
+    alph_(alph),
+    data_(data),
+    emissions_(data.size(), std::vector<double>(alph->getNumberOfStates())),
+    dEmissions_(data.size(), std::vector<double>(alph->getNumberOfStates())),
+    d2Emissions_(data.size(), std::vector<double>(alph->getNumberOfStates()))
+  {
+    size_t nbStates = alph->getNumberOfStates();
+    for (size_t i = 0; i < nbStates; ++i)
+    {
+      double p = (static_cast<double>(i) + 0.5) / static_cast<double>(nbStates);
+      addParameter_(new Parameter("p" + TextTools::toString(i + 1), p, Parameter::PROP_CONSTRAINT_EX));
+    }
+    fireParameterChanged(getParameters());
+  }
+
+  SimpleHmmEmissionProbabilities* clone() const { return new SimpleHmmEmissionProbabilities(*this); }
+
+  const HmmStateAlphabet& hmmStateAlphabet() const { return *alph_; }
+
+  std::shared_ptr<const HmmStateAlphabet> getHmmStateAlphabet() const { return alph_; }
+
+  void setHmmStateAlphabet(std::shared_ptr<const HmmStateAlphabet> stateAlphabet) { alph_ = stateAlphabet; }
+
+  double operator()(size_t pos, size_t state) const { return emissions_[pos][state]; }
+
+  const std::vector<double>& operator()(size_t pos) const { return emissions_[pos]; }
+
+  size_t getNumberOfPositions() const { return data_.size(); }
+
+  void fireParameterChanged(const ParameterList& /* pl */)
+  {
+    size_t nbStates = alph_->getNumberOfStates();
+    for (size_t i = 0; i < nbStates; ++i)
+    {
+      double p = getParameterValue("p" + TextTools::toString(i + 1));
+      for (size_t pos = 0; pos < data_.size(); ++pos)
+      {
+        emissions_[pos][i] = data_[pos] ? p : 1. - p;
+      }
+    }
+  }
+
+  void computeDEmissionProbabilities(std::string& variable) const
+  {
+    size_t nbStates = alph_->getNumberOfStates();
+    for (size_t i = 0; i < nbStates; ++i)
+    {
+      bool isVar = (variable == getParameter_(i).getName());
+      for (size_t pos = 0; pos < data_.size(); ++pos)
+      {
+        dEmissions_[pos][i] = isVar ? (data_[pos] ? 1. : -1.) : 0.;
+      }
+    }
+  }
+
+  void computeD2EmissionProbabilities(std::string& /* variable */) const
+  {
+    // Emissions are linear in the parameters.
+  }
+
+  const std::vector<double>& getDEmissionProbabilities(size_t pos) const { return dEmissions_[pos]; }
+
+  const std::vector<double>& getD2EmissionProbabilities(size_t pos) const { return d2Emissions_[pos]; }
+};
+
+// Draw a random 0/1 sequence.
+inline std::vector<int> simulateSimpleHmmData(size_t nbSites)
+{
+  std::vector<int> data(nbSites);
+  for (auto& x : data)
+  {
+    x = RandomTools::giveRandomNumberBetweenZeroAndEntry(1.) < 0.4 ? 1 : 0;
+  }
+  return data;
+}
@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Numeric/Function/TwoPointsNumericalDerivative.h>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "PolynomialFunction.h"
+
+using namespace bpp;
+using namespace std;
+
+int main()
+{
+  bool test = true;
+
+  auto f = make_shared<PolynomialFunction1>();
+  vector<size_t> slots = f->bindParameters({ "z", "x" });
+  test &= slots.size() == 2 && slots[0] == 2 && slots[1] == 0;
+  try
+  {
+    f->bindParameters({ "w" });
+    test = false;
+  }
+  catch (ParameterNotFoundException& e) {}
+
+  // Fast path of AbstractParametrizable:
+  double values[2] = { 1., 4. };
+  test &= f->matchBoundParametersValues(slots, values);
+  test &= f->getParameterValue("z") == 1. && f->getParameterValue("x") == 4.;
+  test &= f->getValue() == 1. + 4. + 4.;
+  test &= !f->matchBoundParametersValues(slots, values);
+
+  // Only slots flagged as changed are considered:
+  values[0] = 2.;
+  values[1] = 6.;
+  vector<bool> changed = { false, true };
+  f->setBoundParameters(slots, values, &changed);
+  test &= f->getParameterValue("z") == 1. && f->getParameterValue("x") == 6.;
+
+  // Values are checked before any change:
+  values[0] = 10.;
+  values[1] = 5.;
+  try
+  {
+    f->matchBoundParametersValues(slots, values);
+    test = false;
+  }
+  catch (ConstraintException& e) {}
+  test &= f->getParameterValue("z") == 1. && f->getParameterValue("x") == 6.;
+
+  // Default implementation, going through setParameters:
+  TwoPointsNumericalDerivative nd(f);
+  nd.setParametersToDerivate({ "x", "y" });
+  values[0] = 2.;
+  values[1] = 3.;
+  nd.setBoundParameters(nd.bindParameters({ "z", "x" }), values);
+  test &= f->getParameterValue("z") == 2. && f->getParameterValue("x") == 3.;
+  test &= abs(nd.getFirstOrderDerivative("x") - 2. * (3. - 5.)) < 1e-3;
+
+  cout << (test ? "Bound parameters are correctly set." : "Error in bound parameters!") << endl;
+  return test ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Numeric/Function/CachedFunctionWrapper.h>
+#include <Bpp/Numeric/Function/PowellMultiDimensions.h>
+#include <iostream>
+#include <vector>
+
+#include "PolynomialFunction.h"
+
+using namespace bpp;
+using namespace std;
+
+/**
+ * @brief Count the number of times the function is computed.
+ */
+class CountingFunction :
+  public PolynomialFunction1
+{
+public:
+  unsigned int nbComputations;
+
+public:
+  CountingFunction() : PolynomialFunction1(false), nbComputations(0) {}
+
+  CountingFunction* clone() const { return new CountingFunction(*this); }
+
+public:
+  void fireParameterChanged(const ParameterList& pl)
+  {
+    PolynomialFunction1::fireParameterChanged(pl);
+    nbComputations++;
+  }
+};
+
+double optimize(shared_ptr<FunctionInterface> f, ParameterList& result)
+{
+  PowellMultiDimensions optimizer(f);
+  optimizer.setVerbose(0);
+  optimizer.setProfiler(nullptr);
+  optimizer.setMessageHandler(nullptr);
+  optimizer.init(f->getParameters());
+  double value = optimizer.optimize();
+  result = optimizer.getParameters();
+  return value;
+}
+
+int main()
+{
+  bool test = true;
+
+  // Basic behaviour:
+  auto f = make_shared<CountingFunction>();
+  CachedFunctionWrapper cache(f, 2);
+  f->nbComputations = 0;
+  ParameterList pl = cache.getParameters();
+  pl.setParameterValue("x", 1.);
+  test &= cache.f(pl) == f->f(pl);
+  f->nbComputations = 0;
+  pl.setParameterValue("x", 2.);
+  double v2 = cache.f(pl);
+  pl.setParameterValue("x", 1.);
+  cache.f(pl);
+  test &= f->nbComputations == 1 && cache.getNumberOfHits() == 1;
+  pl.setParameterValue("x", 3.);
+  cache.f(pl); // Discards the least recently used point, with x = 2.
+  pl.setParameterValue("x", 1.);
+  cache.f(pl);
+  test &= cache.getNumberOfHits() == 2;
+  test &= cache.getParameterValue("x") == 1. && f->getParameterValue("x") == 3.;
+  pl.setParameterValue("x", 2.);
+  test &= cache.f(pl) == v2 && cache.getNumberOfMisses() == 4;
+  test &= cache.getNumberOfCachedPoints() == 2;
+
+  // Constraints are checked before anything is changed:
+  cache.setConstraint("z", make_shared<IntervalConstraint>(0., 1., true, true));
+  pl.setParameterValue("z", 2.);
+  try
+  {
+    cache.setParameters(pl);
+    test = false;
+  }
+  catch (ConstraintException& ce) {}
+  test &= cache.getParameterValue("x") == 2. && cache.getParameterValue("z") == 0.;
+  cache.removeConstraint("z");
+
+  // Same optimization with and without cache:
+  auto f1 = make_shared<CountingFunction>();
+  ParameterList res1;
+  double min1 = optimize(f1, res1);
+
+  auto f2 = make_shared<CountingFunction>();
+  auto cached = make_shared<CachedFunctionWrapper>(f2);
+  ParameterList res2;
+  double min2 = optimize(cached, res2);
+  cout << "Without cache: " << f1->nbComputations << " computations." << endl;
+  cout << "With cache: " << f2->nbComputations << " computations, " << cached->getNumberOfHits() << " hits, " << cached->getNumberOfMisses() << " misses." << endl;
+  test &= min1 == min2;
+  for (size_t i = 0; i < res1.size(); ++i)
+  {
+    test &= res1[i].getValue() == res2[i].getValue();
+  }
+  test &= cached->getNumberOfHits() > 0 && f2->nbComputations < f1->nbComputations;
+
+  return test ? 0 : 1;
+}
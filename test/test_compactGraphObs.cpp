@@ -0,0 +1,143 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "../src/Bpp/Graph/AssociationDAGraphImplObserver.h"
+#include "../src/Bpp/Graph/AssociationTreeGraphImplObserver.h"
+
+#include <iostream>
+#include <random>
+#include <vector>
+using namespace bpp;
+using namespace std;
+
+/**
+ * @brief Build the same random tree with a given graph implementation,
+ * and describe it.
+ */
+template<class TreeGraph>
+vector<unsigned int> buildTree(size_t nbNodes, bool& valid)
+{
+  AssociationTreeGraphImplObserver<unsigned int, unsigned int, TreeGraph> tree(true);
+  mt19937 gen(42);
+  vector<shared_ptr<unsigned int>> nodes;
+  nodes.push_back(make_shared<unsigned int>(0));
+  tree.createNode(nodes[0]);
+  tree.rootAt(nodes[0]);
+  for (unsigned int i = 1; i < nbNodes; ++i)
+  {
+    nodes.push_back(make_shared<unsigned int>(i));
+    uniform_int_distribution<size_t> dist(0, i - 1);
+    tree.createNode(nodes[dist(gen)], nodes[i], make_shared<unsigned int>(i));
+  }
+  valid = tree.isValid();
+
+  vector<unsigned int> description;
+  for (const auto& node : nodes)
+  {
+    for (const auto& son : tree.getSons(node))
+    {
+      description.push_back(*son);
+    }
+    description.push_back(static_cast<unsigned int>(tree.getLeavesUnderNode(node).size()));
+  }
+  for (const auto& leaf : tree.getAllLeaves())
+  {
+    description.push_back(*leaf);
+  }
+  unique_ptr<typename AssociationTreeGraphObserver<unsigned int, unsigned int>::NodeIterator> it = tree.allNodesIterator();
+  for ( ; !it->end(); it->next())
+  {
+    description.push_back(***it);
+  }
+  description.push_back(*tree.MRCA({nodes[nbNodes - 1], nodes[nbNodes / 2]}));
+
+  // Re-root and check again
+  tree.rootAt(nodes[nbNodes - 1]);
+  valid &= tree.isValid();
+  for (const auto& node : tree.getSubtreeNodes(nodes[0]))
+  {
+    description.push_back(*node);
+  }
+  return description;
+}
+
+int main()
+{
+  bool test = true;
+
+  // Same topology, same answers:
+  bool validGlobal, validCompact;
+  vector<unsigned int> global = buildTree<TreeGlobalGraph>(2000, validGlobal);
+  vector<unsigned int> compact = buildTree<TreeCompactGraph>(2000, validCompact);
+  cout << "Tree description: " << compact.size() << " values, "
+       << (global == compact ? "identical" : "different") << endl;
+  test &= validGlobal && validCompact && global == compact;
+
+  // Ids of deleted nodes and edges are reused:
+  AssociationTreeCompactGraphObserver<string, string> tree(true);
+  auto a = make_shared<string>("a");
+  auto b = make_shared<string>("b");
+  auto c = make_shared<string>("c");
+  auto d = make_shared<string>("d");
+  tree.createNode(a);
+  tree.createNode(a, b, make_shared<string>("ab"));
+  tree.createNode(a, c, make_shared<string>("ac"));
+  tree.rootAt(a);
+  unsigned int bId = tree.getNodeGraphid(b);
+  tree.deleteNode(b);
+  test &= tree.getGraph()->getNumberOfNodes() == 2 && tree.getGraph()->getNumberOfEdges() == 1;
+  tree.createNode(c, d, make_shared<string>("cd"));
+  test &= tree.getNodeGraphid(d) == bId;
+  test &= *tree.getFatherOfNode(d) == "c" && *tree.getEdgeToFather(d) == "cd";
+  test &= tree.isValid() && tree.getLeavesUnderNode(a).size() == 1;
+  tree.outputToDot(cout, "compact");
+
+  // Nodes deleted directly in the graph are forgotten by the observers
+  // before their ids are reused:
+  unsigned int dId = tree.getNodeGraphid(d);
+  tree.getGraph()->deleteNode(dId);
+  test &= !tree.hasNode(d) && tree.getNodeFromGraphid(dId) == nullptr;
+  auto e = make_shared<string>("e");
+  tree.createNode(c, e);
+  test &= tree.getNodeGraphid(e) == dId && tree.getNodeFromGraphid(dId) == e && !tree.hasNode(d);
+  AssociationTreeGlobalGraphObserver<string, string> globalTree(true);
+  globalTree.createNode(a);
+  globalTree.createNode(a, b);
+  unsigned int globalBId = globalTree.getNodeGraphid(b);
+  globalTree.getGraph()->deleteNode(globalBId);
+  test &= !globalTree.hasNode(b) && globalTree.getNodeFromGraphid(globalBId) == nullptr;
+
+  // Deep trees are validated without recursion:
+  TreeCompactGraph chain(true);
+  Graph::NodeId node = chain.createNode();
+  chain.rootAt(node);
+  for (size_t i = 0; i < 200000; ++i)
+  {
+    node = chain.createNodeFromNode(node);
+  }
+  test &= chain.isValid() && chain.getAllLeaves().size() == 1;
+
+  // Directed acyclic graphs:
+  AssociationDACompactGraphObserver<string, string> dag;
+  dag.createNode(a);
+  dag.createNode(a, b);
+  dag.createNode(a, c);
+  dag.createNode(b, d);
+  dag.link(c, d);
+  dag.rootAt(a);
+  test &= dag.isValid() && dag.getFathers(d).size() == 2;
+  dag.link(d, a);
+  test &= !dag.isValid();
+
+  // Undirected graphs:
+  CompactGraph undirected(false);
+  Graph::NodeId u0 = undirected.createNode();
+  Graph::NodeId u1 = undirected.createNodeFromNode(u0);
+  undirected.createNodeFromNode(u1);
+  test &= undirected.getNeighbors(u1).size() == 2 && undirected.getNumberOfNeighbors(u1) == 2;
+  undirected.deleteNode(u1);
+  test &= undirected.getNumberOfEdges() == 0 && undirected.getNeighbors(u0).empty();
+
+  return test ? 0 : 1;
+}
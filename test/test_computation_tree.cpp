@@ -0,0 +1,136 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Numeric/AbstractParametrizable.h>
+#include <Bpp/Numeric/Function/Operators/ComputationTree.h>
+#include <iostream>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+/**
+ * @brief f(x, y) = a.x^2 + b.x.y + c.y + d, with analytical derivatives.
+ */
+class QuadraticFunction :
+  public virtual SecondOrderDerivable,
+  public AbstractParametrizable
+{
+private:
+  double a_, b_, c_, d_;
+
+public:
+  QuadraticFunction(double a, double b, double c, double d) :
+    AbstractParametrizable(""), a_(a), b_(b), c_(c), d_(d)
+  {
+    addParameter_(new Parameter("x", 0.7));
+    addParameter_(new Parameter("y", 1.3));
+  }
+
+  QuadraticFunction* clone() const { return new QuadraticFunction(*this); }
+
+public:
+  void setParameters(const ParameterList& pl) { matchParametersValues(pl); }
+  void fireParameterChanged(const ParameterList& /* pl */) {}
+
+  double getValue() const
+  {
+    double x = getParameterValue("x"), y = getParameterValue("y");
+    return a_ * x * x + b_ * x * y + c_ * y + d_;
+  }
+
+  void enableFirstOrderDerivatives(bool /* yn */) {}
+  bool enableFirstOrderDerivatives() const { return true; }
+  void enableSecondOrderDerivatives(bool /* yn */) {}
+  bool enableSecondOrderDerivatives() const { return true; }
+
+  double getFirstOrderDerivative(const std::string& variable) const
+  {
+    double x = getParameterValue("x"), y = getParameterValue("y");
+    return variable == "x" ? 2 * a_ * x + b_ * y : b_ * x + c_;
+  }
+
+  double getSecondOrderDerivative(const std::string& variable) const
+  {
+    return variable == "x" ? 2 * a_ : 0;
+  }
+
+  double getSecondOrderDerivative(const std::string& variable1, const std::string& variable2) const
+  {
+    if (variable1 == variable2)
+      return getSecondOrderDerivative(variable1);
+    return b_;
+  }
+};
+
+bool isClose(double x, double y, double tol)
+{
+  return abs(x - y) <= tol * (1. + abs(y));
+}
+
+int main()
+{
+  bool test = true;
+
+  auto f = make_shared<QuadraticFunction>(1., 0.5, -1., 2.);
+  auto g = make_shared<QuadraticFunction>(0.2, -0.3, 0.4, 1.);
+  map<string, shared_ptr<FunctionInterface>> functions = {{"f", f}, {"g", g}};
+  vector<string> variables = {"x", "y"};
+  double h = 1e-5;
+
+  for (string formula : {"f - g", "2*f + exp(g)/f - log(f*g)", "-(f*f*g) + 3/(g+1) - 0.5"})
+  {
+    ComputationTree tree(formula, functions);
+    cout << tree.output() << endl;
+
+    vector<double> gradient;
+    double value = tree.getValueAndGradient(variables, gradient);
+    test &= value == tree.getValue();
+
+    // Compare with finite differences:
+    vector<double> direction = {0.3, -0.8};
+    vector<double> gradient2, product;
+    tree.getHessianVectorProduct(variables, direction, gradient2, product);
+    test &= gradient2 == gradient;
+
+    vector<double> numProduct(2, 0.);
+    for (size_t i = 0; i < variables.size(); ++i)
+    {
+      double x = f->getParameterValue(variables[i]);
+      f->setParameterValue(variables[i], x + h);
+      g->setParameterValue(variables[i], x + h);
+      double vp = tree.getValue();
+      vector<double> gp;
+      tree.getValueAndGradient(variables, gp);
+      f->setParameterValue(variables[i], x - h);
+      g->setParameterValue(variables[i], x - h);
+      double vm = tree.getValue();
+      vector<double> gm;
+      tree.getValueAndGradient(variables, gm);
+      f->setParameterValue(variables[i], x);
+      g->setParameterValue(variables[i], x);
+
+      double numDer = (vp - vm) / (2 * h);
+      cout << "  d/d" << variables[i] << ": " << gradient[i] << " (numerical: " << numDer << ")" << endl;
+      test &= isClose(gradient[i], numDer, 1e-6);
+      test &= tree.getFirstOrderDerivative(variables[i]) == gradient[i];
+
+      // Symbolic derivatives of the operators:
+      test &= isClose(tree.getRoot()->getFirstOrderDerivative(variables[i]), gradient[i], 1e-10);
+      test &= isClose(tree.getRoot()->getSecondOrderDerivative(variables[i]), tree.getSecondOrderDerivative(variables[i]), 1e-10);
+
+      for (size_t j = 0; j < variables.size(); ++j)
+      {
+        numProduct[j] += direction[i] * (gp[j] - gm[j]) / (2 * h);
+      }
+    }
+    for (size_t j = 0; j < variables.size(); ++j)
+    {
+      cout << "  (Hu)_" << variables[j] << ": " << product[j] << " (numerical: " << numProduct[j] << ")" << endl;
+      test &= isClose(product[j], numProduct[j], 1e-6);
+    }
+  }
+
+  return test ? 0 : 1;
+}
@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/App/ApplicationTools.h>
+#include <Bpp/Numeric/Matrix/Matrix.h>
+#include <Bpp/Numeric/Matrix/MatrixTools.h>
+#include <Bpp/Numeric/Random/RandomTools.h>
+#include <cstdint>
+#include <vector>
+#include <iostream>
+
+using namespace bpp;
+using namespace std;
+
+int main()
+{
+  bool test = true;
+
+  // Storage and alignment
+  DenseMatrix<double> m(13, 37);
+  for (size_t i = 0; i < m.getNumberOfRows(); ++i)
+  {
+    test &= (reinterpret_cast<uintptr_t>(m.rowData(i)) % DenseMatrix<double>::ALIGNMENT == 0);
+    for (size_t j = 0; j < m.getNumberOfColumns(); ++j)
+    {
+      test &= (m(i, j) == 0.);
+      m(i, j) = RandomTools::giveRandomNumberBetweenZeroAndEntry(1.);
+    }
+  }
+  test &= (m.stride() == 40);
+  ApplicationTools::displayBooleanResult("Alignment", test);
+
+  // Views share the data
+  DenseMatrixView<double> b = m.block(2, 3, 4, 5);
+  b(1, 2) = -1.;
+  test &= (m(3, 5) == -1.);
+  test &= (m.rowView(3)(0, 5) == -1.) && (m.colView(5)(3, 0) == -1.);
+  test &= (b.colView(2).col(0) == vector<double>({ m(2, 5), m(3, 5), m(4, 5), m(5, 5) }));
+  MatrixTools::fill(b, 0.);
+  test &= (m(5, 7) == 0.) && (m(6, 7) != 0.);
+  ApplicationTools::displayBooleanResult("Views", test);
+
+  // Resizing keeps values
+  DenseMatrix<double> r(m);
+  r.resize(20, 10);
+  for (size_t i = 0; i < 13; ++i)
+  {
+    for (size_t j = 0; j < 10; ++j)
+    {
+      test &= (r(i, j) == m(i, j));
+    }
+  }
+  test &= (r(19, 9) == 0.);
+  r.resize(13, 37);
+  test &= (r(0, 20) == 0.) && (r(5, 5) == m(5, 5));
+  ApplicationTools::displayBooleanResult("Resize", test);
+
+  // Products on views, checked against the generic path
+  DenseMatrix<double> q(40, 40);
+  for (size_t i = 0; i < 40; ++i)
+  {
+    for (size_t j = 0; j < 40; ++j)
+    {
+      q(i, j) = RandomTools::giveRandomNumberBetweenZeroAndEntry(1.);
+    }
+  }
+  DenseMatrix<double> p(8, 8);
+  DenseMatrixView<double> pb = p.block(1, 2, 4, 6);
+  MatrixTools::mult(m.block(0, 0, 4, 30), q.block(5, 1, 30, 6), pb);
+  ColMatrix<double> ca(m.block(0, 0, 4, 30)), cb(q.block(5, 1, 30, 6)), co;
+  MatrixTools::mult(ca, cb, co);
+  test &= pb.equals(co, 1e-12) && (p(0, 0) == 0.) && (p(1, 1) == 0.);
+  ApplicationTools::displayBooleanResult("Products", test);
+
+  // Decompositions
+  DenseMatrix<double> s(m.block(0, 0, 10, 10));
+  DenseMatrix<double> si, id;
+  MatrixTools::inv(s, si);
+  MatrixTools::mult(s, si, id);
+  RowMatrix<double> ref;
+  MatrixTools::getId(10, ref);
+  test &= id.equals(ref, 1e-9);
+  ApplicationTools::displayBooleanResult("Inverse", test);
+
+  return test ? 0 : 1;
+}
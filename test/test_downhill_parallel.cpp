@@ -0,0 +1,156 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Numeric/AbstractParametrizable.h>
+#include <Bpp/Numeric/Function/DownhillSimplexMethod.h>
+#include <Bpp/Text/TextTools.h>
+#include <Bpp/Utils/ThreadPool.h>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+/**
+ * @brief A quadratic function with coupled parameters.
+ */
+class CoupledFunction :
+  public virtual FunctionInterface,
+  public AbstractParametrizable
+{
+private:
+  double fval_;
+
+public:
+  CoupledFunction(size_t n) : AbstractParametrizable(""), fval_(0)
+  {
+    for (size_t i = 0; i < n; ++i)
+    {
+      addParameter_(new Parameter("x" + TextTools::toString(i), 0));
+    }
+    fireParameterChanged(getParameters());
+  }
+
+  CoupledFunction* clone() const { return new CoupledFunction(*this); }
+
+public:
+  void setParameters(const ParameterList& pl) { matchParametersValues(pl); }
+
+  double getValue() const { return fval_; }
+
+  void fireParameterChanged(const ParameterList& /* pl */)
+  {
+    fval_ = 0;
+    for (size_t i = 0; i < getNumberOfParameters(); ++i)
+    {
+      double x = getParameter_(i).getValue();
+      fval_ += (x - static_cast<double>(i)) * (x - static_cast<double>(i));
+      if (i > 0)
+        fval_ += 0.5 * x * getParameter_(i - 1).getValue();
+    }
+  }
+};
+
+/**
+ * @brief A function with a plateau around the starting point, where the reflected point ties with
+ * the simplex.
+ */
+class PlateauFunction :
+  public virtual FunctionInterface,
+  public AbstractParametrizable
+{
+private:
+  double fval_;
+
+public:
+  PlateauFunction() : AbstractParametrizable(""), fval_(0)
+  {
+    addParameter_(new Parameter("x", 0));
+    fireParameterChanged(getParameters());
+  }
+
+  PlateauFunction* clone() const { return new PlateauFunction(*this); }
+
+public:
+  void setParameters(const ParameterList& pl) { matchParametersValues(pl); }
+
+  double getValue() const { return fval_; }
+
+  void fireParameterChanged(const ParameterList& /* pl */)
+  {
+    double x = getParameter_(0).getValue();
+    fval_ = std::abs(x) < 0.3 ? 1. : (x - 1.) * (x - 1.);
+  }
+};
+
+double optimizePlateau(shared_ptr<ThreadPool> pool, bool speculative)
+{
+  auto f = make_shared<PlateauFunction>();
+  DownhillSimplexMethod optimizer(f);
+  optimizer.setVerbose(0);
+  optimizer.setProfiler(nullptr);
+  optimizer.setMessageHandler(nullptr);
+  optimizer.setThreadPool(pool);
+  optimizer.setSpeculativeEvaluation(speculative);
+  optimizer.getStopCondition()->setTolerance(1e-10);
+  optimizer.init(f->getParameters());
+  optimizer.optimize();
+  return f->getParameterValue("x");
+}
+
+vector<double> optimize(shared_ptr<ThreadPool> pool, bool speculative, double& value, bool wrapped = false)
+{
+  auto f = make_shared<CoupledFunction>(6);
+  shared_ptr<FunctionInterface> objective = f;
+  if (wrapped)
+    objective = make_shared<InfinityFunctionWrapper>(f);
+  DownhillSimplexMethod optimizer(objective);
+  optimizer.setVerbose(0);
+  optimizer.setProfiler(nullptr);
+  optimizer.setMessageHandler(nullptr);
+  optimizer.setThreadPool(pool);
+  optimizer.setSpeculativeEvaluation(speculative);
+  optimizer.getStopCondition()->setTolerance(1e-10);
+  optimizer.init(f->getParameters());
+  value = optimizer.optimize();
+  cout << (pool ? pool->getNumberOfThreads() : 0) << " threads" << (speculative ? ", speculative" : "") << (wrapped ? ", wrapped" : "") << ": f=" << value;
+  cout << " (" << optimizer.getNumberOfEvaluations() << " evaluations)" << endl;
+  vector<double> x(f->getNumberOfParameters());
+  for (size_t i = 0; i < x.size(); ++i)
+  {
+    x[i] = f->getParameters()[i].getValue();
+  }
+  return x;
+}
+
+int main()
+{
+  bool test = true;
+  double ref;
+  vector<double> xref = optimize(nullptr, false, ref);
+  for (size_t nbThreads : {1, 2, 4})
+  {
+    auto pool = make_shared<ThreadPool>(nbThreads);
+    for (bool speculative : {false, true})
+    {
+      double value;
+      vector<double> x = optimize(pool, speculative, value);
+      // The same points are computed in the same order:
+      test &= value == ref && x == xref;
+    }
+  }
+
+  // Each thread also has its own copy of a wrapped function:
+  double wrappedValue;
+  vector<double> xwrapped = optimize(make_shared<ThreadPool>(4), true, wrappedValue, true);
+  test &= wrappedValue == ref && xwrapped == xref;
+
+  // Ties between the reflected point and the simplex:
+  double plateau = optimizePlateau(nullptr, false);
+  double speculativePlateau = optimizePlateau(make_shared<ThreadPool>(4), true);
+  cout << "Plateau: x=" << plateau << ", speculative x=" << speculativePlateau << endl;
+  test &= plateau == speculativePlateau;
+  return test ? 0 : 1;
+}
@@ -0,0 +1,140 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/App/ApplicationTools.h>
+#include <Bpp/Numeric/Matrix/Matrix.h>
+#include <Bpp/Numeric/Matrix/MatrixKernels.h>
+#include <Bpp/Numeric/Matrix/MatrixTools.h>
+#include <Bpp/Numeric/Random/RandomTools.h>
+#include <cmath>
+#include <vector>
+#include <iostream>
+
+using namespace bpp;
+using namespace std;
+
+template<class MatrixType>
+void fillRandom(MatrixType& m)
+{
+  for (size_t i = 0; i < m.getNumberOfRows(); ++i)
+  {
+    for (size_t j = 0; j < m.getNumberOfColumns(); ++j)
+    {
+      m(i, j) = RandomTools::giveRandomNumberBetweenZeroAndEntry(2.) - 1.;
+    }
+  }
+}
+
+bool testSizes(size_t m, size_t k, size_t n)
+{
+  // ColMatrix does not use the dense kernels, and provides the reference.
+  ColMatrix<double> a(m, k), b(k, n), ref;
+  fillRandom(a);
+  fillRandom(b);
+  MatrixTools::mult(a, b, ref);
+
+  LinearMatrix<double> la(a), lb(b), lo;
+  MatrixTools::mult(la, lb, lo);
+  RowMatrix<double> ra(a), rb(b), ro;
+  MatrixTools::mult(ra, rb, ro);
+  RowMatrix<double> mo;
+  MatrixTools::mult(la, rb, mo);
+
+  double tol = 1e-12 * static_cast<double>(k);
+  bool test = lo.equals(ref, tol) && ro.equals(ref, tol) && mo.equals(ref, tol);
+  if (!test)
+    cerr << "Failed for " << m << "x" << k << " . " << k << "x" << n << endl;
+  return test;
+}
+
+bool testDiag(size_t m, size_t k, size_t n)
+{
+  ColMatrix<double> a(m, k), ia(m, k), b(k, n), ib(k, n), ref, iref;
+  fillRandom(a);
+  fillRandom(ia);
+  fillRandom(b);
+  fillRandom(ib);
+  vector<vector<double>> vD(5, vector<double>(k)), viD(5, vector<double>(k));
+  for (size_t t = 0; t < vD.size(); ++t)
+  {
+    for (size_t p = 0; p < k; ++p)
+    {
+      vD[t][p] = RandomTools::giveRandomNumberBetweenZeroAndEntry(1.);
+      viD[t][p] = RandomTools::giveRandomNumberBetweenZeroAndEntry(1.);
+    }
+  }
+  double tol = 1e-12 * static_cast<double>(k);
+  bool test = true;
+
+  RowMatrix<double> ra(a), ria(ia), rb(b), rib(ib), ro, rio;
+  vector<DenseMatrix<double>> vO;
+  MatrixTools::mult(ra, vD, rb, vO);
+  for (size_t t = 0; t < vD.size(); ++t)
+  {
+    MatrixTools::mult(a, vD[t], b, ref);
+    MatrixTools::mult(ra, vD[t], rb, ro);
+    test &= ro.equals(ref, tol) && vO[t].equals(ref, tol);
+
+    MatrixTools::mult(a, ia, vD[t], viD[t], b, ib, ref, iref);
+    MatrixTools::mult(ra, ria, vD[t], viD[t], rb, rib, ro, rio);
+    test &= ro.equals(ref, tol) && rio.equals(iref, tol);
+  }
+  if (!test)
+    cerr << "Diagonal products failed for " << m << "x" << k << " . " << k << "x" << n << endl;
+  return test;
+}
+
+bool testGemv(size_t m, size_t n)
+{
+  // Rows are stored with some padding, to check the stride:
+  size_t lda = n + 3;
+  vector<double> a(m * lda), x(n), y(m);
+  for (auto& v : a) { v = RandomTools::giveRandomNumberBetweenZeroAndEntry(2.) - 1.; }
+  for (auto& v : x) { v = RandomTools::giveRandomNumberBetweenZeroAndEntry(2.) - 1.; }
+  MatrixKernels::gemv(m, n, a.data(), lda, x.data(), y.data());
+
+  bool test = true;
+  for (size_t i = 0; i < m; ++i)
+  {
+    double ref = 0;
+    for (size_t p = 0; p < n; ++p)
+    {
+      ref += a[i * lda + p] * x[p];
+    }
+    test &= abs(y[i] - ref) < 1e-12 * static_cast<double>(n + 1);
+  }
+  if (!test)
+    cerr << "Matrix-vector product failed for " << m << "x" << n << endl;
+  return test;
+}
+
+int main()
+{
+  vector<MatrixKernels::SimdLevel> levels = { MatrixKernels::SimdLevel::SCALAR };
+  if (MatrixKernels::getSupportedSimdLevel() >= MatrixKernels::SimdLevel::AVX2)
+    levels.push_back(MatrixKernels::SimdLevel::AVX2);
+  if (MatrixKernels::getSupportedSimdLevel() >= MatrixKernels::SimdLevel::AVX512)
+    levels.push_back(MatrixKernels::SimdLevel::AVX512);
+
+  bool test = true;
+  for (auto level : levels)
+  {
+    MatrixKernels::setSimdLevel(level);
+    cout << "SIMD level " << static_cast<int>(level) << endl;
+    test &= testSizes(20, 20, 20);
+    test &= testSizes(1, 37, 513);
+    test &= testSizes(61, 300, 7);
+    test &= testSizes(97, 259, 131);
+    test &= testDiag(20, 20, 20);
+    test &= testDiag(33, 270, 17);
+    test &= testGemv(1, 1);
+    test &= testGemv(7, 13);
+    test &= testGemv(50, 50);
+    test &= testGemv(203, 117);
+  }
+  MatrixKernels::setSimdLevel(MatrixKernels::getSupportedSimdLevel());
+
+  ApplicationTools::displayBooleanResult("Test passed", test);
+  return test ? 0 : 1;
+}
@@ -0,0 +1,239 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "../src/Bpp/Graph/AssociationTreeGraphImplObserver.h"
+#include "../src/Bpp/Graph/DAGraphImpl.h"
+#include "../src/Bpp/Graph/TreeGraphImpl.h"
+
+#include <iostream>
+#include <random>
+#include <vector>
+using namespace bpp;
+using namespace std;
+
+/**
+ * @brief Build the same random tree node by node and from an array of
+ * fathers, and compare them.
+ */
+template<class Tree>
+bool compareBuilds(size_t nbNodes)
+{
+  mt19937 gen(11);
+  vector<size_t> fathers(1, 0);
+  for (size_t i = 1; i < nbNodes; ++i)
+  {
+    uniform_int_distribution<size_t> dist(0, i - 1);
+    fathers.push_back(dist(gen));
+  }
+
+  Tree incremental(true);
+  vector<Graph::NodeId> nodes;
+  for (size_t i = 0; i < nbNodes; ++i)
+  {
+    nodes.push_back(incremental.createNode());
+  }
+  for (size_t i = 1; i < nbNodes; ++i)
+  {
+    incremental.addSon(nodes[fathers[i]], nodes[i]);
+  }
+  incremental.rootAt(nodes[0]);
+
+  Tree bulk(true);
+  vector<Graph::NodeId> bulkNodes = bulk.createTreeFromFathers(fathers);
+  bool test = bulk.isValid() && bulk.getRoot() == bulkNodes[0];
+  test &= bulk.getNumberOfNodes() == nbNodes && bulk.getNumberOfEdges() == nbNodes - 1;
+  test &= bulkNodes == nodes;
+  test &= bulk.getPreOrder() == incremental.getPreOrder();
+  test &= bulk.getPostOrder() == incremental.getPostOrder();
+  for (size_t i = 1; i < nbNodes; ++i)
+  {
+    test &= bulk.getFatherOfNode(bulkNodes[i]) == bulkNodes[fathers[i]];
+    test &= bulk.getTop(bulk.getEdgeToFather(bulkNodes[i])) == bulkNodes[fathers[i]];
+  }
+  test &= bulk.getAllLeaves() == incremental.getAllLeaves();
+
+  // The tree can still be modified afterwards:
+  bulk.rootAt(bulkNodes[nbNodes - 1]);
+  Graph::NodeId newNode = bulk.createNode();
+  bulk.addSon(bulkNodes[0], newNode);
+  test &= bulk.isValid() && bulk.getPreOrder().size() == nbNodes + 1;
+  return test;
+}
+
+template<class Tree>
+bool checkErrors()
+{
+  bool test = true;
+  vector<vector<size_t>> invalid = {
+    {}, {1, 0}, {0, 0, 3}, {0, 1, 2}, {0, 2, 3, 1}
+  };
+  for (const auto& fathers : invalid)
+  {
+    Tree tree(true);
+    try
+    {
+      tree.createTreeFromFathers(fathers);
+      test = false;
+    }
+    catch (Exception& e)
+    {
+      test &= tree.getNumberOfNodes() == 0;
+    }
+  }
+  Tree tree(true);
+  tree.createTreeFromFathers({0, 0, 0});
+  try
+  {
+    tree.createTreeFromFathers({0, 0});
+    test = false;
+  }
+  catch (Exception& e)
+  {}
+  test &= tree.getNumberOfNodes() == 3;
+  return test;
+}
+
+/**
+ * @brief A graph relying on the default implementation of createNodesAndEdges.
+ */
+class DefaultBulkGraph :
+  public GlobalGraph
+{
+public:
+  DefaultBulkGraph(bool directed) : GlobalGraph(directed) {}
+
+  std::pair<Graph::NodeId, Graph::EdgeId> createNodesAndEdges(size_t nbNodes, const std::vector<std::pair<size_t, size_t>>& links) override
+  {
+    return Graph::createNodesAndEdges(nbNodes, links);
+  }
+};
+
+template<class DAGraph, class GraphImpl>
+bool checkGraph()
+{
+  bool test = true;
+
+  // Directed graph, appended to existing nodes:
+  DAGraph dag;
+  Graph::NodeId single = dag.createNode();
+  auto first = dag.createNodesAndEdges(4, {{0, 1}, {0, 2}, {1, 3}, {2, 3}});
+  test &= first.first != single && dag.getNumberOfNodes() == 5 && dag.getNumberOfEdges() == 4;
+  test &= dag.getIncomingNeighbors(first.first + 3).size() == 2 && dag.isDA();
+  test &= dag.getNodes(first.second + 2) == make_pair(first.first + 1, first.first + 3);
+  test &= dag.getEdge(first.first + 2, first.first + 3) == first.second + 3;
+  dag.createNodeFromNode(first.first + 3);
+  test &= dag.getNumberOfEdges() == 5 && dag.getSons(first.first).size() == 2;
+
+  // Undirected graph: a relation in both directions is a duplicate.
+  GraphImpl graph(false);
+  graph.createNodesAndEdges(3, {{0, 1}, {1, 2}});
+  test &= graph.getNumberOfNeighbors(1) == 2 && graph.isTree();
+  try
+  {
+    graph.createNodesAndEdges(2, {{0, 1}, {1, 0}});
+    test = false;
+  }
+  catch (Exception& e)
+  {}
+  try
+  {
+    graph.createNodesAndEdges(2, {{0, 2}});
+    test = false;
+  }
+  catch (Exception& e)
+  {}
+  test &= graph.getNumberOfNodes() == 3 && graph.getNumberOfEdges() == 2;
+  return test;
+}
+
+int main()
+{
+  bool test = true;
+  test &= compareBuilds<TreeGlobalGraph>(3000);
+  test &= compareBuilds<TreeCompactGraph>(3000);
+  test &= checkErrors<TreeGlobalGraph>();
+  test &= checkErrors<TreeCompactGraph>();
+  cout << "Trees from fathers: " << (test ? "ok" : "failed") << endl;
+
+  test &= checkGraph<DAGlobalGraph, GlobalGraph>();
+  test &= checkGraph<DACompactGraph, CompactGraph>();
+
+  // Default implementation, built on createNode and link:
+  GlobalGraph reference(true);
+  DefaultBulkGraph defaultGraph(true);
+  reference.createNode();
+  defaultGraph.createNode();
+  vector<pair<size_t, size_t>> dagLinks = {{0, 1}, {0, 2}, {1, 3}, {2, 3}};
+  test &= defaultGraph.createNodesAndEdges(4, dagLinks) == reference.createNodesAndEdges(4, dagLinks);
+  test &= defaultGraph.getAllEdges() == reference.getAllEdges();
+  for (auto edge : reference.getAllEdges())
+  {
+    test &= defaultGraph.getNodes(edge) == reference.getNodes(edge);
+  }
+  try
+  {
+    defaultGraph.createNodesAndEdges(2, {{0, 2}});
+    test = false;
+  }
+  catch (Exception& e)
+  {}
+  test &= defaultGraph.getNumberOfNodes() == 5;
+  cout << "Graphs from links: " << (test ? "ok" : "failed") << endl;
+
+  // Objects associated in bulk:
+  AssociationTreeCompactGraphObserver<string, string> tree(true);
+  vector<shared_ptr<string>> nodes, edges;
+  vector<pair<size_t, size_t>> links;
+  for (size_t i = 0; i < 100; ++i)
+  {
+    nodes.push_back(make_shared<string>("n" + to_string(i)));
+    if (i > 0)
+    {
+      links.push_back(make_pair(i / 2, i));
+      edges.push_back(make_shared<string>("e" + to_string(i)));
+    }
+  }
+  tree.createNodesAndEdges(nodes, links, edges);
+  tree.rootAt(nodes[0]);
+  test &= tree.isValid() && tree.getNumberOfNodes() == 100 && tree.getNumberOfEdges() == 99;
+  test &= *tree.getFatherOfNode(nodes[41]) == "n20" && *tree.getEdgeToFather(nodes[41]) == "e41";
+  test &= tree.getLeavesUnderNode(nodes[1]).size() == 50;
+  // Objects already in the graph, repeated or null: nothing is created.
+  auto other = make_shared<string>("other");
+  vector<vector<shared_ptr<string>>> invalidNodes = {
+    {nodes[3]}, {other, other}, {other, nullptr}
+  };
+  for (const auto& invalid : invalidNodes)
+  {
+    try
+    {
+      tree.createNodesAndEdges(invalid, {});
+      test = false;
+    }
+    catch (Exception& e)
+    {}
+  }
+  try
+  {
+    auto edge = make_shared<string>("edge");
+    tree.createNodesAndEdges({other, make_shared<string>("a"), make_shared<string>("b")}, {{0, 1}, {0, 2}}, {edge, edge});
+    test = false;
+  }
+  catch (Exception& e)
+  {}
+  test &= tree.getNumberOfNodes() == 100 && tree.getNumberOfEdges() == 99 && !tree.hasNode(other);
+
+  // Large tree:
+  TreeCompactGraph large(true);
+  vector<size_t> fathers(1000000);
+  for (size_t i = 0; i < fathers.size(); ++i)
+  {
+    fathers[i] = i / 2;
+  }
+  large.createTreeFromFathers(fathers);
+  test &= large.getLeavesUnderNode(large.getSons(large.getRoot())[0]).size() == 500000;
+  cout << "Objects and large trees: " << (test ? "ok" : "failed") << endl;
+
+  return test ? 0 : 1;
+}
@@ -0,0 +1,84 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "../src/Bpp/Graph/AssociationTreeGraphImplObserver.h"
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+using namespace bpp;
+using namespace std;
+
+struct Branch
+{
+  double length;
+  explicit Branch(double l) : length(l) {}
+};
+
+template<class TreeGraph>
+bool testTree()
+{
+  AssociationTreeGraphImplObserver<unsigned int, Branch, TreeGraph> tree(true);
+  mt19937 gen(5);
+  vector<shared_ptr<unsigned int>> nodes(1, make_shared<unsigned int>(0));
+  vector<shared_ptr<Branch>> branches;
+  tree.createNode(nodes[0]);
+  tree.rootAt(nodes[0]);
+  for (unsigned int i = 1; i < 1000; ++i)
+  {
+    uniform_int_distribution<size_t> dist(0, nodes.size() - 1);
+    nodes.push_back(make_shared<unsigned int>(i));
+    branches.push_back(make_shared<Branch>(i / 1000.));
+    tree.createNode(nodes[dist(gen)], nodes[i], branches.back());
+  }
+  bool test = true;
+
+  // Constant time lookups, consistent with the dense tables:
+  for (const auto& node : nodes)
+  {
+    test &= tree.getNodesByGraphid().at(tree.getNodeGraphid(node)) == node;
+  }
+  for (const auto& branch : branches)
+  {
+    test &= tree.getEdgesByGraphid().at(tree.getEdgeGraphid(branch)) == branch;
+  }
+
+  // Gather, process and scatter branch lengths:
+  tree.deleteNode(nodes[999]);
+  vector<double> lengths = tree.template gatherEdgeAttribute<double>([](const Branch& b) {return b.length;}, -1.);
+  test &= lengths.size() == tree.getEdgesByGraphid().size();
+  double total = 0;
+  for (auto& length : lengths)
+  {
+    if (length >= 0)
+      total += length;
+    length *= 2;
+  }
+  test &= abs(total - (998. * 999. / 2000.)) < 1e-9;
+  tree.scatterEdgeAttribute(lengths, [](Branch& b, double l) {b.length = l;});
+  test &= branches[10]->length == 11. / 500.;
+
+  // Node attributes:
+  vector<unsigned int> labels = tree.template gatherNodeAttribute<unsigned int>([](unsigned int n) {return n;});
+  test &= labels.at(tree.getNodeGraphid(nodes[42])) == 42;
+  tree.scatterNodeAttribute(labels, [](unsigned int& n, unsigned int l) {n = l + 1;});
+  test &= *nodes[42] == 43;
+  try
+  {
+    tree.scatterNodeAttribute(vector<unsigned int>(3), [](unsigned int& n, unsigned int l) {n = l;});
+    test = false;
+  }
+  catch (Exception& e)
+  {}
+  return test;
+}
+
+int main()
+{
+  bool test = testTree<TreeGlobalGraph>();
+  test &= testTree<TreeCompactGraph>();
+  cout << "Attributes by graph id: " << (test ? "ok" : "failed") << endl;
+  return test ? 0 : 1;
+}
@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Numeric/Hmm/BatchRescaledHmmLikelihood.h>
+#include <Bpp/Numeric/Hmm/FullHmmTransitionMatrix.h>
+#include <Bpp/Numeric/Hmm/RescaledHmmLikelihood.h>
+#include <Bpp/Numeric/Matrix/Matrix.h>
+#include <Bpp/Utils/ThreadPool.h>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "SimpleHmm.h"
+
+using namespace bpp;
+using namespace std;
+
+int main()
+{
+  bool test = true;
+
+  size_t nbStates = 5, nbSequences = 300;
+  auto alphabet = make_shared<SimpleHmmStateAlphabet>(nbStates);
+  auto trans = make_shared<FullHmmTransitionMatrix>(alphabet);
+  RowMatrix<double> pij(nbStates, nbStates);
+  for (size_t i = 0; i < nbStates; ++i)
+  {
+    for (size_t j = 0; j < nbStates; ++j)
+    {
+      pij(i, j) = (i == j) ? 0.8 : 0.2 / static_cast<double>(nbStates - 1);
+    }
+  }
+  trans->setTransitionProbabilities(pij);
+
+  // Short sequences of random lengths:
+  vector< shared_ptr<HmmEmissionProbabilities> > emissions;
+  for (size_t s = 0; s < nbSequences; ++s)
+  {
+    size_t nbSites = 1 + static_cast<size_t>(RandomTools::giveRandomNumberBetweenZeroAndEntry(100.));
+    emissions.push_back(make_shared<SimpleHmmEmissionProbabilities>(alphabet, simulateSimpleHmmData(nbSites)));
+  }
+
+  BatchRescaledHmmLikelihood batch(alphabet, trans, emissions, "");
+  double logLik = batch.getLogLikelihood();
+  double dLogLik = batch.getFirstOrderDerivative("p2");
+  double d2LogLik = batch.getSecondOrderDerivative("p2");
+
+  // Compared to one likelihood object per sequence:
+  double refLogLik = 0, refDLogLik = 0, refD2LogLik = 0;
+  for (size_t s = 0; s < nbSequences; ++s)
+  {
+    RescaledHmmLikelihood lik(alphabet, trans, emissions[s], "");
+    double seqLogLik = lik.getLogLikelihood();
+    double seqDLogLik = lik.getFirstOrderDerivative("p2");
+    double seqD2LogLik = lik.getSecondOrderDerivative("p2");
+    test &= abs(batch.getLogLikelihoodForASequence(s) - seqLogLik) < 1e-10 * abs(seqLogLik);
+    test &= abs(batch.getDLogLikelihoodForASequence(s) + seqDLogLik) < 1e-8 * (1. + abs(seqDLogLik));
+    test &= abs(batch.getD2LogLikelihoodForASequence(s) + seqD2LogLik) < 1e-8 * (1. + abs(seqD2LogLik));
+    refLogLik += seqLogLik;
+    refDLogLik += seqDLogLik;
+    refD2LogLik += seqD2LogLik;
+  }
+  cout << "Batch: " << logLik << " " << dLogLik << " " << d2LogLik << endl;
+  cout << "Separate: " << refLogLik << " " << refDLogLik << " " << refD2LogLik << endl;
+  test &= abs(logLik - refLogLik) < 1e-10 * abs(refLogLik);
+  test &= abs(dLogLik - refDLogLik) < 1e-8 * abs(refDLogLik);
+  test &= abs(d2LogLik - refD2LogLik) < 1e-8 * abs(refD2LogLik);
+
+  // Shared parameters are set in all sequences:
+  batch.setParameterValue("p2", 0.6);
+  double newLogLik = 0;
+  for (size_t s = 0; s < nbSequences; ++s)
+  {
+    newLogLik += batch.getLogLikelihoodForASequence(s);
+    test &= emissions[s]->getParameterValue("p2") == 0.6;
+  }
+  test &= abs(batch.getLogLikelihood() - newLogLik) < 1e-10 * abs(newLogLik);
+
+  // Results are identical whatever the number of threads:
+  for (size_t nbThreads : { 2, 3, 8 })
+  {
+    BatchRescaledHmmLikelihood parallel(alphabet, trans, emissions, "");
+    parallel.setThreadPool(make_shared<ThreadPool>(nbThreads));
+    parallel.setParameterValue("p2", 0.5);
+    batch.setParameterValue("p2", 0.5);
+    bool same = parallel.getLogLikelihood() == batch.getLogLikelihood()
+                && parallel.getFirstOrderDerivative("p3") == batch.getFirstOrderDerivative("p3")
+                && parallel.getSecondOrderDerivative("p3") == batch.getSecondOrderDerivative("p3");
+    cout << nbThreads << " threads: " << (same ? "identical" : "different") << endl;
+    test &= same;
+  }
+
+  return test ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Numeric/Hmm/AutoCorrelationTransitionMatrix.h>
+#include <Bpp/Numeric/Hmm/FullHmmTransitionMatrix.h>
+#include <Bpp/Numeric/Hmm/HmmDecoder.h>
+#include <Bpp/Numeric/Hmm/LogsumHmmLikelihood.h>
+#include <Bpp/Numeric/Hmm/RescaledHmmLikelihood.h>
+#include <Bpp/Numeric/Matrix/Matrix.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "SimpleHmm.h"
+
+using namespace bpp;
+using namespace std;
+
+// Log probability of the data and a given path, with the conventions of the HMM likelihood classes.
+double jointLogProb(const vector<size_t>& path, const HmmTransitionMatrix& trans, const HmmEmissionProbabilities& emissions, const vector<size_t>& breakPoints)
+{
+  size_t nbStates = trans.getNumberOfStates();
+  const vector<double>& eqFreq = trans.getEquilibriumFrequencies();
+  double logProb = 0;
+  for (size_t i = 0; i < path.size(); ++i)
+  {
+    bool reset = (i == 0 || find(breakPoints.begin(), breakPoints.end(), i) != breakPoints.end());
+    double p = 0;
+    if (reset)
+    {
+      for (size_t k = 0; k < nbStates; ++k)
+      {
+        p += eqFreq[k] * trans.Pij(k, path[i]);
+      }
+    }
+    else
+      p = trans.Pij(path[i - 1], path[i]);
+    logProb += log(p) + log(emissions(i, path[i]));
+  }
+  return logProb;
+}
+
+int main()
+{
+  bool test = true;
+
+  // Small model, checked against all possible paths.
+  size_t nbStates = 3, nbSites = 9;
+  auto alphabet = make_shared<SimpleHmmStateAlphabet>(nbStates);
+  auto trans = make_shared<FullHmmTransitionMatrix>(alphabet);
+  RowMatrix<double> pij(nbStates, nbStates);
+  pij(0, 0) = 0.8; pij(0, 1) = 0.15; pij(0, 2) = 0.05;
+  pij(1, 0) = 0.1; pij(1, 1) = 0.7; pij(1, 2) = 0.2;
+  pij(2, 0) = 0.3; pij(2, 1) = 0.3; pij(2, 2) = 0.4;
+  trans->setTransitionProbabilities(pij);
+  vector<int> data = { 1, 1, 0, 0, 0, 1, 0, 1, 1 };
+  auto emissions = make_shared<SimpleHmmEmissionProbabilities>(alphabet, data);
+  vector<size_t> breakPoints = { 4 };
+
+  HmmDecoder decoder(trans, emissions);
+  decoder.setBreakPoints(breakPoints);
+  vector<size_t> path;
+  double logProb = decoder.viterbi(path);
+
+  double bestLogProb = -1e300;
+  vector<size_t> bestPath;
+  vector<size_t> candidate(nbSites, 0);
+  size_t nbPaths = static_cast<size_t>(pow(static_cast<double>(nbStates), static_cast<double>(nbSites)));
+  for (size_t c = 0; c < nbPaths; ++c)
+  {
+    size_t x = c;
+    for (size_t i = 0; i < nbSites; ++i)
+    {
+      candidate[i] = x % nbStates;
+      x /= nbStates;
+    }
+    double lp = jointLogProb(candidate, *trans, *emissions, breakPoints);
+    if (lp > bestLogProb)
+    {
+      bestLogProb = lp;
+      bestPath = candidate;
+    }
+  }
+  cout << "Viterbi: " << logProb << ", brute force: " << bestLogProb << endl;
+  test &= (path == bestPath) && abs(logProb - bestLogProb) < 1e-10;
+
+  // The decoder built from a likelihood object shares its model and break points:
+  RescaledHmmLikelihood rescaled(alphabet, trans, emissions, "");
+  rescaled.setBreakPoints(breakPoints);
+  HmmDecoder decoder2(rescaled);
+  test &= decoder2.getViterbiPath() == path;
+  test &= logProb <= rescaled.getLogLikelihood();
+
+  // Posterior decoding, compared to the full matrix of posterior probabilities:
+  vector<size_t> mapPath;
+  vector<double> mapProbs;
+  HmmDecoder::posteriorDecoding(rescaled, mapPath, &mapProbs);
+  vector< vector<double> > post;
+  rescaled.getHiddenStatesPosteriorProbabilities(post);
+  for (size_t i = 0; i < nbSites; ++i)
+  {
+    size_t best = static_cast<size_t>(max_element(post[i].begin(), post[i].end()) - post[i].begin());
+    test &= mapPath[i] == best && abs(mapProbs[i] - post[i][best]) < 1e-12;
+  }
+  LogsumHmmLikelihood logsum(alphabet, trans, emissions, "");
+  logsum.setBreakPoints(breakPoints);
+  vector<size_t> mapPath2;
+  HmmDecoder::posteriorDecoding(logsum, mapPath2);
+  test &= mapPath2 == mapPath;
+
+  // Many states: traceback pointers are stored on two bytes.
+  nbStates = 300;
+  nbSites = 500;
+  auto alphabet2 = make_shared<SimpleHmmStateAlphabet>(nbStates);
+  auto trans2 = make_shared<AutoCorrelationTransitionMatrix>(alphabet2);
+  auto emissions2 = make_shared<SimpleHmmEmissionProbabilities>(alphabet2, simulateSimpleHmmData(nbSites));
+  HmmDecoder decoder3(trans2, emissions2);
+  breakPoints = { 100, 250, 251 };
+  decoder3.setBreakPoints(breakPoints);
+  logProb = decoder3.viterbi(path);
+  double lp = jointLogProb(path, *trans2, *emissions2, breakPoints);
+  cout << "Viterbi (" << nbStates << " states): " << logProb << ", path: " << lp << endl;
+  test &= path.size() == nbSites && abs(logProb - lp) < 1e-8 * abs(lp);
+
+  return test ? 0 : 1;
+}
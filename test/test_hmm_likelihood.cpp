@@ -0,0 +1,226 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Numeric/Hmm/AutoCorrelationTransitionMatrix.h>
+#include <Bpp/Numeric/Hmm/FullHmmTransitionMatrix.h>
+#include <Bpp/Numeric/Hmm/HmmTransitionKernel.h>
+#include <Bpp/Numeric/Hmm/LogsumHmmLikelihood.h>
+#include <Bpp/Numeric/Hmm/LowMemoryRescaledHmmLikelihood.h>
+#include <Bpp/Numeric/Hmm/RescaledHmmLikelihood.h>
+#include <Bpp/Numeric/Matrix/Matrix.h>
+#include <Bpp/Utils/ThreadPool.h>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "SimpleHmm.h"
+
+using namespace bpp;
+using namespace std;
+
+// The same model, without the declaration of its structure.
+class DenseAutoCorrelationTransitionMatrix :
+  public AutoCorrelationTransitionMatrix
+{
+public:
+  DenseAutoCorrelationTransitionMatrix(std::shared_ptr<const HmmStateAlphabet> alph) :
+    AbstractHmmTransitionMatrix(alph),
+    AutoCorrelationTransitionMatrix(alph) {}
+
+  DenseAutoCorrelationTransitionMatrix* clone() const override { return new DenseAutoCorrelationTransitionMatrix(*this); }
+
+  bool isDiagonalPlusRankOne() const override { return false; }
+};
+
+int main()
+{
+  bool test = true;
+
+  size_t nbStates = 4, nbSites = 20000;
+  auto alphabet = make_shared<SimpleHmmStateAlphabet>(nbStates);
+  auto trans = make_shared<FullHmmTransitionMatrix>(alphabet);
+  RowMatrix<double> pij(nbStates, nbStates);
+  for (size_t i = 0; i < nbStates; ++i)
+  {
+    for (size_t j = 0; j < nbStates; ++j)
+    {
+      pij(i, j) = (i == j) ? 0.9 : 0.1 / static_cast<double>(nbStates - 1);
+    }
+  }
+  trans->setTransitionProbabilities(pij);
+  auto emissions = make_shared<SimpleHmmEmissionProbabilities>(alphabet, simulateSimpleHmmData(nbSites));
+
+  // Segments of random lengths:
+  vector<size_t> breakPoints;
+  for (size_t bp = 37; bp < nbSites; bp += 1 + static_cast<size_t>(RandomTools::giveRandomNumberBetweenZeroAndEntry(200.)))
+  {
+    breakPoints.push_back(bp);
+  }
+
+  RescaledHmmLikelihood serial(alphabet, trans, emissions, "");
+  serial.setBreakPoints(breakPoints);
+  double logLik = serial.getLogLikelihood();
+  double dLogLik = serial.getFirstOrderDerivative("p2");
+  double d2LogLik = serial.getSecondOrderDerivative("p2");
+  vector< vector<double> > post;
+  serial.getHiddenStatesPosteriorProbabilities(post);
+
+  LogsumHmmLikelihood logsum(alphabet, trans, emissions, "");
+  logsum.setBreakPoints(breakPoints);
+  cout << "Rescaled: " << logLik << ", logsum: " << logsum.getLogLikelihood() << endl;
+  test &= abs(logLik - logsum.getLogLikelihood()) < 1e-8 * abs(logLik);
+
+  // Results are identical whatever the number of threads:
+  for (size_t nbThreads : { 1, 2, 3, 8 })
+  {
+    RescaledHmmLikelihood parallel(alphabet, trans, emissions, "");
+    parallel.setThreadPool(make_shared<ThreadPool>(nbThreads));
+    parallel.setBreakPoints(breakPoints);
+    vector< vector<double> > post2;
+    parallel.getHiddenStatesPosteriorProbabilities(post2);
+    bool same = parallel.getLogLikelihood() == logLik
+                && parallel.getFirstOrderDerivative("p2") == dLogLik
+                && parallel.getSecondOrderDerivative("p2") == d2LogLik
+                && post2 == post;
+    cout << nbThreads << " threads: " << (same ? "identical" : "different") << endl;
+    test &= same;
+  }
+
+  // Derivatives, compared to finite differences:
+  double h = 1e-5;
+  double p2 = serial.getParameterValue("p2");
+  serial.setParameterValue("p2", p2 + h);
+  double logLikPlus = serial.getLogLikelihood();
+  double dLogLikPlus = serial.getFirstOrderDerivative("p2");
+  serial.setParameterValue("p2", p2 - h);
+  double logLikMinus = serial.getLogLikelihood();
+  double dLogLikMinus = serial.getFirstOrderDerivative("p2");
+  double numD = (logLikPlus - logLikMinus) / (2 * h);
+  double numD2 = (dLogLikPlus - dLogLikMinus) / (2 * h);
+  // getFirstOrderDerivative returns the derivative of -log L:
+  cout << "dLogLik: " << dLogLik << " / " << -numD << endl;
+  cout << "d2LogLik: " << d2LogLik << " / " << numD2 << endl;
+  test &= abs(dLogLik + numD) < 1e-4 * abs(numD);
+  test &= abs(d2LogLik - numD2) < 1e-4 * abs(numD2);
+
+  // Low memory implementation with checkpoints, compared to the full arrays:
+  RescaledHmmLikelihood full(alphabet, trans, emissions, "");
+  full.setBreakPoints(breakPoints);
+  full.getHiddenStatesPosteriorProbabilities(post);
+  logLik = full.getLogLikelihood();
+  dLogLik = full.getFirstOrderDerivative("p2");
+  d2LogLik = full.getSecondOrderDerivative("p2");
+  for (size_t interval : { 1, 141, 500, 20000 })
+  {
+    LowMemoryRescaledHmmLikelihood lowMem(alphabet, trans, emissions, "", 1000, interval);
+    lowMem.setBreakPoints(breakPoints);
+    vector< vector<double> > post6;
+    lowMem.getHiddenStatesPosteriorProbabilities(post6);
+    bool same = abs(lowMem.getLogLikelihood() - logLik) < 1e-10 * abs(logLik)
+                && abs(lowMem.getFirstOrderDerivative("p2") - dLogLik) < 1e-8 * abs(dLogLik)
+                && abs(lowMem.getSecondOrderDerivative("p2") - d2LogLik) < 1e-8 * abs(d2LogLik)
+                && abs(lowMem.getSecondOrderDerivative("p3") - full.getSecondOrderDerivative("p3")) < 1e-8 * abs(full.getSecondOrderDerivative("p3"));
+    for (size_t i = 0; i < nbSites; ++i)
+    {
+      for (size_t j = 0; j < nbStates; ++j)
+      {
+        same &= abs(post6[i][j] - post[i][j]) < 1e-9;
+      }
+    }
+    for (size_t site : { static_cast<size_t>(0), interval - 1, interval, nbSites / 2, nbSites - 1 })
+    {
+      if (site >= nbSites)
+        continue;
+      Vdouble p = lowMem.getHiddenStatesPosteriorProbabilitiesForASite(site);
+      for (size_t j = 0; j < nbStates; ++j)
+      {
+        same &= abs(p[j] - post[site][j]) < 1e-9;
+      }
+      same &= abs(lowMem.getLikelihoodForASite(site) - full.getLikelihoodForASite(site)) < 1e-9 * full.getLikelihoodForASite(site);
+    }
+    cout << "Checkpoints every " << interval << " sites: " << (same ? "identical" : "different") << endl;
+    test &= same;
+  }
+
+  // Structured transition matrix, compared to the dense computation:
+  nbStates = 50;
+  nbSites = 2000;
+  auto alphabet2 = make_shared<SimpleHmmStateAlphabet>(nbStates);
+  auto structTrans = make_shared<AutoCorrelationTransitionMatrix>(alphabet2);
+  auto denseTrans = make_shared<DenseAutoCorrelationTransitionMatrix>(alphabet2);
+  for (size_t i = 0; i < nbStates; ++i)
+  {
+    string name = "lambda" + TextTools::toString(i + 1);
+    double lambda = RandomTools::giveRandomNumberBetweenZeroAndEntry(1.);
+    structTrans->setParameterValue(name, lambda);
+    denseTrans->setParameterValue(name, lambda);
+  }
+  HmmTransitionKernel structKernel(*structTrans), denseKernel(*denseTrans);
+  test &= structKernel.isStructured() && !denseKernel.isStructured();
+  vector<double> v(nbStates), y1(nbStates), y2(nbStates), y3(nbStates), y4(nbStates);
+  for (auto& vk : v) { vk = RandomTools::giveRandomNumberBetweenZeroAndEntry(1.); }
+  structKernel.forward(&v[0], &y1[0]);
+  denseKernel.forward(&v[0], &y2[0]);
+  structKernel.backward(&v[0], &y3[0]);
+  denseKernel.backward(&v[0], &y4[0]);
+  for (size_t j = 0; j < nbStates; ++j)
+  {
+    test &= abs(y1[j] - y2[j]) < 1e-12 && abs(y3[j] - y4[j]) < 1e-12;
+  }
+
+  // With a single state, the only transition is to itself:
+  auto alphabet1 = make_shared<SimpleHmmStateAlphabet>(1);
+  AutoCorrelationTransitionMatrix structTrans1(alphabet1);
+  DenseAutoCorrelationTransitionMatrix denseTrans1(alphabet1);
+  vector<double> d1, u1, w1;
+  structTrans1.getDiagonalPlusRankOne(d1, u1, w1);
+  test &= d1.size() == 1 && d1[0] == 1. && u1[0] == 0. && denseTrans1.Pij(0, 0) == 1.;
+  HmmTransitionKernel structKernel1(structTrans1), denseKernel1(denseTrans1);
+  double v1 = 0.3, z1 = 0., z2 = 0.;
+  structKernel1.forward(&v1, &z1);
+  denseKernel1.forward(&v1, &z2);
+  test &= z1 == v1 && z2 == v1;
+
+  auto emissions2 = make_shared<SimpleHmmEmissionProbabilities>(alphabet2, simulateSimpleHmmData(nbSites));
+  breakPoints = { 500, 1200 };
+  RescaledHmmLikelihood structRescaled(alphabet2, structTrans, emissions2, "");
+  RescaledHmmLikelihood denseRescaled(alphabet2, denseTrans, emissions2, "");
+  LogsumHmmLikelihood structLogsum(alphabet2, structTrans, emissions2, "");
+  LogsumHmmLikelihood denseLogsum(alphabet2, denseTrans, emissions2, "");
+  LowMemoryRescaledHmmLikelihood structLowMem(alphabet2, structTrans, emissions2, "", 100);
+  LowMemoryRescaledHmmLikelihood denseLowMem(alphabet2, denseTrans, emissions2, "", 100);
+  structRescaled.setBreakPoints(breakPoints);
+  denseRescaled.setBreakPoints(breakPoints);
+  structLogsum.setBreakPoints(breakPoints);
+  denseLogsum.setBreakPoints(breakPoints);
+  structLowMem.setBreakPoints(breakPoints);
+  denseLowMem.setBreakPoints(breakPoints);
+  double ref = denseRescaled.getLogLikelihood();
+  cout << "Structured: " << structRescaled.getLogLikelihood() << " " << structLogsum.getLogLikelihood() << " " << structLowMem.getLogLikelihood()
+       << ", dense: " << ref << " " << denseLogsum.getLogLikelihood() << " " << denseLowMem.getLogLikelihood() << endl;
+  for (double x : { structRescaled.getLogLikelihood(), structLogsum.getLogLikelihood(), structLowMem.getLogLikelihood(),
+                    denseLogsum.getLogLikelihood(), denseLowMem.getLogLikelihood() })
+  {
+    test &= abs(x - ref) < 1e-9 * abs(ref);
+  }
+  double dRef = denseRescaled.getFirstOrderDerivative("p3");
+  double d2Ref = denseRescaled.getSecondOrderDerivative("p3");
+  test &= abs(structRescaled.getFirstOrderDerivative("p3") - dRef) < 1e-8 * abs(dRef);
+  test &= abs(structLogsum.getFirstOrderDerivative("p3") - dRef) < 1e-8 * abs(dRef);
+  test &= abs(structRescaled.getSecondOrderDerivative("p3") - d2Ref) < 1e-8 * abs(d2Ref);
+  test &= abs(structLogsum.getSecondOrderDerivative("p3") - d2Ref) < 1e-8 * abs(d2Ref);
+  vector< vector<double> > post3, post4, post5;
+  structRescaled.getHiddenStatesPosteriorProbabilities(post3);
+  denseRescaled.getHiddenStatesPosteriorProbabilities(post4);
+  structLogsum.getHiddenStatesPosteriorProbabilities(post5);
+  for (size_t i = 0; i < nbSites; ++i)
+  {
+    for (size_t j = 0; j < nbStates; ++j)
+    {
+      test &= abs(post3[i][j] - post4[i][j]) < 1e-9 && abs(post5[i][j] - post4[i][j]) < 1e-9;
+    }
+  }
+
+  return test ? 0 : 1;
+}
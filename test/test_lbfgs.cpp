@@ -0,0 +1,121 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Numeric/Function/LBfgsMultiDimensions.h>
+#include <Bpp/Numeric/AutoParameter.h>
+#include <Bpp/Text/TextTools.h>
+#include <vector>
+#include <iostream>
+#include "PolynomialFunction.h"
+
+using namespace bpp;
+using namespace std;
+
+/**
+ * @brief A chain of coupled quadratic terms with many parameters:
+ * f = sum_i (x_i - c_i)^2 + sum_i (x_i - x_{i+1})^2, with x_0 in [-1, 1].
+ */
+class ChainFunction :
+  public virtual FirstOrderDerivable,
+  public AbstractParametrizable
+{
+private:
+  size_t n_;
+  double fval_;
+  vector<double> der_;
+  bool compDer_;
+
+public:
+  ChainFunction(size_t n) : AbstractParametrizable(""), n_(n), fval_(0), der_(n), compDer_(true)
+  {
+    addParameter_(new Parameter("x0", 0, std::make_shared<IntervalConstraint>(-1, 1, true, true)));
+    for (size_t i = 1; i < n_; ++i)
+    {
+      addParameter_(new Parameter("x" + TextTools::toString(i), 0));
+    }
+    fireParameterChanged(getParameters());
+  }
+
+  ChainFunction* clone() const { return new ChainFunction(*this); }
+
+public:
+  void setParameters(const ParameterList& pl)
+  {
+    matchParametersValues(pl);
+  }
+  double getValue() const { return fval_; }
+
+  static double target(size_t i) { return 3. + static_cast<double>(i % 7) - static_cast<double>(i % 3); }
+
+  void fireParameterChanged(const ParameterList& /* pl */)
+  {
+    const ParameterList& params = getParameters();
+    fval_ = 0;
+    for (size_t i = 0; i < n_; ++i)
+    {
+      double x = params[i].getValue();
+      fval_ += (x - target(i)) * (x - target(i));
+      der_[i] = 2 * (x - target(i));
+      if (i + 1 < n_)
+      {
+        double d = x - params[i + 1].getValue();
+        fval_ += d * d;
+        der_[i] += 2 * d;
+      }
+      if (i > 0)
+        der_[i] -= 2 * (params[i - 1].getValue() - x);
+    }
+  }
+
+  void enableFirstOrderDerivatives(bool yn) { compDer_ = yn; }
+  bool enableFirstOrderDerivatives() const { return compDer_; }
+
+  double getFirstOrderDerivative(const std::string& variable) const
+  {
+    return der_[TextTools::to<size_t>(variable.substr(1))];
+  }
+};
+
+int main()
+{
+  bool test = true;
+
+  // Small problem, as for BFGS:
+  auto f = make_shared<PolynomialFunction1Der1>(false);
+  LBfgsMultiDimensions optimizer(f, 2);
+  optimizer.setConstraintPolicy(AutoParameter::CONSTRAINTS_AUTO);
+  optimizer.setVerbose(0);
+  optimizer.init(f->getParameters());
+  optimizer.optimize();
+  double minf = optimizer.getFunctionValue();
+  double x = f->getParameterValue("x");
+  double y = f->getParameterValue("y");
+  double z = f->getParameterValue("z");
+  cout << "x=" << x << " y=" << y << " z=" << z << " f=" << minf << endl;
+  test &= abs(minf) + abs(x - 5) + abs(y + 2) + abs(z - 3) < 0.01;
+
+  // Many parameters, with a bound reached on x0:
+  size_t n = 2000;
+  auto chain = make_shared<ChainFunction>(n);
+  LBfgsMultiDimensions lbfgs(chain);
+  lbfgs.setVerbose(0);
+  lbfgs.setProfiler(nullptr);
+  lbfgs.getStopCondition()->setTolerance(1e-10);
+  lbfgs.init(chain->getParameters());
+  lbfgs.optimize();
+  cout << "Chain: f=" << lbfgs.getFunctionValue() << " after " << lbfgs.getNumberOfEvaluations() << " evaluations." << endl;
+
+  // At the optimum, the gradient vanishes except for x0 which is on its upper bound:
+  double x0 = chain->getParameterValue("x0");
+  test &= x0 > 0.999 && x0 <= 1. && chain->getFirstOrderDerivative("x0") < 0;
+  double maxDer = 0;
+  for (size_t i = 1; i < n; ++i)
+  {
+    maxDer = max(maxDer, abs(chain->getFirstOrderDerivative("x" + TextTools::toString(i))));
+  }
+  cout << "Max |gradient|: " << maxDer << endl;
+  test &= maxDer < 1e-2;
+
+  return test ? 0 : 1;
+}
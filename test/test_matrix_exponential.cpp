@@ -0,0 +1,101 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/App/ApplicationTools.h>
+#include <Bpp/Numeric/Matrix/Matrix.h>
+#include <Bpp/Numeric/Matrix/MatrixExponential.h>
+#include <Bpp/Numeric/Matrix/MatrixTools.h>
+#include <Bpp/Numeric/Random/RandomTools.h>
+#include <cmath>
+#include <vector>
+#include <iostream>
+
+using namespace bpp;
+using namespace std;
+
+int main()
+{
+  bool test = true;
+
+  // A random rate matrix (rows sum to 0), with real eigenvalues in practice.
+  size_t n = 20;
+  RowMatrix<double> Q(n, n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    double sum = 0;
+    for (size_t j = 0; j < n; ++j)
+    {
+      if (i != j)
+      {
+        Q(i, j) = RandomTools::giveRandomNumberBetweenZeroAndEntry(1.);
+        sum += Q(i, j);
+      }
+    }
+    Q(i, i) = -sum;
+  }
+  MatrixExponential<double> expQ(Q);
+  MatrixExponential<double> padeQ(Q, 0.); // Forces the Padé approximation.
+  test &= expQ.isDiagonalizable() && !padeQ.isDiagonalizable();
+
+  vector<double> vt = { 0., 0.001, 0.1, 1., 10., 50. };
+  vector<DenseMatrix<double>> vE;
+  expQ.exp(vt, vE);
+  for (size_t k = 0; k < vt.size(); ++k)
+  {
+    RowMatrix<double> E1, E2;
+    expQ.exp(vt[k], E1);
+    padeQ.exp(vt[k], E2);
+    test &= E1.equals(E2, 1e-9) && vE[k].equals(E1, 1e-12);
+    // Rows of a transition matrix sum to 1.
+    for (size_t i = 0; i < n; ++i)
+    {
+      test &= abs(VectorTools::sum(E2.row(i)) - 1.) < 1e-9;
+    }
+
+    vector<double> v(n), ev, ve;
+    for (size_t i = 0; i < n; ++i) { v[i] = static_cast<double>(i); }
+    expQ.expTimesVector(vt[k], v, ev);
+    expQ.vectorTimesExp(vt[k], v, ve);
+    for (size_t i = 0; i < n; ++i)
+    {
+      double s1 = 0, s2 = 0;
+      for (size_t j = 0; j < n; ++j)
+      {
+        s1 += E1(i, j) * v[j];
+        s2 += v[j] * E1(j, i);
+      }
+      test &= abs(ev[i] - s1) < 1e-9 && abs(ve[i] - s2) < 1e-9;
+    }
+  }
+  ApplicationTools::displayBooleanResult("Rate matrix", test);
+
+  // Complex eigenvalues: exp(t.[0, 1; -1, 0]) = [cos t, sin t; -sin t, cos t].
+  RowMatrix<double> R(2, 2);
+  R(0, 1) = 1.;
+  R(1, 0) = -1.;
+  MatrixExponential<double> expR(R);
+  MatrixExponential<double> padeR(R, 0.);
+  for (double t : { 0.3, 2., 7. })
+  {
+    RowMatrix<double> ref(2, 2), E1, E2;
+    ref(0, 0) = ref(1, 1) = cos(t);
+    ref(0, 1) = sin(t);
+    ref(1, 0) = -sin(t);
+    expR.exp(t, E1);
+    padeR.exp(t, E2);
+    test &= E1.equals(ref, 1e-12) && E2.equals(ref, 1e-12);
+  }
+  ApplicationTools::displayBooleanResult("Complex eigenvalues", test);
+
+  // Non-diagonalizable: exp([1, 1; 0, 1]) = e.[1, 1; 0, 1].
+  RowMatrix<double> J(2, 2), EJ;
+  J(0, 0) = J(0, 1) = J(1, 1) = 1.;
+  MatrixTools::exp(J, EJ);
+  RowMatrix<double> refJ(J);
+  MatrixTools::scale(refJ, exp(1.));
+  test &= EJ.equals(refJ, 1e-12);
+  ApplicationTools::displayBooleanResult("Jordan block", test);
+
+  return test ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Numeric/Function/BfgsMultiDimensions.h>
+#include <Bpp/Numeric/Function/MetaOptimizer.h>
+#include <Bpp/Numeric/Function/PowellMultiDimensions.h>
+#include <iostream>
+#include <vector>
+
+#include "PolynomialFunction.h"
+
+using namespace bpp;
+using namespace std;
+
+/**
+ * @brief Count the initializations of an optimizer.
+ */
+class InitializationCounter :
+  public OptimizationListener
+{
+public:
+  unsigned int nbInitializations;
+
+public:
+  InitializationCounter() : nbInitializations(0) {}
+
+public:
+  void optimizationInitializationPerformed(const OptimizationEvent& /* event */) { nbInitializations++; }
+  void optimizationStepPerformed(const OptimizationEvent& /* event */) {}
+  bool listenerModifiesParameters() const { return false; }
+};
+
+/**
+ * @brief Compute derivatives at the current point as soon as they are enabled.
+ */
+class PolynomialFunction1Der1Eager :
+  public PolynomialFunction1Der1
+{
+public:
+  PolynomialFunction1Der1Eager() : PolynomialFunction1Der1(false) {}
+
+  PolynomialFunction1Der1Eager* clone() const { return new PolynomialFunction1Der1Eager(*this); }
+
+public:
+  void enableFirstOrderDerivatives(bool yn)
+  {
+    bool recompute = yn && !compFirstDer_;
+    compFirstDer_ = yn;
+    if (recompute)
+      fireParameterChanged(getParameters());
+  }
+  bool enableFirstOrderDerivatives() const { return compFirstDer_; }
+};
+
+bool optimize(bool adaptive)
+{
+  auto f = make_shared<PolynomialFunction1Der1Eager>();
+  auto infos = make_unique<MetaOptimizerInfos>();
+  infos->addOptimizer("bfgs", make_shared<BfgsMultiDimensions>(f), {"x", "y"}, 1);
+  infos->addOptimizer("powell", make_shared<PowellMultiDimensions>(f), {"z"}, 0);
+  MetaOptimizer optimizer(f, std::move(infos), 2);
+  optimizer.setVerbose(0);
+  optimizer.setProfiler(nullptr);
+  optimizer.setMessageHandler(nullptr);
+  optimizer.setAdaptiveScheduling(adaptive);
+  optimizer.getStopCondition()->setTolerance(1e-8);
+  optimizer.init(f->getParameters());
+  double minf = optimizer.optimize();
+  double x = f->getParameterValue("x");
+  double y = f->getParameterValue("y");
+  double z = f->getParameterValue("z");
+  cout << (adaptive ? "Adaptive: " : "Fixed: ") << "x=" << x << " y=" << y << " z=" << z << " f=" << minf;
+  cout << " (" << optimizer.getNumberOfEvaluations() << " evaluations)" << endl;
+  bool test = abs(minf) + abs(x - 5) + abs(y + 2) + abs(z - 3) < 0.01;
+  // Derivatives are disabled after optimization:
+  test &= !f->enableFirstOrderDerivatives();
+  if (adaptive)
+    test &= optimizer.getImprovementRate(0) >= 0 && optimizer.getImprovementRate(1) >= 0;
+  return test;
+}
+
+int main()
+{
+  bool test = true;
+  test &= optimize(false);
+  test &= optimize(true);
+
+  // An optimizer alone is not initialized again between steps:
+  auto f = make_shared<PolynomialFunction1Der1>(false);
+  auto bfgs = make_shared<BfgsMultiDimensions>(f);
+  auto counter = make_shared<InitializationCounter>();
+  bfgs->addOptimizationListener(counter);
+  auto infos = make_unique<MetaOptimizerInfos>();
+  infos->addOptimizer("bfgs", bfgs, {"x", "y", "z"}, 1);
+  MetaOptimizer optimizer(f, std::move(infos), 1);
+  optimizer.setVerbose(0);
+  optimizer.setProfiler(nullptr);
+  optimizer.setMessageHandler(nullptr);
+  optimizer.init(f->getParameters());
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    optimizer.step();
+  }
+  cout << "Initializations: " << counter->nbInitializations << endl;
+  test &= counter->nbInitializations == 1;
+
+  // Missing derivatives are detected at initialization:
+  auto g = make_shared<PolynomialFunction1>(false);
+  auto infos2 = make_unique<MetaOptimizerInfos>();
+  infos2->addOptimizer("powell", make_shared<PowellMultiDimensions>(g), {"x"}, 1);
+  MetaOptimizer optimizer2(g, std::move(infos2));
+  optimizer2.setVerbose(0);
+  optimizer2.setProfiler(nullptr);
+  optimizer2.setMessageHandler(nullptr);
+  try
+  {
+    optimizer2.init(g->getParameters());
+    test = false;
+  }
+  catch (Exception& e) {}
+
+  return test ? 0 : 1;
+}
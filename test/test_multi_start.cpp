@@ -0,0 +1,152 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Numeric/AbstractParametrizable.h>
+#include <Bpp/Numeric/Function/BfgsMultiDimensions.h>
+#include <Bpp/Numeric/Function/MultiStartOptimizer.h>
+#include <Bpp/Numeric/Function/PowellMultiDimensions.h>
+#include <Bpp/Numeric/Function/ThreePointsNumericalDerivative.h>
+#include <Bpp/Utils/ThreadPool.h>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+/**
+ * @brief A function with two local minima, the global one having x < 0.
+ */
+class DoubleWellFunction :
+  public virtual FunctionInterface,
+  public AbstractParametrizable
+{
+private:
+  double fval_;
+
+public:
+  DoubleWellFunction() : AbstractParametrizable(""), fval_(0)
+  {
+    addParameter_(new Parameter("x", 0));
+    addParameter_(new Parameter("y", 0));
+    fireParameterChanged(getParameters());
+  }
+
+  DoubleWellFunction* clone() const { return new DoubleWellFunction(*this); }
+
+public:
+  void setParameters(const ParameterList& pl)
+  {
+    matchParametersValues(pl);
+  }
+  double getValue() const { return fval_; }
+
+  void fireParameterChanged(const ParameterList& /* pl */)
+  {
+    double x = getParameterValue("x");
+    double y = getParameterValue("y");
+    fval_ = (x * x - 4.) * (x * x - 4.) + 0.5 * x + (y - 1.) * (y - 1.);
+  }
+};
+
+int main()
+{
+  bool test = true;
+
+  auto f = make_shared<DoubleWellFunction>();
+  auto optimizer = make_shared<PowellMultiDimensions>(f);
+  optimizer->getStopCondition()->setTolerance(1e-8);
+  optimizer->setVerbose(0);
+  optimizer->setProfiler(nullptr);
+  optimizer->setMessageHandler(nullptr);
+
+  vector<ParameterList> starts;
+  for (size_t i = 0; i < 40; ++i)
+  {
+    ParameterList pl = f->getParameters();
+    pl.setParameterValue("x", 0.3 + 0.1 * static_cast<double>(i) * (i % 3 == 0 ? -1. : 1.));
+    pl.setParameterValue("y", static_cast<double>(i % 5));
+    starts.push_back(pl);
+  }
+
+  MultiStartOptimizer multiStart(optimizer);
+  vector<MultiStartResult> serial = multiStart.optimize(starts);
+  test &= serial.size() == starts.size();
+  test &= serial[0].parameters.getParameterValue("x") < 0 && abs(serial[0].parameters.getParameterValue("y") - 1.) < 1e-3;
+  test &= serial.back().parameters.getParameterValue("x") > 0;
+  for (size_t i = 1; i < serial.size(); ++i)
+  {
+    test &= serial[i - 1].value <= serial[i].value;
+    test &= serial[i].nbSteps > 0 && !serial[i].abandoned;
+  }
+  cout << "Best start: " << serial[0].start << ", f=" << serial[0].value << endl;
+
+  // The prototype is not modified:
+  test &= f->getParameterValue("x") == 0. && f->getParameterValue("y") == 0.;
+
+  // Same results with any number of threads:
+  for (size_t nbThreads : { 2, 3, 8 })
+  {
+    multiStart.setThreadPool(make_shared<ThreadPool>(nbThreads));
+    vector<MultiStartResult> parallel = multiStart.optimize(starts);
+    bool same = parallel.size() == serial.size();
+    for (size_t i = 0; same && i < serial.size(); ++i)
+    {
+      same = parallel[i].start == serial[i].start && parallel[i].value == serial[i].value
+             && parallel[i].nbEvaluations == serial[i].nbEvaluations;
+    }
+    cout << nbThreads << " threads: " << (same ? "identical" : "different") << endl;
+    test &= same;
+  }
+
+  // Early termination:
+  multiStart.setAbandonThreshold(0.5, 1);
+  vector<MultiStartResult> abandon = multiStart.optimize(starts);
+  size_t nbAbandoned = 0;
+  for (const auto& result : abandon)
+  {
+    if (result.abandoned)
+      nbAbandoned++;
+  }
+  cout << nbAbandoned << " starts abandoned." << endl;
+  test &= abandon.size() == starts.size() && nbAbandoned > 0;
+  test &= abs(abandon[0].value - serial[0].value) < 1e-6;
+
+  multiStart.setAbandonThreshold(numeric_limits<double>::infinity());
+  multiStart.setThreadPool(nullptr);
+  multiStart.setTargetValue(serial[0].value + 0.5);
+  vector<MultiStartResult> target = multiStart.optimize(starts);
+  cout << target.size() << " starts run until target." << endl;
+  test &= target.size() < starts.size() && target[0].value <= serial[0].value + 0.5;
+
+  // Gradient-based optimizer on numerical derivatives, each thread having its own copy of
+  // the wrapped function:
+  auto g = make_shared<DoubleWellFunction>();
+  auto derivative = make_shared<ThreePointsNumericalDerivative>(g);
+  derivative->setParametersToDerivate(g->getParameters().getParameterNames());
+  auto bfgs = make_shared<BfgsMultiDimensions>(derivative);
+  bfgs->getStopCondition()->setTolerance(1e-8);
+  bfgs->setVerbose(0);
+  bfgs->setProfiler(nullptr);
+  bfgs->setMessageHandler(nullptr);
+  MultiStartOptimizer bfgsMultiStart(bfgs);
+  vector<MultiStartResult> bfgsSerial = bfgsMultiStart.optimize(starts);
+  test &= bfgsSerial.size() == starts.size() && bfgsSerial[0].parameters.getParameterValue("x") < 0;
+  for (size_t nbThreads : { 2, 8 })
+  {
+    bfgsMultiStart.setThreadPool(make_shared<ThreadPool>(nbThreads));
+    vector<MultiStartResult> parallel = bfgsMultiStart.optimize(starts);
+    bool same = parallel.size() == bfgsSerial.size();
+    for (size_t i = 0; same && i < bfgsSerial.size(); ++i)
+    {
+      same = parallel[i].start == bfgsSerial[i].start && parallel[i].value == bfgsSerial[i].value
+             && parallel[i].nbEvaluations == bfgsSerial[i].nbEvaluations;
+    }
+    cout << "BFGS, " << nbThreads << " threads: " << (same ? "identical" : "different") << endl;
+    test &= same;
+  }
+  test &= g->getParameterValue("x") == 0. && g->getParameterValue("y") == 0.;
+
+  return test ? 0 : 1;
+}
@@ -0,0 +1,109 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Numeric/Function/FivePointsNumericalDerivative.h>
+#include <Bpp/Numeric/Function/ThreePointsNumericalDerivative.h>
+#include <Bpp/Numeric/Function/TwoPointsNumericalDerivative.h>
+#include <Bpp/Utils/ThreadPool.h>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "PolynomialFunction.h"
+
+using namespace bpp;
+using namespace std;
+
+/**
+ * @brief Derivatives computed by a numerical derivative object on a list of points.
+ */
+vector<double> getDerivatives(AbstractNumericalDerivative& nd, const vector<ParameterList>& points, bool cross)
+{
+  vector<string> names = points[0].getParameterNames();
+  vector<double> der;
+  for (const auto& pl : points)
+  {
+    nd.setParameters(pl);
+    for (const auto& name1 : names)
+    {
+      der.push_back(nd.getFirstOrderDerivative(name1));
+      if (!cross)
+        continue;
+      der.push_back(nd.getSecondOrderDerivative(name1));
+      for (const auto& name2 : names)
+      {
+        der.push_back(nd.getSecondOrderDerivative(name1, name2));
+      }
+    }
+  }
+  return der;
+}
+
+int main()
+{
+  bool test = true;
+
+  // Points inside the domain and on both bounds of z:
+  vector<ParameterList> points;
+  auto f = make_shared<PolynomialFunction1>();
+  for (double z : { 0.01, 1.3, 5. })
+  {
+    ParameterList pl = f->getParameters();
+    pl.setParameterValue("x", -z);
+    pl.setParameterValue("y", 2. * z);
+    pl.setParameterValue("z", z);
+    points.push_back(pl);
+  }
+
+  vector< shared_ptr<AbstractNumericalDerivative> > nds = {
+    make_shared<TwoPointsNumericalDerivative>(f),
+    make_shared<ThreePointsNumericalDerivative>(f),
+    make_shared<FivePointsNumericalDerivative>(f)
+  };
+  vector<string> names = { "TwoPoints", "ThreePoints", "FivePoints" };
+
+  for (size_t m = 0; m < nds.size(); ++m)
+  {
+    auto nd = nds[m];
+    bool cross = (m == 1);
+    nd->setParametersToDerivate(f->getParameters().getParameterNames());
+    nd->enableSecondOrderCrossDerivatives(cross);
+    // Cross derivatives can not be computed on the bounds:
+    vector<ParameterList> ndPoints = cross ? vector<ParameterList>(points.begin() + 1, points.end() - 1) : points;
+    vector<double> serial = getDerivatives(*nd, ndPoints, cross);
+
+    // First order derivatives are 2(x - 5), 2(y + 2), 2(z - 3):
+    size_t stride = cross ? 5 : 1;
+    for (size_t p = 0; p < ndPoints.size(); ++p)
+    {
+      test &= abs(serial[p * 3 * stride] - 2. * (ndPoints[p].getParameterValue("x") - 5.)) < 1e-2;
+      test &= abs(serial[(p * 3 + 1) * stride] - 2. * (ndPoints[p].getParameterValue("y") + 2.)) < 1e-2;
+    }
+
+    // Same results with any number of threads:
+    for (size_t nbThreads : { 1, 2, 3, 8 })
+    {
+      nd->setThreadPool(make_shared<ThreadPool>(nbThreads));
+      bool same = getDerivatives(*nd, ndPoints, cross) == serial;
+      cout << names[m] << ", " << nbThreads << " threads: " << (same ? "identical" : "different") << endl;
+      test &= same;
+    }
+    nd->setThreadPool(nullptr);
+
+    // The function is left at the last point:
+    test &= f->getParameterValue("z") == ndPoints.back().getParameterValue("z") && f->getValue() == nd->getValue();
+  }
+
+  // Wrapped functions are copied for each thread as well:
+  auto g = make_shared<PolynomialFunction1>();
+  ThreePointsNumericalDerivative wrapped(make_shared<InfinityFunctionWrapper>(g));
+  wrapped.setParametersToDerivate(g->getParameters().getParameterNames());
+  vector<double> serial = getDerivatives(wrapped, points, false);
+  wrapped.setThreadPool(make_shared<ThreadPool>(4));
+  bool same = getDerivatives(wrapped, points, false) == serial;
+  cout << "Wrapped function, 4 threads: " << (same ? "identical" : "different") << endl;
+  test &= same && g->getParameterValue("z") == points.back().getParameterValue("z");
+
+  return test ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Numeric/Function/BfgsMultiDimensions.h>
+#include <Bpp/Numeric/Function/MetaOptimizer.h>
+#include <Bpp/Numeric/Function/OptimizationTraceListener.h>
+#include <Bpp/Numeric/Function/PowellMultiDimensions.h>
+#include <Bpp/Numeric/Function/SimpleNewtonMultiDimensions.h>
+#include <Bpp/Numeric/Function/ThreePointsNumericalDerivative.h>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "PolynomialFunction.h"
+
+using namespace bpp;
+using namespace std;
+
+int main()
+{
+  bool test = true;
+
+  auto f = make_shared<PolynomialFunction1Der1>(false);
+  auto infos = make_unique<MetaOptimizerInfos>();
+  vector<string> xy = {"x", "y"};
+  vector<string> z = {"z"};
+  infos->addOptimizer("bfgs", make_shared<BfgsMultiDimensions>(f), xy, 1);
+  infos->addOptimizer("powell", make_shared<PowellMultiDimensions>(f), z, 0);
+  MetaOptimizer optimizer(f, std::move(infos));
+  optimizer.setVerbose(0);
+  optimizer.setProfiler(nullptr);
+  optimizer.setMessageHandler(nullptr);
+
+  ostringstream records;
+  auto trace = make_shared<OptimizationTraceListener>(make_shared<StlOutputStreamWrapper>(&records));
+  OptimizationTraceListener::watch(trace, optimizer, "meta");
+  optimizer.init(f->getParameters());
+  optimizer.optimize();
+  cout << records.str();
+
+  const map<string, OptimizationTraceSummary>& summary = trace->getSummary();
+  test &= summary.size() == 3;
+  test &= summary.count("meta") && summary.count("meta/bfgs") && summary.count("meta/powell");
+  if (test)
+  {
+    const OptimizationTraceSummary& meta = summary.at("meta");
+    const OptimizationTraceSummary& bfgs = summary.at("meta/bfgs");
+    const OptimizationTraceSummary& powell = summary.at("meta/powell");
+    test &= meta.nbSteps > 0 && bfgs.nbSteps > 0 && powell.nbSteps > 0;
+    test &= bfgs.nbGradientEvaluations > 0 && powell.nbGradientEvaluations == 0;
+    // The meta optimizer also counts the evaluations of sub-optimizer initializations:
+    test &= meta.nbGradientEvaluations >= bfgs.nbGradientEvaluations;
+    test &= meta.nbEvaluations > 0 && bfgs.nbEvaluations > 0;
+  }
+
+  // One JSON object per step:
+  unsigned int nbLines = 0;
+  istringstream iss(records.str());
+  string line;
+  while (getline(iss, line))
+  {
+    test &= line.front() == '{' && line.back() == '}' && line.find("\"stepNorm\": ") != string::npos;
+    nbLines++;
+  }
+  unsigned int nbSteps = 0;
+  for (const auto& s : summary)
+  {
+    nbSteps += s.second.nbSteps;
+  }
+  test &= nbLines == nbSteps;
+
+  ostringstream summaryRecords;
+  StlOutputStreamWrapper summaryOut(&summaryRecords);
+  trace->writeSummary(summaryOut);
+  cout << summaryRecords.str();
+  test &= summaryRecords.str().find("\"optimizer\": \"meta/bfgs\"") != string::npos;
+
+  // Newton sub-optimizers count the derivatives they use:
+  auto h = make_shared<ThreePointsNumericalDerivative>(make_shared<PolynomialFunction1>(false));
+  h->setParametersToDerivate({"x", "y", "z"});
+  auto newtonInfos = make_unique<MetaOptimizerInfos>();
+  newtonInfos->addOptimizer("newton", make_shared<SimpleNewtonMultiDimensions>(h), xy, 2);
+  newtonInfos->addOptimizer("powell", make_shared<PowellMultiDimensions>(h), z, 0);
+  MetaOptimizer newtonMeta(h, std::move(newtonInfos));
+  newtonMeta.setVerbose(0);
+  newtonMeta.setProfiler(nullptr);
+  newtonMeta.setMessageHandler(nullptr);
+  auto newtonTrace = make_shared<OptimizationTraceListener>(nullptr);
+  OptimizationTraceListener::watch(newtonTrace, newtonMeta, "meta");
+  newtonMeta.init(h->getParameters());
+  newtonMeta.optimize();
+  const map<string, OptimizationTraceSummary>& newtonSummary = newtonTrace->getSummary();
+  test &= newtonSummary.count("meta/newton") && newtonSummary.at("meta/newton").nbGradientEvaluations > 0;
+  test &= newtonSummary.count("meta") && newtonSummary.at("meta").nbGradientEvaluations > 0;
+
+  // CSV records, with a header line:
+  auto g = make_shared<PolynomialFunction1Der1>(false);
+  BfgsMultiDimensions bfgs(g);
+  bfgs.setVerbose(0);
+  bfgs.setProfiler(nullptr);
+  bfgs.setMessageHandler(nullptr);
+  ostringstream csv;
+  auto csvTrace = make_shared<OptimizationTraceListener>(make_shared<StlOutputStreamWrapper>(&csv), OptimizationTraceListener::FORMAT_CSV);
+  OptimizationTraceListener::watch(csvTrace, bfgs, "bfgs \"csv\"");
+  bfgs.init(g->getParameters());
+  bfgs.optimize();
+  cout << csv.str();
+  test &= csv.str().compare(0, 17, "optimizer,step,ti") == 0;
+  test &= csv.str().find("\n\"bfgs \"\"csv\"\"\",1,") != string::npos;
+
+  return test ? 0 : 1;
+}
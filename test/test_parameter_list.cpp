@@ -0,0 +1,108 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Numeric/ParameterList.h>
+#include <Bpp/Text/TextTools.h>
+#include <Bpp/Utils/ThreadPool.h>
+#include <atomic>
+#include <iostream>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+int main()
+{
+  bool test = true;
+
+  size_t n = 5000;
+  ParameterList pl;
+  for (size_t i = 0; i < n; ++i)
+  {
+    pl.addParameter(new Parameter("x" + TextTools::toString(i), static_cast<double>(i)));
+  }
+  test &= pl.size() == n;
+  test &= pl.hasParameter("x0") && pl.hasParameter("x4999") && !pl.hasParameter("x5000");
+  test &= pl.whichParameterHasName("x1234") == 1234;
+  test &= pl.getParameterValue("x42") == 42.;
+  try
+  {
+    pl.addParameter(Parameter("x7", 0.));
+    test = false;
+  }
+  catch (ParameterException& e) {}
+
+  // Deletion shifts the positions:
+  pl.deleteParameter("x10");
+  pl.deleteParameter(static_cast<size_t>(0));
+  test &= !pl.hasParameter("x10") && !pl.hasParameter("x0");
+  test &= pl.whichParameterHasName("x11") == 9;
+  test &= pl.whichParameterHasName("x4999") == n - 3;
+
+  // Renaming directly, including through operator[] or a shared sublist, is seen by lookups:
+  pl.parameter("x1").setName("a");
+  test &= pl.hasParameter("a") && !pl.hasParameter("x1") && pl.whichParameterHasName("a") == 0;
+  ParameterList shared = pl.shareSubList(vector<string>{ "x2", "x3" });
+  shared.parameter("x3").setName("b");
+  test &= pl.hasParameter("b") && !pl.hasParameter("x3") && pl.getParameterValue("b") == 3.;
+  test &= shared.whichParameterHasName("b") == 1 && !shared.hasParameter("x3");
+  pl[pl.size() - 1].setName("x4999b");
+  test &= pl.whichParameterHasName("x4999b") == pl.size() - 1 && !pl.hasParameter("x4999");
+  // Reindexation restores constant time lookups:
+  pl.reindex();
+  test &= pl.whichParameterHasName("b") == 2 && pl.whichParameterHasName("x4999b") == pl.size() - 1;
+
+  // Replacing a parameter:
+  pl.setParameter(0, Parameter("c", -1.));
+  test &= pl.hasParameter("c") && !pl.hasParameter("a") && pl.getParameterValue("c") == -1.;
+  pl.setParameter(1, make_shared<Parameter>("d", -2.));
+  test &= pl.hasParameter("d") && !pl.hasParameter("x2") && pl.getParameterValue("d") == -2.;
+  pl.setParameter(1, make_shared<Parameter>("d", -3.));
+  test &= pl.whichParameterHasName("d") == 1 && pl.getParameterValue("d") == -3.;
+
+  // A replacement by a duplicated name keeps the first position:
+  ParameterList dup;
+  dup.addParameter(Parameter("u", 0.));
+  dup.addParameter(Parameter("v", 1.));
+  dup.addParameter(Parameter("w", 2.));
+  dup.setParameter(2, Parameter("v", 3.));
+  test &= dup.whichParameterHasName("v") == 1 && !dup.hasParameter("w");
+  dup.setParameter(1, Parameter("t", 4.));
+  test &= dup.whichParameterHasName("v") == 2 && dup.whichParameterHasName("t") == 1;
+
+  // Copies keep a valid index:
+  ParameterList copy(pl);
+  copy.parameter("d").setName("e");
+  test &= copy.hasParameter("e") && pl.hasParameter("d") && !pl.hasParameter("e");
+
+  // Matching only updates the common parameters:
+  ParameterList values;
+  values.addParameter(Parameter("x100", -100.));
+  values.addParameter(Parameter("z", 1.));
+  values.addParameter(Parameter("x200", 200.));
+  vector<size_t> updated;
+  test &= pl.matchParametersValues(values, &updated);
+  test &= updated.size() == 1 && updated[0] == 0;
+  test &= pl.getParameterValue("x100") == -100. && !pl.hasParameter("z");
+  pl.includeParameters(values);
+  test &= pl.hasParameter("z") && pl.whichParameterHasName("z") == pl.size() - 1;
+
+  // Lookups do not modify the list, and can be run concurrently:
+  const ParameterList& constList = pl;
+  atomic<size_t> found(0);
+  ThreadPool pool(4);
+  pool.parallelFor(n, [&](size_t i, size_t /* thread */) {
+    if (constList.hasParameter("x" + TextTools::toString(i)))
+      found++;
+  });
+  test &= found == n - 6; // x0, x1, x2, x3, x10 and x4999 are gone
+
+  pl.reset();
+  test &= pl.size() == 0 && !pl.hasParameter("z");
+  pl.addParameter(Parameter("z", 0.));
+  test &= pl.whichParameterHasName("z") == 0;
+
+  cout << (test ? "ParameterList index is consistent." : "ParameterList index is inconsistent!") << endl;
+  return test ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Exceptions.h>
+#include <Bpp/Utils/ThreadPool.h>
+#include <atomic>
+#include <iostream>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+int main()
+{
+  bool test = true;
+
+  for (size_t nbThreads : { 1, 2, 4, 7 })
+  {
+    ThreadPool pool(nbThreads);
+    test &= pool.getNumberOfThreads() == nbThreads;
+
+    // Each iteration is run exactly once, with a valid thread index:
+    size_t n = 10000;
+    vector<int> count(n, 0);
+    atomic<bool> badThread(false);
+    pool.parallelFor(n, [&](size_t i, size_t thread) {
+      count[i]++;
+      if (thread >= nbThreads)
+        badThread = true;
+    });
+    for (size_t i = 0; i < n; ++i)
+    {
+      test &= count[i] == 1;
+    }
+    test &= !badThread;
+
+    // Nested loops run serially in the calling thread, in slot 0:
+    vector<size_t> sums(10, 0);
+    pool.parallelFor(10, [&](size_t i, size_t /* thread */) {
+      pool.parallelFor(100, [&](size_t j, size_t thread2) {
+        sums[i] += j;
+        if (thread2 != 0)
+          badThread = true;
+      });
+    });
+    for (size_t i = 0; i < 10; ++i)
+    {
+      test &= sums[i] == 4950;
+    }
+    test &= !badThread;
+
+    // Also in a smaller pool, called from the iterations of a larger one:
+    ThreadPool inner(2);
+    vector<size_t> innerSums(20, 0);
+    ThreadPool outer(8);
+    outer.parallelFor(20, [&](size_t i, size_t /* thread */) {
+      inner.parallelFor(100, [&](size_t j, size_t thread2) {
+        innerSums[i] += j;
+        if (thread2 >= inner.getNumberOfThreads())
+          badThread = true;
+      });
+    });
+    for (size_t i = 0; i < 20; ++i)
+    {
+      test &= innerSums[i] == 4950;
+    }
+    test &= !badThread;
+
+    // Exceptions are forwarded to the caller, and the pool remains usable:
+    bool caught = false;
+    try
+    {
+      pool.parallelFor(1000, [&](size_t i, size_t /* thread */) {
+        if (i == 500)
+          throw Exception("Iteration 500 failed.");
+      });
+    }
+    catch (Exception& e)
+    {
+      caught = true;
+    }
+    test &= caught;
+    atomic<size_t> total(0);
+    pool.parallelFor(100, [&](size_t i, size_t /* thread */) { total += i; });
+    test &= total == 4950;
+  }
+  cout << (test ? "ThreadPool tests passed." : "ThreadPool tests failed.") << endl;
+  return test ? 0 : 1;
+}
@@ -0,0 +1,120 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "../src/Bpp/Graph/TreeGraphImpl.h"
+#include "../src/Bpp/Utils/ThreadPool.h"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+using namespace bpp;
+using namespace std;
+
+/**
+ * @brief Compare the indexed queries with the default ones on random node sets.
+ */
+template<class Tree>
+bool compareQueries(Tree& tree, const vector<Graph::NodeId>& nodes, mt19937& gen)
+{
+  bool test = true;
+  uniform_int_distribution<size_t> dist(0, nodes.size() - 1);
+  for (size_t i = 0; i < 500; ++i)
+  {
+    Graph::NodeId nodeA = nodes[dist(gen)];
+    Graph::NodeId nodeB = nodes[dist(gen)];
+    vector<Graph::NodeId> set = {nodeA, nodeB, nodes[dist(gen)], nodes[dist(gen)]};
+
+    tree.useLCAIndex(false);
+    Graph::NodeId mrca = tree.MRCA(set);
+    Graph::NodeId lca = tree.MRCA({nodeA, nodeB});
+    vector<Graph::NodeId> nodePath = tree.getNodePathBetweenTwoNodes(nodeA, nodeB);
+    vector<Graph::NodeId> nodePath2 = tree.getNodePathBetweenTwoNodes(nodeA, nodeB, false);
+    vector<Graph::EdgeId> edgePath = tree.getEdgePathBetweenTwoNodes(nodeA, nodeB);
+
+    // The LCA is on the path, and is an ancestor of both nodes
+    test &= find(nodePath.begin(), nodePath.end(), lca) != nodePath.end();
+    test &= nodePath.size() == nodePath2.size() + 1 && nodePath.front() == nodeA && nodePath.back() == nodeB;
+    vector<Graph::NodeId> subtree = tree.getSubtreeNodes(lca);
+    test &= find(subtree.begin(), subtree.end(), nodeA) != subtree.end() && find(subtree.begin(), subtree.end(), nodeB) != subtree.end();
+
+    tree.useLCAIndex(true);
+    test &= tree.getLCA(nodeA, nodeB) == lca;
+    test &= tree.MRCA(set) == mrca;
+    test &= tree.getNodePathBetweenTwoNodes(nodeA, nodeB) == nodePath;
+    test &= tree.getNodePathBetweenTwoNodes(nodeA, nodeB, false) == nodePath2;
+    test &= tree.getEdgePathBetweenTwoNodes(nodeA, nodeB) == edgePath;
+  }
+  return test;
+}
+
+template<class Tree>
+bool testTree()
+{
+  Tree tree(true);
+  mt19937 gen(3);
+  vector<Graph::NodeId> nodes(1, tree.createNode());
+  for (size_t i = 1; i < 1000; ++i)
+  {
+    uniform_int_distribution<size_t> dist(0, nodes.size() - 1);
+    nodes.push_back(tree.createNodeFromNode(nodes[dist(gen)]));
+  }
+  tree.rootAt(nodes[0]);
+  bool test = compareQueries(tree, nodes, gen);
+
+  // The index follows the changes of root and topology:
+  tree.rootAt(nodes[500]);
+  test &= compareQueries(tree, nodes, gen);
+  tree.useLCAIndex(true);
+  test &= tree.getLCA(nodes[0], nodes[500]) == nodes[500];
+  Graph::NodeId newNode = tree.createNode();
+  tree.addSon(nodes[0], newNode);
+  test &= tree.getLCA(newNode, nodes[0]) == nodes[0];
+  nodes.push_back(newNode);
+  test &= compareQueries(tree, nodes, gen);
+
+  // The first queries after a change may come from several threads at once:
+  tree.rootAt(nodes[250]);
+  tree.useLCAIndex(false);
+  vector<Graph::NodeId> expected(nodes.size());
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    expected[i] = tree.MRCA({nodes[i], nodes[nodes.size() - 1 - i]});
+  }
+  tree.useLCAIndex(true);
+  ThreadPool pool(4);
+  vector<unsigned char> ok(nodes.size(), 0);
+  pool.parallelFor(nodes.size(), [&](size_t i, size_t /* thread */) {
+      ok[i] = tree.getLCA(nodes[i], nodes[nodes.size() - 1 - i]) == expected[i];
+    });
+  test &= count(ok.begin(), ok.end(), 1) == static_cast<ptrdiff_t>(ok.size());
+  return test;
+}
+
+int main()
+{
+  bool test = true;
+  test &= testTree<TreeGlobalGraph>();
+  test &= testTree<TreeCompactGraph>();
+  cout << "Random trees: " << (test ? "ok" : "failed") << endl;
+
+  // Deep caterpillar tree:
+  TreeCompactGraph caterpillar(true);
+  Graph::NodeId root = caterpillar.createNode();
+  Graph::NodeId node = root;
+  vector<Graph::NodeId> leaves;
+  for (size_t i = 0; i < 100000; ++i)
+  {
+    leaves.push_back(caterpillar.createNodeFromNode(node));
+    node = caterpillar.createNodeFromNode(node);
+  }
+  caterpillar.rootAt(root);
+  caterpillar.useLCAIndex(true);
+  test &= caterpillar.getLCA(leaves[10], leaves[99999]) == caterpillar.getFatherOfNode(leaves[10]);
+  test &= caterpillar.MRCA(leaves) == root;
+  test &= caterpillar.getEdgePathBetweenTwoNodes(leaves[0], node).size() == 100001;
+  cout << "Caterpillar tree: " << (test ? "ok" : "failed") << endl;
+
+  return test ? 0 : 1;
+}
@@ -0,0 +1,133 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "../src/Bpp/Graph/TreeGraphImpl.h"
+#include "../src/Bpp/Utils/ThreadPool.h"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+using namespace bpp;
+using namespace std;
+
+// Reference recursive traversals
+template<class Tree>
+void preOrder(const Tree& tree, Graph::NodeId node, vector<Graph::NodeId>& nodes)
+{
+  nodes.push_back(node);
+  for (auto son : tree.getSons(node))
+  {
+    preOrder(tree, son, nodes);
+  }
+}
+
+template<class Tree>
+void postOrder(const Tree& tree, Graph::NodeId node, vector<Graph::NodeId>& nodes)
+{
+  for (auto son : tree.getSons(node))
+  {
+    postOrder(tree, son, nodes);
+  }
+  nodes.push_back(node);
+}
+
+template<class Tree>
+bool checkTraversals(const Tree& tree)
+{
+  vector<Graph::NodeId> pre, post;
+  preOrder(tree, tree.getRoot(), pre);
+  postOrder(tree, tree.getRoot(), post);
+  bool test = tree.getPreOrder() == pre && tree.getPostOrder() == post;
+
+  // Level-order: non decreasing depths, sons in order
+  const vector<Graph::NodeId>& level = tree.getLevelOrder();
+  test &= level.size() == pre.size() && level.front() == tree.getRoot();
+  for (size_t i = 1; i < level.size(); ++i)
+  {
+    test &= tree.getNodePathBetweenTwoNodes(tree.getRoot(), level[i - 1]).size() <= tree.getNodePathBetweenTwoNodes(tree.getRoot(), level[i]).size();
+  }
+  vector<Graph::NodeId> sortedLevel(level);
+  sort(sortedLevel.begin(), sortedLevel.end());
+  sort(pre.begin(), pre.end());
+  test &= sortedLevel == pre;
+
+  // Subtrees
+  for (auto node : tree.getPreOrder())
+  {
+    vector<Graph::NodeId> subtree;
+    preOrder(tree, node, subtree);
+    test &= tree.getSubtreeNodes(node) == subtree;
+    vector<Graph::EdgeId> edges = tree.getSubtreeEdges(node);
+    test &= edges.size() + 1 == subtree.size();
+    for (size_t i = 0; i < edges.size(); ++i)
+    {
+      test &= tree.getBottom(edges[i]) == subtree[i + 1];
+    }
+  }
+  return test;
+}
+
+template<class Tree>
+bool testTree()
+{
+  Tree tree(true);
+  mt19937 gen(7);
+  Graph::NodeId root = tree.createNode();
+  vector<Graph::NodeId> nodes(1, root);
+  for (size_t i = 1; i < 300; ++i)
+  {
+    uniform_int_distribution<size_t> dist(0, nodes.size() - 1);
+    nodes.push_back(tree.createNodeFromNode(nodes[dist(gen)]));
+  }
+  tree.rootAt(root);
+  bool test = checkTraversals(tree);
+
+  // The cached orders follow the changes of root and topology:
+  tree.rootAt(nodes[150]);
+  test &= tree.getPreOrder().front() == nodes[150] && checkTraversals(tree);
+  Graph::NodeId newNode = tree.createNode();
+  tree.addSon(nodes[20], newNode);
+  test &= checkTraversals(tree);
+  test &= find(tree.getPostOrder().begin(), tree.getPostOrder().end(), newNode) != tree.getPostOrder().end();
+
+  // The first queries after a change may come from several threads at once:
+  tree.rootAt(nodes[42]);
+  vector<Graph::NodeId> expected;
+  preOrder(tree, nodes[42], expected);
+  ThreadPool pool(4);
+  vector<unsigned char> ok(64, 0);
+  pool.parallelFor(ok.size(), [&](size_t i, size_t /* thread */) {
+      ok[i] = tree.getPreOrder() == expected && tree.getPostOrder().back() == nodes[42];
+    });
+  test &= count(ok.begin(), ok.end(), 1) == static_cast<ptrdiff_t>(ok.size());
+  return test;
+}
+
+int main()
+{
+  bool test = true;
+  test &= testTree<TreeGlobalGraph>();
+  test &= testTree<TreeCompactGraph>();
+  cout << "Random trees: " << (test ? "ok" : "failed") << endl;
+
+  // A caterpillar tree is traversed and rerooted without recursion:
+  TreeCompactGraph caterpillar(true);
+  Graph::NodeId node = caterpillar.createNode();
+  Graph::NodeId root = node;
+  for (size_t i = 0; i < 200000; ++i)
+  {
+    caterpillar.createNodeFromNode(node);
+    node = caterpillar.createNodeFromNode(node);
+  }
+  caterpillar.rootAt(root);
+  test &= caterpillar.getPostOrder().back() == root && caterpillar.getPreOrder().back() == node;
+  test &= caterpillar.getSubtreeNodes(root).size() == caterpillar.getNumberOfNodes();
+  test &= caterpillar.getLeavesUnderNode(root).size() == 200001;
+  caterpillar.rootAt(node);
+  test &= caterpillar.getPostOrder().back() == node && caterpillar.getLevelOrder().front() == node;
+  cout << "Caterpillar tree: " << (test ? "ok" : "failed") << endl;
+
+  return test ? 0 : 1;
+}